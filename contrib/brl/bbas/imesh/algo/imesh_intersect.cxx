@@ -170,6 +170,42 @@ int imesh_intersect_min_dist(const vgl_point_3d<double>& p,
 }
 
 
+//: Build a bounding volume hierarchy over the faces of a triangulated mesh.
+void imesh_build_bvh(const imesh_mesh& mesh, vgl_bvh_3d<double>& bvh)
+{
+  assert(mesh.faces().regularity() == 3);
+  const imesh_regular_face_array<3>& faces
+      = static_cast<const imesh_regular_face_array<3>&>(mesh.faces());
+  const imesh_vertex_array<3>& verts = mesh.vertices<3>();
+
+  std::vector<vgl_point_3d<double> > pts(verts.size());
+  for (unsigned int i=0; i<verts.size(); ++i)
+    pts[i] = vgl_point_3d<double>(verts[i]);
+  std::vector<unsigned> tris(3*faces.size());
+  for (unsigned int i=0; i<faces.size(); ++i)
+    for (unsigned int j=0; j<3; ++j)
+      tris[3*i+j] = faces[i][j];
+  bvh.build(pts, tris);
+}
+
+
+//: Intersect the ray from point p with direction d and the mesh of bvh
+int imesh_intersect_min_dist(const vgl_point_3d<double>& p,
+                             const vgl_vector_3d<double>& d,
+                             const vgl_bvh_3d<double>& bvh,
+                             double& dist, double* u, double* v)
+{
+  double ut, vt;
+  dist = std::numeric_limits<double>::infinity();
+  int isect = bvh.intersect(p, d, dist, ut, vt);
+  if (isect >= 0) {
+    if (u) *u = ut;
+    if (v) *v = vt;
+  }
+  return isect;
+}
+
+
 //: Find the closest point on the triangle a,b,c to point p
 //  The un-normalized normal vector (b-a)x(c-a) is precomputed and also passed in
 //  \returns a code indicating that the closest point:
@@ -349,6 +385,15 @@ int imesh_closest_point(const vgl_point_3d<double>& p,
 }
 
 
+//: Find the closest point on the mesh of bvh to point p
+int imesh_closest_point(const vgl_point_3d<double>& p,
+                        const vgl_bvh_3d<double>& bvh,
+                        vgl_point_3d<double>& cp)
+{
+  return bvh.closest_point(p, cp);
+}
+
+
 //: Find the closest intersection point from p along d with triangle a,b,c
 //  \returns a code indicating that the intersection point:
 //  - 0 does not exist
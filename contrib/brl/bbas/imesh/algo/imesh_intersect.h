@@ -17,6 +17,7 @@
 #include <limits>
 #include <imesh/imesh_mesh.h>
 #include <vgl/vgl_vector_3d.h>
+#include <vgl/algo/vgl_bvh_3d.h>
 #include <vcl_compiler.h>
 
 
@@ -73,6 +74,22 @@ int imesh_intersect_min_dist(const vgl_point_3d<double>& p,
                              double& dist, double* u=0, double* v=0);
 
 
+//: Build a bounding volume hierarchy over the faces of a triangulated mesh.
+//  The overloads below taking it answer the same queries as those taking
+//  the mesh, without testing every face.
+void imesh_build_bvh(const imesh_mesh& mesh, vgl_bvh_3d<double>& bvh);
+
+
+//: Intersect the ray from point p with direction d and the mesh of bvh
+//  \returns the face index of the closest intersecting triangle
+//  \param dist is the distance to the triangle (returned by reference)
+//  \param u and \param v (optional) are the barycentric coordinates of the intersection
+int imesh_intersect_min_dist(const vgl_point_3d<double>& p,
+                             const vgl_vector_3d<double>& d,
+                             const vgl_bvh_3d<double>& bvh,
+                             double& dist, double* u=0, double* v=0);
+
+
 //: Find the closest point on the triangle a,b,c to point p
 //  The un-normalized normal vector (b-a)x(c-a) is precomputed and also passed in
 //  \returns a code indicating that the closest point:
@@ -129,6 +146,14 @@ int imesh_closest_point(const vgl_point_3d<double>& p,
                         double* u=0, double* v=0);
 
 
+//: Find the closest point on the mesh of bvh to point p
+//  \returns the face index of the closest triangle
+//  \param cp is the closest point on the mesh (returned by reference)
+int imesh_closest_point(const vgl_point_3d<double>& p,
+                        const vgl_bvh_3d<double>& bvh,
+                        vgl_point_3d<double>& cp);
+
+
 //: Find the closest intersection point from p along d with triangle a,b,c
 //  \returns a code indicating that the intersection point:
 //  - 0 does not exist
@@ -9,6 +9,7 @@
 #include "mbl_matrix_products.h"
 #include <vnl/vnl_vector.h>
 #include <vnl/vnl_matrix.h>
+#include <vnl/vnl_gemm.h>
 #include <vcl_cassert.h>
 #include <vcl_compiler.h>
 
@@ -32,30 +33,8 @@ void mbl_matrix_product(vnl_matrix<double>& AB, const vnl_matrix<double>& A,
    if ( (AB.rows()!=nr1) || (AB.cols()!= nc2) )
     AB.set_size( nr1, nc2 ) ;
 
-  const double *const * AData = A.data_array();
-  const double *const * BData = B.data_array();
-  double ** RData = AB.data_array();
-
-  // Zero the elements of AB
-  AB.fill(0);
-
-  for (unsigned int r=0; r < nr1; ++r)
-  {
-    const double* A_row = AData[r];
-    double* R_row = RData[r]-1;
-    for (unsigned int c=0; c < nc1 ; ++c )
-    {
-      double a = A_row[c];
-      if (a==0.0) continue;
-
-      const double* B_row = BData[c]-1;
-      int i = nc2+1;
-      while (--i)
-      {
-        R_row[i] += a * B_row[i];
-      }
-    }
-  }
+  vnl_gemm(false, false, nr1, nc2, nc1, 1.0, A.data_block(), nc1, B.data_block(), nc2,
+           0.0, AB.data_block(), nc2);
 }
 
 //=======================================================================
@@ -95,20 +74,8 @@ void mbl_matrix_product_a_bt(vnl_matrix<double>& ABt,
   if ( (ABt.rows()!=nr1) || (ABt.columns()!= nr2) )
     ABt.set_size( nr1, nr2 ) ;
 
-  double const *const * A_data = A.data_array();
-  double const *const * B_data = B.data_array();
-  double ** R_data = ABt.data_array();
-
-  for (unsigned int r=0;r<nr1;++r)
-  {
-    const double* A_row = A_data[r];
-    double* R_row = R_data[r];
-    for (unsigned int c=0;c<nr2;++c)
-    {
-      const double* B_row = B_data[c];
-      R_row[c] = vnl_c_vector<double>::dot_product(A_row,B_row,nc);
-    }
-  }
+  vnl_gemm(false, true, nr1, nr2, nc, 1.0, A.data_block(), A.columns(),
+           B.data_block(), B.columns(), 0.0, ABt.data_block(), nr2);
 }
 
 //=======================================================================
@@ -123,7 +90,6 @@ void mbl_matrix_product_at_b(vnl_matrix<double>& AtB,
 
 //=======================================================================
 //: Compute AAt = A * A.transpose(), using only first nr x nc partition of A
-//  Uses symmetry of result to improve speed
 //=======================================================================
 void mbl_matrix_product_a_at(vnl_matrix<double>& AAt,
                              const vnl_matrix<double>& A,
@@ -135,31 +101,12 @@ void mbl_matrix_product_a_at(vnl_matrix<double>& AAt,
   if ( (AAt.rows()!=nr) || (AAt.columns()!= nr) )
     AAt.set_size( nr, nr ) ;
 
-  double const *const * A_data = A.data_array();
-  double ** R_data = AAt.data_array();
-
-  // Fill in upper triangle of symmetric matrix
-  for (unsigned int r=0;r<nr;++r)
-  {
-    const double* A_row = A_data[r];
-    double* R_row = R_data[r];
-    for (unsigned int c=r;c<nr;++c)
-    {
-      const double* B_row = A_data[c];
-      R_row[c] = vnl_c_vector<double>::dot_product(A_row,B_row,nc);
-    }
-  }
-
-  // Copy upper triangle to lower triangle
-  for (unsigned int r=1;r<nr;++r)
-    for (unsigned int c=0;c<r;++c)
-      AAt(r,c)=AAt(c,r);
+  vnl_gemm(false, true, nr, nr, nc, 1.0, A.data_block(), A.columns(),
+           A.data_block(), A.columns(), 0.0, AAt.data_block(), nr);
 }
 
 //=======================================================================
 //: Compute product AAt = A * A.transpose()
-//  Uses symmetry of result to be approx twice as fast as
-//  mbl_matrix_product_a_bt(AAt,A,A)
 //=======================================================================
 void mbl_matrix_product_a_at(vnl_matrix<double>& AAt,
                              const vnl_matrix<double>& A)
@@ -188,29 +135,8 @@ void mbl_matrix_product_at_b(vnl_matrix<double>& AtB,
   if ( (AtB.rows()!=(unsigned int)nc_a) || (AtB.columns()!= nc2) )
     AtB.set_size( nc_a, nc2 ) ;
 
-  double const *const * A_data = A.data_array();
-  double const *const * B_data = B.data_array();
-  double ** R_data = AtB.data_array()-1;
-
-  AtB.fill(0);
-
-  for (unsigned int r1 = 0; r1<nr1; ++r1)
-  {
-    const double* A_row = A_data[r1]-1;
-    const double* B_row = B_data[r1]-1;
-    double a;
-    int c1 =  nc_a+1;
-    while (--c1)
-    {
-      double *R_row = R_data[c1]-1;
-      a = A_row[c1];
-      int c2 = nc2+1;
-      while (--c2)
-      {
-         R_row[c2] +=a*B_row[c2];
-      }
-    }
-  }
+  vnl_gemm(true, false, nc_a, nc2, nr1, 1.0, A.data_block(), A.columns(),
+           B.data_block(), nc2, 0.0, AtB.data_block(), nc2);
 }
 
 
@@ -227,27 +153,8 @@ void mbl_matrix_product_at_a(vnl_matrix<double>& AtA,
   if ( AtA.rows()!=nr || (AtA.columns()!= nc) )
     AtA.set_size( nc, nc ) ;
 
-  double const *const * A_data = A.data_array();
-  double ** R_data = AtA.data_array()-1;
-
-  AtA.fill(0);
-
-  for (unsigned int r = 0; r<nr; ++r)
-  {
-    const double* A_row = A_data[r]-1;
-    double a;
-    int c1 =  nc+1;
-    while (--c1)
-    {
-      double *R_row = R_data[c1]-1;
-      a = A_row[c1];
-      int c2 = nc+1;
-      while (--c2)
-      {
-         R_row[c2] +=a*A_row[c2];
-      }
-    }
-  }
+  vnl_gemm(true, false, nc, nc, nr, 1.0, A.data_block(), A.columns(),
+           A.data_block(), A.columns(), 0.0, AtA.data_block(), nc);
 }
 
 //=======================================================================
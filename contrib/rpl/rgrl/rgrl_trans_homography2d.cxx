@@ -9,6 +9,7 @@
 #include <vnl/vnl_math.h>
 #include <vnl/vnl_double_2.h>
 #include <vnl/vnl_double_3.h>
+#include <vgl/algo/vgl_projective_map.h>
 
 #include <rgrl/rgrl_util.h>
 
@@ -307,6 +308,15 @@ map_loc( vnl_vector<double> const& from,
   to[1] = h_to[1]/h_to[2] + to_centre_[1];
 }
 
+void
+rgrl_trans_homography2d::
+map_locs( double const* from, double* to, unsigned n ) const
+{
+  // the centring is folded into the matrix
+  const vnl_matrix_fixed<double,3,3> H = uncenter_H_matrix();
+  vgl_projective_map_2d( H.data_block(), from, to, n );
+}
+
 void
 rgrl_trans_homography2d::
 map_dir( vnl_vector<double> const& from_loc,
@@ -53,6 +53,11 @@ class rgrl_trans_homography2d
                 vnl_vector<double>& from,
                 vnl_vector<double>& from_next_est) const;
 
+  //: Map the n interleaved locations from = (x0, y0, x1, y1, ...) into to, all at once.
+  //  to may be from, to map the locations in place.  Used for scoring
+  //  many matches against one estimate; see vgl_projective_map.h
+  void map_locs( double const* from, double* to, unsigned n ) const;
+
   //: is this an invertible transformation?
   bool is_invertible() const { return true; }
 
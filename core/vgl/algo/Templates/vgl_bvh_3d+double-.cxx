@@ -0,0 +1,3 @@
+// Instantiation of vgl_bvh_3d<double>
+#include <vgl/algo/vgl_bvh_3d.hxx>
+VGL_BVH_3D_INSTANTIATE(double);
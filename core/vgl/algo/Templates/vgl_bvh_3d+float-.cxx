@@ -0,0 +1,3 @@
+// Instantiation of vgl_bvh_3d<float>
+#include <vgl/algo/vgl_bvh_3d.hxx>
+VGL_BVH_3D_INSTANTIATE(float);
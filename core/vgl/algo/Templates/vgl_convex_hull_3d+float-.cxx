@@ -0,0 +1,3 @@
+// Instantiation of vgl_convex_hull_3d for float
+#include <vgl/algo/vgl_convex_hull_3d.hxx>
+VGL_CONVEX_HULL_3D_INSTANTIATE(float);
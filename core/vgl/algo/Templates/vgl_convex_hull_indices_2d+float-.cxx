@@ -0,0 +1,3 @@
+// Instantiation of vgl_convex_hull_indices_2d for float
+#include <vgl/algo/vgl_convex_hull_indices_2d.hxx>
+VGL_CONVEX_HULL_INDICES_2D_INSTANTIATE(float);
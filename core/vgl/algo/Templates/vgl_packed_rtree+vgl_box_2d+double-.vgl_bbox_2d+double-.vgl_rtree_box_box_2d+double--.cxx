@@ -0,0 +1,9 @@
+#include <vgl/algo/vgl_packed_rtree.hxx>
+#include <vgl/vgl_box_2d.h>
+#include <vgl/algo/vgl_rtree_c.h>
+
+typedef vgl_box_2d<double> v;
+typedef vgl_bbox_2d<double> b;
+typedef vgl_rtree_box_box_2d<double> c;
+
+VGL_PACKED_RTREE_INSTANTIATE(v, b, c);
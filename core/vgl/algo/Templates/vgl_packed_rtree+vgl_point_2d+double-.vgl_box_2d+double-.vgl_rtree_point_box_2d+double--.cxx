@@ -0,0 +1,10 @@
+#include <vgl/algo/vgl_packed_rtree.hxx>
+#include <vgl/vgl_point_2d.h>
+#include <vgl/vgl_box_2d.h>
+#include <vgl/algo/vgl_rtree_c.h>
+
+typedef vgl_point_2d<double> pt;
+typedef vgl_box_2d<double> box;
+typedef vgl_rtree_point_box_2d<double> c;
+
+VGL_PACKED_RTREE_INSTANTIATE(pt, box, c);
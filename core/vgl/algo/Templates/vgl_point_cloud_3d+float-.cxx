@@ -0,0 +1,3 @@
+// Instantiation of vgl_point_cloud_3d<float>
+#include <vgl/algo/vgl_point_cloud_3d.hxx>
+VGL_POINT_CLOUD_3D_INSTANTIATE(float);
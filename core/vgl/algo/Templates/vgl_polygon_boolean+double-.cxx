@@ -0,0 +1,3 @@
+// Instantiation of vgl_polygon_boolean for double
+#include <vgl/algo/vgl_polygon_boolean.hxx>
+VGL_POLYGON_BOOLEAN_INSTANTIATE(double);
@@ -0,0 +1,3 @@
+// Instantiation of vgl_polygon_boolean for float
+#include <vgl/algo/vgl_polygon_boolean.hxx>
+VGL_POLYGON_BOOLEAN_INSTANTIATE(float);
@@ -0,0 +1,3 @@
+// Instantiation of vgl_projective_map for float
+#include <vgl/algo/vgl_projective_map.hxx>
+VGL_PROJECTIVE_MAP_INSTANTIATE(float);
@@ -0,0 +1,235 @@
+// This is core/vgl/algo/tests/test_bvh_3d.cxx
+// Tests of the bounding volume hierarchy queries against testing every triangle
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <vcl_compiler.h>
+#include <vgl/vgl_triangle_3d.h>
+#include <vgl/algo/vgl_bvh_3d.h>
+#include <vnl/vnl_random.h>
+#include <testlib/testlib_test.h>
+
+//: A wavy height field over [0,n]x[0,n], as an indexed mesh
+static void terrain(unsigned n, std::vector<vgl_point_3d<double> >& verts, std::vector<unsigned>& tris)
+{
+  verts.clear(); tris.clear();
+  for (unsigned j = 0; j <= n; ++j)
+    for (unsigned i = 0; i <= n; ++i)
+      verts.push_back(vgl_point_3d<double>(i, j, 2.0 * std::sin(0.3 * i) * std::cos(0.2 * j)));
+  for (unsigned j = 0; j < n; ++j)
+    for (unsigned i = 0; i < n; ++i) {
+      const unsigned a = j * (n + 1) + i, b = a + 1, c = a + n + 1, d = c + 1;
+      tris.push_back(a); tris.push_back(b); tris.push_back(d);
+      tris.push_back(a); tris.push_back(d); tris.push_back(c);
+    }
+}
+
+//: Nearest triangle met by the ray, by testing them all
+static int brute_intersect(std::vector<vgl_point_3d<double> > const& v, std::vector<unsigned> const& tris,
+                           vgl_point_3d<double> const& o, vgl_vector_3d<double> const& d, double& t)
+{
+  int best = -1;
+  t = 1e300;
+  for (unsigned k = 0; k < tris.size() / 3; ++k) {
+    vgl_point_3d<double> const& p0 = v[tris[3 * k]];
+    vgl_vector_3d<double> e1 = v[tris[3 * k + 1]] - p0, e2 = v[tris[3 * k + 2]] - p0;
+    vgl_vector_3d<double> p = cross_product(d, e2);
+    const double det = dot_product(e1, p);
+    if (std::fabs(det) < 1e-14) continue;
+    vgl_vector_3d<double> s = o - p0, q = cross_product(s, e1);
+    const double u = dot_product(s, p) / det, w = dot_product(d, q) / det, tk = dot_product(e2, q) / det;
+    if (u >= 0 && w >= 0 && u + w <= 1 && tk >= 0 && tk < t) { t = tk; best = k; }
+  }
+  return best;
+}
+
+static void test_rays(vgl_bvh_3d<double> const& bvh, std::vector<vgl_point_3d<double> > const& verts,
+                      std::vector<unsigned> const& tris, vnl_random& rng)
+{
+  unsigned wrong = 0, hits = 0, wrong_occluded = 0, wrong_bary = 0;
+  std::vector<vgl_ray_3d<double> > rays;
+  std::vector<double> expected_t;
+  for (unsigned r = 0; r < 2000; ++r) {
+    vgl_point_3d<double> o(rng.drand64(-5, 45), rng.drand64(-5, 45), rng.drand64(-6, 6));
+    vgl_vector_3d<double> d(rng.drand64(-1, 1), rng.drand64(-1, 1), rng.drand64(-1, 1));
+    d /= d.length();
+    rays.push_back(vgl_ray_3d<double>(o, d));
+    double tb, t, u, v;
+    const int fb = brute_intersect(verts, tris, o, d, tb);
+    const int f = bvh.intersect(o, d, t, u, v);
+    expected_t.push_back(fb < 0 ? -1.0 : tb);
+    if ((fb < 0) != (f < 0) || (f >= 0 && std::fabs(t - tb) > 1e-9)) { ++wrong; continue; }
+    if (bvh.occluded(o, d, 1e300) != (f >= 0) || (f >= 0 && bvh.occluded(o, d, 0.5 * t)))
+      ++wrong_occluded;
+    if (f < 0) continue;
+    ++hits;
+    vgl_point_3d<double> p0, p1, p2;
+    bvh.triangle(f, p0, p1, p2);
+    vgl_point_3d<double> q = p0 + u * (p1 - p0) + v * (p2 - p0);
+    if ((q - (o + t * d)).length() > 1e-9)
+      ++wrong_bary;
+  }
+  std::cout << hits << " of 2000 rays hit\n";
+  TEST("nearest hit agrees with testing every triangle", wrong, 0u);
+  TEST("occluded agrees", wrong_occluded, 0u);
+  TEST("barycentric coordinates give the hit", wrong_bary, 0u);
+  TEST("some rays hit and some miss", hits > 0 && hits < 2000, true);
+
+  std::vector<int> faces;
+  std::vector<double> ts;
+  bvh.intersect(rays, faces, ts);
+  unsigned wrong_batch = 0;
+  for (unsigned r = 0; r < rays.size(); ++r)
+    if ((faces[r] < 0) != (expected_t[r] < 0) || (faces[r] >= 0 && std::fabs(ts[r] - expected_t[r]) > 1e-9))
+      ++wrong_batch;
+  TEST("batched rays agree", wrong_batch, 0u);
+}
+
+static void test_closest(vgl_bvh_3d<double> const& bvh, std::vector<vgl_point_3d<double> > const& verts,
+                         std::vector<unsigned> const& tris, vnl_random& rng)
+{
+  std::vector<vgl_point_3d<double> > ps;
+  std::vector<double> dist;
+  unsigned wrong = 0;
+  for (unsigned r = 0; r < 500; ++r) {
+    vgl_point_3d<double> p(rng.drand64(-5, 45), rng.drand64(-5, 45), rng.drand64(-6, 6));
+    double best = 1e300;
+    for (unsigned k = 0; k < tris.size() / 3; ++k)
+      best = std::min(best, vgl_triangle_3d_distance(p, verts[tris[3 * k]], verts[tris[3 * k + 1]], verts[tris[3 * k + 2]]));
+    vgl_point_3d<double> cp;
+    const int f = bvh.closest_point(p, cp);
+    vgl_point_3d<double> p0, p1, p2;
+    bvh.triangle(f, p0, p1, p2);
+    if (std::fabs((cp - p).length() - best) > 1e-9 || vgl_triangle_3d_distance(cp, p0, p1, p2) > 1e-9)
+      ++wrong;
+    ps.push_back(p);
+    dist.push_back(best);
+  }
+  TEST("closest point agrees with testing every triangle", wrong, 0u);
+
+  std::vector<vgl_point_3d<double> > cps;
+  std::vector<int> faces;
+  bvh.closest_points(ps, cps, faces);
+  unsigned wrong_batch = 0;
+  for (unsigned r = 0; r < ps.size(); ++r)
+    if (faces[r] < 0 || std::fabs((cps[r] - ps[r]).length() - dist[r]) > 1e-9)
+      ++wrong_batch;
+  TEST("batched closest points agree", wrong_batch, 0u);
+}
+
+static void test_overlapping(vgl_bvh_3d<double> const& bvh, std::vector<vgl_point_3d<double> > const& verts,
+                             std::vector<unsigned> const& tris, vnl_random& rng)
+{
+  const unsigned n = (unsigned)tris.size() / 3;
+  unsigned wrong = 0, found = 0;
+  for (unsigned r = 0; r < 200; ++r) {
+    const double x = rng.drand64(-2, 42), y = rng.drand64(-2, 42), z = rng.drand64(-3, 3);
+    vgl_box_3d<double> box(x, y, z, x + rng.drand64(0.1, 5), y + rng.drand64(0.1, 5), z + rng.drand64(0.1, 2));
+    std::vector<unsigned> faces;
+    bvh.overlapping(box, faces);
+    std::vector<bool> in(n, false);
+    for (unsigned k = 0; k < faces.size(); ++k)
+      in[faces[k]] = true;
+    found += (unsigned)faces.size();
+    for (unsigned k = 0; k < n; ++k) {
+      vgl_point_3d<double> const& a = verts[tris[3 * k]];
+      vgl_point_3d<double> const& b = verts[tris[3 * k + 1]];
+      vgl_point_3d<double> const& c = verts[tris[3 * k + 2]];
+      // a triangle with a corner in the box must be reported; one whose
+      // bounding box misses the box must not be, nor one far from its centre
+      vgl_box_3d<double> tb;
+      tb.add(a); tb.add(b); tb.add(c);
+      const bool corner = box.contains(a) || box.contains(b) || box.contains(c);
+      const bool apart = tb.min_x() > box.max_x() || tb.max_x() < box.min_x() ||
+                         tb.min_y() > box.max_y() || tb.max_y() < box.min_y() ||
+                         tb.min_z() > box.max_z() || tb.max_z() < box.min_z();
+      const double dist = vgl_triangle_3d_distance(box.centroid(), a, b, c);
+      const double radius = 0.5 * (box.max_point() - box.min_point()).length();
+      if ((corner && !in[k]) || (apart && in[k]) || (in[k] && dist > radius + 1e-12))
+        ++wrong;
+    }
+  }
+  TEST("overlapping triangles are reported", wrong, 0u);
+  TEST("some triangles overlap", found > 0, true);
+
+  // a flat triangle crossing a box whose corners it misses, and one just beside it
+  std::vector<vgl_point_3d<double> > soup;
+  soup.push_back(vgl_point_3d<double>(-5, -5, 0.5)); soup.push_back(vgl_point_3d<double>(5, -5, 0.5));
+  soup.push_back(vgl_point_3d<double>(0, 5, 0.5));
+  soup.push_back(vgl_point_3d<double>(1.2, 1.2, 0)); soup.push_back(vgl_point_3d<double>(3, 1.2, 0));
+  soup.push_back(vgl_point_3d<double>(1.2, 3, 0));
+  vgl_bvh_3d<double> two(soup);
+  std::vector<unsigned> faces;
+  two.overlapping(vgl_box_3d<double>(0, 0, 0, 1, 1, 1), faces);
+  TEST("plane through a box overlaps it", faces.size() == 1 && faces[0] == 0, true);
+  // both bounding boxes meet this box, but neither triangle does
+  two.overlapping(vgl_box_3d<double>(2.2, 2.2, -1, 2.8, 2.8, 1), faces);
+  TEST("bounding box overlap alone is not enough", faces.size(), 0u);
+}
+
+static void test_bvh_3d()
+{
+  std::vector<vgl_point_3d<double> > verts;
+  std::vector<unsigned> tris;
+  terrain(40, verts, tris);
+  vgl_bvh_3d<double> bvh(verts, tris);
+  std::cout << bvh.size() << " triangles, " << bvh.nodes() << " nodes, depth " << bvh.depth() << '\n';
+  TEST("size", bvh.size(), 3200u);
+  TEST("nodes", bvh.nodes() >= 3200 / 4 && bvh.nodes() < 2 * 3200, true);
+  TEST("depth is logarithmic", bvh.depth() > 5 && bvh.depth() < 40, true);
+  vgl_box_3d<double> bb = bvh.bounding_box();
+  TEST("bounding box", bb.min_x() == 0 && bb.max_x() == 40 && bb.min_y() == 0 && bb.max_y() == 40, true);
+  vgl_point_3d<double> p0, p1, p2;
+  bvh.triangle(123, p0, p1, p2);
+  TEST("triangle corners", p0 == verts[tris[369]] && p1 == verts[tris[370]] && p2 == verts[tris[371]], true);
+
+  vnl_random rng(9667566);
+  test_rays(bvh, verts, tris, rng);
+  test_closest(bvh, verts, tris, rng);
+  test_overlapping(bvh, verts, tris, rng);
+
+  // random triangle soup, many overlapping, with leaves of one triangle
+  std::vector<vgl_point_3d<double> > soup;
+  std::vector<unsigned> soup_tris;
+  for (unsigned k = 0; k < 900; ++k) {
+    vgl_point_3d<double> c(rng.drand64(0, 40), rng.drand64(0, 40), rng.drand64(-4, 4));
+    for (unsigned i = 0; i < 3; ++i) {
+      soup.push_back(c + vgl_vector_3d<double>(rng.drand64(-2, 2), rng.drand64(-2, 2), rng.drand64(-2, 2)));
+      soup_tris.push_back(3 * k + i);
+    }
+  }
+  vgl_bvh_3d<double> soup_bvh(soup, 1);
+  TEST("soup: size", soup_bvh.size(), 900u);
+  TEST("soup: one triangle per leaf", soup_bvh.nodes(), 2 * 900u - 1);
+  test_rays(soup_bvh, soup, soup_tris, rng);
+  test_closest(soup_bvh, soup, soup_tris, rng);
+
+  // identical triangles cannot be split
+  std::vector<vgl_point_3d<double> > same;
+  for (unsigned k = 0; k < 10; ++k) {
+    same.push_back(vgl_point_3d<double>(0, 0, 0)); same.push_back(vgl_point_3d<double>(1, 0, 0));
+    same.push_back(vgl_point_3d<double>(0, 1, 0));
+  }
+  vgl_bvh_3d<double> same_bvh(same, 2);
+  TEST("coincident triangles: a single leaf", same_bvh.nodes() == 1 && same_bvh.depth() == 1, true);
+  double t, u, v;
+  TEST("coincident triangles: hit", same_bvh.intersect(vgl_point_3d<double>(0.2, 0.2, 1), vgl_vector_3d<double>(0, 0, -1), t, u, v) >= 0 && t == 1.0, true);
+
+  // empty, and float
+  vgl_bvh_3d<float> empty;
+  float tf;
+  vgl_point_3d<float> cp;
+  TEST("empty: no hit", empty.intersect(vgl_ray_3d<float>(vgl_point_3d<float>(0, 0, 0), vgl_vector_3d<float>(1, 0, 0)), tf), -1);
+  TEST("empty: no closest point", empty.closest_point(vgl_point_3d<float>(0, 0, 0), cp), -1);
+  TEST("empty: depth", empty.depth(), 0u);
+  std::vector<vgl_point_3d<float> > fs;
+  fs.push_back(vgl_point_3d<float>(0, 0, 2)); fs.push_back(vgl_point_3d<float>(2, 0, 2));
+  fs.push_back(vgl_point_3d<float>(0, 2, 2));
+  vgl_bvh_3d<float> fb(fs);
+  TEST("float: hit", fb.intersect(vgl_ray_3d<float>(vgl_point_3d<float>(0.5f, 0.5f, 0), vgl_vector_3d<float>(0, 0, 1)), tf), 0);
+  TEST_NEAR("float: distance", tf, 2.0f, 1e-6);
+  TEST("float: closest point", fb.closest_point(vgl_point_3d<float>(3, 3, 3), cp) == 0 &&
+       std::fabs(cp.x() - 1) < 1e-6 && std::fabs(cp.y() - 1) < 1e-6, true);
+}
+
+TESTMAIN(test_bvh_3d);
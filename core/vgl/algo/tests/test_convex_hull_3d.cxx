@@ -0,0 +1,146 @@
+// This is core/vgl/algo/tests/test_convex_hull_3d.cxx
+#include <iostream>
+#include <vector>
+#include <map>
+#include <utility>
+#include <cmath>
+#include <vcl_compiler.h>
+#include <vgl/vgl_point_3d.h>
+#include <vgl/algo/vgl_convex_hull_3d.h>
+#include <vnl/vnl_random.h>
+#include <testlib/testlib_test.h>
+
+//: Is the hull a closed convex surface, with V - E + F = 2, containing all its points?
+template <class T>
+static bool is_hull(vgl_convex_hull_3d<T> const& hull)
+{
+  std::vector<unsigned> tris, verts;
+  hull.faces(tris);
+  hull.vertices(verts);
+  // each edge once in each direction
+  std::map<std::pair<unsigned, unsigned>, unsigned> edges;
+  for (unsigned f = 0; f < tris.size(); f += 3)
+    for (unsigned i = 0; i < 3; ++i)
+      ++edges[std::make_pair(tris[f + i], tris[f + (i + 1) % 3])];
+  for (std::map<std::pair<unsigned, unsigned>, unsigned>::const_iterator e = edges.begin(); e != edges.end(); ++e)
+    if (e->second != 1 || edges.count(std::make_pair(e->first.second, e->first.first)) != 1)
+      return false;
+  const int F = int(tris.size() / 3), E = int(edges.size() / 2), V = int(verts.size());
+  if (V - E + F != 2)
+    return false;
+  // every point is inside every face, within rounding
+  for (unsigned f = 0; f < tris.size(); f += 3) {
+    vgl_point_3d<T> a = hull.point(tris[f]), b = hull.point(tris[f + 1]), c = hull.point(tris[f + 2]);
+    vgl_vector_3d<double> n = cross_product(vgl_vector_3d<double>(b.x() - a.x(), b.y() - a.y(), b.z() - a.z()),
+                                            vgl_vector_3d<double>(c.x() - a.x(), c.y() - a.y(), c.z() - a.z()));
+    n /= n.length();
+    for (unsigned i = 0; i < hull.num_points(); ++i) {
+      vgl_point_3d<T> p = hull.point(i);
+      if (n.x() * (p.x() - a.x()) + n.y() * (p.y() - a.y()) + n.z() * (p.z() - a.z()) > 1e-5)
+        return false;
+    }
+  }
+  return true;
+}
+
+static void test_random()
+{
+  vnl_random rng(1234);
+  std::vector<vgl_point_3d<double> > pts;
+  for (unsigned i = 0; i < 5000; ++i)
+    pts.push_back(vgl_point_3d<double>(rng.drand64(-1, 1), rng.drand64(-1, 1), rng.drand64(-1, 1)));
+  vgl_convex_hull_3d<double> hull(pts);
+  std::vector<unsigned> verts;
+  hull.vertices(verts);
+  std::cout << "hull of 5000 points in a cube: " << verts.size() << " vertices, " << hull.num_faces() << " faces\n";
+  TEST("cube: dimension", hull.dimension(), 3);
+  TEST("cube: closed convex surface", is_hull(hull), true);
+  TEST("cube: contains every point", hull.contains(pts[17]) && hull.contains(vgl_point_3d<double>(0, 0, 0)), true);
+  TEST("cube: not outside points", hull.contains(vgl_point_3d<double>(1.01, 0, 0)), false);
+  TEST("cube: volume a little below that of the cube", hull.volume() > 7.5 && hull.volume() < 8.0, true);
+
+  // the same points one at a time give the same vertices
+  vgl_convex_hull_3d<double> inc;
+  unsigned outside = 0;
+  for (unsigned i = 0; i < pts.size(); ++i)
+    if (inc.insert(pts[i])) ++outside;
+  std::vector<unsigned> inc_verts;
+  inc.vertices(inc_verts);
+  TEST("incremental: same vertices", inc_verts == verts, true);
+  TEST("incremental: closed convex surface", is_hull(inc), true);
+  TEST_NEAR("incremental: same volume", inc.volume(), hull.volume(), 1e-12);
+  TEST("incremental: points found outside", outside >= verts.size() && outside < pts.size(), true);
+
+  // a second batch, partly outside
+  std::vector<vgl_point_3d<double> > more;
+  for (unsigned i = 0; i < 2000; ++i)
+    more.push_back(vgl_point_3d<double>(rng.drand64(0, 2), rng.drand64(-1, 1), rng.drand64(-1, 1)));
+  hull.insert(more);
+  TEST("second batch: point count", hull.num_points(), 7000u);
+  TEST("second batch: closed convex surface", is_hull(hull), true);
+  TEST("second batch: volume a little below 12", hull.volume() > 11.5 && hull.volume() < 12.0, true);
+
+  // points on a sphere are all vertices
+  std::vector<float> x, y, z;
+  for (unsigned i = 0; i < 1000; ++i) {
+    double v[3] = { rng.normal64(), rng.normal64(), rng.normal64() };
+    const double l = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    x.push_back(float(v[0] / l)); y.push_back(float(v[1] / l)); z.push_back(float(v[2] / l));
+  }
+  vgl_convex_hull_3d<float> sphere(&x[0], &y[0], &z[0], 1000);
+  sphere.vertices(verts);
+  TEST("float sphere: every point is a vertex", verts.size(), 1000u);
+  TEST("float sphere: faces", sphere.num_faces(), 2 * 1000u - 4);
+  TEST("float sphere: closed convex surface", is_hull(sphere), true);
+  TEST("float sphere: volume a little below that of the sphere", sphere.volume() > 4.0 && sphere.volume() < 4.18879, true);
+}
+
+static void test_flat()
+{
+  vgl_convex_hull_3d<double> hull;
+  TEST("empty", hull.dimension(), -1);
+  hull.insert(vgl_point_3d<double>(1, 2, 3));
+  hull.insert(vgl_point_3d<double>(1, 2, 3));
+  std::vector<unsigned> verts;
+  hull.vertices(verts);
+  TEST("one point", hull.dimension() == 0 && verts.size() == 1 && verts[0] == 0, true);
+  hull.insert(vgl_point_3d<double>(3, 2, 3));
+  hull.insert(vgl_point_3d<double>(2, 2, 3));
+  hull.vertices(verts);
+  TEST("segment", hull.dimension() == 1 && verts.size() == 2 && verts[0] == 0 && verts[1] == 2, true);
+  // a square in the plane z = 3, with its centre
+  hull.insert(vgl_point_3d<double>(3, 4, 3));
+  hull.insert(vgl_point_3d<double>(1, 4, 3));
+  hull.insert(vgl_point_3d<double>(2, 3, 3));
+  hull.vertices(verts);
+  TEST("square: dimension", hull.dimension(), 2);
+  TEST("square: four corners", verts.size(), 4u);
+  TEST("square: no faces or volume", hull.num_faces() == 0 && hull.volume() == 0, true);
+  // off the plane: a pyramid
+  TEST("apex is outside", hull.insert(vgl_point_3d<double>(2, 3, 5)), true);
+  hull.vertices(verts);
+  TEST("pyramid: dimension", hull.dimension(), 3);
+  TEST("pyramid: five vertices", verts.size(), 5u);
+  TEST("pyramid: closed convex surface", is_hull(hull), true);
+  TEST_NEAR("pyramid: volume", hull.volume(), 4.0 * 2 / 3, 1e-12);
+  TEST("point inside is not outside", hull.insert(vgl_point_3d<double>(2, 3, 4)), false);
+
+  // a cube with points on its faces and edges: only the corners are vertices
+  std::vector<vgl_point_3d<double> > cube;
+  for (unsigned i = 0; i < 27; ++i)
+    cube.push_back(vgl_point_3d<double>(i % 3, (i / 3) % 3, i / 9));
+  vgl_convex_hull_3d<double> c(cube);
+  c.vertices(verts);
+  TEST("grid cube: eight corners", verts.size(), 8u);
+  TEST("grid cube: twelve triangles", c.num_faces(), 12u);
+  TEST("grid cube: closed convex surface", is_hull(c), true);
+  TEST_NEAR("grid cube: volume", c.volume(), 8.0, 1e-12);
+}
+
+static void test_convex_hull_3d()
+{
+  test_random();
+  test_flat();
+}
+
+TESTMAIN(test_convex_hull_3d);
@@ -0,0 +1,107 @@
+// This is core/vgl/algo/tests/test_convex_hull_indices_2d.cxx
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <vcl_compiler.h>
+#include <vgl/vgl_point_2d.h>
+#include <vgl/algo/vgl_convex_hull_indices_2d.h>
+#include <vnl/vnl_random.h>
+#include <testlib/testlib_test.h>
+
+//: Is hull a strictly convex counterclockwise polygon with all the points inside or on it?
+static bool is_hull(std::vector<double> const& x, std::vector<double> const& y, std::vector<unsigned> const& hull)
+{
+  const unsigned m = (unsigned)hull.size();
+  if (m < 3)
+    return false;
+  for (unsigned k = 0; k < m; ++k) {
+    const unsigned a = hull[k], b = hull[(k + 1) % m], c = hull[(k + 2) % m];
+    if ((x[b] - x[a]) * (y[c] - y[a]) - (y[b] - y[a]) * (x[c] - x[a]) <= 0)
+      return false;
+    for (unsigned i = 0; i < x.size(); ++i)
+      if ((x[b] - x[a]) * (y[i] - y[a]) - (y[b] - y[a]) * (x[i] - x[a]) < -1e-9)
+        return false;
+  }
+  return true;
+}
+
+static void test_random()
+{
+  vnl_random rng(1234);
+  std::vector<double> x, y;
+  for (unsigned i = 0; i < 3000; ++i) {
+    x.push_back(rng.normal64());
+    y.push_back(rng.normal64());
+  }
+  std::vector<unsigned> hull;
+  vgl_convex_hull_indices_2d(&x[0], &y[0], (unsigned)x.size(), hull);
+  std::cout << "hull of " << x.size() << " gaussian points: " << hull.size() << " vertices\n";
+  TEST("gaussian points: convex hull", is_hull(x, y, hull), true);
+  bool least_first = true;
+  for (unsigned k = 1; k < hull.size(); ++k)
+    if (x[hull[k]] < x[hull[0]]) least_first = false;
+  TEST("starts from the least x", least_first, true);
+
+  // many points, in several blocks, mostly discarded by the octagon
+  const unsigned n = 300000;
+  x.resize(n); y.resize(n);
+  for (unsigned i = 0; i < n; ++i) {
+    const double r = std::sqrt(rng.drand64()), a = rng.drand64(0, 6.283185307179586);
+    x[i] = 5 + r * std::cos(a);
+    y[i] = -3 + 2 * r * std::sin(a);
+  }
+  vgl_convex_hull_indices_2d(&x[0], &y[0], n, hull);
+  std::cout << "hull of " << n << " points in an ellipse: " << hull.size() << " vertices\n";
+  TEST("many points: convex hull", is_hull(x, y, hull), true);
+}
+
+static void test_special_cases()
+{
+  std::vector<vgl_point_2d<double> > pts;
+  std::vector<unsigned> hull;
+  vgl_convex_hull_indices_2d(pts, hull);
+  TEST("no points", hull.size(), 0u);
+
+  pts.push_back(vgl_point_2d<double>(1, 1));
+  pts.push_back(vgl_point_2d<double>(1, 1));
+  vgl_convex_hull_indices_2d(pts, hull);
+  TEST("coincident points: one", hull.size() == 1 && hull[0] == 0, true);
+
+  pts.clear();
+  for (unsigned i = 0; i < 10; ++i)
+    pts.push_back(vgl_point_2d<double>(9.0 - i, 2.0 * (9.0 - i)));
+  vgl_convex_hull_indices_2d(pts, hull);
+  TEST("collinear points: the end points", hull.size() == 2 && hull[0] == 9 && hull[1] == 0, true);
+
+  // a square with points on its edges, repeated corners and inside points
+  pts.clear();
+  pts.push_back(vgl_point_2d<double>(0.5, 0.5));
+  pts.push_back(vgl_point_2d<double>(1, 1));
+  pts.push_back(vgl_point_2d<double>(0, 0));
+  pts.push_back(vgl_point_2d<double>(1, 0));
+  pts.push_back(vgl_point_2d<double>(0, 1));
+  pts.push_back(vgl_point_2d<double>(0.5, 0));
+  pts.push_back(vgl_point_2d<double>(0, 0));
+  pts.push_back(vgl_point_2d<double>(1, 0.25));
+  pts.push_back(vgl_point_2d<double>(1, 1));
+  vgl_convex_hull_indices_2d(pts, hull);
+  TEST("square: four corners", hull.size(), 4u);
+  TEST("square: counterclockwise from the least, least indices",
+       hull.size() == 4 && hull[0] == 2 && hull[1] == 3 && hull[2] == 1 && hull[3] == 4, true);
+
+  // float, on a circle: every point is a vertex
+  std::vector<vgl_point_2d<float> > circle;
+  for (unsigned i = 0; i < 100; ++i)
+    circle.push_back(vgl_point_2d<float>(float(std::cos(0.0628318530718 * i)), float(std::sin(0.0628318530718 * i))));
+  vgl_convex_hull_indices_2d(circle, hull);
+  TEST("float circle: all points", hull.size(), 100u);
+  TEST("float circle: order", hull.size() == 100 && hull[0] == 50 && hull[1] == 51 && hull[99] == 49, true);
+}
+
+static void test_convex_hull_indices_2d()
+{
+  test_random();
+  test_special_cases();
+}
+
+TESTMAIN(test_convex_hull_indices_2d);
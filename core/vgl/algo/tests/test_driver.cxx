@@ -1,9 +1,12 @@
 #include <testlib/testlib_register.h>
 
+DECLARE( test_bvh_3d );
 DECLARE( test_compute_similarity_3d );
 DECLARE( test_compute_rigid_3d );
 DECLARE( test_conic );
 DECLARE( test_convex_hull_2d );
+DECLARE( test_convex_hull_3d );
+DECLARE( test_convex_hull_indices_2d );
 DECLARE( test_ellipsoid );
 DECLARE( test_fit_conics_2d );
 DECLARE( test_fit_lines_2d );
@@ -16,16 +19,22 @@ DECLARE( test_homg );
 DECLARE( test_intersection );
 DECLARE( test_orient_box_3d );
 DECLARE( test_p_matrix );
+DECLARE( test_packed_rtree );
+DECLARE( test_point_cloud_3d );
+DECLARE( test_polygon_boolean );
 DECLARE( test_rotation_3d );
 DECLARE( test_rtree );
 
 void
 register_tests()
 {
+  REGISTER( test_bvh_3d );
   REGISTER( test_compute_similarity_3d );
   REGISTER( test_compute_rigid_3d );
   REGISTER( test_conic );
   REGISTER( test_convex_hull_2d );
+  REGISTER( test_convex_hull_3d );
+  REGISTER( test_convex_hull_indices_2d );
   REGISTER( test_ellipsoid );
   REGISTER( test_fit_conics_2d );
   REGISTER( test_fit_lines_2d );
@@ -38,6 +47,9 @@ register_tests()
   REGISTER( test_intersection );
   REGISTER( test_orient_box_3d );
   REGISTER( test_p_matrix );
+  REGISTER( test_packed_rtree );
+  REGISTER( test_point_cloud_3d );
+  REGISTER( test_polygon_boolean );
   REGISTER( test_rotation_3d );
   REGISTER( test_rtree );
 }
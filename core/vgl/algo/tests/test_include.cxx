@@ -1,8 +1,11 @@
 #include <vgl/algo/vgl_algo_fwd.h>
 
+#include <vgl/algo/vgl_bvh_3d.h>
 #include <vgl/algo/vgl_compute_similarity_3d.h>
 #include <vgl/algo/vgl_conic_2d_regression.h>
 #include <vgl/algo/vgl_convex_hull_2d.h>
+#include <vgl/algo/vgl_convex_hull_3d.h>
+#include <vgl/algo/vgl_convex_hull_indices_2d.h>
 #include <vgl/algo/vgl_ellipsoid_3d.h>
 #include <vgl/algo/vgl_fit_conics_2d.h>
 #include <vgl/algo/vgl_fit_lines_2d.h>
@@ -33,6 +36,9 @@
 #include <vgl/algo/vgl_orient_box_3d.h>
 #include <vgl/algo/vgl_orient_box_3d_operators.h>
 #include <vgl/algo/vgl_p_matrix.h>
+#include <vgl/algo/vgl_packed_rtree.h>
+#include <vgl/algo/vgl_point_cloud_3d.h>
+#include <vgl/algo/vgl_polygon_boolean.h>
 #include <vgl/algo/vgl_rotation_3d.h>
 #include <vgl/algo/vgl_rtree.h>
 #include <vgl/algo/vgl_rtree_c.h>
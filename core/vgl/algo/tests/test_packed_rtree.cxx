@@ -0,0 +1,154 @@
+// This is core/vgl/algo/tests/test_packed_rtree.cxx
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <vcl_compiler.h>
+#include <vgl/vgl_point_2d.h>
+#include <vgl/vgl_box_2d.h>
+#include <vgl/vgl_polygon.h>
+#include <vgl/algo/vgl_rtree.h>
+#include <vgl/algo/vgl_rtree_c.h>
+#include <vgl/algo/vgl_packed_rtree.h>
+#include <vnl/vnl_random.h>
+#include <testlib/testlib_test.h>
+
+typedef vgl_rtree_point_box_2d<double> point_c;
+typedef vgl_packed_rtree<point_c::v_type, point_c::b_type, point_c> point_tree;
+typedef vgl_rtree_box_box_2d<double> box_c;
+typedef vgl_packed_rtree<box_c::v_type, box_c::b_type, box_c> box_tree;
+
+// indices of the elements meeting a region, found by checking them all
+template <class C, class B>
+static std::vector<unsigned> brute_force(std::vector<typename C::v_type> const& vs, B const& region)
+{
+  std::vector<unsigned> r;
+  for (unsigned i = 0; i < vs.size(); ++i)
+    if (C::meet(region, vs[i]))
+      r.push_back(i);
+  return r;
+}
+
+static void test_points(point_tree::build_method method, char const* name)
+{
+  std::cout << "\n--- point tree, " << name << " ---\n";
+  vnl_random rng(1234);
+  std::vector<vgl_point_2d<double> > pts(10000);
+  for (unsigned i = 0; i < pts.size(); ++i)
+    pts[i].set(rng.drand64(0.0, 100.0), rng.drand64(0.0, 50.0));
+
+  point_tree tree(pts, method, 8);
+  TEST("size", tree.size(), pts.size());
+  TEST("bounds", tree.bounds().min_x() >= 0.0 && tree.bounds().max_x() <= 100.0 && tree.bounds().max_y() <= 50.0, true);
+  std::cout << "nodes: " << tree.nodes() << '\n';
+  TEST("nodes are full", tree.nodes() <= 1 + 10000/8 + 10000/64 + 10000/512 + 10000/4096 + 4, true);
+
+  std::vector<vgl_box_2d<double> > regions;
+  for (unsigned q = 0; q < 200; ++q) {
+    vgl_point_2d<double> c(rng.drand64(-5.0, 105.0), rng.drand64(-5.0, 55.0));
+    regions.push_back(vgl_box_2d<double>(c, rng.drand64(0.0, 20.0), rng.drand64(0.0, 20.0), vgl_box_2d<double>::centre));
+  }
+  bool all_match = true;
+  for (unsigned q = 0; q < regions.size(); ++q) {
+    std::vector<unsigned> found;
+    tree.get_indices(regions[q], found);
+    std::sort(found.begin(), found.end());
+    all_match = all_match && found == brute_force<point_c>(pts, regions[q]);
+  }
+  TEST("region queries match brute force", all_match, true);
+
+  std::vector<std::vector<unsigned> > batch;
+  tree.get_indices(regions, batch);
+  bool batch_match = batch.size() == regions.size();
+  for (unsigned q = 0; batch_match && q < regions.size(); ++q) {
+    std::vector<unsigned> one;
+    tree.get_indices(regions[q], one);
+    batch_match = batch[q] == one;
+  }
+  TEST("batched queries match single queries", batch_match, true);
+
+  std::vector<std::vector<vgl_point_2d<double> > > batch_pts;
+  tree.get(regions, batch_pts);
+  bool same_points = batch_pts.size() == regions.size();
+  for (unsigned q = 0; same_points && q < regions.size(); ++q) {
+    same_points = batch_pts[q].size() == batch[q].size();
+    for (unsigned k = 0; same_points && k < batch[q].size(); ++k)
+      same_points = batch_pts[q][k] == pts[batch[q][k]];
+  }
+  TEST("get returns the elements of get_indices", same_points, true);
+
+  // a point query is a query by a one-point box
+  std::vector<unsigned> at;
+  tree.get_indices(vgl_box_2d<double>(pts[77], pts[77]), at);
+  TEST("point query", std::find(at.begin(), at.end(), 77u) != at.end(), true);
+
+  // polygon probe, against vgl_rtree
+  vgl_polygon<double> poly(1);
+  poly.push_back(30.0, 10.0); poly.push_back(60.0, 5.0);
+  poly.push_back(70.0, 40.0); poly.push_back(35.0, 30.0);
+  vgl_rtree_polygon_probe<point_c::v_type, point_c::b_type, point_c> probe(poly);
+  std::vector<unsigned> in_poly;
+  tree.get_indices(probe, in_poly);
+  unsigned expected = 0;
+  for (unsigned i = 0; i < pts.size(); ++i)
+    if (poly.contains(pts[i])) ++expected;
+  TEST("polygon probe", in_poly.size(), expected);
+  std::vector<vgl_point_2d<double> > probe_pts;
+  tree.get(probe, probe_pts);
+  TEST("polygon probe elements", probe_pts.size(), expected);
+
+  std::vector<vgl_point_2d<double> > all;
+  tree.get_all(all);
+  TEST("get_all", all.size(), pts.size());
+}
+
+static void test_boxes()
+{
+  std::cout << "\n--- box tree ---\n";
+  vnl_random rng(99);
+  std::vector<vgl_box_2d<double> > boxes(3000);
+  for (unsigned i = 0; i < boxes.size(); ++i) {
+    vgl_point_2d<double> c(rng.drand64(0.0, 1000.0), rng.drand64(0.0, 1000.0));
+    boxes[i] = vgl_box_2d<double>(c, rng.drand64(1.0, 10.0), rng.drand64(1.0, 10.0), vgl_box_2d<double>::centre);
+  }
+  box_tree str_tree(boxes), hilbert_tree(boxes, box_tree::hilbert);
+  bool match = true;
+  for (unsigned q = 0; q < 100; ++q) {
+    vgl_point_2d<double> c(rng.drand64(0.0, 1000.0), rng.drand64(0.0, 1000.0));
+    vgl_bbox_2d<double> region(c.x() - 30, c.x() + 30, c.y() - 2, c.y() + 2);
+    std::vector<unsigned> expected = brute_force<box_c>(boxes, region), a, b;
+    str_tree.get_indices(region, a);
+    hilbert_tree.get_indices(region, b);
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    match = match && a == expected && b == expected;
+  }
+  TEST("box queries match brute force", match, true);
+
+  // a region crossing a node's bounds without containing one of its corners
+  vgl_bbox_2d<double> b0(0, 10, 4, 6), b1(4, 6, 0, 10);
+  TEST("crossing bounds meet", box_c::meet(b0, b1), true);
+}
+
+static void test_empty()
+{
+  point_tree tree;
+  TEST("empty", tree.empty() && tree.size() == 0 && tree.nodes() == 0, true);
+  std::vector<vgl_point_2d<double> > found;
+  tree.get(vgl_box_2d<double>(0, 1, 0, 1), found);
+  TEST("query of empty tree", found.size(), 0u);
+
+  std::vector<vgl_point_2d<double> > one(1, vgl_point_2d<double>(0.5, 0.5));
+  tree.build(one);
+  tree.get(vgl_box_2d<double>(0, 1, 0, 1), found);
+  TEST("tree of one element", tree.nodes() == 1 && found.size() == 1, true);
+}
+
+static void test_packed_rtree()
+{
+  test_points(point_tree::sort_tile_recursive, "STR");
+  test_points(point_tree::hilbert, "Hilbert");
+  test_boxes();
+  test_empty();
+}
+
+TESTMAIN(test_packed_rtree);
@@ -0,0 +1,138 @@
+// This is core/vgl/algo/tests/test_point_cloud_3d.cxx
+#include <iostream>
+#include <cstddef>
+#include <vcl_compiler.h>
+#include <vgl/vgl_point_3d.h>
+#include <vgl/vgl_vector_3d.h>
+#include <vgl/vgl_pointset_3d.h>
+#include <vgl/vgl_distance.h>
+#include <vgl/algo/vgl_rotation_3d.h>
+#include <vgl/algo/vgl_point_cloud_3d.h>
+#include <vgl/algo/vgl_compute_similarity_3d.h>
+#include <vnl/vnl_random.h>
+#include <testlib/testlib_test.h>
+
+static bool aligned(void const* p)
+{
+  return reinterpret_cast<std::size_t>(p) % 32 == 0;
+}
+
+static void test_storage()
+{
+  vgl_point_cloud_3d<float> cloud;
+  TEST("empty", cloud.empty() && !cloud.has_normals(), true);
+  for (unsigned i = 0; i < 100; ++i)
+    cloud.push_back(vgl_point_3d<float>(float(i), 2.0f * i, -1.0f));
+  TEST("push_back", cloud.size() == 100 && cloud.point(42) == vgl_point_3d<float>(42.0f, 84.0f, -1.0f), true);
+  TEST("channels aligned", aligned(cloud.x()) && aligned(cloud.y()) && aligned(cloud.z()), true);
+  TEST("no normal channels", cloud.nx() == VXL_NULLPTR, true);
+
+  unsigned c = cloud.add_scalar("intensity", 0.5f);
+  cloud.scalar(c)[3] = 7.0f;
+  TEST("scalar channel", cloud.num_scalars() == 1 && cloud.scalar_index("intensity") == 0 && cloud.scalar_index("range") == -1, true);
+  TEST("scalar values", cloud.scalar(0)[0] == 0.5f && cloud.scalar(0)[3] == 7.0f && aligned(cloud.scalar(0)), true);
+
+  cloud.push_back(vgl_point_3d<float>(1, 2, 3), vgl_vector_3d<float>(0, 0, 1));
+  TEST("normals added", cloud.has_normals() && aligned(cloud.nx()), true);
+  TEST("earlier normals zero", cloud.normal(5) == vgl_vector_3d<float>(0, 0, 0), true);
+  TEST("new normal", cloud.normal(100) == vgl_vector_3d<float>(0, 0, 1), true);
+  TEST("scalar of new point", cloud.scalar(0)[100], 0.0f);
+
+  // writes through the channels are seen by the accessors
+  float* xs = cloud.x();
+  xs[7] = -3.0f;
+  TEST("zero-copy channel", cloud.point(7).x(), -3.0f);
+
+  vgl_point_cloud_3d<float> copy(cloud);
+  TEST("copy", copy.size() == 101 && copy.point(7) == cloud.point(7) && copy.scalar(0)[3] == 7.0f && copy.x() != cloud.x(), true);
+  vgl_point_cloud_3d<float> assigned(3);
+  assigned = cloud;
+  TEST("assignment", assigned.size() == 101 && assigned.normal(100) == cloud.normal(100) && assigned.num_scalars() == 1, true);
+
+  cloud.resize(10);
+  cloud.resize(20);
+  TEST("resize clears new points", cloud.point(15) == vgl_point_3d<float>(0, 0, 0) && cloud.scalar(0)[15] == 0.0f, true);
+}
+
+static void test_pointset_conversion()
+{
+  vgl_pointset_3d<double> ps;
+  ps.add_point_with_normal(vgl_point_3d<double>(1, 2, 3), vgl_vector_3d<double>(1, 0, 0));
+  ps.add_point_with_normal(vgl_point_3d<double>(4, 5, 6), vgl_vector_3d<double>(0, 1, 0));
+  vgl_point_cloud_3d<double> cloud(ps);
+  TEST("from pointset", cloud.size() == 2 && cloud.has_normals() && cloud.point(1) == ps.p(1) && cloud.normal(0) == ps.n(0), true);
+  TEST("to pointset", cloud.as_pointset() == ps, true);
+
+  vgl_pointset_3d<double> bare;
+  bare.add_point(vgl_point_3d<double>(0, 1, 0));
+  vgl_point_cloud_3d<double> bare_cloud(bare);
+  TEST("pointset without normals", !bare_cloud.has_normals() && bare_cloud.as_pointset() == bare, true);
+}
+
+static void test_operations()
+{
+  vnl_random rng(5);
+  const unsigned n = 1003;
+  vgl_point_cloud_3d<double> cloud(n, true);
+  for (unsigned i = 0; i < n; ++i) {
+    cloud.set_point(i, vgl_point_3d<double>(rng.drand64(-10, 10), rng.drand64(0, 5), rng.drand64(-1, 1)));
+    cloud.set_normal(i, normalized(vgl_vector_3d<double>(rng.normal(), rng.normal(), rng.normal())));
+  }
+  vgl_point_cloud_3d<double> original(cloud);
+
+  vgl_box_3d<double> box = cloud.bounding_box();
+  bool inside = true;
+  for (unsigned i = 0; i < n; ++i)
+    inside = inside && box.contains(cloud.point(i));
+  TEST("bounding box contains all points", inside, true);
+  TEST("bounding box is tight", box.min_x() > -10 && box.min_x() < -9.9 && box.max_y() > 4.9, true);
+
+  double sx = 0, sy = 0, sz = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    sx += cloud.point(i).x(); sy += cloud.point(i).y(); sz += cloud.point(i).z();
+  }
+  TEST_NEAR("centroid", vgl_distance(cloud.centroid(), vgl_point_3d<double>(sx/n, sy/n, sz/n)), 0.0, 1e-12);
+
+  vgl_rotation_3d<double> R(0.3, -0.2, 1.1);
+  vgl_vector_3d<double> t(5, -2, 0.5);
+  const double s = 1.7;
+  cloud.transform(R, t, s);
+  double err = 0, nerr = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    vgl_point_3d<double> p = original.point(i);
+    vgl_point_3d<double> q = R * vgl_point_3d<double>(s * p.x(), s * p.y(), s * p.z()) + t;
+    err = std::max(err, vgl_distance(q, cloud.point(i)));
+    nerr = std::max(nerr, length(R * original.normal(i) - cloud.normal(i)));
+  }
+  TEST_NEAR("similarity transform of points", err, 0.0, 1e-12);
+  TEST_NEAR("rotation of normals", nerr, 0.0, 1e-12);
+
+  // the similarity estimated between the clouds maps one onto the other
+  std::vector<vgl_point_3d<double> > from(original.as_pointset().points()), to(cloud.as_pointset().points());
+  vgl_compute_similarity_3d<double> cs(from, to);
+  cs.estimate();
+  original.transform(cs.rotation(), cs.translation(), cs.scale());
+  err = 0;
+  for (unsigned i = 0; i < n; ++i)
+    err = std::max(err, vgl_distance(original.point(i), cloud.point(i)));
+  TEST_NEAR("transform by vgl_compute_similarity_3d", err, 0.0, 1e-8);
+
+  vgl_point_3d<double> before = cloud.point(3);
+  cloud.translate(-t);
+  TEST_NEAR("translate", vgl_distance(cloud.point(3), before - t), 0.0, 1e-12);
+
+  vgl_point_cloud_3d<float> f(4);
+  f.set_point(3, vgl_point_3d<float>(1, 1, 1));
+  f.transform(vgl_rotation_3d<float>(), vgl_vector_3d<float>(1, 0, 0));
+  TEST("float cloud", f.point(3) == vgl_point_3d<float>(2, 1, 1) && f.point(0) == vgl_point_3d<float>(1, 0, 0), true);
+  TEST("empty cloud reductions", vgl_point_cloud_3d<float>().bounding_box().is_empty(), true);
+}
+
+static void test_point_cloud_3d()
+{
+  test_storage();
+  test_pointset_conversion();
+  test_operations();
+}
+
+TESTMAIN(test_point_cloud_3d);
@@ -0,0 +1,178 @@
+// This is core/vgl/algo/tests/test_polygon_boolean.cxx
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <vcl_compiler.h>
+#include <vgl/vgl_polygon.h>
+#include <vgl/vgl_area.h>
+#include <vgl/algo/vgl_polygon_boolean.h>
+#include <vnl/vnl_random.h>
+#include <testlib/testlib_test.h>
+
+static vgl_polygon<double> box(double x0, double y0, double x1, double y1)
+{
+  vgl_polygon<double> p(1);
+  p.push_back(x0, y0); p.push_back(x1, y0); p.push_back(x1, y1); p.push_back(x0, y1);
+  return p;
+}
+
+//: A star shaped polygon about (cx,cy), with a square hole if hole>0
+static vgl_polygon<double> star(double cx, double cy, double r, unsigned n, double hole)
+{
+  vgl_polygon<double> p(1);
+  for (unsigned k = 0; k < 2*n; ++k) {
+    double a = 3.14159265358979 * k / n, rk = (k % 2) ? 0.45 * r : r;
+    p.push_back(cx + rk * std::cos(a), cy + rk * std::sin(a));
+  }
+  if (hole > 0) {
+    p.new_sheet();
+    p.push_back(cx - hole, cy - hole); p.push_back(cx + hole, cy - hole);
+    p.push_back(cx + hole, cy + hole); p.push_back(cx - hole, cy + hole);
+  }
+  return p;
+}
+
+static bool expected(vgl_clip_type op, bool a, bool b)
+{
+  switch (op)
+  {
+    case vgl_clip_type_union:      return a || b;
+    case vgl_clip_type_difference: return a && !b;
+    case vgl_clip_type_xor:        return a != b;
+    default:                       return a && b;
+  }
+}
+
+//: Number of random points in [0,w]x[0,h] where r does not hold op(a, b)
+static unsigned disagreements(vgl_polygon<double> const& a, vgl_polygon<double> const& b,
+                              vgl_clip_type op, vgl_polygon<double> const& r, vnl_random& rng,
+                              double w, double h)
+{
+  unsigned n = 0;
+  for (unsigned k = 0; k < 4000; ++k) {
+    const double x = rng.drand64(0, w), y = rng.drand64(0, h);
+    if (r.contains(x, y) != expected(op, a.contains(x, y), b.contains(x, y)))
+      ++n;
+  }
+  return n;
+}
+
+static void test_two_squares()
+{
+  vgl_polygon<double> a = box(0, 0, 2, 2), b = box(1, 1, 3, 3);
+  vgl_polygon<double> i = vgl_polygon_boolean(a, b, vgl_clip_type_intersect);
+  vgl_polygon<double> u = vgl_polygon_boolean(a, b, vgl_clip_type_union);
+  vgl_polygon<double> d = vgl_polygon_boolean(a, b, vgl_clip_type_difference);
+  vgl_polygon<double> x = vgl_polygon_boolean(a, b, vgl_clip_type_xor);
+  TEST("intersection: one square", i.num_sheets() == 1 && i[0].size() == 4, true);
+  TEST_NEAR("intersection area", vgl_area_signed(i), 1.0, 1e-12);
+  TEST("union: one sheet of 8 vertices", u.num_sheets() == 1 && u[0].size() == 8, true);
+  TEST_NEAR("union area", vgl_area_signed(u), 7.0, 1e-12);
+  TEST_NEAR("difference area", vgl_area_signed(d), 3.0, 1e-12);
+  TEST_NEAR("xor area", vgl_area_signed(x), 6.0, 1e-12);
+
+  // a hole
+  vgl_polygon<double> h = vgl_polygon_boolean(box(0, 0, 4, 4), box(1, 1, 3, 3), vgl_clip_type_difference);
+  TEST("difference with a hole: two sheets", h.num_sheets(), 2u);
+  TEST_NEAR("difference with a hole: area", vgl_area_signed(h), 12.0, 1e-12);
+  TEST("difference with a hole: contains", h.contains(0.5, 0.5) && !h.contains(2, 2), true);
+
+  // disjoint and touching operands
+  vgl_polygon<double> far = box(10, 10, 11, 11);
+  TEST("disjoint intersection empty", vgl_polygon_boolean(a, far, vgl_clip_type_intersect).num_sheets(), 0u);
+  TEST("disjoint union", vgl_polygon_boolean(a, far, vgl_clip_type_union).num_sheets(), 2u);
+  vgl_polygon<double> t = vgl_polygon_boolean(a, box(2, 0, 4, 2), vgl_clip_type_union);
+  TEST("union across a shared edge is one rectangle", t.num_sheets() == 1 && t[0].size() == 4, true);
+  TEST_NEAR("shared edge: area", vgl_area_signed(t), 8.0, 1e-12);
+  TEST("intersection across a shared edge is empty",
+       vgl_polygon_boolean(a, box(2, 0, 4, 2), vgl_clip_type_intersect).num_sheets(), 0u);
+  vgl_polygon<double> self = vgl_polygon_boolean(a, a, vgl_clip_type_intersect);
+  TEST("intersection with itself", self.num_sheets() == 1 && std::fabs(vgl_area_signed(self) - 4.0) < 1e-12, true);
+  TEST("xor with itself is empty", vgl_polygon_boolean(a, a, vgl_clip_type_xor).num_sheets(), 0u);
+}
+
+static void test_random_polygons()
+{
+  vnl_random rng(9667566);
+  const vgl_clip_type ops[4] = { vgl_clip_type_intersect, vgl_clip_type_union,
+                                 vgl_clip_type_difference, vgl_clip_type_xor };
+  const char* names[4] = { "intersect", "union", "difference", "xor" };
+  for (unsigned trial = 0; trial < 5; ++trial) {
+    vgl_polygon<double> a = star(rng.drand64(35, 65), rng.drand64(35, 65), rng.drand64(20, 35), 5 + trial, rng.drand64(0, 6));
+    vgl_polygon<double> b = star(rng.drand64(35, 65), rng.drand64(35, 65), rng.drand64(20, 35), 7, rng.drand64(0, 6));
+    for (unsigned o = 0; o < 4; ++o) {
+      vgl_polygon<double> r = vgl_polygon_boolean(a, b, ops[o]);
+      unsigned n = disagreements(a, b, ops[o], r, rng, 100, 100);
+      std::cout << "trial " << trial << ' ' << names[o] << ": " << r.num_sheets() << " sheets, "
+                << n << " disagreements\n";
+      TEST("random stars: result contains the right points", n, 0u);
+    }
+  }
+
+  // float
+  vgl_polygon<float> af(1), bf(1);
+  af.push_back(0.f, 0.f); af.push_back(2.f, 0.f); af.push_back(1.f, 2.f);
+  bf.push_back(0.f, 1.f); bf.push_back(2.f, 1.f); bf.push_back(1.f, -1.f);
+  vgl_polygon<float> sf = vgl_polygon_boolean(af, bf, vgl_clip_type_intersect);
+  TEST("float: star of David core is a hexagon", sf.num_sheets() == 1 && sf[0].size() == 6, true);
+}
+
+static void test_union()
+{
+  // a 10x10 grid of unit squares sharing edges merges to one square
+  std::vector<vgl_polygon<double> > tiles;
+  for (unsigned i = 0; i < 10; ++i)
+    for (unsigned j = 0; j < 10; ++j)
+      tiles.push_back(box(i, j, i + 1, j + 1));
+  vgl_polygon<double> u = vgl_polygon_union(tiles);
+  TEST("tiles: one sheet of 4 vertices", u.num_sheets() == 1 && u[0].size() == 4, true);
+  TEST_NEAR("tiles: area", vgl_area_signed(u), 100.0, 1e-9);
+
+  // random overlapping footprints, and some far from the others
+  vnl_random rng(1234);
+  std::vector<vgl_polygon<double> > polys;
+  for (unsigned k = 0; k < 300; ++k) {
+    const double x = rng.drand64(0, 100), y = rng.drand64(0, 100);
+    polys.push_back(box(x, y, x + rng.drand64(1, 6), y + rng.drand64(1, 6)));
+  }
+  polys.push_back(star(150, 50, 10, 6, 2));
+  polys.push_back(box(200, 200, 201, 201));
+  polys.push_back(vgl_polygon<double>());
+  u = vgl_polygon_union(polys);
+  unsigned wrong = 0;
+  for (unsigned k = 0; k < 20000; ++k) {
+    const double x = rng.drand64(-5, 210), y = rng.drand64(-5, 210);
+    bool in = false;
+    for (unsigned p = 0; p < polys.size() && !in; ++p)
+      in = polys[p].contains(x, y);
+    if (u.contains(x, y) != in)
+      ++wrong;
+  }
+  std::cout << "union of " << polys.size() << " polygons: " << u.num_sheets() << " sheets, "
+            << wrong << " disagreements\n";
+  TEST("union of many polygons", wrong, 0u);
+  TEST("isolated polygons are copied", u.contains(200.5, 200.5) && u.contains(157, 50) && !u.contains(150, 50), true);
+
+  // the same through the engine directly
+  vgl_polygon_boolean_engine engine;
+  engine.add_polygon(box(0, 0, 2, 2));
+  engine.add_polygon(box(1, 0, 3, 2));
+  engine.add_polygon(box(2, 0, 4, 2));
+  TEST("engine: operands", engine.num_operands(), 3u);
+  std::vector<std::vector<vgl_point_2d<double> > > sheets;
+  engine.compute(vgl_clip_type_intersect, sheets);
+  TEST("engine: three operands have no common point", sheets.size(), 0u);
+  engine.compute(vgl_clip_type_xor, sheets);
+  vgl_polygon<double> x(sheets);
+  TEST_NEAR("engine: xor of three", vgl_area_signed(x), 4.0, 1e-12);
+  TEST("engine: xor of three", x.contains(0.5, 1) && !x.contains(1.5, 1) && x.contains(3.5, 1), true);
+}
+
+static void test_polygon_boolean()
+{
+  test_two_squares();
+  test_random_polygons();
+  test_union();
+}
+
+TESTMAIN(test_polygon_boolean);
@@ -1,6 +1,9 @@
+#include <vgl/algo/vgl_bvh_3d.hxx>
 #include <vgl/algo/vgl_compute_similarity_3d.hxx>
 #include <vgl/algo/vgl_conic_2d_regression.hxx>
 #include <vgl/algo/vgl_convex_hull_2d.hxx>
+#include <vgl/algo/vgl_convex_hull_3d.hxx>
+#include <vgl/algo/vgl_convex_hull_indices_2d.hxx>
 #include <vgl/algo/vgl_ellipsoid_3d.hxx>
 #include <vgl/algo/vgl_fit_conics_2d.hxx>
 #include <vgl/algo/vgl_fit_lines_2d.hxx>
@@ -18,6 +21,9 @@
 #include <vgl/algo/vgl_orient_box_3d.hxx>
 #include <vgl/algo/vgl_orient_box_3d_operators.hxx>
 #include <vgl/algo/vgl_p_matrix.hxx>
+#include <vgl/algo/vgl_packed_rtree.hxx>
+#include <vgl/algo/vgl_point_cloud_3d.hxx>
+#include <vgl/algo/vgl_polygon_boolean.hxx>
 #include <vgl/algo/vgl_rtree.hxx>
 
 int main() { return 0; }
@@ -0,0 +1,139 @@
+// This is core/vgl/algo/vgl_bvh_3d.h
+#ifndef vgl_bvh_3d_h_
+#define vgl_bvh_3d_h_
+//:
+// \file
+// \brief Bounding volume hierarchy over triangles, for ray and nearest point queries
+//
+//    Finding where a ray first meets a triangle mesh, or the point of the
+//    mesh closest to a given point, by testing every triangle (as
+//    imesh_intersect_min_dist and imesh_closest_point do) takes time
+//    proportional to the number of triangles.  vgl_bvh_3d groups the
+//    triangles into a tree of nested bounding boxes, so that a query only
+//    visits the few boxes near the ray or the point.
+//
+//    The tree is built top down, splitting each box where the surface
+//    area heuristic (SAH) estimates the cheapest ray queries, with the
+//    triangle centroids binned along each axis.  Its nodes are stored in
+//    one array, in depth first order, so a node's first child follows it;
+//    the triangles are copied into another array in the order the leaves
+//    reference them.  When compiled with OpenMP, large subtrees are built
+//    in parallel, and the batched queries run on several threads.
+//
+//    The tree cannot be modified after it is built; build a new one when
+//    the mesh changes.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vector>
+#include <limits>
+#include <vcl_compiler.h>
+#include <vgl/vgl_point_3d.h>
+#include <vgl/vgl_vector_3d.h>
+#include <vgl/vgl_box_3d.h>
+#include <vgl/vgl_ray_3d.h>
+
+//: Bounding volume hierarchy over a set of triangles.
+//  Triangles are numbered as in the input; queries return these numbers,
+//  or -1 if nothing is found.
+template <class T>
+class vgl_bvh_3d
+{
+ public:
+  //: Empty hierarchy
+  vgl_bvh_3d() : depth_(0) {}
+
+  //: Hierarchy over an indexed mesh.
+  //  Triangle k has corners verts[tris[3k]], verts[tris[3k+1]], verts[tris[3k+2]].
+  //  Leaves hold at most max_leaf_size triangles, unless their centroids coincide.
+  vgl_bvh_3d(std::vector<vgl_point_3d<T> > const& verts, std::vector<unsigned> const& tris,
+             unsigned max_leaf_size = 4);
+
+  //: Hierarchy over a triangle soup: triangle k has corners corners[3k], corners[3k+1], corners[3k+2].
+  explicit vgl_bvh_3d(std::vector<vgl_point_3d<T> > const& corners, unsigned max_leaf_size = 4);
+
+  //: Rebuild over an indexed mesh.
+  void build(std::vector<vgl_point_3d<T> > const& verts, std::vector<unsigned> const& tris,
+             unsigned max_leaf_size = 4);
+
+  //: Number of triangles
+  unsigned size() const { return (unsigned)face_.size(); }
+
+  //: Number of nodes
+  unsigned nodes() const { return (unsigned)nodes_.size(); }
+
+  //: Depth of the tree; 1 for a single leaf, 0 when empty
+  unsigned depth() const { return depth_; }
+
+  //: Bounding box of all triangles
+  vgl_box_3d<T> bounding_box() const;
+
+  //: The corners of triangle k.
+  //  The triangles are stored in leaf order, so this searches for k.
+  void triangle(unsigned k, vgl_point_3d<T>& p0, vgl_point_3d<T>& p1, vgl_point_3d<T>& p2) const;
+
+  //: First triangle met by the ray origin + t * direction, for 0 <= t <= t_max.
+  //  On a hit t is set to the ray parameter, and u and v to barycentric
+  //  coordinates of the hit, which is (1-u-v) p0 + u p1 + v p2 for the
+  //  corners of the triangle.
+  int intersect(vgl_point_3d<T> const& origin, vgl_vector_3d<T> const& direction,
+                T& t, T& u, T& v, T t_max = std::numeric_limits<T>::infinity()) const;
+
+  //: First triangle met by ray; t is then the distance along it.
+  int intersect(vgl_ray_3d<T> const& ray, T& t) const
+  { T u, v; return intersect(ray.origin(), ray.direction(), t, u, v); }
+
+  //: Does the ray origin + t * direction meet any triangle for 0 <= t <= t_max?
+  //  Stops at the first triangle found, so is quicker than intersect for
+  //  visibility tests.
+  bool occluded(vgl_point_3d<T> const& origin, vgl_vector_3d<T> const& direction, T t_max) const;
+
+  //: First triangle met by each ray, and its distance along the ray.
+  void intersect(std::vector<vgl_ray_3d<T> > const& rays, std::vector<int>& faces, std::vector<T>& ts) const;
+
+  //: Point of the triangles closest to p, and the triangle it lies on.
+  int closest_point(vgl_point_3d<T> const& p, vgl_point_3d<T>& cp) const;
+
+  //: Closest point to each of ps, and the triangles they lie on.
+  void closest_points(std::vector<vgl_point_3d<T> > const& ps,
+                      std::vector<vgl_point_3d<T> >& cps, std::vector<int>& faces) const;
+
+  //: Triangles meeting box, in no particular order.
+  //  A triangle is reported if it has a point inside or on the box, not
+  //  merely if its bounding box meets it.
+  void overlapping(vgl_box_3d<T> const& box, std::vector<unsigned>& faces) const;
+
+ private:
+  struct node_type
+  {
+    T lo[3], hi[3];
+    //: Second child of an interior node, or first triangle of a leaf
+    unsigned index;
+    //: Number of triangles of a leaf; 0 for an interior node
+    unsigned count;
+  };
+
+  //: Build the subtree over perm[b,e) into tmp[k], tmp[k+1], ...
+  //  It needs at most 2(e-b)-1 nodes; the second child of tmp[k] starts
+  //  after the nodes reserved for the first.
+  void build_node(std::vector<node_type>& tmp, unsigned k, std::vector<unsigned>& perm,
+                  unsigned b, unsigned e, std::vector<T> const& bounds,
+                  std::vector<T> const& centres, unsigned max_leaf_size);
+
+  //: Copy the tree in tmp into nodes_ in depth first order, leaving out unused nodes.
+  void flatten(std::vector<node_type> const& tmp);
+
+  //: Corners of the triangles in leaf order, 9 coordinates each
+  std::vector<T> tri_;
+  //: Input number of each triangle of tri_
+  std::vector<unsigned> face_;
+  //: Nodes, root first
+  std::vector<node_type> nodes_;
+  unsigned depth_;
+};
+
+#define VGL_BVH_3D_INSTANTIATE(T) extern "please include vgl/algo/vgl_bvh_3d.hxx first"
+
+#endif // vgl_bvh_3d_h_
@@ -0,0 +1,623 @@
+// This is core/vgl/algo/vgl_bvh_3d.hxx
+#ifndef vgl_bvh_3d_hxx_
+#define vgl_bvh_3d_hxx_
+//:
+// \file
+
+#include <algorithm>
+#include <cmath>
+#include "vgl_bvh_3d.h"
+#include <vcl_compiler.h>
+#include <vcl_cassert.h>
+
+//: Subtrees of more triangles than this are built as separate OpenMP tasks
+static const unsigned vgl_bvh_3d_task_size = 4096;
+
+//: Number of bins along each axis for the SAH split
+static const unsigned vgl_bvh_3d_bins = 16;
+
+//: Half the surface area of the box lo, hi
+template <class T>
+static inline T vgl_bvh_3d_area(T const lo[3], T const hi[3])
+{
+  const T x = hi[0] - lo[0], y = hi[1] - lo[1], z = hi[2] - lo[2];
+  return x * y + y * z + z * x;
+}
+
+//: Slab test of the box lo, hi against the ray o + t d, 0 <= t <= t_max; r = 1/d.
+template <class T>
+static inline bool vgl_bvh_3d_slab(T const lo[3], T const hi[3], T const o[3], T const r[3], T t_max, T& t_near)
+{
+  T tn = T(0), tf = t_max;
+  for (unsigned a = 0; a < 3; ++a) {
+    const T t0 = (lo[a] - o[a]) * r[a], t1 = (hi[a] - o[a]) * r[a];
+    // a NaN (origin on a slab plane of a parallel ray) keeps the other bound
+    const T n = t1 < t0 ? t1 : t0, f = t1 < t0 ? t0 : t1;
+    tn = tn < n ? n : tn;
+    tf = f < tf ? f : tf;
+  }
+  t_near = tn;
+  return tn <= tf;
+}
+
+//: Moller-Trumbore test of the triangle at p (9 coordinates) against the ray o + t d, t >= 0.
+template <class T>
+static inline bool vgl_bvh_3d_hit(T const* p, T const o[3], T const d[3], T& t, T& u, T& v)
+{
+  const T e1x = p[3] - p[0], e1y = p[4] - p[1], e1z = p[5] - p[2];
+  const T e2x = p[6] - p[0], e2y = p[7] - p[1], e2z = p[8] - p[2];
+  const T px = d[1] * e2z - d[2] * e2y, py = d[2] * e2x - d[0] * e2z, pz = d[0] * e2y - d[1] * e2x;
+  const T det = e1x * px + e1y * py + e1z * pz;
+  const T eps = std::numeric_limits<T>::epsilon() *
+                std::sqrt((e1x * e1x + e1y * e1y + e1z * e1z) * (e2x * e2x + e2y * e2y + e2z * e2z));
+  if (!(std::fabs(det) > eps))
+    return false;
+  const T inv = T(1) / det;
+  const T sx = o[0] - p[0], sy = o[1] - p[1], sz = o[2] - p[2];
+  u = (sx * px + sy * py + sz * pz) * inv;
+  if (u < T(0) || u > T(1))
+    return false;
+  const T qx = sy * e1z - sz * e1y, qy = sz * e1x - sx * e1z, qz = sx * e1y - sy * e1x;
+  v = (d[0] * qx + d[1] * qy + d[2] * qz) * inv;
+  if (v < T(0) || u + v > T(1))
+    return false;
+  t = (e2x * qx + e2y * qy + e2z * qz) * inv;
+  return t >= T(0);
+}
+
+//: Squared distance from q to the box lo, hi
+template <class T>
+static inline T vgl_bvh_3d_dist2(T const lo[3], T const hi[3], T const q[3])
+{
+  T d2 = T(0);
+  for (unsigned a = 0; a < 3; ++a) {
+    const T e = q[a] < lo[a] ? lo[a] - q[a] : (q[a] > hi[a] ? q[a] - hi[a] : T(0));
+    d2 += e * e;
+  }
+  return d2;
+}
+
+//: Point c of the triangle at p (9 coordinates) closest to q.
+//  The Voronoi region method of Ericson, "Real-Time Collision Detection", 5.1.5.
+template <class T>
+static void vgl_bvh_3d_closest(T const* p, T const q[3], T c[3])
+{
+  T ab[3], ac[3], ap[3];
+  for (unsigned i = 0; i < 3; ++i) {
+    ab[i] = p[3 + i] - p[i]; ac[i] = p[6 + i] - p[i]; ap[i] = q[i] - p[i];
+  }
+  const T d1 = ab[0] * ap[0] + ab[1] * ap[1] + ab[2] * ap[2];
+  const T d2 = ac[0] * ap[0] + ac[1] * ap[1] + ac[2] * ap[2];
+  if (d1 <= T(0) && d2 <= T(0)) { // corner 0
+    for (unsigned i = 0; i < 3; ++i) c[i] = p[i];
+    return;
+  }
+  T bp[3];
+  for (unsigned i = 0; i < 3; ++i) bp[i] = q[i] - p[3 + i];
+  const T d3 = ab[0] * bp[0] + ab[1] * bp[1] + ab[2] * bp[2];
+  const T d4 = ac[0] * bp[0] + ac[1] * bp[1] + ac[2] * bp[2];
+  if (d3 >= T(0) && d4 <= d3) { // corner 1
+    for (unsigned i = 0; i < 3; ++i) c[i] = p[3 + i];
+    return;
+  }
+  const T vc = d1 * d4 - d3 * d2;
+  if (vc <= T(0) && d1 >= T(0) && d3 <= T(0)) { // edge 0-1
+    const T s = d1 / (d1 - d3);
+    for (unsigned i = 0; i < 3; ++i) c[i] = p[i] + s * ab[i];
+    return;
+  }
+  T cp[3];
+  for (unsigned i = 0; i < 3; ++i) cp[i] = q[i] - p[6 + i];
+  const T d5 = ab[0] * cp[0] + ab[1] * cp[1] + ab[2] * cp[2];
+  const T d6 = ac[0] * cp[0] + ac[1] * cp[1] + ac[2] * cp[2];
+  if (d6 >= T(0) && d5 <= d6) { // corner 2
+    for (unsigned i = 0; i < 3; ++i) c[i] = p[6 + i];
+    return;
+  }
+  const T vb = d5 * d2 - d1 * d6;
+  if (vb <= T(0) && d2 >= T(0) && d6 <= T(0)) { // edge 0-2
+    const T s = d2 / (d2 - d6);
+    for (unsigned i = 0; i < 3; ++i) c[i] = p[i] + s * ac[i];
+    return;
+  }
+  const T va = d3 * d6 - d5 * d4;
+  if (va <= T(0) && (d4 - d3) >= T(0) && (d5 - d6) >= T(0)) { // edge 1-2
+    const T s = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    for (unsigned i = 0; i < 3; ++i) c[i] = p[3 + i] + s * (p[6 + i] - p[3 + i]);
+    return;
+  }
+  const T sum = va + vb + vc;
+  if (!(sum > T(0))) { // degenerate triangle not caught above
+    for (unsigned i = 0; i < 3; ++i) c[i] = p[i];
+    return;
+  }
+  const T v = vb / sum, w = vc / sum;
+  for (unsigned i = 0; i < 3; ++i) c[i] = p[i] + v * ab[i] + w * ac[i];
+}
+
+//: Does the triangle at p (9 coordinates) meet the box of centre m and half sizes h?
+//  The separating axis test of Akenine-Moller: the box axes, the triangle
+//  normal, and the cross products of box axes and triangle edges.
+template <class T>
+static bool vgl_bvh_3d_overlap(T const* p, T const m[3], T const h[3])
+{
+  T v[3][3], e[3][3];
+  for (unsigned k = 0; k < 3; ++k)
+    for (unsigned i = 0; i < 3; ++i)
+      v[k][i] = p[3 * k + i] - m[i];
+  for (unsigned k = 0; k < 3; ++k)
+    for (unsigned i = 0; i < 3; ++i)
+      e[k][i] = v[(k + 1) % 3][i] - v[k][i];
+
+  // box axes
+  for (unsigned i = 0; i < 3; ++i) {
+    const T lo = std::min(v[0][i], std::min(v[1][i], v[2][i]));
+    const T hi = std::max(v[0][i], std::max(v[1][i], v[2][i]));
+    if (lo > h[i] || hi < -h[i])
+      return false;
+  }
+  // box axis i cross edge k
+  for (unsigned i = 0; i < 3; ++i) {
+    const unsigned j = (i + 1) % 3, l = (i + 2) % 3;
+    for (unsigned k = 0; k < 3; ++k) {
+      T a[3];
+      a[i] = T(0); a[j] = -e[k][l]; a[l] = e[k][j];
+      const T p0 = a[j] * v[0][j] + a[l] * v[0][l];
+      const T p1 = a[j] * v[1][j] + a[l] * v[1][l];
+      const T p2 = a[j] * v[2][j] + a[l] * v[2][l];
+      const T r = h[j] * std::fabs(a[j]) + h[l] * std::fabs(a[l]);
+      if (std::min(p0, std::min(p1, p2)) > r || std::max(p0, std::max(p1, p2)) < -r)
+        return false;
+    }
+  }
+  // triangle normal
+  const T n[3] = { e[0][1] * e[1][2] - e[0][2] * e[1][1],
+                   e[0][2] * e[1][0] - e[0][0] * e[1][2],
+                   e[0][0] * e[1][1] - e[0][1] * e[1][0] };
+  const T d = n[0] * v[0][0] + n[1] * v[0][1] + n[2] * v[0][2];
+  const T r = h[0] * std::fabs(n[0]) + h[1] * std::fabs(n[1]) + h[2] * std::fabs(n[2]);
+  return std::fabs(d) <= r;
+}
+
+//: Orders triangles by the coordinate a of their centres
+template <class T>
+struct vgl_bvh_3d_centre_less
+{
+  std::vector<T> const& c;
+  unsigned a;
+  vgl_bvh_3d_centre_less(std::vector<T> const& centres, unsigned axis) : c(centres), a(axis) {}
+  bool operator()(unsigned i, unsigned j) const { return c[3 * i + a] < c[3 * j + a]; }
+};
+
+template <class T>
+vgl_bvh_3d<T>::vgl_bvh_3d(std::vector<vgl_point_3d<T> > const& verts, std::vector<unsigned> const& tris,
+                          unsigned max_leaf_size)
+  : depth_(0)
+{
+  build(verts, tris, max_leaf_size);
+}
+
+template <class T>
+vgl_bvh_3d<T>::vgl_bvh_3d(std::vector<vgl_point_3d<T> > const& corners, unsigned max_leaf_size)
+  : depth_(0)
+{
+  std::vector<unsigned> tris(corners.size() - corners.size() % 3);
+  for (unsigned i = 0; i < tris.size(); ++i)
+    tris[i] = i;
+  build(corners, tris, max_leaf_size);
+}
+
+template <class T>
+void vgl_bvh_3d<T>::build(std::vector<vgl_point_3d<T> > const& verts, std::vector<unsigned> const& tris,
+                          unsigned max_leaf_size)
+{
+  tri_.clear();
+  face_.clear();
+  nodes_.clear();
+  depth_ = 0;
+  const unsigned n = (unsigned)(tris.size() / 3);
+  if (n == 0)
+    return;
+  if (max_leaf_size == 0)
+    max_leaf_size = 1;
+
+  // bounds and centre of each triangle
+  std::vector<T> bounds(6 * n), centres(3 * n);
+  for (unsigned k = 0; k < n; ++k) {
+    vgl_point_3d<T> const& a = verts[tris[3 * k]];
+    vgl_point_3d<T> const& b = verts[tris[3 * k + 1]];
+    vgl_point_3d<T> const& c = verts[tris[3 * k + 2]];
+    const T x[3] = { a.x(), b.x(), c.x() }, y[3] = { a.y(), b.y(), c.y() }, z[3] = { a.z(), b.z(), c.z() };
+    T* bk = &bounds[6 * k];
+    bk[0] = std::min(x[0], std::min(x[1], x[2])); bk[3] = std::max(x[0], std::max(x[1], x[2]));
+    bk[1] = std::min(y[0], std::min(y[1], y[2])); bk[4] = std::max(y[0], std::max(y[1], y[2]));
+    bk[2] = std::min(z[0], std::min(z[1], z[2])); bk[5] = std::max(z[0], std::max(z[1], z[2]));
+    for (unsigned i = 0; i < 3; ++i)
+      centres[3 * k + i] = (bk[i] + bk[3 + i]) / 2;
+  }
+
+  std::vector<unsigned> perm(n);
+  for (unsigned k = 0; k < n; ++k)
+    perm[k] = k;
+  std::vector<node_type> tmp(2 * n - 1);
+#if defined(_OPENMP)
+#pragma omp parallel
+#pragma omp single
+#endif
+  build_node(tmp, 0, perm, 0, n, bounds, centres, max_leaf_size);
+  flatten(tmp);
+
+  // the leaves refer to perm, so copy the triangles in that order
+  face_.swap(perm);
+  tri_.resize(9 * n);
+  for (unsigned k = 0; k < n; ++k)
+    for (unsigned c = 0; c < 3; ++c) {
+      vgl_point_3d<T> const& p = verts[tris[3 * face_[k] + c]];
+      tri_[9 * k + 3 * c] = p.x(); tri_[9 * k + 3 * c + 1] = p.y(); tri_[9 * k + 3 * c + 2] = p.z();
+    }
+}
+
+template <class T>
+void vgl_bvh_3d<T>::build_node(std::vector<node_type>& tmp, unsigned k, std::vector<unsigned>& perm,
+                               unsigned b, unsigned e, std::vector<T> const& bounds,
+                               std::vector<T> const& centres, unsigned max_leaf_size)
+{
+  node_type& nd = tmp[k];
+  const T inf = std::numeric_limits<T>::infinity();
+  T clo[3] = { inf, inf, inf }, chi[3] = { -inf, -inf, -inf };
+  for (unsigned i = 0; i < 3; ++i) { nd.lo[i] = inf; nd.hi[i] = -inf; }
+  for (unsigned j = b; j < e; ++j) {
+    T const* bj = &bounds[6 * perm[j]];
+    T const* cj = &centres[3 * perm[j]];
+    for (unsigned i = 0; i < 3; ++i) {
+      nd.lo[i] = std::min(nd.lo[i], bj[i]); nd.hi[i] = std::max(nd.hi[i], bj[3 + i]);
+      clo[i] = std::min(clo[i], cj[i]); chi[i] = std::max(chi[i], cj[i]);
+    }
+  }
+  const unsigned n = e - b;
+  nd.index = b;
+  nd.count = n;
+  if (n <= max_leaf_size)
+    return;
+
+  // Binned SAH: cost of a split after bin s along axis a, in units of a triangle test
+  const unsigned B = vgl_bvh_3d_bins;
+  T best_cost = inf;
+  unsigned best_axis = 3, best_split = 0;
+  for (unsigned a = 0; a < 3; ++a) {
+    const T extent = chi[a] - clo[a];
+    if (!(extent > T(0)))
+      continue;
+    const T scale = T(B) / extent;
+    unsigned count[B];
+    T lo[B][3], hi[B][3];
+    for (unsigned s = 0; s < B; ++s) {
+      count[s] = 0;
+      for (unsigned i = 0; i < 3; ++i) { lo[s][i] = inf; hi[s][i] = -inf; }
+    }
+    for (unsigned j = b; j < e; ++j) {
+      const unsigned s = std::min(B - 1, unsigned((centres[3 * perm[j] + a] - clo[a]) * scale));
+      T const* bj = &bounds[6 * perm[j]];
+      ++count[s];
+      for (unsigned i = 0; i < 3; ++i) {
+        lo[s][i] = std::min(lo[s][i], bj[i]); hi[s][i] = std::max(hi[s][i], bj[3 + i]);
+      }
+    }
+    // areas and counts to the right of each split, then sweep from the left
+    T right_area[B];
+    unsigned right_count[B];
+    T rlo[3] = { inf, inf, inf }, rhi[3] = { -inf, -inf, -inf };
+    unsigned rc = 0;
+    for (unsigned s = B - 1; s > 0; --s) {
+      rc += count[s];
+      for (unsigned i = 0; i < 3; ++i) { rlo[i] = std::min(rlo[i], lo[s][i]); rhi[i] = std::max(rhi[i], hi[s][i]); }
+      right_count[s - 1] = rc;
+      right_area[s - 1] = rc ? vgl_bvh_3d_area(rlo, rhi) : T(0);
+    }
+    T llo[3] = { inf, inf, inf }, lhi[3] = { -inf, -inf, -inf };
+    unsigned lc = 0;
+    for (unsigned s = 0; s + 1 < B; ++s) {
+      lc += count[s];
+      for (unsigned i = 0; i < 3; ++i) { llo[i] = std::min(llo[i], lo[s][i]); lhi[i] = std::max(lhi[i], hi[s][i]); }
+      if (lc == 0 || right_count[s] == 0)
+        continue;
+      const T cost = vgl_bvh_3d_area(llo, lhi) * T(lc) + right_area[s] * T(right_count[s]);
+      if (cost < best_cost) {
+        best_cost = cost; best_axis = a; best_split = s;
+      }
+    }
+  }
+  if (best_axis == 3) // all centroids coincide: nothing separates the triangles
+    return;
+
+  unsigned* first = &perm[0] + b;
+  unsigned* last = &perm[0] + e;
+  unsigned* mid = first;
+  // A split is worth it if a traversal step plus the tests of both
+  // children is cheaper than testing every triangle here.
+  const T area = vgl_bvh_3d_area(nd.lo, nd.hi);
+  if (best_cost < T(n - 1) * area || !(area > T(0))) {
+    const T lo = clo[best_axis], scale = T(B) / (chi[best_axis] - lo);
+    const unsigned a = best_axis, split = best_split;
+    for (unsigned* j = first; j != last; ++j)
+      if (std::min(B - 1, unsigned((centres[3 * *j + a] - lo) * scale)) <= split)
+        std::swap(*j, *mid++);
+  }
+  if (mid == first || mid == last) {
+    // SAH prefers a leaf, but it would be too big: split at the median of the longest axis
+    unsigned a = 0;
+    for (unsigned i = 1; i < 3; ++i)
+      if (chi[i] - clo[i] > chi[a] - clo[a]) a = i;
+    mid = first + n / 2;
+    std::nth_element(first, mid, last, vgl_bvh_3d_centre_less<T>(centres, a));
+  }
+
+  const unsigned nl = unsigned(mid - first);
+  nd.count = 0;
+  nd.index = k + 2 * nl; // the first child takes 2 nl - 1 nodes from k+1
+#if defined(_OPENMP)
+  if (n > vgl_bvh_3d_task_size) {
+    std::vector<node_type>* tp = &tmp;
+    std::vector<unsigned>* pp = &perm;
+    std::vector<T> const* bp = &bounds;
+    std::vector<T> const* cp = &centres;
+#pragma omp task firstprivate(tp, pp, bp, cp, k, b, nl, max_leaf_size)
+    build_node(*tp, k + 1, *pp, b, b + nl, *bp, *cp, max_leaf_size);
+    build_node(tmp, k + 2 * nl, perm, b + nl, e, bounds, centres, max_leaf_size);
+#pragma omp taskwait
+    return;
+  }
+#endif
+  build_node(tmp, k + 1, perm, b, b + nl, bounds, centres, max_leaf_size);
+  build_node(tmp, k + 2 * nl, perm, b + nl, e, bounds, centres, max_leaf_size);
+}
+
+template <class T>
+void vgl_bvh_3d<T>::flatten(std::vector<node_type> const& tmp)
+{
+  // Depth first, with an explicit stack of (node in tmp, its depth, the
+  // node in nodes_ whose second child it is, or -1).
+  struct entry { unsigned k, depth; int parent; };
+  std::vector<entry> stack;
+  entry root = { 0, 1, -1 };
+  stack.push_back(root);
+  while (!stack.empty()) {
+    entry t = stack.back();
+    stack.pop_back();
+    const unsigned at = (unsigned)nodes_.size();
+    nodes_.push_back(tmp[t.k]);
+    depth_ = std::max(depth_, t.depth);
+    if (t.parent >= 0)
+      nodes_[t.parent].index = at;
+    if (tmp[t.k].count == 0) {
+      entry second = { tmp[t.k].index, t.depth + 1, int(at) }, first = { t.k + 1, t.depth + 1, -1 };
+      stack.push_back(second);
+      stack.push_back(first);
+    }
+  }
+}
+
+template <class T>
+vgl_box_3d<T> vgl_bvh_3d<T>::bounding_box() const
+{
+  vgl_box_3d<T> box;
+  if (!nodes_.empty()) {
+    box.add(vgl_point_3d<T>(nodes_[0].lo[0], nodes_[0].lo[1], nodes_[0].lo[2]));
+    box.add(vgl_point_3d<T>(nodes_[0].hi[0], nodes_[0].hi[1], nodes_[0].hi[2]));
+  }
+  return box;
+}
+
+template <class T>
+void vgl_bvh_3d<T>::triangle(unsigned k, vgl_point_3d<T>& p0, vgl_point_3d<T>& p1, vgl_point_3d<T>& p2) const
+{
+  assert(k < face_.size());
+  // triangles are stored in leaf order; find where k went
+  const unsigned j = unsigned(std::find(face_.begin(), face_.end(), k) - face_.begin());
+  T const* p = &tri_[9 * j];
+  p0.set(p[0], p[1], p[2]);
+  p1.set(p[3], p[4], p[5]);
+  p2.set(p[6], p[7], p[8]);
+}
+
+template <class T>
+int vgl_bvh_3d<T>::intersect(vgl_point_3d<T> const& origin, vgl_vector_3d<T> const& direction,
+                             T& t, T& u, T& v, T t_max) const
+{
+  if (nodes_.empty())
+    return -1;
+  const T o[3] = { origin.x(), origin.y(), origin.z() };
+  const T d[3] = { direction.x(), direction.y(), direction.z() };
+  const T r[3] = { T(1) / d[0], T(1) / d[1], T(1) / d[2] };
+
+  // the stack holds at most one node per level, and one more
+  unsigned local[64];
+  std::vector<unsigned> big;
+  unsigned* stack = local;
+  if (depth_ >= 64) {
+    big.resize(depth_ + 1);
+    stack = &big[0];
+  }
+  unsigned sp = 0;
+  stack[sp++] = 0;
+  int hit = -1;
+  T best = t_max, tn;
+  while (sp > 0) {
+    const unsigned k = stack[--sp];
+    node_type const& nd = nodes_[k];
+    // best may have shrunk since the node was pushed
+    if (!vgl_bvh_3d_slab(nd.lo, nd.hi, o, r, best, tn))
+      continue;
+    if (nd.count) {
+      for (unsigned j = nd.index; j < nd.index + nd.count; ++j) {
+        T tj, uj, vj;
+        if (vgl_bvh_3d_hit(&tri_[9 * j], o, d, tj, uj, vj) && tj <= best) {
+          best = tj; u = uj; v = vj; hit = int(face_[j]);
+        }
+      }
+      continue;
+    }
+    // push the farther child first, so the nearer is visited next
+    const unsigned c0 = k + 1, c1 = nd.index;
+    T t0, t1;
+    const bool h0 = vgl_bvh_3d_slab(nodes_[c0].lo, nodes_[c0].hi, o, r, best, t0);
+    const bool h1 = vgl_bvh_3d_slab(nodes_[c1].lo, nodes_[c1].hi, o, r, best, t1);
+    if (h0 && h1) {
+      if (t1 < t0) { stack[sp++] = c0; stack[sp++] = c1; }
+      else         { stack[sp++] = c1; stack[sp++] = c0; }
+    }
+    else if (h0)
+      stack[sp++] = c0;
+    else if (h1)
+      stack[sp++] = c1;
+  }
+  if (hit >= 0)
+    t = best;
+  return hit;
+}
+
+template <class T>
+bool vgl_bvh_3d<T>::occluded(vgl_point_3d<T> const& origin, vgl_vector_3d<T> const& direction, T t_max) const
+{
+  if (nodes_.empty())
+    return false;
+  const T o[3] = { origin.x(), origin.y(), origin.z() };
+  const T d[3] = { direction.x(), direction.y(), direction.z() };
+  const T r[3] = { T(1) / d[0], T(1) / d[1], T(1) / d[2] };
+  std::vector<unsigned> stack(1, 0u);
+  stack.reserve(depth_ + 1);
+  T tn;
+  while (!stack.empty()) {
+    const unsigned k = stack.back();
+    stack.pop_back();
+    node_type const& nd = nodes_[k];
+    if (!vgl_bvh_3d_slab(nd.lo, nd.hi, o, r, t_max, tn))
+      continue;
+    if (nd.count) {
+      for (unsigned j = nd.index; j < nd.index + nd.count; ++j) {
+        T tj, uj, vj;
+        if (vgl_bvh_3d_hit(&tri_[9 * j], o, d, tj, uj, vj) && tj <= t_max)
+          return true;
+      }
+      continue;
+    }
+    stack.push_back(nd.index);
+    stack.push_back(k + 1);
+  }
+  return false;
+}
+
+template <class T>
+void vgl_bvh_3d<T>::intersect(std::vector<vgl_ray_3d<T> > const& rays, std::vector<int>& faces,
+                              std::vector<T>& ts) const
+{
+  const int n = (int)rays.size();
+  faces.resize(n);
+  ts.resize(n);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+  for (int i = 0; i < n; ++i) {
+    T t = std::numeric_limits<T>::infinity();
+    faces[i] = intersect(rays[i], t);
+    ts[i] = t;
+  }
+}
+
+template <class T>
+int vgl_bvh_3d<T>::closest_point(vgl_point_3d<T> const& p, vgl_point_3d<T>& cp) const
+{
+  if (nodes_.empty())
+    return -1;
+  const T q[3] = { p.x(), p.y(), p.z() };
+  unsigned local[64];
+  std::vector<unsigned> big;
+  unsigned* stack = local;
+  if (depth_ >= 64) {
+    big.resize(depth_ + 1);
+    stack = &big[0];
+  }
+  unsigned sp = 0;
+  stack[sp++] = 0;
+  int face = -1;
+  T best = std::numeric_limits<T>::infinity(), c[3];
+  while (sp > 0) {
+    const unsigned k = stack[--sp];
+    node_type const& nd = nodes_[k];
+    if (vgl_bvh_3d_dist2(nd.lo, nd.hi, q) > best)
+      continue;
+    if (nd.count) {
+      for (unsigned j = nd.index; j < nd.index + nd.count; ++j) {
+        vgl_bvh_3d_closest(&tri_[9 * j], q, c);
+        const T d2 = (c[0] - q[0]) * (c[0] - q[0]) + (c[1] - q[1]) * (c[1] - q[1]) + (c[2] - q[2]) * (c[2] - q[2]);
+        if (d2 < best || face < 0) {
+          best = d2; face = int(face_[j]);
+          cp.set(c[0], c[1], c[2]);
+        }
+      }
+      continue;
+    }
+    const unsigned c0 = k + 1, c1 = nd.index;
+    const T d0 = vgl_bvh_3d_dist2(nodes_[c0].lo, nodes_[c0].hi, q);
+    const T d1 = vgl_bvh_3d_dist2(nodes_[c1].lo, nodes_[c1].hi, q);
+    if (d1 < d0) {
+      if (d0 <= best) stack[sp++] = c0;
+      if (d1 <= best) stack[sp++] = c1;
+    }
+    else {
+      if (d1 <= best) stack[sp++] = c1;
+      if (d0 <= best) stack[sp++] = c0;
+    }
+  }
+  return face;
+}
+
+template <class T>
+void vgl_bvh_3d<T>::closest_points(std::vector<vgl_point_3d<T> > const& ps,
+                                   std::vector<vgl_point_3d<T> >& cps, std::vector<int>& faces) const
+{
+  const int n = (int)ps.size();
+  cps.resize(n);
+  faces.resize(n);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+  for (int i = 0; i < n; ++i)
+    faces[i] = closest_point(ps[i], cps[i]);
+}
+
+template <class T>
+void vgl_bvh_3d<T>::overlapping(vgl_box_3d<T> const& box, std::vector<unsigned>& faces) const
+{
+  faces.clear();
+  if (nodes_.empty() || box.is_empty())
+    return;
+  const T lo[3] = { box.min_x(), box.min_y(), box.min_z() };
+  const T hi[3] = { box.max_x(), box.max_y(), box.max_z() };
+  const T m[3] = { (lo[0] + hi[0]) / 2, (lo[1] + hi[1]) / 2, (lo[2] + hi[2]) / 2 };
+  const T h[3] = { hi[0] - m[0], hi[1] - m[1], hi[2] - m[2] };
+  std::vector<unsigned> stack(1, 0u);
+  stack.reserve(depth_ + 1);
+  while (!stack.empty()) {
+    const unsigned k = stack.back();
+    stack.pop_back();
+    node_type const& nd = nodes_[k];
+    if (nd.lo[0] > hi[0] || nd.hi[0] < lo[0] || nd.lo[1] > hi[1] || nd.hi[1] < lo[1] ||
+        nd.lo[2] > hi[2] || nd.hi[2] < lo[2])
+      continue;
+    if (nd.count) {
+      for (unsigned j = nd.index; j < nd.index + nd.count; ++j)
+        if (vgl_bvh_3d_overlap(&tri_[9 * j], m, h))
+          faces.push_back(face_[j]);
+      continue;
+    }
+    stack.push_back(nd.index);
+    stack.push_back(k + 1);
+  }
+}
+
+#undef VGL_BVH_3D_INSTANTIATE
+#define VGL_BVH_3D_INSTANTIATE(T) \
+template class vgl_bvh_3d<T >
+
+#endif // vgl_bvh_3d_hxx_
@@ -0,0 +1,142 @@
+// This is core/vgl/algo/vgl_convex_hull_3d.h
+#ifndef vgl_convex_hull_3d_h_
+#define vgl_convex_hull_3d_h_
+//:
+// \file
+// \brief Convex hull of a 3-d point set, by quickhull, with points added incrementally
+//
+//    The hull is a closed surface of triangles, each of whose corners is
+//    one of the points.  It is found by quickhull (Barber, Dobkin and
+//    Huhdanpaa, 1996): starting from a tetrahedron of extreme points,
+//    every point outside the hull is assigned to a face it lies outside
+//    of, and repeatedly the point farthest outside a face is added,
+//    replacing the faces it sees by a cone of new faces from it to their
+//    horizon.  Points may be added later, one at a time or in batches;
+//    the hull is then grown rather than built again.
+//
+//    Points are kept as arrays of coordinates, and the hull refers to
+//    them by index, in the order they were added.  The coordinates may be
+//    those of a vgl_point_cloud_3d.  When compiled with OpenMP, the
+//    assignment of a batch of points to the faces runs in parallel.
+//
+//    A point counts as outside a face only if it is farther from its plane
+//    than a tolerance set by the rounding error of the computation.  Until
+//    the points span a volume, the hull is flat: a point, a segment, or a
+//    convex polygon, with vertices but no faces.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vector>
+#include <vcl_compiler.h>
+#include <vgl/vgl_point_3d.h>
+
+//: Convex hull of a growing set of 3-d points.
+template <class T>
+class vgl_convex_hull_3d
+{
+ public:
+  //: Hull of no points
+  vgl_convex_hull_3d() { clear(); }
+
+  //: Hull of points
+  explicit vgl_convex_hull_3d(std::vector<vgl_point_3d<T> > const& points);
+
+  //: Hull of the points (x[i], y[i], z[i]), 0 <= i < n
+  vgl_convex_hull_3d(T const* x, T const* y, T const* z, unsigned n);
+
+  //: Remove all points
+  void clear();
+
+  //: Add p, growing the hull if it lies outside.
+  //  Returns true if p lies outside the hull, and so is now one of its vertices.
+  bool insert(vgl_point_3d<T> const& p);
+
+  //: Add points, growing the hull to contain them
+  void insert(std::vector<vgl_point_3d<T> > const& points);
+
+  //: Add the points (x[i], y[i], z[i]), 0 <= i < n
+  void insert(T const* x, T const* y, T const* z, unsigned n);
+
+  //: Number of points added
+  unsigned num_points() const { return (unsigned)x_.size(); }
+
+  //: Point i
+  vgl_point_3d<T> point(unsigned i) const { return vgl_point_3d<T>(x_[i], y_[i], z_[i]); }
+
+  //: Dimension of the hull: 3 for a solid, 2, 1 or 0 for a polygon, a segment or a point, -1 if empty
+  int dimension() const { return dim_; }
+
+  //: Number of triangular faces; 0 unless the dimension is 3
+  unsigned num_faces() const { return (unsigned)faces_.size(); }
+
+  //: Indices of the vertices of the hull, in increasing order.
+  //  For a flat hull of dimension 2 they are in order around the polygon instead.
+  void vertices(std::vector<unsigned>& v) const;
+
+  //: The faces, as 3 indices each, counterclockwise seen from outside
+  void faces(std::vector<unsigned>& tris) const;
+
+  //: Is p inside or on the hull?  Always false unless the dimension is 3.
+  bool contains(vgl_point_3d<T> const& p) const;
+
+  //: Volume enclosed
+  double volume() const;
+
+ private:
+  struct face_type
+  {
+    //: Corners, counterclockwise seen from outside
+    unsigned v[3];
+    //: Face across the edge from v[i] to v[(i+1)%3]
+    unsigned nbr[3];
+    //: Outward unit normal and offset: a point p is outside if n.p > d + tolerance
+    double n[3], d;
+    //: Points assigned to this face, which lie outside it
+    std::vector<unsigned> outside;
+    //: Visit stamp and visibility during an insertion
+    unsigned visit;
+    bool visible;
+    bool alive;
+  };
+
+  //: Signed distance of point i from the plane of face f
+  double distance(face_type const& f, unsigned i) const
+  { return f.n[0] * double(x_[i]) + f.n[1] * double(y_[i]) + f.n[2] * double(z_[i]) - f.d; }
+
+  //: Set the corners and plane of f
+  void set_face(face_type& f, unsigned a, unsigned b, unsigned c) const;
+
+  //: Update the bounds of the coordinates and the tolerance for points from first on
+  void update_tolerance(unsigned first);
+
+  //: Build the hull of all points from scratch
+  void build();
+
+  //: Assign the points to faces they lie outside of, and add them
+  void add(std::vector<unsigned> const& points);
+
+  //: Add the point eye, which lies outside face f
+  void add_eye(unsigned f, unsigned eye);
+
+  //: Remove dead faces
+  void compact();
+
+  //: Point coordinates
+  std::vector<T> x_, y_, z_;
+  std::vector<face_type> faces_;
+  int dim_;
+  //: Largest absolute coordinate along each axis
+  double extent_[3];
+  //: Distance below which a point counts as on a plane
+  double tol_;
+  unsigned stamp_;
+  //: For a flat hull: a point on it, and a unit direction along a segment or normal to a polygon
+  unsigned origin_;
+  double dir_[3];
+};
+
+#define VGL_CONVEX_HULL_3D_INSTANTIATE(T) extern "please include vgl/algo/vgl_convex_hull_3d.hxx first"
+
+#endif // vgl_convex_hull_3d_h_
@@ -0,0 +1,455 @@
+// This is core/vgl/algo/vgl_convex_hull_3d.hxx
+#ifndef vgl_convex_hull_3d_hxx_
+#define vgl_convex_hull_3d_hxx_
+//:
+// \file
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include "vgl_convex_hull_3d.h"
+#include <vgl/algo/vgl_convex_hull_indices_2d.h>
+#include <vcl_compiler.h>
+#include <vcl_cassert.h>
+
+template <class T>
+vgl_convex_hull_3d<T>::vgl_convex_hull_3d(std::vector<vgl_point_3d<T> > const& points)
+{
+  clear();
+  insert(points);
+}
+
+template <class T>
+vgl_convex_hull_3d<T>::vgl_convex_hull_3d(T const* x, T const* y, T const* z, unsigned n)
+{
+  clear();
+  insert(x, y, z, n);
+}
+
+template <class T>
+void vgl_convex_hull_3d<T>::clear()
+{
+  x_.clear(); y_.clear(); z_.clear();
+  faces_.clear();
+  dim_ = -1;
+  extent_[0] = extent_[1] = extent_[2] = 0;
+  tol_ = 0;
+  stamp_ = 0;
+  origin_ = 0;
+  dir_[0] = dir_[1] = dir_[2] = 0;
+}
+
+template <class T>
+void vgl_convex_hull_3d<T>::set_face(face_type& f, unsigned a, unsigned b, unsigned c) const
+{
+  f.v[0] = a; f.v[1] = b; f.v[2] = c;
+  const double ux = double(x_[b]) - x_[a], uy = double(y_[b]) - y_[a], uz = double(z_[b]) - z_[a];
+  const double vx = double(x_[c]) - x_[a], vy = double(y_[c]) - y_[a], vz = double(z_[c]) - z_[a];
+  double n[3] = { uy * vz - uz * vy, uz * vx - ux * vz, ux * vy - uy * vx };
+  const double len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+  if (len > 0)
+    for (unsigned i = 0; i < 3; ++i) n[i] /= len;
+  for (unsigned i = 0; i < 3; ++i) f.n[i] = n[i];
+  // offset through the centroid, to spread the rounding error over the corners
+  f.d = (n[0] * (double(x_[a]) + x_[b] + x_[c]) + n[1] * (double(y_[a]) + y_[b] + y_[c]) +
+         n[2] * (double(z_[a]) + z_[b] + z_[c])) / 3;
+  f.visit = 0;
+  f.visible = false;
+  f.alive = true;
+}
+
+template <class T>
+void vgl_convex_hull_3d<T>::update_tolerance(unsigned first)
+{
+  for (unsigned i = first; i < x_.size(); ++i) {
+    extent_[0] = std::max(extent_[0], std::fabs(double(x_[i])));
+    extent_[1] = std::max(extent_[1], std::fabs(double(y_[i])));
+    extent_[2] = std::max(extent_[2], std::fabs(double(z_[i])));
+  }
+  tol_ = 4 * std::numeric_limits<double>::epsilon() * (extent_[0] + extent_[1] + extent_[2]);
+}
+
+template <class T>
+bool vgl_convex_hull_3d<T>::insert(vgl_point_3d<T> const& p)
+{
+  const unsigned i = num_points();
+  x_.push_back(p.x()); y_.push_back(p.y()); z_.push_back(p.z());
+  update_tolerance(i);
+  if (dim_ < 3) {
+    // a flat hull only changes here if p leaves its line or plane
+    const double dx = double(x_[i]) - x_[origin_], dy = double(y_[i]) - y_[origin_], dz = double(z_[i]) - z_[origin_];
+    double off = 0;
+    if (dim_ == 0)
+      off = std::sqrt(dx * dx + dy * dy + dz * dz);
+    else if (dim_ == 1) {
+      const double cx = dy * dir_[2] - dz * dir_[1], cy = dz * dir_[0] - dx * dir_[2], cz = dx * dir_[1] - dy * dir_[0];
+      off = std::sqrt(cx * cx + cy * cy + cz * cz);
+    }
+    else if (dim_ == 2)
+      off = std::fabs(dx * dir_[0] + dy * dir_[1] + dz * dir_[2]);
+    if (dim_ >= 0 && off <= tol_)
+      return false;
+    build();
+    return true;
+  }
+  unsigned best = 0;
+  double best_d = tol_;
+  for (unsigned f = 0; f < faces_.size(); ++f) {
+    const double d = distance(faces_[f], i);
+    if (d > best_d) { best_d = d; best = f; }
+  }
+  if (best_d <= tol_)
+    return false;
+  std::vector<unsigned> one(1, i);
+  add(one);
+  return true;
+}
+
+template <class T>
+void vgl_convex_hull_3d<T>::insert(std::vector<vgl_point_3d<T> > const& points)
+{
+  const unsigned n = (unsigned)points.size();
+  std::vector<T> x(n), y(n), z(n);
+  for (unsigned i = 0; i < n; ++i) {
+    x[i] = points[i].x(); y[i] = points[i].y(); z[i] = points[i].z();
+  }
+  if (n > 0)
+    insert(&x[0], &y[0], &z[0], n);
+}
+
+template <class T>
+void vgl_convex_hull_3d<T>::insert(T const* x, T const* y, T const* z, unsigned n)
+{
+  const unsigned first = num_points();
+  x_.insert(x_.end(), x, x + n);
+  y_.insert(y_.end(), y, y + n);
+  z_.insert(z_.end(), z, z + n);
+  update_tolerance(first);
+  if (dim_ < 3) {
+    // build from scratch: the hull may become solid
+    if (n > 0)
+      build();
+    return;
+  }
+  std::vector<unsigned> points(n);
+  for (unsigned i = 0; i < n; ++i)
+    points[i] = first + i;
+  add(points);
+}
+
+template <class T>
+void vgl_convex_hull_3d<T>::build()
+{
+  faces_.clear();
+  const unsigned n = num_points();
+  dim_ = n ? 0 : -1;
+  origin_ = 0;
+  if (n == 0)
+    return;
+
+  // the two farthest apart of the extreme points along the axes
+  unsigned ext[6] = { 0, 0, 0, 0, 0, 0 };
+  for (unsigned i = 1; i < n; ++i) {
+    if (x_[i] < x_[ext[0]]) ext[0] = i;
+    if (x_[i] > x_[ext[1]]) ext[1] = i;
+    if (y_[i] < y_[ext[2]]) ext[2] = i;
+    if (y_[i] > y_[ext[3]]) ext[3] = i;
+    if (z_[i] < z_[ext[4]]) ext[4] = i;
+    if (z_[i] > z_[ext[5]]) ext[5] = i;
+  }
+  unsigned p0 = 0, p1 = 0;
+  double best = -1;
+  for (unsigned a = 0; a < 6; ++a)
+    for (unsigned b = a + 1; b < 6; ++b) {
+      const double dx = double(x_[ext[b]]) - x_[ext[a]], dy = double(y_[ext[b]]) - y_[ext[a]],
+                   dz = double(z_[ext[b]]) - z_[ext[a]];
+      const double d = dx * dx + dy * dy + dz * dz;
+      if (d > best) { best = d; p0 = ext[a]; p1 = ext[b]; }
+    }
+  origin_ = p0;
+  if (std::sqrt(best) <= tol_)
+    return; // a point
+
+  // the point farthest from the line p0 p1
+  double u[3] = { double(x_[p1]) - x_[p0], double(y_[p1]) - y_[p0], double(z_[p1]) - z_[p0] };
+  const double ul = std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+  for (unsigned k = 0; k < 3; ++k) u[k] /= ul;
+  unsigned p2 = p0;
+  best = -1;
+  for (unsigned i = 0; i < n; ++i) {
+    const double dx = double(x_[i]) - x_[p0], dy = double(y_[i]) - y_[p0], dz = double(z_[i]) - z_[p0];
+    const double cx = dy * u[2] - dz * u[1], cy = dz * u[0] - dx * u[2], cz = dx * u[1] - dy * u[0];
+    const double d = cx * cx + cy * cy + cz * cz;
+    if (d > best) { best = d; p2 = i; }
+  }
+  if (std::sqrt(best) <= tol_) {
+    dim_ = 1;
+    for (unsigned k = 0; k < 3; ++k) dir_[k] = u[k];
+    return;
+  }
+
+  // the point farthest from the plane p0 p1 p2
+  face_type base;
+  set_face(base, p0, p1, p2);
+  unsigned p3 = p0;
+  best = -1;
+  for (unsigned i = 0; i < n; ++i) {
+    const double d = std::fabs(distance(base, i));
+    if (d > best) { best = d; p3 = i; }
+  }
+  if (best <= tol_) {
+    dim_ = 2;
+    for (unsigned k = 0; k < 3; ++k) dir_[k] = base.n[k];
+    return;
+  }
+
+  // a tetrahedron, its faces turned outwards
+  dim_ = 3;
+  const unsigned corner[4] = { p0, p1, p2, p3 };
+  const unsigned tet[4][3] = { { p0, p1, p2 }, { p0, p1, p3 }, { p1, p2, p3 }, { p2, p0, p3 } };
+  const double cx = (double(x_[p0]) + x_[p1] + x_[p2] + x_[p3]) / 4;
+  const double cy = (double(y_[p0]) + y_[p1] + y_[p2] + y_[p3]) / 4;
+  const double cz = (double(z_[p0]) + z_[p1] + z_[p2] + z_[p3]) / 4;
+  faces_.resize(4);
+  for (unsigned f = 0; f < 4; ++f) {
+    set_face(faces_[f], tet[f][0], tet[f][1], tet[f][2]);
+    face_type const& ff = faces_[f];
+    if (ff.n[0] * cx + ff.n[1] * cy + ff.n[2] * cz > ff.d)
+      set_face(faces_[f], tet[f][0], tet[f][2], tet[f][1]);
+  }
+  for (unsigned f = 0; f < 4; ++f)
+    for (unsigned i = 0; i < 3; ++i) {
+      const unsigned a = faces_[f].v[i], b = faces_[f].v[(i + 1) % 3];
+      for (unsigned g = 0; g < 4; ++g)
+        for (unsigned j = 0; j < 3; ++j)
+          if (faces_[g].v[j] == b && faces_[g].v[(j + 1) % 3] == a)
+            faces_[f].nbr[i] = g;
+    }
+
+  std::vector<unsigned> rest;
+  rest.reserve(n - 4);
+  for (unsigned i = 0; i < n; ++i)
+    if (i != corner[0] && i != corner[1] && i != corner[2] && i != corner[3])
+      rest.push_back(i);
+  add(rest);
+}
+
+template <class T>
+void vgl_convex_hull_3d<T>::add(std::vector<unsigned> const& points)
+{
+  // assign each point to the face it is farthest outside of
+  const int n = (int)points.size();
+  const unsigned n_faces = (unsigned)faces_.size();
+  std::vector<int> which(n);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 1024)
+#endif
+  for (int k = 0; k < n; ++k) {
+    int best = -1;
+    double best_d = tol_;
+    for (unsigned f = 0; f < n_faces; ++f) {
+      const double d = distance(faces_[f], points[k]);
+      if (d > best_d) { best_d = d; best = int(f); }
+    }
+    which[k] = best;
+  }
+  for (int k = 0; k < n; ++k)
+    if (which[k] >= 0)
+      faces_[which[k]].outside.push_back(points[k]);
+
+  // add the farthest point outside each face, until no face has any
+  for (unsigned f = 0; f < faces_.size(); ++f) {
+    if (!faces_[f].alive || faces_[f].outside.empty())
+      continue;
+    std::vector<unsigned> const& out = faces_[f].outside;
+    unsigned eye = out[0];
+    double best_d = distance(faces_[f], eye);
+    for (unsigned k = 1; k < out.size(); ++k) {
+      const double d = distance(faces_[f], out[k]);
+      if (d > best_d) { best_d = d; eye = out[k]; }
+    }
+    add_eye(f, eye);
+  }
+  compact();
+}
+
+template <class T>
+void vgl_convex_hull_3d<T>::add_eye(unsigned f0, unsigned eye)
+{
+  // the faces eye can see, found across edges from f0
+  ++stamp_;
+  std::vector<unsigned> visible(1, f0);
+  faces_[f0].visit = stamp_;
+  faces_[f0].visible = true;
+  for (unsigned k = 0; k < visible.size(); ++k)
+    for (unsigned i = 0; i < 3; ++i) {
+      face_type& g = faces_[faces_[visible[k]].nbr[i]];
+      if (g.visit != stamp_) {
+        g.visit = stamp_;
+        g.visible = distance(g, eye) > tol_;
+        if (g.visible)
+          visible.push_back(faces_[visible[k]].nbr[i]);
+      }
+    }
+
+  // a new face from each edge of the horizon to eye
+  std::vector<std::pair<unsigned, unsigned> > from, to; // first and second corner of each new face
+  std::vector<unsigned> added;
+  for (unsigned k = 0; k < visible.size(); ++k)
+    for (unsigned i = 0; i < 3; ++i) {
+      const unsigned vf = visible[k], g = faces_[vf].nbr[i];
+      if (faces_[g].visible)
+        continue;
+      const unsigned a = faces_[vf].v[i], b = faces_[vf].v[(i + 1) % 3];
+      const unsigned nf = (unsigned)faces_.size();
+      faces_.push_back(face_type());
+      set_face(faces_[nf], a, b, eye);
+      faces_[nf].nbr[0] = g;
+      for (unsigned j = 0; j < 3; ++j)
+        if (faces_[g].nbr[j] == vf && faces_[g].v[j] == b)
+          faces_[g].nbr[j] = nf;
+      from.push_back(std::make_pair(a, nf));
+      to.push_back(std::make_pair(b, nf));
+      added.push_back(nf);
+    }
+  std::sort(from.begin(), from.end());
+  std::sort(to.begin(), to.end());
+  for (unsigned k = 0; k < added.size(); ++k) {
+    face_type& f = faces_[added[k]];
+    // across b -> eye is the new face starting at b; across eye -> a the one ending at a
+    std::vector<std::pair<unsigned, unsigned> >::const_iterator s = std::lower_bound(from.begin(), from.end(), std::make_pair(f.v[1], 0u));
+    std::vector<std::pair<unsigned, unsigned> >::const_iterator e = std::lower_bound(to.begin(), to.end(), std::make_pair(f.v[0], 0u));
+    assert(s != from.end() && s->first == f.v[1] && e != to.end() && e->first == f.v[0]);
+    f.nbr[1] = s->second;
+    f.nbr[2] = e->second;
+  }
+
+  // pass the points outside the visible faces on to the new faces
+  for (unsigned k = 0; k < visible.size(); ++k) {
+    std::vector<unsigned> out;
+    out.swap(faces_[visible[k]].outside);
+    faces_[visible[k]].alive = false;
+    for (unsigned j = 0; j < out.size(); ++j) {
+      if (out[j] == eye)
+        continue;
+      int best = -1;
+      double best_d = tol_;
+      for (unsigned a = 0; a < added.size(); ++a) {
+        const double d = distance(faces_[added[a]], out[j]);
+        if (d > best_d) { best_d = d; best = int(added[a]); }
+      }
+      if (best >= 0)
+        faces_[best].outside.push_back(out[j]);
+    }
+  }
+}
+
+template <class T>
+void vgl_convex_hull_3d<T>::compact()
+{
+  std::vector<unsigned> map(faces_.size());
+  unsigned m = 0;
+  for (unsigned f = 0; f < faces_.size(); ++f)
+    if (faces_[f].alive)
+      map[f] = m++;
+  std::vector<face_type> kept;
+  kept.reserve(m);
+  for (unsigned f = 0; f < faces_.size(); ++f)
+    if (faces_[f].alive) {
+      kept.push_back(faces_[f]);
+      for (unsigned i = 0; i < 3; ++i)
+        kept.back().nbr[i] = map[kept.back().nbr[i]];
+    }
+  faces_.swap(kept);
+}
+
+template <class T>
+void vgl_convex_hull_3d<T>::vertices(std::vector<unsigned>& v) const
+{
+  v.clear();
+  const unsigned n = num_points();
+  if (dim_ == 0)
+    v.push_back(origin_);
+  else if (dim_ == 1) {
+    // the end points along the line
+    unsigned lo = 0, hi = 0;
+    double tlo = std::numeric_limits<double>::infinity(), thi = -tlo;
+    for (unsigned i = 0; i < n; ++i) {
+      const double t = (double(x_[i]) - x_[origin_]) * dir_[0] + (double(y_[i]) - y_[origin_]) * dir_[1] +
+                       (double(z_[i]) - z_[origin_]) * dir_[2];
+      if (t < tlo) { tlo = t; lo = i; }
+      if (t > thi) { thi = t; hi = i; }
+    }
+    v.push_back(lo);
+    v.push_back(hi);
+  }
+  else if (dim_ == 2) {
+    // the 2-d hull in the plane, with axes e1, e2 such that e1 x e2 is the normal
+    const double ax = std::fabs(dir_[0]) < 0.9 ? 1.0 : 0.0, ay = 1.0 - ax;
+    double e1[3] = { ay * dir_[2], -ax * dir_[2], ax * dir_[1] - ay * dir_[0] };
+    const double l = std::sqrt(e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2]);
+    for (unsigned k = 0; k < 3; ++k) e1[k] /= l;
+    const double e2[3] = { dir_[1] * e1[2] - dir_[2] * e1[1], dir_[2] * e1[0] - dir_[0] * e1[2],
+                           dir_[0] * e1[1] - dir_[1] * e1[0] };
+    std::vector<double> s(n), t(n);
+    for (unsigned i = 0; i < n; ++i) {
+      const double dx = double(x_[i]) - x_[origin_], dy = double(y_[i]) - y_[origin_], dz = double(z_[i]) - z_[origin_];
+      s[i] = dx * e1[0] + dy * e1[1] + dz * e1[2];
+      t[i] = dx * e2[0] + dy * e2[1] + dz * e2[2];
+    }
+    vgl_convex_hull_indices_2d(&s[0], &t[0], n, v);
+  }
+  else if (dim_ == 3) {
+    for (unsigned f = 0; f < faces_.size(); ++f)
+      v.insert(v.end(), faces_[f].v, faces_[f].v + 3);
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+  }
+}
+
+template <class T>
+void vgl_convex_hull_3d<T>::faces(std::vector<unsigned>& tris) const
+{
+  tris.resize(3 * faces_.size());
+  for (unsigned f = 0; f < faces_.size(); ++f)
+    for (unsigned i = 0; i < 3; ++i)
+      tris[3 * f + i] = faces_[f].v[i];
+}
+
+template <class T>
+bool vgl_convex_hull_3d<T>::contains(vgl_point_3d<T> const& p) const
+{
+  if (dim_ < 3)
+    return false;
+  const double px = p.x(), py = p.y(), pz = p.z();
+  for (unsigned f = 0; f < faces_.size(); ++f) {
+    face_type const& ff = faces_[f];
+    if (ff.n[0] * px + ff.n[1] * py + ff.n[2] * pz - ff.d > tol_)
+      return false;
+  }
+  return true;
+}
+
+template <class T>
+double vgl_convex_hull_3d<T>::volume() const
+{
+  if (dim_ < 3)
+    return 0;
+  const unsigned o = faces_[0].v[0];
+  double v = 0;
+  for (unsigned f = 0; f < faces_.size(); ++f) {
+    const unsigned a = faces_[f].v[0], b = faces_[f].v[1], c = faces_[f].v[2];
+    const double ax = double(x_[a]) - x_[o], ay = double(y_[a]) - y_[o], az = double(z_[a]) - z_[o];
+    const double bx = double(x_[b]) - x_[o], by = double(y_[b]) - y_[o], bz = double(z_[b]) - z_[o];
+    const double cx = double(x_[c]) - x_[o], cy = double(y_[c]) - y_[o], cz = double(z_[c]) - z_[o];
+    v += ax * (by * cz - bz * cy) + ay * (bz * cx - bx * cz) + az * (bx * cy - by * cx);
+  }
+  return v / 6;
+}
+
+#undef VGL_CONVEX_HULL_3D_INSTANTIATE
+#define VGL_CONVEX_HULL_3D_INSTANTIATE(T) \
+template class vgl_convex_hull_3d<T >
+
+#endif // vgl_convex_hull_3d_hxx_
@@ -0,0 +1,47 @@
+// This is core/vgl/algo/vgl_convex_hull_indices_2d.h
+#ifndef vgl_convex_hull_indices_2d_h_
+#define vgl_convex_hull_indices_2d_h_
+//:
+// \file
+// \brief Convex hull of a large 2-d point set, as indices into the points
+//
+//    vgl_convex_hull_2d sorts a copy of every point and returns a polygon
+//    of copied points.  For footprints of point clouds of millions of
+//    points, almost all of which lie well inside the hull, that is wasted
+//    work.  vgl_convex_hull_indices_2d first finds the extreme points in
+//    eight directions and discards every point strictly inside the
+//    octagon they form (Akl and Toussaint), so that the remaining work
+//    depends mostly on the size of the hull rather than of the input.
+//    The survivors are divided into blocks, the hull of each block is
+//    found by Andrew's monotone chain, and the block hulls are merged by
+//    one more monotone chain.  When compiled with OpenMP the filtering
+//    and the block hulls run in parallel; the result does not depend on
+//    the number of threads.
+//
+//    The hull is returned as the indices of its vertices, counterclockwise
+//    from the one of least x (and least y among those).  Points inside
+//    hull edges are not vertices.  Of coincident points the one with the
+//    least index is used.  The hull of collinear points is their two end
+//    points, and that of coincident points one of them.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vector>
+#include <vcl_compiler.h>
+#include <vgl/vgl_point_2d.h>
+
+//: Indices of the vertices of the convex hull of the points (x[i], y[i]), 0 <= i < n.
+//  The coordinates may be the x() and y() arrays of a vgl_point_cloud_3d,
+//  for the hull of its footprint.
+template <class T>
+void vgl_convex_hull_indices_2d(T const* x, T const* y, unsigned n, std::vector<unsigned>& hull);
+
+//: Indices of the vertices of the convex hull of points.
+template <class T>
+void vgl_convex_hull_indices_2d(std::vector<vgl_point_2d<T> > const& points, std::vector<unsigned>& hull);
+
+#define VGL_CONVEX_HULL_INDICES_2D_INSTANTIATE(T) extern "please include vgl/algo/vgl_convex_hull_indices_2d.hxx first"
+
+#endif // vgl_convex_hull_indices_2d_h_
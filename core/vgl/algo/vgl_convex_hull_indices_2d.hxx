@@ -0,0 +1,163 @@
+// This is core/vgl/algo/vgl_convex_hull_indices_2d.hxx
+#ifndef vgl_convex_hull_indices_2d_hxx_
+#define vgl_convex_hull_indices_2d_hxx_
+//:
+// \file
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "vgl_convex_hull_indices_2d.h"
+#include <vcl_compiler.h>
+
+//: Points are filtered, and block hulls found, in blocks of this many
+static const unsigned vgl_convex_hull_indices_2d_block = 1u << 16;
+
+//: Orders point indices by x, then y, then index
+template <class T>
+struct vgl_convex_hull_indices_2d_less
+{
+  T const* x;
+  T const* y;
+  vgl_convex_hull_indices_2d_less(T const* x_, T const* y_) : x(x_), y(y_) {}
+  bool operator()(unsigned i, unsigned j) const
+  {
+    return x[i] < x[j] || (x[i] == x[j] && (y[i] < y[j] || (y[i] == y[j] && i < j)));
+  }
+};
+
+//: Twice the signed area of the triangle a, b, c; positive if counterclockwise
+template <class T>
+static inline double vgl_convex_hull_indices_2d_turn(T const* x, T const* y, unsigned a, unsigned b, unsigned c)
+{
+  return (double(x[b]) - double(x[a])) * (double(y[c]) - double(y[a])) -
+         (double(y[b]) - double(y[a])) * (double(x[c]) - double(x[a]));
+}
+
+//: Replace idx by the hull of the points it indexes, counterclockwise from the least.
+template <class T>
+static void vgl_convex_hull_indices_2d_chain(T const* x, T const* y, std::vector<unsigned>& idx)
+{
+  std::sort(idx.begin(), idx.end(), vgl_convex_hull_indices_2d_less<T>(x, y));
+  // drop coincident points, keeping the least index
+  unsigned m = 0;
+  for (unsigned k = 0; k < idx.size(); ++k)
+    if (m == 0 || x[idx[k]] != x[idx[m - 1]] || y[idx[k]] != y[idx[m - 1]])
+      idx[m++] = idx[k];
+  idx.resize(m);
+  if (m < 3)
+    return;
+
+  // lower chain left to right, then upper chain right to left
+  std::vector<unsigned> h(2 * m);
+  unsigned s = 0;
+  for (unsigned k = 0; k < m; ++k) {
+    while (s >= 2 && vgl_convex_hull_indices_2d_turn(x, y, h[s - 2], h[s - 1], idx[k]) <= 0)
+      --s;
+    h[s++] = idx[k];
+  }
+  for (unsigned k = m - 1, lower = s + 1; k-- > 0;) {
+    while (s >= lower && vgl_convex_hull_indices_2d_turn(x, y, h[s - 2], h[s - 1], idx[k]) <= 0)
+      --s;
+    h[s++] = idx[k];
+  }
+  h.resize(s - 1); // the last is the first again
+  idx.swap(h);
+}
+
+template <class T>
+void vgl_convex_hull_indices_2d(T const* x, T const* y, unsigned n, std::vector<unsigned>& hull)
+{
+  hull.clear();
+  if (n == 0)
+    return;
+  const unsigned B = vgl_convex_hull_indices_2d_block;
+  const int n_blocks = int((n + B - 1) / B);
+
+  // Extreme points along x, x+y, y, y-x, -x, -x-y, -y and x-y, in each
+  // block and then overall: an octagon inside the hull, counterclockwise.
+  std::vector<unsigned> block_extreme(8 * n_blocks);
+#if defined(_OPENMP)
+#pragma omp parallel for
+#endif
+  for (int b = 0; b < n_blocks; ++b) {
+    const unsigned first = b * B, last = std::min(n, first + B);
+    unsigned* e = &block_extreme[8 * b];
+    double best[8];
+    for (unsigned d = 0; d < 8; ++d) {
+      e[d] = first;
+      best[d] = -std::numeric_limits<double>::infinity();
+    }
+    for (unsigned i = first; i < last; ++i) {
+      const double px = x[i], py = y[i];
+      const double v[8] = { px, px + py, py, py - px, -px, -px - py, -py, px - py };
+      for (unsigned d = 0; d < 8; ++d)
+        if (v[d] > best[d]) { best[d] = v[d]; e[d] = i; }
+    }
+  }
+  unsigned oct[8];
+  for (unsigned d = 0; d < 8; ++d) {
+    oct[d] = block_extreme[d];
+    for (int b = 1; b < n_blocks; ++b) {
+      const unsigned i = block_extreme[8 * b + d], j = oct[d];
+      const double px = x[i], py = y[i], qx = x[j], qy = y[j];
+      const double v[8] = { px, px + py, py, py - px, -px, -px - py, -py, px - py };
+      const double w[8] = { qx, qx + qy, qy, qy - qx, -qx, -qx - qy, -qy, qx - qy };
+      if (v[d] > w[d])
+        oct[d] = i;
+    }
+  }
+  // distinct corners of the octagon, and the sizes of its edges for rounding errors
+  unsigned corner[8], n_corners = 0;
+  for (unsigned d = 0; d < 8; ++d)
+    if (n_corners == 0 || (x[oct[d]] != x[corner[n_corners - 1]] || y[oct[d]] != y[corner[n_corners - 1]]))
+      corner[n_corners++] = oct[d];
+  while (n_corners > 1 && x[corner[n_corners - 1]] == x[corner[0]] && y[corner[n_corners - 1]] == y[corner[0]])
+    --n_corners;
+  double scale = 0;
+  for (unsigned c = 0; c < n_corners; ++c)
+    scale = std::max(scale, std::max(std::fabs(double(x[corner[c]])), std::fabs(double(y[corner[c]]))));
+  const double tol = 16 * std::numeric_limits<double>::epsilon() * scale * scale;
+
+  // Survivors of each block: the points not strictly inside the octagon
+  std::vector<std::vector<unsigned> > survivors(n_blocks);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int b = 0; b < n_blocks; ++b) {
+    const unsigned first = b * B, last = std::min(n, first + B);
+    std::vector<unsigned>& s = survivors[b];
+    for (unsigned i = first; i < last; ++i) {
+      bool inside = n_corners >= 3;
+      for (unsigned c = 0; c < n_corners && inside; ++c)
+        inside = vgl_convex_hull_indices_2d_turn(x, y, corner[c], corner[(c + 1) % n_corners], i) > tol;
+      if (!inside)
+        s.push_back(i);
+    }
+    vgl_convex_hull_indices_2d_chain(x, y, s);
+  }
+
+  // Merge the block hulls
+  for (int b = 0; b < n_blocks; ++b)
+    hull.insert(hull.end(), survivors[b].begin(), survivors[b].end());
+  vgl_convex_hull_indices_2d_chain(x, y, hull);
+}
+
+template <class T>
+void vgl_convex_hull_indices_2d(std::vector<vgl_point_2d<T> > const& points, std::vector<unsigned>& hull)
+{
+  const unsigned n = (unsigned)points.size();
+  std::vector<T> x(n), y(n);
+  for (unsigned i = 0; i < n; ++i) {
+    x[i] = points[i].x();
+    y[i] = points[i].y();
+  }
+  vgl_convex_hull_indices_2d(n ? &x[0] : (T const*)VXL_NULLPTR, n ? &y[0] : (T const*)VXL_NULLPTR, n, hull);
+}
+
+#undef VGL_CONVEX_HULL_INDICES_2D_INSTANTIATE
+#define VGL_CONVEX_HULL_INDICES_2D_INSTANTIATE(T) \
+template void vgl_convex_hull_indices_2d(T const*, T const*, unsigned, std::vector<unsigned>&); \
+template void vgl_convex_hull_indices_2d(std::vector<vgl_point_2d<T > > const&, std::vector<unsigned>&)
+
+#endif // vgl_convex_hull_indices_2d_hxx_
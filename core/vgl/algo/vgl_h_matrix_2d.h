@@ -27,6 +27,7 @@
 #include <vgl/vgl_homg_point_2d.h>
 #include <vgl/vgl_homg_line_2d.h>
 #include <vgl/vgl_conic.h>
+#include <vgl/algo/vgl_projective_map.h>
 #include <vcl_compiler.h>
 
 //:
@@ -69,6 +70,14 @@ class vgl_h_matrix_2d
   //: Return the transformed point given by $q = {\tt H} p$
   vgl_homg_point_2d<T> operator*(vgl_homg_point_2d<T> const& p) const { return (*this)(p);}
 
+  //: Map the points (x[i], y[i]) to (u[i], v[i]), 0 <= i < n, all at once.
+  //  u and v may be x and y, to map the points in place; see vgl_projective_map.h
+  void map_points(T const* x, T const* y, T* u, T* v, unsigned n) const
+  { vgl_projective_map_2d(t12_matrix_.data_block(), x, y, u, v, n); }
+  //: Map the n interleaved points xy = (x0, y0, x1, y1, ...) into uv, all at once
+  void map_points(T const* xy, T* uv, unsigned n) const
+  { vgl_projective_map_2d(t12_matrix_.data_block(), xy, uv, n); }
+
   bool operator==(vgl_h_matrix_2d<T> const& M) const { return t12_matrix_ == M.get_matrix(); }
 
   //: Return the transformed line given by $m = {\tt H} l$
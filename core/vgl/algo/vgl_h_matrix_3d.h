@@ -26,6 +26,7 @@
 #include <vgl/vgl_homg_point_3d.h>
 #include <vgl/vgl_homg_plane_3d.h>
 #include <vgl/vgl_pointset_3d.h>
+#include <vgl/algo/vgl_projective_map.h>
 #include <vcl_compiler.h>
 
 //:
@@ -80,6 +81,14 @@ class vgl_h_matrix_3d
 
   vgl_pointset_3d<T> operator()(vgl_pointset_3d<T> const& ptset) const;
 
+  //: Map the points (x[i], y[i], z[i]) to (u[i], v[i], w[i]), 0 <= i < n, all at once.
+  //  u, v and w may be x, y and z, to map the points in place; see vgl_projective_map.h
+  void map_points(T const* x, T const* y, T const* z, T* u, T* v, T* w, unsigned n) const
+  { vgl_projective_map_3d(t12_matrix_.data_block(), x, y, z, u, v, w, n); }
+  //: Map the n interleaved points xyz = (x0, y0, z0, x1, ...) into uvw, all at once
+  void map_points(T const* xyz, T* uvw, unsigned n) const
+  { vgl_projective_map_3d(t12_matrix_.data_block(), xyz, uvw, n); }
+
   //the following require computing the inverse homography
 
   //: Return the preimage of a transformed point: $p = {\tt H}^{-1} q$
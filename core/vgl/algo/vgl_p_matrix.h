@@ -43,6 +43,7 @@
 #include <vgl/vgl_line_segment_3d.h>
 #include <vgl/algo/vgl_homg_operators_3d.h> //for p_matrix_ * vgl_homg_point_3d
 #include <vgl/algo/vgl_h_matrix_3d.h>
+#include <vgl/algo/vgl_projective_map.h>
 
 template <class T>
 class vgl_p_matrix
@@ -87,6 +88,13 @@ class vgl_p_matrix
   vgl_homg_point_2d<T>   operator()(vgl_homg_point_3d<T> const& X) const { return p_matrix_ * X; }
   //: Return the image point which is the projection of the specified 3D point X
   vgl_homg_point_2d<T>   operator*(vgl_homg_point_3d<T> const& X) const { return (*this)(X); }
+  //: Project the points (x[i], y[i], z[i]) to the image points (u[i], v[i]), 0 <= i < n, all at once.
+  //  See vgl_projective_map.h
+  void project(T const* x, T const* y, T const* z, T* u, T* v, unsigned n) const
+  { vgl_projective_project_3d(p_matrix_.data_block(), x, y, z, u, v, n); }
+  //: Project the n interleaved points xyz = (x0, y0, z0, x1, ...) to the interleaved image points uv
+  void project(T const* xyz, T* uv, unsigned n) const
+  { vgl_projective_project_3d(p_matrix_.data_block(), xyz, uv, n); }
   //: Return the image line which is the projection of the specified 3D line L
   vgl_homg_line_2d<T>    operator()(vgl_homg_line_3d_2_points<T> const& L) const;
   //: Return the image line which is the projection of the specified 3D line L
@@ -0,0 +1,129 @@
+// This is core/vgl/algo/vgl_packed_rtree.h
+#ifndef vgl_packed_rtree_h_
+#define vgl_packed_rtree_h_
+//:
+// \file
+// \brief Static rtree, bulk loaded and packed into contiguous arrays
+//
+//    vgl_rtree is built by inserting one element at a time, and each node
+//    is a separate heap block, which is slow to build for large data sets
+//    and scatters a query over memory.  vgl_packed_rtree is built once from
+//    all its elements, by Sort-Tile-Recursive (STR) or Hilbert curve
+//    ordering, with each node filled to capacity.  The nodes are stored in
+//    one array, root first and level by level, and the elements in another
+//    in leaf order, so a query walks through memory mostly forwards.
+//
+//    The tree uses the same V, B and C types as vgl_rtree (see
+//    vgl_rtree_c.h for examples), and can be queried with a region of type
+//    B or a vgl_rtree_probe.  It cannot be modified after it is built.
+//
+//    When compiled with OpenMP, the bounds, sorts of the STR slabs and
+//    batched queries run on several threads.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vector>
+#include <vcl_compiler.h>
+#include <vgl/algo/vgl_rtree.h>
+
+//: Static rtree, bulk loaded and packed into contiguous arrays.
+//  V, B and C are as for vgl_rtree, except that C::volume is not used.
+//  The build orders elements by the centres of their bounds, so B must
+//  also provide
+//  \code
+//    double B::centroid_x() const;
+//    double B::centroid_y() const;
+//  \endcode
+//  as vgl_box_2d and vgl_bbox_2d do (any arithmetic return type will do).
+//
+//  A query by a point is a query by a region of type B holding just that
+//  point, e.g. vgl_box_2d<T>(p, p).
+template <class V, class B, class C>
+class vgl_packed_rtree
+{
+ public:
+  //: How elements are grouped into nodes.
+  //  sort_tile_recursive sorts on x, cuts the elements into vertical slabs
+  //  and sorts each slab on y; it usually gives slightly better queries.
+  //  hilbert sorts along a Hilbert curve through the centres, which is
+  //  cheaper to build.
+  enum build_method { sort_tile_recursive, hilbert };
+
+  typedef vgl_rtree_probe<V, B, C> probe;
+
+  //: Empty tree whose nodes will have up to node_capacity children.
+  explicit vgl_packed_rtree(unsigned node_capacity = 16);
+
+  //: Tree holding the elements of vs.
+  vgl_packed_rtree(std::vector<V> const& vs, build_method method = sort_tile_recursive,
+                   unsigned node_capacity = 16);
+
+  //: Replace the contents of the tree by the elements of vs.
+  void build(std::vector<V> const& vs, build_method method = sort_tile_recursive);
+
+  //: Append the elements which meet the given region to vs.
+  void get(B const& region, std::vector<V>& vs) const;
+
+  //: Append the elements which meet the given probe to vs.
+  void get(probe const& region, std::vector<V>& vs) const;
+
+  //: Append the positions, in the vector the tree was built from, of the elements meeting the region.
+  void get_indices(B const& region, std::vector<unsigned>& indices) const;
+
+  //: Append the positions of the elements meeting the probe.
+  void get_indices(probe const& region, std::vector<unsigned>& indices) const;
+
+  //: Query each of the regions; vs[i] is set to the elements meeting regions[i].
+  void get(std::vector<B> const& regions, std::vector<std::vector<V> >& vs) const;
+
+  //: Query each of the regions; indices[i] is set to the positions of the elements meeting regions[i].
+  void get_indices(std::vector<B> const& regions, std::vector<std::vector<unsigned> >& indices) const;
+
+  //: Append all elements, in leaf order, to vs.
+  void get_all(std::vector<V>& vs) const { vs.insert(vs.end(), vts_.begin(), vts_.end()); }
+
+  //: Bounds of all elements; only valid if the tree is not empty.
+  B const& bounds() const { return nodes_[0].bounds; }
+
+  //: return true iff the tree has no elements.
+  bool empty() const { return vts_.empty(); }
+
+  //: return number of elements stored in the tree.
+  unsigned size() const { return (unsigned)vts_.size(); }
+
+  //: return number of nodes used by the tree.
+  unsigned nodes() const { return (unsigned)nodes_.size(); }
+
+  //: Maximum number of children, or elements, of a node.
+  unsigned node_capacity() const { return capacity_; }
+
+ private:
+  struct node_type
+  {
+    B bounds;
+    //: First child, in nodes_, or first element, in vts_, for a leaf.
+    unsigned first;
+    unsigned count;
+  };
+
+  //: Positions in vts_ of the elements meeting region, or if it is null, p.
+  void search(B const* region, probe const* p, std::vector<unsigned>& pos) const;
+
+  //: Group items with the given bounds and centres into nodes.
+  void order(std::vector<double> const& cx, std::vector<double> const& cy,
+             build_method method, std::vector<unsigned>& perm) const;
+
+  unsigned capacity_;
+  //: Nodes, root first; nodes from leaf_begin_ on are leaves.
+  std::vector<node_type> nodes_;
+  unsigned leaf_begin_;
+  //: Elements in leaf order, and their positions in the input.
+  std::vector<V> vts_;
+  std::vector<unsigned> idx_;
+};
+
+#define VGL_PACKED_RTREE_INSTANTIATE(V, B, C) extern "please include vgl/algo/vgl_packed_rtree.hxx first"
+
+#endif // vgl_packed_rtree_h_
@@ -0,0 +1,280 @@
+// This is core/vgl/algo/vgl_packed_rtree.hxx
+#ifndef vgl_packed_rtree_hxx_
+#define vgl_packed_rtree_hxx_
+//:
+// \file
+
+#include <algorithm>
+#include <cmath>
+#include "vgl_packed_rtree.h"
+#include <vcl_compiler.h>
+
+//: Orders item indices on the values of a key array.
+struct vgl_packed_rtree_key_less
+{
+  std::vector<double> const* key;
+  explicit vgl_packed_rtree_key_less(std::vector<double> const& k) : key(&k) {}
+  bool operator()(unsigned a, unsigned b) const { return (*key)[a] < (*key)[b]; }
+};
+
+//: Distance along a Hilbert curve through a 2^16 x 2^16 grid.
+inline double vgl_packed_rtree_hilbert_key(unsigned x, unsigned y)
+{
+  const unsigned n = 1u << 16;
+  double d = 0;
+  for (unsigned s = n / 2; s > 0; s /= 2) {
+    unsigned rx = (x & s) ? 1 : 0, ry = (y & s) ? 1 : 0;
+    d += double(s) * double(s) * double((3 * rx) ^ ry);
+    if (ry == 0) { // rotate the quadrant
+      if (rx == 1) { x = n - 1 - x; y = n - 1 - y; }
+      unsigned t = x; x = y; y = t;
+    }
+  }
+  return d;
+}
+
+template <class V, class B, class C>
+vgl_packed_rtree<V, B, C>::vgl_packed_rtree(unsigned node_capacity)
+  : capacity_(node_capacity < 2 ? 2 : node_capacity), leaf_begin_(0)
+{
+}
+
+template <class V, class B, class C>
+vgl_packed_rtree<V, B, C>::vgl_packed_rtree(std::vector<V> const& vs, build_method method,
+                                            unsigned node_capacity)
+  : capacity_(node_capacity < 2 ? 2 : node_capacity), leaf_begin_(0)
+{
+  build(vs, method);
+}
+
+template <class V, class B, class C>
+void vgl_packed_rtree<V, B, C>::order(std::vector<double> const& cx, std::vector<double> const& cy,
+                                      build_method method, std::vector<unsigned>& perm) const
+{
+  const int n = (int)cx.size();
+  perm.resize(n);
+  for (int i = 0; i < n; ++i)
+    perm[i] = i;
+  if (n <= (int)capacity_)
+    return;
+
+  if (method == hilbert) {
+    double x0 = cx[0], x1 = cx[0], y0 = cy[0], y1 = cy[0];
+    for (int i = 1; i < n; ++i) {
+      x0 = std::min(x0, cx[i]); x1 = std::max(x1, cx[i]);
+      y0 = std::min(y0, cy[i]); y1 = std::max(y1, cy[i]);
+    }
+    const double sx = x1 > x0 ? 65535.0 / (x1 - x0) : 0;
+    const double sy = y1 > y0 ? 65535.0 / (y1 - y0) : 0;
+    std::vector<double> key(n);
+#if defined(_OPENMP)
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < n; ++i)
+      key[i] = vgl_packed_rtree_hilbert_key(unsigned((cx[i] - x0) * sx), unsigned((cy[i] - y0) * sy));
+    std::stable_sort(perm.begin(), perm.end(), vgl_packed_rtree_key_less(key));
+    return;
+  }
+
+  // Sort-Tile-Recursive: sqrt(#nodes) slabs of whole nodes along x,
+  // then each slab along y.
+  std::sort(perm.begin(), perm.end(), vgl_packed_rtree_key_less(cx));
+  const int n_nodes = (n + capacity_ - 1) / capacity_;
+  const int slab = int(std::ceil(std::sqrt(double(n_nodes)))) * capacity_;
+  const int n_slabs = (n + slab - 1) / slab;
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int s = 0; s < n_slabs; ++s)
+    std::sort(perm.begin() + s * slab, perm.begin() + std::min(n, (s + 1) * slab),
+              vgl_packed_rtree_key_less(cy));
+}
+
+template <class V, class B, class C>
+void vgl_packed_rtree<V, B, C>::build(std::vector<V> const& vs, build_method method)
+{
+  nodes_.clear();
+  vts_.clear();
+  idx_.clear();
+  leaf_begin_ = 0;
+  const int n = (int)vs.size();
+  if (n == 0)
+    return;
+  const int M = capacity_;
+
+  // Order the elements and pack them into leaves.
+  std::vector<B> vb(n);
+  std::vector<double> cx(n), cy(n);
+#if defined(_OPENMP)
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < n; ++i) {
+    C::init(vb[i], vs[i]);
+    cx[i] = double(vb[i].centroid_x());
+    cy[i] = double(vb[i].centroid_y());
+  }
+  order(cx, cy, method, idx_);
+  vts_.resize(n);
+  for (int i = 0; i < n; ++i)
+    vts_[i] = vs[idx_[i]];
+
+  std::vector<std::vector<node_type> > levels(1);
+  levels[0].resize((n + M - 1) / M);
+  const int n_leaves = (int)levels[0].size();
+#if defined(_OPENMP)
+#pragma omp parallel for
+#endif
+  for (int j = 0; j < n_leaves; ++j) {
+    node_type& nd = levels[0][j];
+    nd.first = j * M;
+    nd.count = std::min(M, n - j * M);
+    nd.bounds = vb[idx_[nd.first]];
+    for (unsigned k = 1; k < nd.count; ++k)
+      C::update(nd.bounds, vb[idx_[nd.first + k]]);
+  }
+
+  // Pack each level into nodes of the level above, until one is left.
+  // The Hilbert order of the leaves already suits the upper levels; STR
+  // tiles each level again.
+  std::vector<unsigned> perm;
+  while (levels.back().size() > 1) {
+    const int nb = (int)levels.back().size();
+    if (method == sort_tile_recursive) {
+      std::vector<node_type>& below = levels.back();
+      for (int i = 0; i < nb; ++i) {
+        cx[i] = double(below[i].bounds.centroid_x());
+        cy[i] = double(below[i].bounds.centroid_y());
+      }
+      cx.resize(nb); cy.resize(nb);
+      order(cx, cy, method, perm);
+      std::vector<node_type> sorted(nb);
+      for (int i = 0; i < nb; ++i)
+        sorted[i] = below[perm[i]];
+      below.swap(sorted);
+    }
+    std::vector<node_type> above((nb + M - 1) / M);
+    std::vector<node_type> const& below = levels.back();
+    for (int j = 0; j < (int)above.size(); ++j) {
+      node_type& nd = above[j];
+      nd.first = j * M;
+      nd.count = std::min(M, nb - j * M);
+      nd.bounds = below[nd.first].bounds;
+      for (unsigned k = 1; k < nd.count; ++k)
+        C::update(nd.bounds, below[nd.first + k].bounds);
+    }
+    levels.push_back(above);
+  }
+
+  // Store the levels root first; children of a level follow it.
+  unsigned offset = 0;
+  for (int l = (int)levels.size() - 1; l >= 0; --l) {
+    const unsigned next = offset + (unsigned)levels[l].size();
+    for (unsigned j = 0; j < levels[l].size(); ++j) {
+      node_type nd = levels[l][j];
+      if (l > 0)
+        nd.first += next;
+      nodes_.push_back(nd);
+    }
+    if (l == 0)
+      leaf_begin_ = offset;
+    offset = next;
+  }
+}
+
+template <class V, class B, class C>
+void vgl_packed_rtree<V, B, C>::search(B const* region, probe const* p, std::vector<unsigned>& pos) const
+{
+  if (nodes_.empty())
+    return;
+  std::vector<unsigned> stack;
+  if (region ? C::meet(*region, nodes_[0].bounds) : p->meets(nodes_[0].bounds))
+    stack.push_back(0);
+  while (!stack.empty()) {
+    node_type const& nd = nodes_[stack.back()];
+    const bool leaf = stack.back() >= leaf_begin_;
+    stack.pop_back();
+    const unsigned end = nd.first + nd.count;
+    if (leaf) {
+      for (unsigned i = nd.first; i < end; ++i)
+        if (region ? C::meet(*region, vts_[i]) : p->meets(vts_[i]))
+          pos.push_back(i);
+    }
+    else {
+      // push in reverse so that children are visited in storage order
+      for (unsigned i = end; i-- > nd.first; )
+        if (region ? C::meet(*region, nodes_[i].bounds) : p->meets(nodes_[i].bounds))
+          stack.push_back(i);
+    }
+  }
+}
+
+template <class V, class B, class C>
+void vgl_packed_rtree<V, B, C>::get(B const& region, std::vector<V>& vs) const
+{
+  std::vector<unsigned> pos;
+  search(&region, VXL_NULLPTR, pos);
+  for (unsigned i = 0; i < pos.size(); ++i)
+    vs.push_back(vts_[pos[i]]);
+}
+
+template <class V, class B, class C>
+void vgl_packed_rtree<V, B, C>::get(probe const& region, std::vector<V>& vs) const
+{
+  std::vector<unsigned> pos;
+  search(VXL_NULLPTR, &region, pos);
+  for (unsigned i = 0; i < pos.size(); ++i)
+    vs.push_back(vts_[pos[i]]);
+}
+
+template <class V, class B, class C>
+void vgl_packed_rtree<V, B, C>::get_indices(B const& region, std::vector<unsigned>& indices) const
+{
+  std::vector<unsigned> pos;
+  search(&region, VXL_NULLPTR, pos);
+  for (unsigned i = 0; i < pos.size(); ++i)
+    indices.push_back(idx_[pos[i]]);
+}
+
+template <class V, class B, class C>
+void vgl_packed_rtree<V, B, C>::get_indices(probe const& region, std::vector<unsigned>& indices) const
+{
+  std::vector<unsigned> pos;
+  search(VXL_NULLPTR, &region, pos);
+  for (unsigned i = 0; i < pos.size(); ++i)
+    indices.push_back(idx_[pos[i]]);
+}
+
+template <class V, class B, class C>
+void vgl_packed_rtree<V, B, C>::get(std::vector<B> const& regions, std::vector<std::vector<V> >& vs) const
+{
+  const int n = (int)regions.size();
+  vs.resize(n);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+  for (int i = 0; i < n; ++i) {
+    vs[i].clear();
+    get(regions[i], vs[i]);
+  }
+}
+
+template <class V, class B, class C>
+void vgl_packed_rtree<V, B, C>::get_indices(std::vector<B> const& regions,
+                                            std::vector<std::vector<unsigned> >& indices) const
+{
+  const int n = (int)regions.size();
+  indices.resize(n);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+  for (int i = 0; i < n; ++i) {
+    indices[i].clear();
+    get_indices(regions[i], indices[i]);
+  }
+}
+
+#undef VGL_PACKED_RTREE_INSTANTIATE
+#define VGL_PACKED_RTREE_INSTANTIATE(V, B, C) \
+template class vgl_packed_rtree<V, B, C >
+
+#endif // vgl_packed_rtree_hxx_
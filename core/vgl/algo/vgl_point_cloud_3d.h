@@ -0,0 +1,162 @@
+// This is core/vgl/algo/vgl_point_cloud_3d.h
+#ifndef vgl_point_cloud_3d_h_
+#define vgl_point_cloud_3d_h_
+//:
+// \file
+// \brief A 3-d point cloud stored as separate coordinate, normal and scalar arrays
+//
+//    vgl_pointset_3d keeps a vector of vgl_point_3d and one of normals.
+//    vgl_point_cloud_3d keeps each coordinate in its own array (structure
+//    of arrays): x, y and z, optionally the normal components nx, ny and nz,
+//    and any number of named scalar channels such as intensity.  Each array
+//    starts on a 32 byte boundary, so that loops over whole clouds, such as
+//    those of transform(), bounding_box() and centroid(), are vectorised by
+//    the compiler.
+//
+//    The arrays are accessed directly through x(), y(), ... without copying;
+//    the pointers stay valid until the cloud is resized.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vector>
+#include <string>
+#include <vcl_compiler.h>
+#include <vgl/vgl_point_3d.h>
+#include <vgl/vgl_vector_3d.h>
+#include <vgl/vgl_box_3d.h>
+#include <vgl/vgl_pointset_3d.h>
+#include <vgl/algo/vgl_rotation_3d.h>
+
+//: One array of a vgl_point_cloud_3d, aligned on 32 bytes.
+template <class T>
+class vgl_point_cloud_3d_channel
+{
+ public:
+  vgl_point_cloud_3d_channel() : raw_(VXL_NULLPTR), data_(VXL_NULLPTR) {}
+  ~vgl_point_cloud_3d_channel() { delete[] raw_; }
+
+  //: Change the capacity, keeping the first size elements; new elements are set to value.
+  void reallocate(unsigned size, unsigned capacity, T value = T(0));
+
+  T* data() { return data_; }
+  T const* data() const { return data_; }
+
+ private:
+  char* raw_;
+  T* data_;
+  // only the owner knows the size, so it does the copying
+  vgl_point_cloud_3d_channel(vgl_point_cloud_3d_channel<T> const&);
+  vgl_point_cloud_3d_channel<T>& operator=(vgl_point_cloud_3d_channel<T> const&);
+};
+
+//: A 3-d point cloud stored as separate coordinate, normal and scalar arrays
+template <class T>
+class vgl_point_cloud_3d
+{
+ public:
+  //: Empty cloud
+  vgl_point_cloud_3d();
+
+  //: Cloud of n points at the origin, with zero normals if with_normals.
+  explicit vgl_point_cloud_3d(unsigned n, bool with_normals = false);
+
+  //: Copy the points, and normals if any, of a vgl_pointset_3d.
+  explicit vgl_point_cloud_3d(vgl_pointset_3d<T> const& ps);
+
+  vgl_point_cloud_3d(vgl_point_cloud_3d<T> const& that);
+  vgl_point_cloud_3d<T>& operator=(vgl_point_cloud_3d<T> const& that);
+  ~vgl_point_cloud_3d();
+
+  //: Points and normals as a vgl_pointset_3d; scalar channels are dropped.
+  vgl_pointset_3d<T> as_pointset() const;
+
+  //: Number of points
+  unsigned size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  //: Change the number of points; new points are at the origin, with zero normals and scalars.
+  void resize(unsigned n);
+  //: Make room for n points without reallocating.
+  void reserve(unsigned n);
+  //: Remove all points; the channels are kept.
+  void clear() { size_ = 0; }
+
+  //: Append a point.  Its normal and scalars are zero.
+  void push_back(vgl_point_3d<T> const& p);
+  //: Append a point with a normal.  Adds the normal channels if there are none.
+  void push_back(vgl_point_3d<T> const& p, vgl_vector_3d<T> const& n);
+
+  bool has_normals() const { return has_normals_; }
+  //: Add (zero) or remove the normal channels.
+  void set_has_normals(bool on);
+
+  // Channels -----------------------------------------------------------------
+
+  T* x() { return ch_[0]->data(); }
+  T* y() { return ch_[1]->data(); }
+  T* z() { return ch_[2]->data(); }
+  T const* x() const { return ch_[0]->data(); }
+  T const* y() const { return ch_[1]->data(); }
+  T const* z() const { return ch_[2]->data(); }
+
+  //: Normal components; null unless has_normals().
+  T* nx() { return has_normals_ ? ch_[3]->data() : VXL_NULLPTR; }
+  T* ny() { return has_normals_ ? ch_[4]->data() : VXL_NULLPTR; }
+  T* nz() { return has_normals_ ? ch_[5]->data() : VXL_NULLPTR; }
+  T const* nx() const { return has_normals_ ? ch_[3]->data() : VXL_NULLPTR; }
+  T const* ny() const { return has_normals_ ? ch_[4]->data() : VXL_NULLPTR; }
+  T const* nz() const { return has_normals_ ? ch_[5]->data() : VXL_NULLPTR; }
+
+  //: Number of scalar channels
+  unsigned num_scalars() const { return (unsigned)names_.size(); }
+  //: Add a scalar channel with every value set to value, and return its index.
+  unsigned add_scalar(std::string const& name, T value = T(0));
+  //: Index of the named scalar channel, or -1 if there is none.
+  int scalar_index(std::string const& name) const;
+  std::string const& scalar_name(unsigned c) const { return names_[c]; }
+  T* scalar(unsigned c) { return ch_[6 + c]->data(); }
+  T const* scalar(unsigned c) const { return ch_[6 + c]->data(); }
+
+  // Element access -----------------------------------------------------------
+
+  vgl_point_3d<T> point(unsigned i) const { return vgl_point_3d<T>(x()[i], y()[i], z()[i]); }
+  void set_point(unsigned i, vgl_point_3d<T> const& p) { x()[i] = p.x(); y()[i] = p.y(); z()[i] = p.z(); }
+  //: Normal of point i; zero if there are no normals.
+  vgl_vector_3d<T> normal(unsigned i) const
+  { return has_normals_ ? vgl_vector_3d<T>(nx()[i], ny()[i], nz()[i]) : vgl_vector_3d<T>(); }
+  void set_normal(unsigned i, vgl_vector_3d<T> const& n) { nx()[i] = n.x(); ny()[i] = n.y(); nz()[i] = n.z(); }
+
+  // Operations ---------------------------------------------------------------
+
+  //: Replace each point p by s*R*p + t, and each normal n by R*n.
+  //  With s = 1 this is a rigid motion; the similarity estimated by
+  //  vgl_compute_similarity_3d is applied as
+  //  transform(c.rotation(), c.translation(), c.scale()).
+  void transform(vgl_rotation_3d<T> const& R, vgl_vector_3d<T> const& t, T s = T(1));
+
+  //: Add t to each point.
+  void translate(vgl_vector_3d<T> const& t);
+
+  //: Smallest box containing all points; empty if there are none.
+  vgl_box_3d<T> bounding_box() const;
+
+  //: Mean of the points, summed in double precision; the origin if there are none.
+  vgl_point_3d<T> centroid() const;
+
+ private:
+  void reallocate(unsigned capacity);
+
+  unsigned size_;
+  unsigned capacity_;
+  bool has_normals_;
+  //: x, y, z, nx, ny, nz, then the scalars.
+  //  The normal channels have no storage unless has_normals_.
+  std::vector<vgl_point_cloud_3d_channel<T>*> ch_;
+  std::vector<std::string> names_;
+};
+
+#define VGL_POINT_CLOUD_3D_INSTANTIATE(T) extern "please include vgl/algo/vgl_point_cloud_3d.hxx first"
+
+#endif // vgl_point_cloud_3d_h_
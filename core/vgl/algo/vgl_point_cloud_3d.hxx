@@ -0,0 +1,294 @@
+// This is core/vgl/algo/vgl_point_cloud_3d.hxx
+#ifndef vgl_point_cloud_3d_hxx_
+#define vgl_point_cloud_3d_hxx_
+//:
+// \file
+
+#include <algorithm>
+#include <cstddef>
+#include "vgl_point_cloud_3d.h"
+#include <vcl_compiler.h>
+#include <vcl_cassert.h>
+#include <vnl/vnl_matrix_fixed.h>
+
+template <class T>
+void vgl_point_cloud_3d_channel<T>::reallocate(unsigned size, unsigned capacity, T value)
+{
+  char* raw = capacity ? new char[capacity * sizeof(T) + 31] : VXL_NULLPTR;
+  T* data = VXL_NULLPTR;
+  if (raw) {
+    std::size_t a = reinterpret_cast<std::size_t>(raw);
+    data = reinterpret_cast<T*>(raw + ((32 - a % 32) % 32));
+    const unsigned keep = std::min(size, capacity);
+    if (data_)
+      std::copy(data_, data_ + keep, data);
+    std::fill(data + keep, data + capacity, value);
+  }
+  delete[] raw_;
+  raw_ = raw;
+  data_ = data;
+}
+
+template <class T>
+vgl_point_cloud_3d<T>::vgl_point_cloud_3d()
+  : size_(0), capacity_(0), has_normals_(false)
+{
+  for (int c = 0; c < 6; ++c)
+    ch_.push_back(new vgl_point_cloud_3d_channel<T>);
+}
+
+template <class T>
+vgl_point_cloud_3d<T>::vgl_point_cloud_3d(unsigned n, bool with_normals)
+  : size_(0), capacity_(0), has_normals_(with_normals)
+{
+  for (int c = 0; c < 6; ++c)
+    ch_.push_back(new vgl_point_cloud_3d_channel<T>);
+  resize(n);
+}
+
+template <class T>
+vgl_point_cloud_3d<T>::vgl_point_cloud_3d(vgl_pointset_3d<T> const& ps)
+  : size_(0), capacity_(0), has_normals_(ps.has_normals())
+{
+  for (int c = 0; c < 6; ++c)
+    ch_.push_back(new vgl_point_cloud_3d_channel<T>);
+  const unsigned n = ps.npts();
+  resize(n);
+  std::vector<vgl_point_3d<T> > const& pts = ps.points();
+  T *px = x(), *py = y(), *pz = z();
+  for (unsigned i = 0; i < n; ++i) {
+    px[i] = pts[i].x(); py[i] = pts[i].y(); pz[i] = pts[i].z();
+  }
+  if (has_normals_) {
+    std::vector<vgl_vector_3d<T> > const& normals = ps.normals();
+    for (unsigned i = 0; i < n; ++i)
+      set_normal(i, normals[i]);
+  }
+}
+
+template <class T>
+vgl_point_cloud_3d<T>::vgl_point_cloud_3d(vgl_point_cloud_3d<T> const& that)
+  : size_(0), capacity_(0), has_normals_(false)
+{
+  for (int c = 0; c < 6; ++c)
+    ch_.push_back(new vgl_point_cloud_3d_channel<T>);
+  *this = that;
+}
+
+template <class T>
+vgl_point_cloud_3d<T>& vgl_point_cloud_3d<T>::operator=(vgl_point_cloud_3d<T> const& that)
+{
+  if (this == &that)
+    return *this;
+  while (ch_.size() > 6) {
+    delete ch_.back();
+    ch_.pop_back();
+  }
+  names_.clear();
+  size_ = 0;
+  has_normals_ = that.has_normals_;
+  for (unsigned c = 0; c < that.num_scalars(); ++c) {
+    ch_.push_back(new vgl_point_cloud_3d_channel<T>);
+    names_.push_back(that.names_[c]);
+  }
+  reallocate(that.size_);
+  size_ = that.size_;
+  for (unsigned c = 0; c < ch_.size(); ++c)
+    if (c < 3 || c >= 6 || has_normals_)
+      std::copy(that.ch_[c]->data(), that.ch_[c]->data() + size_, ch_[c]->data());
+  return *this;
+}
+
+template <class T>
+vgl_point_cloud_3d<T>::~vgl_point_cloud_3d()
+{
+  for (unsigned c = 0; c < ch_.size(); ++c)
+    delete ch_[c];
+}
+
+template <class T>
+vgl_pointset_3d<T> vgl_point_cloud_3d<T>::as_pointset() const
+{
+  std::vector<vgl_point_3d<T> > pts(size_);
+  for (unsigned i = 0; i < size_; ++i)
+    pts[i] = point(i);
+  if (!has_normals_)
+    return vgl_pointset_3d<T>(pts);
+  std::vector<vgl_vector_3d<T> > normals(size_);
+  for (unsigned i = 0; i < size_; ++i)
+    normals[i] = normal(i);
+  return vgl_pointset_3d<T>(pts, normals);
+}
+
+template <class T>
+void vgl_point_cloud_3d<T>::reallocate(unsigned capacity)
+{
+  for (unsigned c = 0; c < ch_.size(); ++c)
+    if (c < 3 || c >= 6 || has_normals_)
+      ch_[c]->reallocate(size_, capacity);
+  capacity_ = capacity;
+}
+
+template <class T>
+void vgl_point_cloud_3d<T>::reserve(unsigned n)
+{
+  if (n > capacity_)
+    reallocate(n);
+}
+
+template <class T>
+void vgl_point_cloud_3d<T>::resize(unsigned n)
+{
+  if (n > capacity_)
+    reallocate(n);
+  else if (n > size_) // clear points left over from a previous size
+    for (unsigned c = 0; c < ch_.size(); ++c)
+      if (c < 3 || c >= 6 || has_normals_)
+        std::fill(ch_[c]->data() + size_, ch_[c]->data() + n, T(0));
+  size_ = n;
+}
+
+template <class T>
+void vgl_point_cloud_3d<T>::push_back(vgl_point_3d<T> const& p)
+{
+  const unsigned i = size_;
+  if (i == capacity_)
+    reallocate(capacity_ < 8 ? 16 : 2 * capacity_);
+  resize(i + 1);
+  set_point(i, p);
+}
+
+template <class T>
+void vgl_point_cloud_3d<T>::push_back(vgl_point_3d<T> const& p, vgl_vector_3d<T> const& n)
+{
+  set_has_normals(true);
+  push_back(p);
+  set_normal(size_ - 1, n);
+}
+
+template <class T>
+void vgl_point_cloud_3d<T>::set_has_normals(bool on)
+{
+  if (on == has_normals_)
+    return;
+  has_normals_ = on;
+  for (int c = 3; c < 6; ++c)
+    ch_[c]->reallocate(0, on ? capacity_ : 0);
+}
+
+template <class T>
+unsigned vgl_point_cloud_3d<T>::add_scalar(std::string const& name, T value)
+{
+  ch_.push_back(new vgl_point_cloud_3d_channel<T>);
+  ch_.back()->reallocate(0, capacity_, value);
+  names_.push_back(name);
+  return num_scalars() - 1;
+}
+
+template <class T>
+int vgl_point_cloud_3d<T>::scalar_index(std::string const& name) const
+{
+  for (unsigned c = 0; c < names_.size(); ++c)
+    if (names_[c] == name)
+      return c;
+  return -1;
+}
+
+template <class T>
+void vgl_point_cloud_3d<T>::transform(vgl_rotation_3d<T> const& R, vgl_vector_3d<T> const& t, T s)
+{
+  vnl_matrix_fixed<T, 3, 3> M = R.as_matrix();
+  // Coefficients in locals, so that the loops only touch the arrays.
+  const T r00 = M(0,0), r01 = M(0,1), r02 = M(0,2);
+  const T r10 = M(1,0), r11 = M(1,1), r12 = M(1,2);
+  const T r20 = M(2,0), r21 = M(2,1), r22 = M(2,2);
+  const T tx = t.x(), ty = t.y(), tz = t.z();
+  const int n = size_;
+
+  T *px = x(), *py = y(), *pz = z();
+  if (s == T(1)) {
+    for (int i = 0; i < n; ++i) {
+      const T a = px[i], b = py[i], c = pz[i];
+      px[i] = r00 * a + r01 * b + r02 * c + tx;
+      py[i] = r10 * a + r11 * b + r12 * c + ty;
+      pz[i] = r20 * a + r21 * b + r22 * c + tz;
+    }
+  }
+  else {
+    const T s00 = s * r00, s01 = s * r01, s02 = s * r02;
+    const T s10 = s * r10, s11 = s * r11, s12 = s * r12;
+    const T s20 = s * r20, s21 = s * r21, s22 = s * r22;
+    for (int i = 0; i < n; ++i) {
+      const T a = px[i], b = py[i], c = pz[i];
+      px[i] = s00 * a + s01 * b + s02 * c + tx;
+      py[i] = s10 * a + s11 * b + s12 * c + ty;
+      pz[i] = s20 * a + s21 * b + s22 * c + tz;
+    }
+  }
+
+  if (has_normals_) {
+    T *qx = nx(), *qy = ny(), *qz = nz();
+    for (int i = 0; i < n; ++i) {
+      const T a = qx[i], b = qy[i], c = qz[i];
+      qx[i] = r00 * a + r01 * b + r02 * c;
+      qy[i] = r10 * a + r11 * b + r12 * c;
+      qz[i] = r20 * a + r21 * b + r22 * c;
+    }
+  }
+}
+
+template <class T>
+void vgl_point_cloud_3d<T>::translate(vgl_vector_3d<T> const& t)
+{
+  const T tx = t.x(), ty = t.y(), tz = t.z();
+  const int n = size_;
+  T *px = x(), *py = y(), *pz = z();
+  for (int i = 0; i < n; ++i) px[i] += tx;
+  for (int i = 0; i < n; ++i) py[i] += ty;
+  for (int i = 0; i < n; ++i) pz[i] += tz;
+}
+
+//: Smallest and largest of n values.
+template <class T>
+inline void vgl_point_cloud_3d_range(T const* v, int n, T& lo, T& hi)
+{
+  T l = v[0], h = v[0];
+  for (int i = 1; i < n; ++i) {
+    l = v[i] < l ? v[i] : l;
+    h = v[i] > h ? v[i] : h;
+  }
+  lo = l; hi = h;
+}
+
+template <class T>
+vgl_box_3d<T> vgl_point_cloud_3d<T>::bounding_box() const
+{
+  if (size_ == 0)
+    return vgl_box_3d<T>();
+  T x0, x1, y0, y1, z0, z1;
+  vgl_point_cloud_3d_range(x(), size_, x0, x1);
+  vgl_point_cloud_3d_range(y(), size_, y0, y1);
+  vgl_point_cloud_3d_range(z(), size_, z0, z1);
+  return vgl_box_3d<T>(x0, y0, z0, x1, y1, z1);
+}
+
+template <class T>
+vgl_point_3d<T> vgl_point_cloud_3d<T>::centroid() const
+{
+  if (size_ == 0)
+    return vgl_point_3d<T>(T(0), T(0), T(0));
+  double sx = 0, sy = 0, sz = 0;
+  const int n = size_;
+  T const *px = x(), *py = y(), *pz = z();
+  for (int i = 0; i < n; ++i) sx += px[i];
+  for (int i = 0; i < n; ++i) sy += py[i];
+  for (int i = 0; i < n; ++i) sz += pz[i];
+  return vgl_point_3d<T>(T(sx / n), T(sy / n), T(sz / n));
+}
+
+#undef VGL_POINT_CLOUD_3D_INSTANTIATE
+#define VGL_POINT_CLOUD_3D_INSTANTIATE(T) \
+template class vgl_point_cloud_3d_channel<T >; \
+template class vgl_point_cloud_3d<T >
+
+#endif // vgl_point_cloud_3d_hxx_
@@ -0,0 +1,372 @@
+// This is core/vgl/algo/vgl_polygon_boolean.cxx
+//:
+// \file
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <utility>
+#include "vgl_polygon_boolean.h"
+#include <vgl/vgl_box_2d.h>
+#include <vgl/algo/vgl_packed_rtree.h>
+#include <vgl/algo/vgl_rtree_c.h>
+#include <vcl_compiler.h>
+
+typedef vgl_packed_rtree<vgl_box_2d<double>, vgl_bbox_2d<double>, vgl_rtree_box_box_2d<double> >
+        vgl_polygon_boolean_tree;
+
+//: A point at which an edge is to be cut, t along it.
+struct vgl_polygon_boolean_cut
+{
+  unsigned edge;
+  double t, x, y;
+  bool operator<(vgl_polygon_boolean_cut const& c) const { return t < c.t; }
+};
+
+//: A piece of an input edge, between vertices v0 and v1 (v0 < v1).
+struct vgl_polygon_boolean_piece
+{
+  unsigned v0, v1, operand;
+  bool operator<(vgl_polygon_boolean_piece const& p) const
+  {
+    return v0 < p.v0 || (v0 == p.v0 && (v1 < p.v1 || (v1 == p.v1 && operand < p.operand)));
+  }
+};
+
+static inline double vgl_polygon_boolean_cross(double ax, double ay, double bx, double by)
+{
+  return ax * by - ay * bx;
+}
+
+//: If (px,py), at distance d from the line of edge e of length len, lies inside e, cut e there.
+template <class E>
+static bool vgl_polygon_boolean_on_edge(E const& e, unsigned ie, double len, double px, double py,
+                                        double d, double tol, std::vector<vgl_polygon_boolean_cut>& cuts)
+{
+  if (std::fabs(d) > tol)
+    return false;
+  const double t = ((px - e.x0) * (e.x1 - e.x0) + (py - e.y0) * (e.y1 - e.y0)) / (len * len);
+  if (t * len <= tol || (1 - t) * len <= tol)
+    return false; // at or beyond an end
+  vgl_polygon_boolean_cut c = { ie, t, px, py };
+  cuts.push_back(c);
+  return true;
+}
+
+//: Cuts of edges a and b where they cross, or where an end of one touches the other.
+template <class E>
+static void vgl_polygon_boolean_meet(E const& a, unsigned ia, E const& b, unsigned ib, double tol,
+                                     std::vector<vgl_polygon_boolean_cut>& cuts)
+{
+  const double rx = a.x1 - a.x0, ry = a.y1 - a.y0, sx = b.x1 - b.x0, sy = b.y1 - b.y0;
+  const double ra = std::sqrt(rx * rx + ry * ry), sb = std::sqrt(sx * sx + sy * sy);
+  // signed distances of the ends of b from the line of a, and vice versa
+  const double db0 = vgl_polygon_boolean_cross(rx, ry, b.x0 - a.x0, b.y0 - a.y0) / ra;
+  const double db1 = vgl_polygon_boolean_cross(rx, ry, b.x1 - a.x0, b.y1 - a.y0) / ra;
+  const double da0 = vgl_polygon_boolean_cross(sx, sy, a.x0 - b.x0, a.y0 - b.y0) / sb;
+  const double da1 = vgl_polygon_boolean_cross(sx, sy, a.x1 - b.x0, a.y1 - b.y0) / sb;
+
+  // Ends on the other edge; this also covers collinear overlaps, which are
+  // cut at the ends of each edge lying on the other.
+  bool touch = vgl_polygon_boolean_on_edge(a, ia, ra, b.x0, b.y0, db0, tol, cuts);
+  touch = vgl_polygon_boolean_on_edge(a, ia, ra, b.x1, b.y1, db1, tol, cuts) || touch;
+  touch = vgl_polygon_boolean_on_edge(b, ib, sb, a.x0, a.y0, da0, tol, cuts) || touch;
+  touch = vgl_polygon_boolean_on_edge(b, ib, sb, a.x1, a.y1, da1, tol, cuts) || touch;
+  if (touch)
+    return;
+  if (std::fabs(db0) <= tol || std::fabs(db1) <= tol || std::fabs(da0) <= tol || std::fabs(da1) <= tol)
+    return; // an end on the other line, but outside the other edge
+  if ((db0 > 0) == (db1 > 0) || (da0 > 0) == (da1 > 0))
+    return;
+  const double t = da0 / (da0 - da1), u = db0 / (db0 - db1);
+  const double x = a.x0 + t * rx, y = a.y0 + t * ry;
+  vgl_polygon_boolean_cut ca = { ia, t, x, y }, cb = { ib, u, x, y };
+  cuts.push_back(ca);
+  cuts.push_back(cb);
+}
+
+//: Flip the membership of operand k in the sorted set s.
+static inline void vgl_polygon_boolean_toggle(std::vector<unsigned>& s, unsigned k)
+{
+  std::vector<unsigned>::iterator it = std::lower_bound(s.begin(), s.end(), k);
+  if (it != s.end() && *it == k)
+    s.erase(it);
+  else
+    s.insert(it, k);
+}
+
+//: Is a point inside exactly the operands in s inside the result?
+static inline bool vgl_polygon_boolean_rule(vgl_clip_type op, std::vector<unsigned> const& s, unsigned n)
+{
+  switch (op)
+  {
+    case vgl_clip_type_union:      return !s.empty();
+    case vgl_clip_type_difference: return s.size() == 1 && s[0] == 0;
+    case vgl_clip_type_xor:        return s.size() % 2 == 1;
+    case vgl_clip_type_intersect:
+    default:                       return n > 0 && s.size() == n;
+  }
+}
+
+//: Merges points closer than a tolerance into numbered vertices.
+class vgl_polygon_boolean_vertices
+{
+ public:
+  explicit vgl_polygon_boolean_vertices(double tol) : tol_(tol) {}
+
+  unsigned vertex(double x, double y)
+  {
+    const long long cx = (long long)std::floor(x / tol_), cy = (long long)std::floor(y / tol_);
+    for (long long i = cx - 1; i <= cx + 1; ++i)
+      for (long long j = cy - 1; j <= cy + 1; ++j) {
+        std::map<std::pair<long long, long long>, unsigned>::const_iterator it = grid_.find(std::make_pair(i, j));
+        if (it != grid_.end() &&
+            std::fabs(pts_[it->second].x() - x) <= tol_ && std::fabs(pts_[it->second].y() - y) <= tol_)
+          return it->second;
+      }
+    const unsigned v = (unsigned)pts_.size();
+    pts_.push_back(vgl_point_2d<double>(x, y));
+    grid_.insert(std::make_pair(std::make_pair(cx, cy), v)); // keeps an earlier vertex in the cell
+    return v;
+  }
+
+  std::vector<vgl_point_2d<double> > const& points() const { return pts_; }
+
+ private:
+  double tol_;
+  std::map<std::pair<long long, long long>, unsigned> grid_;
+  std::vector<vgl_point_2d<double> > pts_;
+};
+
+void vgl_polygon_boolean_engine::compute(vgl_clip_type op,
+                                         std::vector<std::vector<vgl_point_2d<double> > >& sheets) const
+{
+  sheets.clear();
+  const int n_edges = (int)edges_.size();
+  if (n_edges == 0)
+    return;
+
+  double big = 0;
+  std::vector<vgl_box_2d<double> > boxes(n_edges);
+  for (int i = 0; i < n_edges; ++i) {
+    edge const& e = edges_[i];
+    boxes[i] = vgl_box_2d<double>(std::min(e.x0, e.x1), std::max(e.x0, e.x1),
+                                  std::min(e.y0, e.y1), std::max(e.y0, e.y1));
+    big = std::max(big, std::max(std::max(std::fabs(e.x0), std::fabs(e.x1)),
+                                 std::max(std::fabs(e.y0), std::fabs(e.y1))));
+  }
+  const double tol = 1e-10 * (big > 0 ? big : 1.0);
+
+  // Cut the edges where they meet.
+  std::vector<std::vector<vgl_polygon_boolean_cut> > found(n_edges);
+  {
+    vgl_polygon_boolean_tree tree(boxes);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (int i = 0; i < n_edges; ++i) {
+      std::vector<unsigned> near;
+      vgl_box_2d<double> const& b = boxes[i];
+      tree.get_indices(vgl_bbox_2d<double>(b.min_x() - tol, b.max_x() + tol, b.min_y() - tol, b.max_y() + tol), near);
+      for (unsigned k = 0; k < near.size(); ++k)
+        if ((int)near[k] > i)
+          vgl_polygon_boolean_meet(edges_[i], i, edges_[near[k]], near[k], tol, found[i]);
+    }
+  }
+  std::vector<std::vector<vgl_polygon_boolean_cut> > cuts(n_edges);
+  for (int i = 0; i < n_edges; ++i)
+    for (unsigned k = 0; k < found[i].size(); ++k)
+      cuts[found[i][k].edge].push_back(found[i][k]);
+  found.clear();
+
+  // Number the vertices, and split the edges into pieces between them.
+  vgl_polygon_boolean_vertices vertices(tol);
+  std::vector<vgl_polygon_boolean_piece> pieces;
+  pieces.reserve(n_edges);
+  for (int i = 0; i < n_edges; ++i) {
+    std::vector<vgl_polygon_boolean_cut>& c = cuts[i];
+    std::sort(c.begin(), c.end());
+    unsigned prev = vertices.vertex(edges_[i].x0, edges_[i].y0);
+    for (unsigned k = 0; k <= c.size(); ++k) {
+      const unsigned v = k < c.size() ? vertices.vertex(c[k].x, c[k].y)
+                                      : vertices.vertex(edges_[i].x1, edges_[i].y1);
+      if (v != prev) {
+        vgl_polygon_boolean_piece p = { std::min(prev, v), std::max(prev, v), edges_[i].operand };
+        pieces.push_back(p);
+      }
+      prev = v;
+    }
+  }
+  cuts.clear();
+  std::vector<vgl_point_2d<double> > const& pts = vertices.points();
+
+  // Merge coincident pieces; each distinct piece separates the operands
+  // that have it an odd number of times.
+  std::sort(pieces.begin(), pieces.end());
+  std::vector<vgl_polygon_boolean_piece> uniq;
+  std::vector<std::vector<unsigned> > flips;
+  for (unsigned i = 0; i < pieces.size(); ) {
+    unsigned j = i;
+    while (j < pieces.size() && pieces[j].v0 == pieces[i].v0 && pieces[j].v1 == pieces[i].v1)
+      ++j;
+    std::vector<unsigned> f;
+    for (unsigned k = i; k < j; ) {
+      unsigned l = k;
+      while (l < j && pieces[l].operand == pieces[k].operand)
+        ++l;
+      if ((l - k) % 2 == 1)
+        f.push_back(pieces[k].operand);
+      k = l;
+    }
+    if (!f.empty()) {
+      uniq.push_back(pieces[i]);
+      flips.push_back(f);
+    }
+    i = j;
+  }
+  pieces.clear();
+
+  // Classify each piece by casting a ray from its midpoint: upwards for a
+  // piece that is not vertical, else to the right.
+  const int n_uniq = (int)uniq.size();
+  double xmax = -big, ymax = -big;
+  boxes.resize(n_uniq);
+  for (int i = 0; i < n_uniq; ++i) {
+    vgl_point_2d<double> const& p = pts[uniq[i].v0];
+    vgl_point_2d<double> const& q = pts[uniq[i].v1];
+    boxes[i] = vgl_box_2d<double>(std::min(p.x(), q.x()), std::max(p.x(), q.x()),
+                                  std::min(p.y(), q.y()), std::max(p.y(), q.y()));
+    xmax = std::max(xmax, boxes[i].max_x());
+    ymax = std::max(ymax, boxes[i].max_y());
+  }
+  // kept pieces, directed with the result on their left
+  std::vector<std::pair<unsigned, unsigned> > kept(n_uniq, std::make_pair(0u, 0u));
+  std::vector<char> keep(n_uniq, 0);
+  {
+    vgl_polygon_boolean_tree tree(boxes);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (int i = 0; i < n_uniq; ++i) {
+      unsigned a = uniq[i].v0, b = uniq[i].v1;
+      if (pts[b].x() < pts[a].x() || (pts[b].x() == pts[a].x() && pts[b].y() < pts[a].y()))
+        std::swap(a, b); // a is left of b, or below it
+      const bool vertical = pts[a].x() == pts[b].x();
+      const double mx = 0.5 * (pts[a].x() + pts[b].x()), my = 0.5 * (pts[a].y() + pts[b].y());
+      std::vector<unsigned> near, side;
+      tree.get_indices(vertical ? vgl_bbox_2d<double>(mx, xmax, my, my) : vgl_bbox_2d<double>(mx, mx, my, ymax), near);
+      for (unsigned k = 0; k < near.size(); ++k) {
+        const unsigned j = near[k];
+        if ((int)j == i)
+          continue;
+        vgl_point_2d<double> const& p = pts[uniq[j].v0];
+        vgl_point_2d<double> const& q = pts[uniq[j].v1];
+        bool crosses;
+        if (vertical)
+          crosses = (p.y() <= my) != (q.y() <= my) &&
+                    p.x() + (my - p.y()) * (q.x() - p.x()) / (q.y() - p.y()) > mx;
+        else
+          crosses = (p.x() <= mx) != (q.x() <= mx) &&
+                    p.y() + (mx - p.x()) * (q.y() - p.y()) / (q.x() - p.x()) > my;
+        if (crosses)
+          for (unsigned f = 0; f < flips[j].size(); ++f)
+            vgl_polygon_boolean_toggle(side, flips[j][f]);
+      }
+      // side holds the operands above (left of a->b) or right of (right of a->b) the piece
+      const bool in1 = vgl_polygon_boolean_rule(op, side, n_operands_);
+      for (unsigned f = 0; f < flips[i].size(); ++f)
+        vgl_polygon_boolean_toggle(side, flips[i][f]);
+      const bool in2 = vgl_polygon_boolean_rule(op, side, n_operands_);
+      if (in1 == in2)
+        continue;
+      keep[i] = 1;
+      kept[i] = (in1 != vertical) ? std::make_pair(a, b) : std::make_pair(b, a);
+    }
+  }
+
+  // Link the kept pieces into sheets, turning as far left as possible at
+  // each vertex, so that sheets touching at a vertex are kept apart.
+  const unsigned n_pts = (unsigned)pts.size();
+  std::vector<unsigned> first(n_pts + 1, 0), out;
+  for (int i = 0; i < n_uniq; ++i)
+    if (keep[i]) ++first[kept[i].first + 1];
+  for (unsigned v = 0; v < n_pts; ++v)
+    first[v + 1] += first[v];
+  out.resize(first[n_pts]);
+  {
+    std::vector<unsigned> pos(first.begin(), first.end() - 1);
+    for (int i = 0; i < n_uniq; ++i)
+      if (keep[i]) out[pos[kept[i].first]++] = kept[i].second;
+  }
+  std::vector<char> used(out.size(), 0);
+  const double two_pi = 6.28318530717958647692;
+  for (unsigned v0 = 0; v0 < n_pts; ++v0)
+    for (unsigned s = first[v0]; s < first[v0 + 1]; ++s) {
+      if (used[s])
+        continue;
+      std::vector<vgl_point_2d<double> > sheet;
+      unsigned from = v0, e = s;
+      while (true) {
+        used[e] = 1;
+        sheet.push_back(pts[from]);
+        const unsigned to = out[e];
+        if (to == v0)
+          break;
+        const double back = std::atan2(pts[from].y() - pts[to].y(), pts[from].x() - pts[to].x());
+        unsigned best = first[to + 1];
+        double best_turn = 0;
+        for (unsigned k = first[to]; k < first[to + 1]; ++k) {
+          if (used[k])
+            continue;
+          // clockwise angle from the way back to this edge
+          double turn = back - std::atan2(pts[out[k]].y() - pts[to].y(), pts[out[k]].x() - pts[to].x());
+          while (turn <= 0) turn += two_pi;
+          while (turn > two_pi) turn -= two_pi;
+          if (best == first[to + 1] || turn < best_turn) {
+            best = k;
+            best_turn = turn;
+          }
+        }
+        if (best == first[to + 1])
+          break; // cannot happen when each vertex has as many edges in as out
+        from = to;
+        e = best;
+      }
+
+      // drop vertices between collinear edges
+      std::vector<vgl_point_2d<double> > clean;
+      for (unsigned k = 0; k < sheet.size(); ++k) {
+        vgl_point_2d<double> const& p = sheet[k];
+        while (clean.size() >= 2) {
+          vgl_point_2d<double> const& a = clean[clean.size() - 2];
+          vgl_point_2d<double> const& b = clean.back();
+          const double ux = b.x() - a.x(), uy = b.y() - a.y(), wx = p.x() - b.x(), wy = p.y() - b.y();
+          if (std::fabs(vgl_polygon_boolean_cross(ux, uy, wx, wy)) <= tol * std::sqrt((p.x() - a.x()) * (p.x() - a.x()) + (p.y() - a.y()) * (p.y() - a.y())) &&
+              ux * wx + uy * wy > 0)
+            clean.pop_back();
+          else
+            break;
+        }
+        clean.push_back(p);
+      }
+      // and around the start of the sheet
+      bool changed = true;
+      while (changed && clean.size() >= 3) {
+        changed = false;
+        for (unsigned k = 0; k < 2 && clean.size() >= 3; ++k) {
+          const unsigned n = (unsigned)clean.size(), m = k == 0 ? n - 1 : 0;
+          vgl_point_2d<double> const& a = clean[(m + n - 1) % n];
+          vgl_point_2d<double> const& b = clean[m];
+          vgl_point_2d<double> const& p = clean[(m + 1) % n];
+          const double ux = b.x() - a.x(), uy = b.y() - a.y(), wx = p.x() - b.x(), wy = p.y() - b.y();
+          if (std::fabs(vgl_polygon_boolean_cross(ux, uy, wx, wy)) <= tol * std::sqrt((p.x() - a.x()) * (p.x() - a.x()) + (p.y() - a.y()) * (p.y() - a.y())) &&
+              ux * wx + uy * wy > 0) {
+            clean.erase(clean.begin() + m);
+            changed = true;
+          }
+        }
+      }
+      if (clean.size() >= 3)
+        sheets.push_back(clean);
+    }
+}
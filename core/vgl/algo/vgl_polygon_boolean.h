@@ -0,0 +1,117 @@
+// This is core/vgl/algo/vgl_polygon_boolean.h
+#ifndef vgl_polygon_boolean_h_
+#define vgl_polygon_boolean_h_
+//:
+// \file
+// \brief Union, intersection, difference and xor of polygons
+//
+//    vgl_clip converts its operands to the structures of an external
+//    clipper (GPC or Clipper) and back, and combines only two polygons at a
+//    time, so merging many polygons means a long chain of calls, each
+//    copying the growing result.  vgl_polygon_boolean works directly on
+//    the edges of any number of polygons:
+//    -  all edges are split where they cross or touch, using a packed rtree
+//       (vgl_packed_rtree) of edge bounds to find the pairs that can meet;
+//    -  for each piece of edge, the operands covering either side of it are
+//       found by casting a ray from its midpoint, again through an rtree;
+//    -  pieces with the result inside on one side only are kept, and linked
+//       into closed sheets.
+//    Shared and overlapping edges, as between adjacent building footprints,
+//    need no special treatment: coincident pieces are merged before they
+//    are classified.
+//
+//    Each operand is a vgl_polygon, with the even-odd rule of
+//    vgl_polygon::contains, so sheets inside another sheet are holes.  In
+//    the result, outer boundaries are anticlockwise and holes clockwise,
+//    and vertices between collinear edges are removed.
+//
+//    Points closer together than about 1e-10 times the largest coordinate
+//    are merged, to absorb rounding in the computed crossings.
+//
+//    When compiled with OpenMP, the search for crossings and the
+//    classification run on several threads, as do the independent groups
+//    of vgl_polygon_union.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vector>
+#include <vcl_compiler.h>
+#include <vgl/vgl_point_2d.h>
+#include <vgl/vgl_polygon.h>
+#include <vgl/vgl_clip.h>
+
+//: Combines any number of polygons, in double precision.
+//  Each polygon added is an operand, numbered from 0.  With more than two
+//  operands, vgl_clip_type_union keeps the points inside any operand,
+//  vgl_clip_type_intersect those inside all of them,
+//  vgl_clip_type_difference those inside operand 0 and no other, and
+//  vgl_clip_type_xor those inside an odd number of operands.
+class vgl_polygon_boolean_engine
+{
+ public:
+  vgl_polygon_boolean_engine() : n_operands_(0) {}
+
+  //: Add the polygon p as the next operand.
+  template <class T>
+  void add_polygon(vgl_polygon<T> const& p)
+  {
+    for (unsigned s = 0; s < p.num_sheets(); ++s)
+      add_sheet(p[s], n_operands_);
+    ++n_operands_;
+  }
+
+  //: Number of operands added
+  unsigned num_operands() const { return n_operands_; }
+
+  //: Combine the operands, giving the boundary of the result as closed sheets.
+  void compute(vgl_clip_type op, std::vector<std::vector<vgl_point_2d<double> > >& sheets) const;
+
+ private:
+  struct edge
+  {
+    double x0, y0, x1, y1;
+    unsigned operand;
+  };
+
+  template <class T>
+  void add_sheet(std::vector<vgl_point_2d<T> > const& sheet, unsigned operand)
+  {
+    const unsigned n = (unsigned)sheet.size();
+    if (n < 3)
+      return;
+    for (unsigned i = 0; i < n; ++i) {
+      vgl_point_2d<T> const& p = sheet[i];
+      vgl_point_2d<T> const& q = sheet[(i + 1) % n];
+      if (p == q)
+        continue;
+      edge e;
+      e.x0 = p.x(); e.y0 = p.y(); e.x1 = q.x(); e.y1 = q.y();
+      e.operand = operand;
+      edges_.push_back(e);
+    }
+  }
+
+  std::vector<edge> edges_;
+  unsigned n_operands_;
+};
+
+//: Combine two polygons.
+//  Does the same as vgl_clip(poly1, poly2, op), without an external library.
+// \relatesalso vgl_polygon
+template <class T>
+vgl_polygon<T> vgl_polygon_boolean(vgl_polygon<T> const& poly1, vgl_polygon<T> const& poly2,
+                                   vgl_clip_type op = vgl_clip_type_intersect);
+
+//: Union of many polygons.
+//  The polygons are first grouped by overlap of their bounding boxes, and
+//  each group is merged separately; a polygon meeting no other is copied
+//  to the result unchanged.
+// \relatesalso vgl_polygon
+template <class T>
+vgl_polygon<T> vgl_polygon_union(std::vector<vgl_polygon<T> > const& polys);
+
+#define VGL_POLYGON_BOOLEAN_INSTANTIATE(T) extern "please include vgl/algo/vgl_polygon_boolean.hxx first"
+
+#endif // vgl_polygon_boolean_h_
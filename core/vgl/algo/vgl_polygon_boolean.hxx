@@ -0,0 +1,148 @@
+// This is core/vgl/algo/vgl_polygon_boolean.hxx
+#ifndef vgl_polygon_boolean_hxx_
+#define vgl_polygon_boolean_hxx_
+//:
+// \file
+
+#include <algorithm>
+#include "vgl_polygon_boolean.h"
+#include <vgl/vgl_box_2d.h>
+#include <vgl/algo/vgl_packed_rtree.h>
+#include <vgl/algo/vgl_rtree_c.h>
+#include <vcl_compiler.h>
+
+//: Append the sheets, converted to T, to poly.
+template <class T>
+static void vgl_polygon_boolean_append(std::vector<std::vector<vgl_point_2d<double> > > const& sheets,
+                                       vgl_polygon<T>& poly)
+{
+  for (unsigned s = 0; s < sheets.size(); ++s) {
+    poly.new_sheet();
+    for (unsigned k = 0; k < sheets[s].size(); ++k)
+      poly.push_back(T(sheets[s][k].x()), T(sheets[s][k].y()));
+  }
+}
+
+//: Bounding box of the sheets of poly, in double.
+template <class T>
+static vgl_box_2d<double> vgl_polygon_boolean_bounds(vgl_polygon<T> const& poly)
+{
+  vgl_box_2d<double> b;
+  for (unsigned s = 0; s < poly.num_sheets(); ++s)
+    for (unsigned k = 0; k < poly[s].size(); ++k)
+      b.add(vgl_point_2d<double>(poly[s][k].x(), poly[s][k].y()));
+  return b;
+}
+
+template <class T>
+vgl_polygon<T> vgl_polygon_boolean(vgl_polygon<T> const& poly1, vgl_polygon<T> const& poly2, vgl_clip_type op)
+{
+  vgl_polygon<T> result;
+  vgl_box_2d<double> b1 = vgl_polygon_boolean_bounds(poly1), b2 = vgl_polygon_boolean_bounds(poly2);
+  if (b1.is_empty() || b2.is_empty() ||
+      b1.max_x() < b2.min_x() || b2.max_x() < b1.min_x() ||
+      b1.max_y() < b2.min_y() || b2.max_y() < b1.min_y()) { // disjoint: no need to look at the edges
+    switch (op)
+    {
+      case vgl_clip_type_intersect: break;
+      case vgl_clip_type_difference: result = poly1; break;
+      case vgl_clip_type_union:
+      case vgl_clip_type_xor:
+      default:
+        result = poly1;
+        for (unsigned s = 0; s < poly2.num_sheets(); ++s)
+          result.push_back(poly2[s]);
+        break;
+    }
+    return result;
+  }
+
+  vgl_polygon_boolean_engine engine;
+  engine.add_polygon(poly1);
+  engine.add_polygon(poly2);
+  std::vector<std::vector<vgl_point_2d<double> > > sheets;
+  engine.compute(op, sheets);
+  vgl_polygon_boolean_append(sheets, result);
+  return result;
+}
+
+template <class T>
+vgl_polygon<T> vgl_polygon_union(std::vector<vgl_polygon<T> > const& polys)
+{
+  typedef vgl_packed_rtree<vgl_box_2d<double>, vgl_bbox_2d<double>, vgl_rtree_box_box_2d<double> > tree_t;
+
+  // Group the polygons whose bounds overlap, directly or through others.
+  std::vector<unsigned> which;
+  std::vector<vgl_box_2d<double> > boxes;
+  for (unsigned i = 0; i < polys.size(); ++i) {
+    vgl_box_2d<double> b = vgl_polygon_boolean_bounds(polys[i]);
+    if (!b.is_empty()) {
+      which.push_back(i);
+      boxes.push_back(b);
+    }
+  }
+  const unsigned n = (unsigned)boxes.size();
+  std::vector<unsigned> parent(n);
+  for (unsigned i = 0; i < n; ++i)
+    parent[i] = i;
+  {
+    tree_t tree(boxes);
+    std::vector<unsigned> near;
+    for (unsigned i = 0; i < n; ++i) {
+      near.clear();
+      tree.get_indices(vgl_bbox_2d<double>(boxes[i].min_point(), boxes[i].max_point()), near);
+      for (unsigned k = 0; k < near.size(); ++k) {
+        unsigned a = i, b = near[k];
+        while (parent[a] != a) a = parent[a] = parent[parent[a]];
+        while (parent[b] != b) b = parent[b] = parent[parent[b]];
+        if (a != b)
+          parent[std::max(a, b)] = std::min(a, b);
+      }
+    }
+  }
+  std::vector<std::vector<unsigned> > groups;
+  std::vector<unsigned> group_of(n);
+  for (unsigned i = 0; i < n; ++i) {
+    unsigned r = i;
+    while (parent[r] != r) r = parent[r];
+    if (r == i) {
+      group_of[i] = (unsigned)groups.size();
+      groups.push_back(std::vector<unsigned>());
+    }
+    groups[group_of[r]].push_back(which[i]);
+  }
+
+  // Merge each group.
+  const int n_groups = (int)groups.size();
+  std::vector<std::vector<std::vector<vgl_point_2d<double> > > > sheets(n_groups);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int g = 0; g < n_groups; ++g) {
+    if (groups[g].size() < 2)
+      continue;
+    vgl_polygon_boolean_engine engine;
+    for (unsigned k = 0; k < groups[g].size(); ++k)
+      engine.add_polygon(polys[groups[g][k]]);
+    engine.compute(vgl_clip_type_union, sheets[g]);
+  }
+
+  vgl_polygon<T> result;
+  for (int g = 0; g < n_groups; ++g) {
+    if (groups[g].size() < 2) {
+      vgl_polygon<T> const& p = polys[groups[g][0]];
+      for (unsigned s = 0; s < p.num_sheets(); ++s)
+        result.push_back(p[s]);
+    }
+    else
+      vgl_polygon_boolean_append(sheets[g], result);
+  }
+  return result;
+}
+
+#undef VGL_POLYGON_BOOLEAN_INSTANTIATE
+#define VGL_POLYGON_BOOLEAN_INSTANTIATE(T) \
+template vgl_polygon<T > vgl_polygon_boolean(vgl_polygon<T > const&, vgl_polygon<T > const&, vgl_clip_type); \
+template vgl_polygon<T > vgl_polygon_union(std::vector<vgl_polygon<T > > const&)
+
+#endif // vgl_polygon_boolean_hxx_
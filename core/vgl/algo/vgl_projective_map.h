@@ -0,0 +1,57 @@
+// This is core/vgl/algo/vgl_projective_map.h
+#ifndef vgl_projective_map_h_
+#define vgl_projective_map_h_
+//:
+// \file
+// \brief Apply a homography or a projection matrix to many points at once
+//
+//    vgl_h_matrix_2d, vgl_h_matrix_3d and vgl_p_matrix map one
+//    vgl_homg_point at a time, through vnl vectors.  Robust estimation
+//    (RANSAC scoring) and rendering map thousands of points through the
+//    same matrix, so here the points are contiguous arrays, either one
+//    array per coordinate or interleaved (x0 y0 x1 y1 ...), and the mapping
+//    is a loop without branches which the compiler turns into SIMD
+//    instructions when optimising.  When compiled with OpenMP, blocks of
+//    points are mapped in parallel.
+//
+//    The matrices are given row by row, as the data_block() of a
+//    vnl_matrix_fixed.  Each point is mapped to the inhomogeneous point
+//    given by its homogeneous image, multiplying by the reciprocal of its
+//    last coordinate; a point mapped to infinity gives infinite or NaN
+//    coordinates.  The output arrays of a homography may be its input
+//    arrays, to map the points in place, but must not otherwise overlap
+//    them; those of a projection must not overlap its input arrays.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vcl_compiler.h>
+
+//: Map (x[i], y[i]) to (u[i], v[i]) by the 3x3 homography H, 0 <= i < n
+template <class T>
+void vgl_projective_map_2d(T const H[9], T const* x, T const* y, T* u, T* v, unsigned n);
+
+//: Map the interleaved points xy = (x0, y0, x1, y1, ...) by the 3x3 homography H into uv
+template <class T>
+void vgl_projective_map_2d(T const H[9], T const* xy, T* uv, unsigned n);
+
+//: Map (x[i], y[i], z[i]) to (u[i], v[i], w[i]) by the 4x4 homography H, 0 <= i < n
+template <class T>
+void vgl_projective_map_3d(T const H[16], T const* x, T const* y, T const* z, T* u, T* v, T* w, unsigned n);
+
+//: Map the interleaved points xyz = (x0, y0, z0, x1, ...) by the 4x4 homography H into uvw
+template <class T>
+void vgl_projective_map_3d(T const H[16], T const* xyz, T* uvw, unsigned n);
+
+//: Project (x[i], y[i], z[i]) to (u[i], v[i]) by the 3x4 projection matrix P, 0 <= i < n
+template <class T>
+void vgl_projective_project_3d(T const P[12], T const* x, T const* y, T const* z, T* u, T* v, unsigned n);
+
+//: Project the interleaved points xyz = (x0, y0, z0, x1, ...) by the 3x4 projection matrix P into uv = (u0, v0, u1, ...)
+template <class T>
+void vgl_projective_project_3d(T const P[12], T const* xyz, T* uv, unsigned n);
+
+#define VGL_PROJECTIVE_MAP_INSTANTIATE(T) extern "please include vgl/algo/vgl_projective_map.hxx first"
+
+#endif // vgl_projective_map_h_
@@ -0,0 +1,149 @@
+// This is core/vgl/algo/vgl_projective_map.hxx
+#ifndef vgl_projective_map_hxx_
+#define vgl_projective_map_hxx_
+//:
+// \file
+
+#include <algorithm>
+#include "vgl_projective_map.h"
+#include <vcl_compiler.h>
+
+//: Points are mapped, by one thread each, in blocks of this many
+static const unsigned vgl_projective_map_block = 4096;
+
+template <class T>
+void vgl_projective_map_2d(T const H[9], T const* x, T const* y, T* u, T* v, unsigned n)
+{
+  const T h0 = H[0], h1 = H[1], h2 = H[2], h3 = H[3], h4 = H[4], h5 = H[5], h6 = H[6], h7 = H[7], h8 = H[8];
+  const unsigned B = vgl_projective_map_block;
+  const int n_blocks = int((n + B - 1) / B);
+#if defined(_OPENMP)
+#pragma omp parallel for if (n_blocks > 1)
+#endif
+  for (int b = 0; b < n_blocks; ++b) {
+    const unsigned first = b * B, last = std::min(n, first + B);
+    for (unsigned i = first; i < last; ++i) {
+      const T px = x[i], py = y[i];
+      const T r = T(1) / (h6 * px + h7 * py + h8);
+      u[i] = (h0 * px + h1 * py + h2) * r;
+      v[i] = (h3 * px + h4 * py + h5) * r;
+    }
+  }
+}
+
+template <class T>
+void vgl_projective_map_2d(T const H[9], T const* xy, T* uv, unsigned n)
+{
+  const T h0 = H[0], h1 = H[1], h2 = H[2], h3 = H[3], h4 = H[4], h5 = H[5], h6 = H[6], h7 = H[7], h8 = H[8];
+  const unsigned B = vgl_projective_map_block;
+  const int n_blocks = int((n + B - 1) / B);
+#if defined(_OPENMP)
+#pragma omp parallel for if (n_blocks > 1)
+#endif
+  for (int b = 0; b < n_blocks; ++b) {
+    const unsigned first = b * B, last = std::min(n, first + B);
+    for (unsigned i = first; i < last; ++i) {
+      const T px = xy[2 * i], py = xy[2 * i + 1];
+      const T r = T(1) / (h6 * px + h7 * py + h8);
+      uv[2 * i] = (h0 * px + h1 * py + h2) * r;
+      uv[2 * i + 1] = (h3 * px + h4 * py + h5) * r;
+    }
+  }
+}
+
+template <class T>
+void vgl_projective_map_3d(T const H[16], T const* x, T const* y, T const* z, T* u, T* v, T* w, unsigned n)
+{
+  const T h0 = H[0], h1 = H[1], h2 = H[2], h3 = H[3], h4 = H[4], h5 = H[5], h6 = H[6], h7 = H[7],
+          h8 = H[8], h9 = H[9], h10 = H[10], h11 = H[11], h12 = H[12], h13 = H[13], h14 = H[14], h15 = H[15];
+  const unsigned B = vgl_projective_map_block;
+  const int n_blocks = int((n + B - 1) / B);
+#if defined(_OPENMP)
+#pragma omp parallel for if (n_blocks > 1)
+#endif
+  for (int b = 0; b < n_blocks; ++b) {
+    const unsigned first = b * B, last = std::min(n, first + B);
+    for (unsigned i = first; i < last; ++i) {
+      const T px = x[i], py = y[i], pz = z[i];
+      const T r = T(1) / (h12 * px + h13 * py + h14 * pz + h15);
+      u[i] = (h0 * px + h1 * py + h2 * pz + h3) * r;
+      v[i] = (h4 * px + h5 * py + h6 * pz + h7) * r;
+      w[i] = (h8 * px + h9 * py + h10 * pz + h11) * r;
+    }
+  }
+}
+
+template <class T>
+void vgl_projective_map_3d(T const H[16], T const* xyz, T* uvw, unsigned n)
+{
+  const T h0 = H[0], h1 = H[1], h2 = H[2], h3 = H[3], h4 = H[4], h5 = H[5], h6 = H[6], h7 = H[7],
+          h8 = H[8], h9 = H[9], h10 = H[10], h11 = H[11], h12 = H[12], h13 = H[13], h14 = H[14], h15 = H[15];
+  const unsigned B = vgl_projective_map_block;
+  const int n_blocks = int((n + B - 1) / B);
+#if defined(_OPENMP)
+#pragma omp parallel for if (n_blocks > 1)
+#endif
+  for (int b = 0; b < n_blocks; ++b) {
+    const unsigned first = b * B, last = std::min(n, first + B);
+    for (unsigned i = first; i < last; ++i) {
+      const T px = xyz[3 * i], py = xyz[3 * i + 1], pz = xyz[3 * i + 2];
+      const T r = T(1) / (h12 * px + h13 * py + h14 * pz + h15);
+      uvw[3 * i] = (h0 * px + h1 * py + h2 * pz + h3) * r;
+      uvw[3 * i + 1] = (h4 * px + h5 * py + h6 * pz + h7) * r;
+      uvw[3 * i + 2] = (h8 * px + h9 * py + h10 * pz + h11) * r;
+    }
+  }
+}
+
+template <class T>
+void vgl_projective_project_3d(T const P[12], T const* x, T const* y, T const* z, T* u, T* v, unsigned n)
+{
+  const T p0 = P[0], p1 = P[1], p2 = P[2], p3 = P[3], p4 = P[4], p5 = P[5],
+          p6 = P[6], p7 = P[7], p8 = P[8], p9 = P[9], p10 = P[10], p11 = P[11];
+  const unsigned B = vgl_projective_map_block;
+  const int n_blocks = int((n + B - 1) / B);
+#if defined(_OPENMP)
+#pragma omp parallel for if (n_blocks > 1)
+#endif
+  for (int b = 0; b < n_blocks; ++b) {
+    const unsigned first = b * B, last = std::min(n, first + B);
+    for (unsigned i = first; i < last; ++i) {
+      const T px = x[i], py = y[i], pz = z[i];
+      const T r = T(1) / (p8 * px + p9 * py + p10 * pz + p11);
+      u[i] = (p0 * px + p1 * py + p2 * pz + p3) * r;
+      v[i] = (p4 * px + p5 * py + p6 * pz + p7) * r;
+    }
+  }
+}
+
+template <class T>
+void vgl_projective_project_3d(T const P[12], T const* xyz, T* uv, unsigned n)
+{
+  const T p0 = P[0], p1 = P[1], p2 = P[2], p3 = P[3], p4 = P[4], p5 = P[5],
+          p6 = P[6], p7 = P[7], p8 = P[8], p9 = P[9], p10 = P[10], p11 = P[11];
+  const unsigned B = vgl_projective_map_block;
+  const int n_blocks = int((n + B - 1) / B);
+#if defined(_OPENMP)
+#pragma omp parallel for if (n_blocks > 1)
+#endif
+  for (int b = 0; b < n_blocks; ++b) {
+    const unsigned first = b * B, last = std::min(n, first + B);
+    for (unsigned i = first; i < last; ++i) {
+      const T px = xyz[3 * i], py = xyz[3 * i + 1], pz = xyz[3 * i + 2];
+      const T r = T(1) / (p8 * px + p9 * py + p10 * pz + p11);
+      uv[2 * i] = (p0 * px + p1 * py + p2 * pz + p3) * r;
+      uv[2 * i + 1] = (p4 * px + p5 * py + p6 * pz + p7) * r;
+    }
+  }
+}
+
+#undef VGL_PROJECTIVE_MAP_INSTANTIATE
+#define VGL_PROJECTIVE_MAP_INSTANTIATE(T) \
+template void vgl_projective_map_2d(T const[9], T const*, T const*, T*, T*, unsigned); \
+template void vgl_projective_map_2d(T const[9], T const*, T*, unsigned); \
+template void vgl_projective_map_3d(T const[16], T const*, T const*, T const*, T*, T*, T*, unsigned); \
+template void vgl_projective_map_3d(T const[16], T const*, T*, unsigned); \
+template void vgl_projective_project_3d(T const[12], T const*, T const*, T const*, T*, T*, unsigned); \
+template void vgl_projective_project_3d(T const[12], T const*, T*, unsigned)
+
+#endif // vgl_projective_map_hxx_
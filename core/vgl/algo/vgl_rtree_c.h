@@ -127,16 +127,18 @@ class vgl_rtree_box_box_2d
   static void  update(vgl_bbox_2d<T>& b0, vgl_bbox_2d<T> const &b1)
   { b0.add(b1.min_point());  b0.add(b1.max_point()); }
 
+  // Bounds meet if they overlap at all; two boxes may cross without
+  // either containing a corner of the other.
   static bool  meet(vgl_bbox_2d<T> const& b0, vgl_box_2d<T> const& v) {
-    bool resultf =(b0.contains(v.min_point()) || b0.contains(v.max_point()));
-    bool resultr =(v.contains(b0.min_point()) || v.contains(b0.max_point()));
-    return resultf||resultr;
+    return !b0.is_empty() && !v.is_empty() &&
+           b0.min_x() <= v.max_x() && v.min_x() <= b0.max_x() &&
+           b0.min_y() <= v.max_y() && v.min_y() <= b0.max_y();
   }
 
   static bool  meet(vgl_bbox_2d<T> const& b0, vgl_bbox_2d<T> const& b1) {
-    bool resultf =(b0.contains(b1.min_point()) || b0.contains(b1.max_point()));
-    bool resultr =(b1.contains(b0.min_point()) || b1.contains(b0.max_point()));
-    return resultf||resultr;
+    return !b0.is_empty() && !b1.is_empty() &&
+           b0.min_x() <= b1.max_x() && b1.min_x() <= b0.max_x() &&
+           b0.min_y() <= b1.max_y() && b1.min_y() <= b0.max_y();
   }
 
   static float volume(vgl_box_2d<T> const& b)
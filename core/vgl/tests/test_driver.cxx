@@ -18,6 +18,7 @@ DECLARE( test_triangle_3d );
 DECLARE( test_triangle_3d_line_intersection );
 DECLARE( test_infinite_line_3d );
 DECLARE( test_ray_3d );
+DECLARE( test_ray_packet_3d );
 DECLARE( test_plane_3d );
 DECLARE( test_frustum_3d );
 DECLARE( test_intersection );
@@ -45,6 +46,7 @@ register_tests()
   REGISTER( test_triangle_3d_line_intersection );
   REGISTER( test_infinite_line_3d );
   REGISTER( test_ray_3d );
+  REGISTER( test_ray_packet_3d );
   REGISTER( test_plane_3d );
   REGISTER( test_frustum_3d );
   REGISTER( test_intersection );
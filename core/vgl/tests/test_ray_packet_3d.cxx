@@ -0,0 +1,140 @@
+// This is core/vgl/tests/test_ray_packet_3d.cxx
+// Tests of the packet ray-box and ray-triangle tests against the single ray ones
+
+#include <iostream>
+#include <cmath>
+#include <vcl_compiler.h>
+#include <testlib/testlib_test.h>
+#include <vgl/vgl_ray_packet_3d.h>
+#include <vgl/vgl_intersection.h>
+#include <vgl/vgl_triangle_3d.h>
+
+//: Uniform in [lo, hi), from a fixed sequence
+static double uniform(double lo, double hi)
+{
+  static unsigned long s = 12345;
+  s = (s * 1103515245ul + 12345ul) % 2147483648ul;
+  return lo + (hi - lo) * double(s) / 2147483648.0;
+}
+
+static vgl_ray_3d<double> random_ray()
+{
+  vgl_point_3d<double> o(uniform(-4, 4), uniform(-4, 4), uniform(-4, 4));
+  vgl_vector_3d<double> d(uniform(-1, 1), uniform(-1, 1), uniform(-1, 1));
+  return vgl_ray_3d<double>(o, d);
+}
+
+template <unsigned N>
+static void test_box_packet()
+{
+  std::cout << "Box test, packets of " << N << '\n';
+  vgl_box_3d<double> box(-1.0, -0.5, -2.0, 1.5, 0.5, 1.0);
+  unsigned n_hits = 0, wrong = 0, wrong_points = 0, wrong_slab = 0;
+  for (unsigned p = 0; p < 200; ++p) {
+    vgl_ray_packet_3d<double, N> rays;
+    for (unsigned i = 0; i < N; ++i)
+      rays.set(i, random_ray());
+    double tn[N], tf[N];
+    const unsigned hits = vgl_intersection(box, rays, tn, tf);
+    for (unsigned i = 0; i < N; ++i) {
+      vgl_ray_3d<double> ray(rays.origin(i), rays.direction(i));
+      vgl_point_3d<double> p0, p1;
+      const bool hit = vgl_intersection(box, ray, p0, p1);
+      const bool packet_hit = (hits >> i) & 1u;
+      if (hit != packet_hit) { ++wrong; continue; }
+      double sn, sf;
+      const vgl_vector_3d<double> inv(rays.rx[i], rays.ry[i], rays.rz[i]);
+      if (vgl_intersection_slab(box, rays.origin(i), inv, sn, sf) != hit ||
+          (hit && (sn != tn[i] || sf != tf[i])))
+        ++wrong_slab;
+      if (!hit) continue;
+      ++n_hits;
+      // the far point is the exit point; the near one is the entry, or the origin if it is inside
+      vgl_point_3d<double> in = rays.point(i, tn[i]), out = rays.point(i, tf[i]);
+      if (box.contains(ray.origin())) {
+        if ((out - p1).length() > 1e-9 || (in - ray.origin()).length() > 1e-12) ++wrong_points;
+      }
+      else if (std::min((in - p0).length() + (out - p1).length(), (in - p1).length() + (out - p0).length()) > 1e-9)
+        ++wrong_points;
+    }
+  }
+  std::cout << n_hits << " of " << 200 * N << " rays hit\n";
+  TEST("packet hits agree with vgl_intersection(box, ray)", wrong, 0u);
+  TEST("packet entry and exit points agree", wrong_points, 0u);
+  TEST("single ray slab test agrees", wrong_slab, 0u);
+  TEST("some rays hit and some miss", n_hits > 0 && n_hits < 200 * N, true);
+}
+
+static void test_box_special_cases()
+{
+  vgl_box_3d<float> box(0.f, 0.f, 0.f, 1.f, 1.f, 1.f);
+  vgl_ray_packet_3d<float, 4> rays;
+  // parallel to x, inside the y and z slabs: hits
+  rays.set(0, vgl_point_3d<float>(-1.f, 0.5f, 0.5f), vgl_vector_3d<float>(1.f, 0.f, 0.f));
+  // parallel to x, outside the y slab: misses
+  rays.set(1, vgl_point_3d<float>(-1.f, 2.f, 0.5f), vgl_vector_3d<float>(1.f, 0.f, 0.f));
+  // from inside: t_near is 0
+  rays.set(2, vgl_point_3d<float>(0.5f, 0.5f, 0.5f), vgl_vector_3d<float>(0.f, 0.f, -1.f));
+  // box behind the ray: misses
+  rays.set(3, vgl_point_3d<float>(0.5f, 0.5f, 2.f), vgl_vector_3d<float>(0.f, 0.f, 1.f));
+  float tn[4], tf[4];
+  unsigned hits = vgl_intersection(box, rays, tn, tf);
+  TEST("axis parallel rays: hit mask", hits, 5u);
+  TEST("axis parallel ray: entry and exit", tn[0] == 1.f && tf[0] == 2.f, true);
+  TEST("origin inside: entry and exit", tn[2] == 0.f && tf[2] == 0.5f, true);
+  TEST("empty box", vgl_intersection(vgl_box_3d<float>(), rays, tn, tf), 0u);
+}
+
+template <unsigned N>
+static void test_triangle_packet()
+{
+  std::cout << "Triangle test, packets of " << N << '\n';
+  vgl_point_3d<double> a(-2.0, -1.0, 0.5), b(2.5, -0.5, -0.5), c(0.0, 2.0, 1.0);
+  unsigned n_hits = 0, wrong = 0, wrong_points = 0, skipped = 0;
+  for (unsigned p = 0; p < 200; ++p) {
+    vgl_ray_packet_3d<double, N> rays;
+    for (unsigned i = 0; i < N; ++i)
+      rays.set(i, random_ray());
+    double t[N], u[N], v[N];
+    const unsigned hits = vgl_intersection(a, b, c, rays, t, u, v);
+    for (unsigned i = 0; i < N; ++i) {
+      vgl_point_3d<double> o = rays.origin(i), far = rays.point(i, 100.0), ip;
+      vgl_triangle_3d_intersection_t r =
+        vgl_triangle_3d_line_intersection(vgl_line_segment_3d<double>(o, far), a, b, c, ip);
+      const bool packet_hit = (hits >> i) & 1u;
+      // skip rays passing too close to an edge for the two tests to agree
+      if (std::fabs(std::min(std::min(u[i], v[i]), 1.0 - u[i] - v[i])) < 1e-9) { ++skipped; continue; }
+      if (packet_hit != (r == Skew)) { ++wrong; continue; }
+      if (!packet_hit) continue;
+      ++n_hits;
+      vgl_point_3d<double> q = rays.point(i, t[i]);
+      vgl_point_3d<double> bary(a.x() + u[i] * (b.x() - a.x()) + v[i] * (c.x() - a.x()),
+                                a.y() + u[i] * (b.y() - a.y()) + v[i] * (c.y() - a.y()),
+                                a.z() + u[i] * (b.z() - a.z()) + v[i] * (c.z() - a.z()));
+      if ((q - ip).length() > 1e-9 || (bary - ip).length() > 1e-9)
+        ++wrong_points;
+    }
+  }
+  std::cout << n_hits << " of " << 200 * N << " rays hit, " << skipped << " skipped\n";
+  TEST("packet hits agree with vgl_triangle_3d_line_intersection", wrong, 0u);
+  TEST("packet hit points agree", wrong_points, 0u);
+  TEST("some rays hit", n_hits > 0, true);
+
+  // a ray in the plane of the triangle misses
+  vgl_ray_packet_3d<double, N> rays;
+  rays.set(0, a - (b - a), b - a);
+  double t[N], u[N], v[N];
+  TEST("ray in the plane misses", vgl_intersection(a, b, c, rays, t, u, v) & 1u, 0u);
+}
+
+static void test_ray_packet_3d()
+{
+  test_box_packet<4>();
+  test_box_packet<8>();
+  test_box_packet<16>();
+  test_box_special_cases();
+  test_triangle_packet<4>();
+  test_triangle_packet<8>();
+}
+
+TESTMAIN(test_ray_packet_3d);
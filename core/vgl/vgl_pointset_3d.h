@@ -52,8 +52,8 @@ class vgl_pointset_3d
   vgl_vector_3d<Type> n(unsigned i) const
   {if(has_normals_) return normals_[i]; return vgl_vector_3d<Type>();}
 
-  std::vector<vgl_point_3d<Type> > points() const {return points_;}
-  std::vector<vgl_vector_3d<Type> > normals() const {return normals_;}
+  std::vector<vgl_point_3d<Type> > const& points() const {return points_;}
+  std::vector<vgl_vector_3d<Type> > const& normals() const {return normals_;}
 
   void set_points(std::vector<vgl_point_3d<Type> > const& points)
   { points_ = points; has_normals_=false;}
@@ -95,14 +95,14 @@ template <class Type>
   unsigned n = pointset.npts();
   if(n != this->npts())
     return false;
-  std::vector<vgl_point_3d<Type> > pts = pointset.points();
+  std::vector<vgl_point_3d<Type> > const& pts = pointset.points();
   for(unsigned i =0; i<n; ++i)
     if(pts[i] != points_[i])
       return false;
   if(has_normals_){
     if(static_cast<unsigned>(normals_.size()) != n)
       return false;
-    std::vector<vgl_vector_3d<Type> > normals = pointset.normals();
+    std::vector<vgl_vector_3d<Type> > const& normals = pointset.normals();
     for(unsigned i =0; i<n; ++i)
       if(normals[i] != normals_[i])
         return false;
@@ -116,14 +116,14 @@ std::ostream&  operator<<(std::ostream& ostr, vgl_pointset_3d<Type> const& ptset
     std::cout << "Bad ostream in write vgl_pointset_3d to stream\n";
     return ostr;
   }
-  std::vector<vgl_point_3d<Type> > pts = ptset.points();
+  std::vector<vgl_point_3d<Type> > const& pts = ptset.points();
   if(!ptset.has_normals()){
     for(unsigned i =0; i<static_cast<unsigned>(pts.size()); i++){
     const vgl_point_3d<Type>& p = pts[i];
     ostr << p.x() << ',' << p.y() << ',' << p.z() << '\n';
     }
   }else{
-    std::vector<vgl_vector_3d<Type> > normals = ptset.normals();
+    std::vector<vgl_vector_3d<Type> > const& normals = ptset.normals();
     for(unsigned i =0; i<static_cast<unsigned>(pts.size()); i++){
     const vgl_point_3d<Type>& p = pts[i];
     const vgl_vector_3d<Type>& n = normals[i];
@@ -0,0 +1,161 @@
+// This is core/vil/algo/tests/test_algo_polygon_rasteriser.cxx
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <testlib/testlib_test.h>
+#include <vcl_compiler.h>
+#include <vgl/vgl_polygon.h>
+#include <vil/algo/vil_polygon_rasteriser.h>
+
+static vgl_polygon<double> box(double x0, double y0, double x1, double y1)
+{
+  vgl_polygon<double> p(1);
+  p.push_back(x0, y0); p.push_back(x1, y0); p.push_back(x1, y1); p.push_back(x0, y1);
+  return p;
+}
+
+//: A star shaped polygon about (cx,cy), with a square hole if hole>0
+static vgl_polygon<double> star(double cx, double cy, double r, unsigned n, double hole)
+{
+  vgl_polygon<double> p(1);
+  for (unsigned k = 0; k < 2*n; ++k) {
+    double a = 3.14159265358979 * k / n, rk = (k % 2) ? 0.5 * r : r;
+    p.push_back(cx + rk * std::cos(a), cy + rk * std::sin(a));
+  }
+  if (hole > 0) {
+    p.new_sheet();
+    p.push_back(cx - hole, cy - hole); p.push_back(cx + hole, cy - hole);
+    p.push_back(cx + hole, cy + hole); p.push_back(cx - hole, cy + hole);
+  }
+  return p;
+}
+
+static void test_fill()
+{
+  std::vector<vgl_polygon<double> > polys;
+  polys.push_back(star(20.3, 17.6, 15.2, 5, 3.1));
+  polys.push_back(star(50.7, 40.2, 22.9, 7, 0.0));
+  polys.push_back(star(45.1, 80.4, 30.3, 3, 6.3)); // overlaps the previous one
+  polys.push_back(star(95.0, 10.0, 20.0, 6, 0.0)); // partly outside the image
+  vil_polygon_rasteriser<double> raster(polys);
+  TEST("size", raster.size(), 4u);
+
+  const unsigned ni = 90, nj = 110;
+  vil_image_view<int> image(ni, nj);
+  image.fill(-1);
+  std::vector<int> labels;
+  for (int k = 0; k < 4; ++k) labels.push_back(k);
+  raster.fill(image, labels);
+
+  // each pixel has the label of the last polygon containing its centre;
+  // no centre is on an edge, where vgl_polygon::contains counts it inside
+  unsigned wrong = 0, inside = 0, in_each = 0;
+  for (unsigned j = 0; j < nj; ++j)
+    for (unsigned i = 0; i < ni; ++i) {
+      int expected = -1;
+      for (int k = 0; k < 4; ++k)
+        if (polys[k].contains(i, j)) { expected = k; ++in_each; }
+      if (image(i, j) != expected) ++wrong;
+      if (expected >= 0) ++inside;
+    }
+  std::cout << inside << " pixels inside, " << wrong << " wrong\n";
+  TEST("fill agrees with vgl_polygon::contains", wrong, 0u);
+
+  // the chords cover the same pixels
+  std::vector<std::vector<vil_chord> > chords;
+  raster.chords(ni, nj, chords);
+  unsigned n_chord_pixels = 0;
+  for (unsigned k = 0; k < chords.size(); ++k)
+    for (unsigned c = 0; c < chords[k].size(); ++c)
+      n_chord_pixels += chords[k][c].length();
+  vil_image_view<int> one(ni, nj);
+  one.fill(0);
+  raster.fill(one, 1);
+  unsigned n_filled = 0;
+  for (unsigned j = 0; j < nj; ++j)
+    for (unsigned i = 0; i < ni; ++i)
+      n_filled += one(i, j);
+  TEST("fill with one value", n_filled, inside);
+  TEST("chords of each polygon", n_chord_pixels, in_each);
+
+  // a single polygon
+  vil_polygon_rasteriser<double> single(polys[1]);
+  single.chords(ni, nj, chords);
+  unsigned n_single = 0;
+  for (unsigned c = 0; c < chords[0].size(); ++c) n_single += chords[0][c].length();
+  unsigned n_contains = 0;
+  for (unsigned j = 0; j < nj; ++j)
+    for (unsigned i = 0; i < ni; ++i)
+      if (polys[1].contains(i, j)) ++n_contains;
+  TEST("single polygon", n_single, n_contains);
+
+  // pixels on edges shared by two polygons belong to exactly one
+  std::vector<vgl_polygon<double> > tiles;
+  tiles.push_back(box(2, 2, 6, 6));
+  tiles.push_back(box(6, 2, 10, 6));
+  tiles.push_back(box(2, 6, 10, 9));
+  vil_image_view<int> count(12, 12);
+  count.fill(0);
+  vil_image_view<int> tile(12, 12);
+  for (unsigned k = 0; k < tiles.size(); ++k) {
+    tile.fill(0);
+    vil_polygon_rasteriser<double>(tiles[k]).fill(tile, 1);
+    for (unsigned j = 0; j < 12; ++j)
+      for (unsigned i = 0; i < 12; ++i)
+        count(i, j) += tile(i, j);
+  }
+  unsigned twice = 0, once = 0;
+  for (unsigned j = 0; j < 12; ++j)
+    for (unsigned i = 0; i < 12; ++i) {
+      if (count(i, j) > 1) ++twice;
+      if (count(i, j) == 1) ++once;
+    }
+  TEST("shared edges filled once", twice, 0u);
+  TEST("tiles cover 8x7 pixels", once, 56u);
+}
+
+static void test_coverage()
+{
+  vil_image_view<float> cover(10, 10);
+
+  // a square on pixel boundaries
+  vil_polygon_rasteriser<double>(box(1.5, 2.5, 4.5, 5.5)).coverage(cover);
+  float sum = 0.f;
+  for (unsigned j = 0; j < 10; ++j)
+    for (unsigned i = 0; i < 10; ++i) sum += cover(i, j);
+  TEST_NEAR("aligned square: inside", cover(3, 4), 1.0, 1e-6);
+  TEST_NEAR("aligned square: outside", cover(5, 4), 0.0, 1e-6);
+  TEST_NEAR("aligned square: area", sum, 9.0, 1e-5);
+
+  // half a pixel offset in x and a quarter in y
+  vil_polygon_rasteriser<double>(box(2.0, 2.25, 5.0, 5.25)).coverage(cover, 4);
+  TEST_NEAR("offset square: left edge", cover(2, 3), 0.5, 1e-6);
+  TEST_NEAR("offset square: top left corner", cover(2, 2), 0.125, 1e-6);
+  TEST_NEAR("offset square: interior", cover(3, 4), 1.0, 1e-6);
+
+  // a triangle: total coverage is close to its area
+  vgl_polygon<double> tri(1);
+  tri.push_back(0.7, 0.2); tri.push_back(8.1, 1.9); tri.push_back(3.3, 8.8);
+  vil_polygon_rasteriser<double>(tri).coverage(cover, 16);
+  sum = 0.f;
+  for (unsigned j = 0; j < 10; ++j)
+    for (unsigned i = 0; i < 10; ++i) sum += cover(i, j);
+  double area = 0.5 * std::fabs((8.1 - 0.7) * (8.8 - 0.2) - (3.3 - 0.7) * (1.9 - 0.2));
+  TEST_NEAR("triangle area", sum, area, 0.05);
+
+  // overlapping polygons are clamped at 1
+  std::vector<vgl_polygon<double> > two;
+  two.push_back(box(0.5, 0.5, 3.5, 3.5));
+  two.push_back(box(1.5, 1.5, 4.5, 4.5));
+  vil_image_view<double> cd(6, 6);
+  vil_polygon_rasteriser<double>(two).coverage(cd);
+  TEST_NEAR("overlap clamped", cd(2, 2), 1.0, 1e-12);
+}
+
+static void test_algo_polygon_rasteriser()
+{
+  test_fill();
+  test_coverage();
+}
+
+TESTMAIN(test_algo_polygon_rasteriser);
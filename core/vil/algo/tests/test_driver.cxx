@@ -36,6 +36,7 @@ DECLARE( test_algo_suppress_non_max_edges );
 DECLARE( test_algo_checker_board );
 DECLARE( test_algo_quad_distance_function );
 DECLARE( test_algo_flood_fill );
+DECLARE( test_algo_polygon_rasteriser );
 
 void
 register_tests()
@@ -76,6 +77,7 @@ register_tests()
   REGISTER( test_algo_checker_board );
   REGISTER( test_algo_quad_distance_function );
   REGISTER( test_algo_flood_fill );
+  REGISTER( test_algo_polygon_rasteriser );
 }
 
 DEFINE_MAIN;
@@ -0,0 +1,267 @@
+// This is core/vil/algo/vil_polygon_rasteriser.h
+#ifndef vil_polygon_rasteriser_h_
+#define vil_polygon_rasteriser_h_
+//:
+// \file
+// \brief Scan converts many polygons at once into an image
+//
+//    vgl_polygon_scan_iterator converts one polygon at a time, sorting its
+//    edges each time.  vil_polygon_rasteriser takes a whole list of
+//    polygons, sorts all their edges once, and then fills each image row
+//    from the edges crossing it, so that the cost is proportional to the
+//    number of edges and of pixels filled, rather than to the number of
+//    polygons times the image size.  Rows are processed in bands, which
+//    run on separate threads when compiled with OpenMP.
+//
+//    A polygon may have several sheets; a pixel is inside if a ray from it
+//    crosses the sheets an odd number of times, so sheets inside another
+//    sheet are holes, as for vgl_polygon::contains.
+//
+//    Pixel (i,j) has its centre at (i,j).  It is inside a polygon if its
+//    centre is, with centres exactly on a left or top edge counted as
+//    inside and on a right or bottom edge as outside; so pixels on an edge
+//    shared by two polygons belong to exactly one of them.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <vcl_compiler.h>
+#include <vcl_cassert.h>
+#include <vgl/vgl_polygon.h>
+#include <vil/vil_image_view.h>
+#include <vil/vil_chord.h>
+
+//: Scan converts many polygons at once into an image.
+//  For example, to burn building footprints into a label image:
+// \code
+//   vil_polygon_rasteriser<double> raster(footprints);
+//   vil_image_view<vxl_uint_16> labels(ni, nj);
+//   labels.fill(0);
+//   raster.fill(labels, ids);   // ids[k] is the label of footprints[k]
+// \endcode
+template <class C>
+class vil_polygon_rasteriser
+{
+ public:
+  //: Prepare to rasterise the polygons.
+  explicit vil_polygon_rasteriser(std::vector<vgl_polygon<C> > const& polygons)
+    : n_polygons_((unsigned)polygons.size())
+  {
+    for (unsigned k = 0; k < polygons.size(); ++k)
+      add_edges(polygons[k], k);
+    std::sort(edges_.begin(), edges_.end());
+  }
+
+  //: Prepare to rasterise a single polygon.
+  explicit vil_polygon_rasteriser(vgl_polygon<C> const& polygon)
+    : n_polygons_(1)
+  {
+    add_edges(polygon, 0);
+    std::sort(edges_.begin(), edges_.end());
+  }
+
+  //: Number of polygons
+  unsigned size() const { return n_polygons_; }
+
+  //: Set image(i,j,plane) to values[k] for each pixel inside polygon k.
+  //  Where polygons overlap, the later one in the list wins.
+  //  Other pixels are left unchanged.
+  template <class T>
+  void fill(vil_image_view<T>& image, std::vector<T> const& values, unsigned plane = 0) const
+  {
+    assert(values.size() >= n_polygons_);
+    assert(plane < image.nplanes());
+    const int nj = image.nj(), n_bands = (nj + band_ - 1) / band_;
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int b = 0; b < n_bands; ++b) {
+      scanner s(*this);
+      std::vector<crossing> cr;
+      for (int j = b * band_; j < std::min(nj, (b + 1) * band_); ++j) {
+        s.crossings(j, cr);
+        for (unsigned c = 0; c + 1 < cr.size(); c += 2) {
+          int ilo, ihi;
+          if (span(cr[c].x, cr[c+1].x, image.ni(), ilo, ihi)) {
+            const T v = values[cr[c].poly];
+            T* p = &image(ilo, j, plane);
+            for (int i = ilo; i <= ihi; ++i, p += image.istep())
+              *p = v;
+          }
+        }
+      }
+    }
+  }
+
+  //: Set image(i,j,plane) to value for each pixel inside any of the polygons.
+  template <class T>
+  void fill(vil_image_view<T>& image, T value, unsigned plane = 0) const
+  {
+    fill(image, std::vector<T>(n_polygons_, value), plane);
+  }
+
+  //: The pixels of an ni x nj image inside each polygon, as chords.
+  //  chords[k] lists the rows of pixels inside polygon k, ordered by j.
+  void chords(unsigned ni, unsigned nj, std::vector<std::vector<vil_chord> >& chords) const
+  {
+    chords.assign(n_polygons_, std::vector<vil_chord>());
+    scanner s(*this);
+    std::vector<crossing> cr;
+    for (unsigned j = 0; j < nj; ++j) {
+      s.crossings(j, cr);
+      for (unsigned c = 0; c + 1 < cr.size(); c += 2) {
+        int ilo, ihi;
+        if (span(cr[c].x, cr[c+1].x, ni, ilo, ihi))
+          chords[cr[c].poly].push_back(vil_chord(ilo, ihi, j));
+      }
+    }
+  }
+
+  //: Set each pixel of cover to the fraction of its area inside the polygons.
+  //  The pixel (i,j) is the square [i-0.5,i+0.5] x [j-0.5,j+0.5].  Each
+  //  row is sampled on the given number of lines, and the length of each
+  //  line inside the polygons is found exactly, so edges are anti-aliased.
+  //  Where polygons overlap, their coverages are added and clamped at 1.
+  //  cover must already have the size of the image.
+  template <class T>
+  void coverage(vil_image_view<T>& cover, unsigned subsamples = 4, unsigned plane = 0) const
+  {
+    assert(plane < cover.nplanes());
+    const int ni = cover.ni(), nj = cover.nj(), n_bands = (nj + band_ - 1) / band_;
+    const unsigned ns = subsamples < 1 ? 1 : subsamples;
+    const double w = 1.0 / ns;
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int b = 0; b < n_bands; ++b) {
+      scanner s(*this);
+      std::vector<crossing> cr;
+      std::vector<double> row(ni);
+      for (int j = b * band_; j < std::min(nj, (b + 1) * band_); ++j) {
+        std::fill(row.begin(), row.end(), 0.0);
+        for (unsigned k = 0; k < ns; ++k) {
+          s.crossings(j - 0.5 + (k + 0.5) * w, cr);
+          for (unsigned c = 0; c + 1 < cr.size(); c += 2)
+            add_coverage(cr[c].x, cr[c+1].x, w, row);
+        }
+        for (int i = 0; i < ni; ++i)
+          cover(i, j, plane) = T(row[i] < 1.0 ? row[i] : 1.0);
+      }
+    }
+  }
+
+ private:
+  struct edge
+  {
+    double ytop, ybot; //!< ytop < ybot
+    double x;          //!< x at ytop
+    double dxdy;
+    unsigned poly;
+    bool operator<(edge const& e) const { return ytop < e.ytop; }
+  };
+
+  struct crossing
+  {
+    double x;
+    unsigned poly;
+    bool operator<(crossing const& c) const { return poly < c.poly || (poly == c.poly && x < c.x); }
+  };
+
+  //: Walks down the edges, keeping those crossing the current line.
+  //  Lines must be visited in increasing y.
+  class scanner
+  {
+   public:
+    explicit scanner(vil_polygon_rasteriser<C> const& r) : edges_(r.edges_), next_(0) {}
+
+    //: Crossings of the polygons with line y, sorted by polygon and then by x.
+    void crossings(double y, std::vector<crossing>& cr)
+    {
+      while (next_ < edges_.size() && edges_[next_].ytop <= y)
+        active_.push_back(&edges_[next_++]);
+      cr.clear();
+      unsigned n = 0;
+      for (unsigned a = 0; a < active_.size(); ++a) {
+        edge const* e = active_[a];
+        if (e->ybot <= y)
+          continue; // passed: drop it
+        active_[n++] = e;
+        crossing c;
+        c.x = e->x + (y - e->ytop) * e->dxdy;
+        c.poly = e->poly;
+        cr.push_back(c);
+      }
+      active_.resize(n);
+      std::sort(cr.begin(), cr.end());
+    }
+
+   private:
+    std::vector<edge> const& edges_;
+    unsigned next_;
+    std::vector<edge const*> active_;
+  };
+
+  void add_edges(vgl_polygon<C> const& poly, unsigned k)
+  {
+    for (unsigned s = 0; s < poly.num_sheets(); ++s) {
+      typename vgl_polygon<C>::sheet_t const& sheet = poly[s];
+      for (unsigned v = 0; v < sheet.size(); ++v) {
+        double x0 = sheet[v].x(), y0 = sheet[v].y();
+        double x1 = sheet[(v + 1) % sheet.size()].x(), y1 = sheet[(v + 1) % sheet.size()].y();
+        if (y0 == y1)
+          continue; // horizontal edges never cross a line
+        if (y0 > y1) { std::swap(x0, x1); std::swap(y0, y1); }
+        edge e;
+        e.ytop = y0; e.ybot = y1; e.x = x0;
+        e.dxdy = (x1 - x0) / (y1 - y0);
+        e.poly = k;
+        edges_.push_back(e);
+      }
+    }
+  }
+
+  //: Pixels ilo..ihi with centres in [xa, xb), clipped to 0..ni-1; false if none.
+  static bool span(double xa, double xb, int ni, int& ilo, int& ihi)
+  {
+    double lo = std::ceil(xa), hi = std::ceil(xb) - 1;
+    if (lo < 0) lo = 0;
+    if (hi > ni - 1) hi = ni - 1;
+    if (lo > hi)
+      return false;
+    ilo = int(lo); ihi = int(hi);
+    return true;
+  }
+
+  //: Add w times the length of [xa,xb] within each pixel to row.
+  static void add_coverage(double xa, double xb, double w, std::vector<double>& row)
+  {
+    const int ni = (int)row.size();
+    xa = std::max(xa, -0.5);
+    xb = std::min(xb, ni - 0.5);
+    if (!(xa < xb))
+      return;
+    int ia = int(std::floor(xa + 0.5)), ib = int(std::floor(xb + 0.5));
+    if (ib >= ni) ib = ni - 1;
+    if (ia == ib) {
+      row[ia] += w * (xb - xa);
+      return;
+    }
+    row[ia] += w * (ia + 0.5 - xa);
+    for (int i = ia + 1; i < ib; ++i)
+      row[i] += w;
+    row[ib] += w * (xb - (ib - 0.5));
+  }
+
+  //: Rows per band of work
+  static const int band_ = 32;
+
+  unsigned n_polygons_;
+  //: Edges of all polygons, sorted by ytop
+  std::vector<edge> edges_;
+};
+
+#endif // vil_polygon_rasteriser_h_
@@ -34,6 +34,10 @@
 #include <dctagkey.h>
 #include <dcdeftag.h>
 #include <dcstack.h>
+#include <dcxfer.h>
+#if HAS_DCMTK_RLE
+#include <dcrledrg.h>
+#endif
 #include <diinpxt.h>
 
 #include "vil_dicom_stream.h"
@@ -107,6 +111,7 @@ read_header( DcmObject* dataset, vil_dicom_header_info& i );
 static
 void
 read_pixels_into_buffer(DcmPixelData* pixels,
+                        unsigned first_sample,
                         unsigned num_samples,
                         Uint16 alloc,
                         Uint16 stored,
@@ -117,18 +122,38 @@ read_pixels_into_buffer(DcmPixelData* pixels,
                         vil_memory_chunk_sptr& out_buf,
                         vil_pixel_format& out_format);
 
+static
+bool
+can_read_directly(DcmPixelData* pixels,
+                  unsigned first_sample,
+                  unsigned num_samples,
+                  Uint16 alloc,
+                  Uint16 stored,
+                  Uint16 high,
+                  Uint16 rep);
+
 
 vil_dicom_image::vil_dicom_image(vil_stream* vs)
-  : pixels_( 0 )
+  : pixels_( 0 ),
+    ffmt_( 0 ),
+    pixel_data_( 0 ),
+    current_frame_( 0 ),
+    bits_alloc_( 0 ), bits_stored_( 0 ), high_bit_( 0 ), pixel_rep_( 0 ),
+    slope_( 1 ), intercept_( 0 )
 {
   vil_dicom_header_info_clear( header_ );
 
+#if HAS_DCMTK_RLE
+  // Allow RLE compressed pixel data to be decoded (registers only once)
+  DcmRLEDecoderRegistration::registerCodecs();
+#endif
+
   vil_dicom_stream_input dcis( vs );
 
-  DcmFileFormat ffmt;
-  ffmt.transferInit();
-  OFCondition cond = ffmt.read( dcis );
-  ffmt.transferEnd();
+  ffmt_ = new DcmFileFormat;
+  ffmt_->transferInit();
+  OFCondition cond = ffmt_->read( dcis );
+  ffmt_->transferEnd();
 
   if ( cond != EC_Normal ) {
     std::cerr << "vil_dicom ERROR: could not read file (" << cond.text() << ")\n"
@@ -137,7 +162,17 @@ vil_dicom_image::vil_dicom_image(vil_stream* vs)
       return;
   }
 
-  DcmDataset& dset = *ffmt.getDataset();
+  DcmDataset& dset = *ffmt_->getDataset();
+
+#if HAS_DCMTK_RLE
+  // Decompress encapsulated pixel data (e.g. RLE) to the native representation
+  if ( DcmXfer( dset.getOriginalXfer() ).isEncapsulated() &&
+       dset.chooseRepresentation( EXS_LittleEndianExplicit, 0 ) != EC_Normal ) {
+    std::cerr << "vil_dicom ERROR: can't decompress pixel data\n";
+    return;
+  }
+#endif
+
   read_header( &dset, header_ );
 
   //correct known manufacturers' drop-offs in header data!
@@ -181,46 +216,69 @@ vil_dicom_image::vil_dicom_image(vil_stream* vs)
 #undef MustRead
 #undef Stringify
 
-  // The pixels buffer will eventually be assigned to pixel_buf, and
-  // the pixel format written into pixel_format.
-  //
-  vil_memory_chunk_sptr pixel_buf;
-  vil_pixel_format pixel_format = VIL_PIXEL_FORMAT_UNKNOWN;
+  bits_alloc_ = bits_alloc;
+  bits_stored_ = bits_stored;
+  high_bit_ = high_bit;
+  pixel_rep_ = pixel_rep;
+  slope_ = slope;
+  intercept_ = intercept;
 
-  // First, read in the bytes and interpret them appropriately
-  //
+  // Find the pixel data; it is decoded one frame at a time, on demand.
+  DcmStack stack;
+  if ( dset.search( DCM_PixelData, stack, ESM_fromHere, true ) == EC_Normal )
   {
-    DcmPixelData* pixels = 0;
-    DcmStack stack;
-    if ( dset.search( DCM_PixelData, stack, ESM_fromHere, true ) == EC_Normal )
-    {
-      if ( stack.card() == 0 ) {
-        std::cerr << "vil_dicom ERROR: no pixel data found\n";
-        return;
-      }
-      else {
-        assert( stack.top()->ident() == EVR_PixelData );
-        pixels = static_cast<DcmPixelData*>(stack.top());
-      }
+    if ( stack.card() == 0 ) {
+      std::cerr << "vil_dicom ERROR: no pixel data found\n";
+      return;
+    }
+    else {
+      assert( stack.top()->ident() == EVR_PixelData );
+      pixel_data_ = static_cast<DcmPixelData*>(stack.top());
     }
-    unsigned num_samples = ni() * nj() * nplanes();
-    read_pixels_into_buffer(pixels, num_samples,
-                            bits_alloc, bits_stored, high_bit, pixel_rep,
-                            slope, intercept,
-                            pixel_buf, pixel_format);
   }
 
-  // Create an image resource to manage the pixel buffer
-  //
+  Sint32 num_frames;
+  if ( dset.findAndGetSint32( DCM_NumberOfFrames, num_frames ) != EC_Normal || num_frames < 1 )
+    num_frames = 1;
+  frames_.resize( num_frames );
+
+  set_current_frame( 0 );
+}
+
+
+void vil_dicom_image::set_current_frame(unsigned f)
+{
+  assert( f < frames_.size() );
+  current_frame_ = f;
+  if ( !frames_[f] )
+    decode_frames( f );
+  pixels_ = frames_[f];
+
+  // Once every frame has been decoded, release the parsed file.
+  for ( unsigned k = 0; k < frames_.size(); ++k )
+    if ( !frames_[k] ) return;
+  delete ffmt_;
+  ffmt_ = 0;
+  pixel_data_ = 0;
+}
+
+
+//: Wrap the samples of one frame, starting at sample offset, in an image resource
+static vil_image_resource_sptr
+frame_resource(vil_memory_chunk_sptr const& pixel_buf,
+               vil_pixel_format pixel_format,
+               unsigned offset,
+               unsigned ni, unsigned nj, unsigned nplanes)
+{
 #define DOCASE( fmt )                                                \
       case fmt: {                                                    \
         typedef vil_pixel_format_type_of<fmt>::component_type T;     \
-        pixels_ = vil_new_image_resource_of_view(                    \
-                    vil_image_view<T>(pixel_buf,                     \
-                                      (T*)pixel_buf->data(),         \
-                                      ni(), nj(), nplanes(),         \
-                                      nplanes(), ni()*nplanes(), 1));\
-      } break
+        return vil_new_image_resource_of_view(                       \
+                 vil_image_view<T>(pixel_buf,                        \
+                                   (T*)pixel_buf->data() + offset,   \
+                                   ni, nj, nplanes,                  \
+                                   nplanes, ni*nplanes, 1));         \
+      }
 
   switch ( pixel_format ) {
     DOCASE( VIL_PIXEL_FORMAT_UINT_16 );
@@ -231,6 +289,43 @@ vil_dicom_image::vil_dicom_image(vil_stream* vs)
     default: std::cerr << "vil_dicom ERROR: unexpected pixel format\n";
   }
 #undef DOCASE
+  return 0;
+}
+
+
+void vil_dicom_image::decode_frames(unsigned f)
+{
+  if ( !pixel_data_ ) return;
+
+  unsigned frame_samples = ni() * nj() * nplanes();
+  Uint16 alloc = Uint16(bits_alloc_), stored = Uint16(bits_stored_);
+  Uint16 high = Uint16(high_bit_), rep = Uint16(pixel_rep_);
+
+  // Samples that must be unpacked go through DiInputPixelTemplate, which
+  // always converts the whole pixel element. Rather than repeat that for
+  // each frame, convert once and share the buffer between all the frames.
+  unsigned first = f, count = 1;
+  if ( !can_read_directly( pixel_data_, f * frame_samples, frame_samples,
+                           alloc, stored, high, rep ) ) {
+    first = 0;
+    count = nframes();
+  }
+
+  // The pixels buffer will eventually be assigned to pixel_buf, and
+  // the pixel format written into pixel_format.
+  //
+  vil_memory_chunk_sptr pixel_buf;
+  vil_pixel_format pixel_format = VIL_PIXEL_FORMAT_UNKNOWN;
+  read_pixels_into_buffer(pixel_data_, first * frame_samples, count * frame_samples,
+                          alloc, stored, high, rep,
+                          slope_, intercept_,
+                          pixel_buf, pixel_format);
+  if ( !pixel_buf ) return;
+
+  for ( unsigned k = 0; k < count; ++k )
+    if ( !frames_[first+k] )
+      frames_[first+k] = frame_resource( pixel_buf, pixel_format, k * frame_samples,
+                                         ni(), nj(), nplanes() );
 }
 
 
@@ -262,6 +357,11 @@ char const* vil_dicom_image::file_format() const
 
 vil_dicom_image::vil_dicom_image(vil_stream* /*vs*/, unsigned ni, unsigned nj,
                                  unsigned nplanes, vil_pixel_format format)
+  : ffmt_( 0 ),
+    pixel_data_( 0 ),
+    current_frame_( 0 ),
+    bits_alloc_( 0 ), bits_stored_( 0 ), high_bit_( 0 ), pixel_rep_( 0 ),
+    slope_( 1 ), intercept_( 0 )
 {
   assert(!"vil_dicom_image doesn't yet support output");
 
@@ -273,6 +373,7 @@ vil_dicom_image::vil_dicom_image(vil_stream* /*vs*/, unsigned ni, unsigned nj,
 
 vil_dicom_image::~vil_dicom_image()
 {
+  delete ffmt_;
 }
 
 unsigned vil_dicom_image::nplanes() const
@@ -967,6 +1068,7 @@ namespace
   void
   convert_src_type( InT const*,
                     DcmPixelData* pixels,
+                    unsigned first_sample,
                     unsigned num_samples,
                     Uint16 alloc,
                     Uint16 stored,
@@ -977,22 +1079,24 @@ namespace
   {
     if ( rep == 0 && stored <= 8 ) {
       act_format = VIL_PIXEL_FORMAT_BYTE;
-      pixel_data = new DiInputPixelTemplate<InT,Uint8>( pixels, alloc, stored, high, 0, num_samples );
+      pixel_data = new DiInputPixelTemplate<InT,Uint8>( pixels, alloc, stored, high, first_sample, num_samples );
     }
     else if ( rep == 0 && stored <= 16 ) {
       act_format = VIL_PIXEL_FORMAT_UINT_16;
-      pixel_data = new DiInputPixelTemplate<InT,Uint16>( pixels, alloc, stored, high, 0, num_samples );
+      pixel_data = new DiInputPixelTemplate<InT,Uint16>( pixels, alloc, stored, high, first_sample, num_samples );
     }
     else if ( rep == 1 && stored <= 8 ) {
       act_format = VIL_PIXEL_FORMAT_SBYTE;
-      pixel_data = new DiInputPixelTemplate<InT,Sint8>( pixels, alloc, stored, high, 0, num_samples );
+      pixel_data = new DiInputPixelTemplate<InT,Sint8>( pixels, alloc, stored, high, first_sample, num_samples );
     }
     else if ( rep == 1 && stored <= 16 ) {
       act_format = VIL_PIXEL_FORMAT_INT_16;
-      pixel_data = new DiInputPixelTemplate<InT,Sint16>( pixels, alloc, stored, high, 0, num_samples );
+      pixel_data = new DiInputPixelTemplate<InT,Sint16>( pixels, alloc, stored, high, first_sample, num_samples );
     }
   }
 
+  // Written as an indexed loop over distinct types, so that the compiler
+  // can vectorise the conversion and multiply-add.
   template<class IntType, class OutType>
   void
   rescale_values( IntType const* int_begin,
@@ -1000,11 +1104,80 @@ namespace
                   OutType* float_begin,
                   Float64 slope, Float64 intercept )
   {
-    IntType const* const int_end = int_begin + num_samples;
-    for ( ; int_begin != int_end; ++int_begin, ++float_begin ) {
-      *float_begin = static_cast<OutType>( *int_begin * slope + intercept );
+    for ( unsigned k = 0; k < num_samples; ++k ) {
+      float_begin[k] = static_cast<OutType>( int_begin[k] * slope + intercept );
+    }
+  }
+
+  //: Rescale num_samples values of integral type in_format into a new float buffer
+  void
+  rescale_into_buffer( void const* in_begin,
+                       vil_pixel_format in_format,
+                       unsigned num_samples,
+                       Float64 slope, Float64 intercept,
+                       vil_memory_chunk_sptr& out_buf,
+                       vil_pixel_format& out_format )
+  {
+    out_buf = new vil_memory_chunk( num_samples * sizeof(float), VIL_PIXEL_FORMAT_FLOAT );
+    out_format = VIL_PIXEL_FORMAT_FLOAT;
+    float* out_begin = static_cast<float*>( out_buf->data() );
+
+    switch ( in_format )
+    {
+     case VIL_PIXEL_FORMAT_BYTE:
+      rescale_values( (vxl_byte const*)in_begin, num_samples, out_begin, slope, intercept );
+      break;
+     case VIL_PIXEL_FORMAT_SBYTE:
+      rescale_values( (vxl_sbyte const*)in_begin, num_samples, out_begin, slope, intercept );
+      break;
+     case VIL_PIXEL_FORMAT_UINT_16:
+      rescale_values( (vxl_uint_16 const*)in_begin, num_samples, out_begin, slope, intercept );
+      break;
+     case VIL_PIXEL_FORMAT_INT_16:
+      rescale_values( (vxl_sint_16 const*)in_begin, num_samples, out_begin, slope, intercept );
+      break;
+     default:
+      std::cerr << "vil_dicom ERROR: unexpected internal pixel format\n";
+    }
+  }
+
+#ifndef MIXED_ENDIAN
+  //: Get a pointer to samples [first_sample, first_sample+num_samples) straight from DCMTK's buffer.
+  // This is only possible when each sample fills its allocated bits, so that
+  // no overlay bits need masking off and no shifting is needed. Returns 0
+  // if the data can't be used directly.
+  void const*
+  direct_samples( DcmPixelData* pixels,
+                  unsigned first_sample,
+                  unsigned num_samples,
+                  Uint16 alloc,
+                  Uint16 stored,
+                  Uint16 high,
+                  Uint16 rep,
+                  vil_pixel_format& act_format )
+  {
+    if ( stored != alloc || high != alloc-1 )
+      return 0;
+    Uint32 length = pixels->getLength();
+    if ( alloc == 16 && pixels->getVR() == EVR_OW ) {
+      Uint16* data = 0;
+      if ( pixels->getUint16Array( data ) != EC_Normal || !data ||
+           length < 2 * (first_sample + num_samples) )
+        return 0;
+      act_format = rep ? VIL_PIXEL_FORMAT_INT_16 : VIL_PIXEL_FORMAT_UINT_16;
+      return data + first_sample;
     }
+    if ( alloc == 8 && pixels->getVR() != EVR_OW ) {
+      Uint8* data = 0;
+      if ( pixels->getUint8Array( data ) != EC_Normal || !data ||
+           length < first_sample + num_samples )
+        return 0;
+      act_format = rep ? VIL_PIXEL_FORMAT_SBYTE : VIL_PIXEL_FORMAT_BYTE;
+      return data + first_sample;
+    }
+    return 0;
   }
+#endif //MIXED_ENDIAN
 } // anonymous namespace
 #ifdef MIXED_ENDIAN
 static  unsigned short swap_short(unsigned short v)
@@ -1022,9 +1195,30 @@ static void swap_shorts(unsigned short *ip, unsigned short *op, int count)
   }
 }
 #endif //MIXED_ENDIAN
+static
+bool
+can_read_directly(DcmPixelData* pixels,
+                  unsigned first_sample,
+                  unsigned num_samples,
+                  Uint16 alloc,
+                  Uint16 stored,
+                  Uint16 high,
+                  Uint16 rep)
+{
+#ifdef MIXED_ENDIAN
+  return false;
+#else
+  vil_pixel_format fmt;
+  return direct_samples( pixels, first_sample, num_samples,
+                         alloc, stored, high, rep, fmt ) != 0;
+#endif //MIXED_ENDIAN
+}
+
+
 static
 void
 read_pixels_into_buffer(DcmPixelData* pixels,
+                        unsigned first_sample,
                         unsigned num_samples,
                         Uint16 alloc,
                         Uint16 stored,
@@ -1041,16 +1235,35 @@ read_pixels_into_buffer(DcmPixelData* pixels,
   //
   vil_pixel_format act_format = VIL_PIXEL_FORMAT_UNKNOWN;
 
+#ifndef MIXED_ENDIAN
+  // Common case of 8 or 16 bit samples with no overlay bits: copy or
+  // rescale the frame straight out of DCMTK's buffer, with no intermediate
+  // DiInputPixel conversion.
+  void const* direct = direct_samples( pixels, first_sample, num_samples,
+                                       alloc, stored, high, rep, act_format );
+  if ( direct ) {
+    if ( slope == 1 && intercept == 0 ) {
+      out_format = act_format;
+      out_buf = new vil_memory_chunk( num_samples * (alloc/8), act_format );
+      std::memcpy( out_buf->data(), direct, out_buf->size() );
+    }
+    else {
+      rescale_into_buffer( direct, act_format, num_samples, slope, intercept, out_buf, out_format );
+    }
+    return;
+  }
+#endif //MIXED_ENDIAN
+
   // First convert from the stored src pixels to the actual
   // pixels. This is an integral type to integral type conversion.
   // Make sure pixel_data is deleted before this function exits!
   //
   DiInputPixel* pixel_data = 0;
   if ( pixels->getVR() == EVR_OW ) {
-    convert_src_type( (Uint16*)0, pixels, num_samples, alloc, stored, high, rep, pixel_data, act_format );
+    convert_src_type( (Uint16*)0, pixels, first_sample, num_samples, alloc, stored, high, rep, pixel_data, act_format );
   }
   else {
-    convert_src_type( (Uint8*)0, pixels, num_samples, alloc, stored, high, rep, pixel_data, act_format );
+    convert_src_type( (Uint8*)0, pixels, first_sample, num_samples, alloc, stored, high, rep, pixel_data, act_format );
   }
 #ifdef MIXED_ENDIAN
 #ifdef NO_OFFSET
@@ -1063,7 +1276,7 @@ read_pixels_into_buffer(DcmPixelData* pixels,
   bool swap_data = false;
   unsigned short* temp1 = new unsigned short[num_samples];
   unsigned short* temp2 =
-    reinterpret_cast<unsigned short*>(pixel_data->getData());
+    reinterpret_cast<unsigned short*>(pixel_data->getData()) + first_sample;
   swap_shorts(temp2, temp1, num_samples);
   vxl_byte* temp3 = reinterpret_cast<vxl_byte*>(temp1);
 #endif //MIXED_ENDIAN
@@ -1071,9 +1284,19 @@ read_pixels_into_buffer(DcmPixelData* pixels,
   if ( pixel_data == 0 ) {
     return;
   }
-
-  // The data has been copied and converted. Release the source.
-  pixels->clear();
+  // The conversion covers the whole pixel element, all frames included.
+  if ( pixel_data->getCount() < first_sample + num_samples ) {
+    std::cerr << "vil_dicom ERROR: pixel data is shorter than expected\n";
+#ifdef MIXED_ENDIAN
+    delete [] temp1;
+#endif //MIXED_ENDIAN
+    delete pixel_data;
+    return;
+  }
+#ifndef MIXED_ENDIAN
+  void const* first = static_cast<char const*>( pixel_data->getData() ) +
+                      first_sample * vil_pixel_format_sizeof_components( act_format );
+#endif //MIXED_ENDIAN
 
   // Now, the actual buffer is good, or else we need to rescale
   //
@@ -1091,36 +1314,16 @@ read_pixels_into_buffer(DcmPixelData* pixels,
 #ifdef MIXED_ENDIAN
     std::memcpy( out_buf->data(), temp3, out_buf->size() );
 #else
-    std::memcpy( out_buf->data(), pixel_data->getData(), out_buf->size() );
+    std::memcpy( out_buf->data(), first, out_buf->size() );
 #endif //MIXED_ENDIAN
   }
   else {
-    out_buf = new vil_memory_chunk( num_samples * sizeof(float), VIL_PIXEL_FORMAT_FLOAT );
-    out_format = VIL_PIXEL_FORMAT_FLOAT;
 #ifdef MIXED_ENDIAN
     void* in_begin = reinterpret_cast<void*>(temp1);
 #else
-    void* in_begin = const_cast<void*>(pixel_data->getData());
+    void const* in_begin = first;
 #endif //MIXED_ENDIAN
-    float* out_begin = static_cast<float*>( out_buf->data() );
-
-    switch ( act_format )
-    {
-     case VIL_PIXEL_FORMAT_BYTE:
-      rescale_values( (vxl_byte*)in_begin, num_samples, out_begin, slope, intercept );
-      break;
-     case VIL_PIXEL_FORMAT_SBYTE:
-      rescale_values( (vxl_sbyte*)in_begin, num_samples, out_begin, slope, intercept );
-      break;
-     case VIL_PIXEL_FORMAT_UINT_16:
-      rescale_values( (vxl_uint_16*)in_begin, num_samples, out_begin, slope, intercept );
-      break;
-     case VIL_PIXEL_FORMAT_INT_16:
-      rescale_values( (vxl_sint_16*)in_begin, num_samples, out_begin, slope, intercept );
-      break;
-     default:
-      std::cerr << "vil_dicom ERROR: unexpected internal pixel format\n";
-    }
+    rescale_into_buffer( in_begin, act_format, num_samples, slope, intercept, out_buf, out_format );
   }
 
 #ifdef MIXED_ENDIAN
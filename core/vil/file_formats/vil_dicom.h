@@ -10,14 +10,22 @@
 // \author Amitha Perera
 //
 // This dicom parser is a wrapper around DCMTK.
+//
+// Multi-frame images are supported: nframes() gives the number of frames and
+// set_current_frame() selects the one returned by get_view(). Frames stored
+// as plain 8 or 16 bit samples are decoded the first time they are selected;
+// packed samples (e.g. 12 bits in 16) are decoded all at once.
 
 #include <vil/vil_image_resource.h>
 #include <vil/vil_file_format.h>
 #include <vil/file_formats/vil_dicom_header.h>
 
+#include <vector>
+
 class DicomImage;
 class vil_dicom_stream_input;
 class DcmFileFormat;
+class DcmPixelData;
 
 class vil_image_view_base;
 
@@ -42,6 +50,22 @@ class vil_dicom_image : public vil_image_resource
   vil_dicom_header_info header_;
   vil_image_resource_sptr pixels_;
 
+  //: The parsed file, kept until every frame has been decoded
+  DcmFileFormat* ffmt_;
+  //: The (undecoded) pixel data element within ffmt_
+  DcmPixelData* pixel_data_;
+  //: Decoded frames; null until first selected
+  std::vector<vil_image_resource_sptr> frames_;
+  unsigned current_frame_;
+
+  // How the samples are stored, and the rescale to apply to them
+  unsigned bits_alloc_, bits_stored_, high_bit_, pixel_rep_;
+  double slope_, intercept_;
+
+  //: Decode frame f of the pixel data into frames_.
+  // Frames whose samples need unpacking are all decoded together.
+  void decode_frames(unsigned f);
+
  public:
   vil_dicom_image(vil_stream* is, unsigned ni,
                   unsigned nj, unsigned nplanes,
@@ -69,6 +93,16 @@ class vil_dicom_image : public vil_image_resource
   // Dicom specific stuff
   vil_dicom_header_info const& header() const { return header_; }
 
+  //: Number of frames in the image (1 unless it is a multi-frame image)
+  unsigned nframes() const { return unsigned(frames_.size()); }
+
+  //: Index of the frame returned by get_view() and get_copy_view()
+  unsigned current_frame() const { return current_frame_; }
+
+  //: Select the frame returned by get_view() and get_copy_view().
+  // The frame is decoded if this is the first time it is selected.
+  void set_current_frame(unsigned f);
+
   //:correct known manufacturers drop-offs in header data!
   //For example Hologic encode pixel-size in the imageComment!
   //NB if this section starts bloating, use derived classes which override correct_manufacturer_discrepancies
@@ -7,6 +7,8 @@
 // (To enable debug logging, set value to vil_nitf2::log_debug)
 vil_nitf2::enum_log_level vil_nitf2::s_log_level = vil_nitf2::log_none;
 
+bool vil_nitf2::s_lazy_parsing = false;
+
 #include "vil_nitf2_header.h"
 #include "vil_nitf2_field_definition.h"
 #include "vil_nitf2_image_subheader.h"
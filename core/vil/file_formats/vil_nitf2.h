@@ -46,6 +46,14 @@ class vil_nitf2
   // Logging level for all vil_nitf classes. This could be generalized to an
   // array, if different subsets of classes want their own logging levels.
   static enum_log_level s_log_level;
+
+  // When set, vil_nitf2_image only indexes the byte offsets of image segments
+  // and tagged record extensions (TREs) when a file is opened; image subheaders
+  // and TRE fields are then decoded the first time they are requested.
+  // This makes opening files with many segments or TREs much cheaper, at the
+  // cost of reporting some header errors later than parse_headers().
+  // Defaults to false (everything is parsed on open).
+  static bool s_lazy_parsing;
   /**
     * Call this function to flush all of the nitf2 classes statically
     * allocated memory.  Usually, you'd want to do this just before
@@ -5,6 +5,7 @@
 #include <cstring>
 #include <algorithm>
 #include <cstdlib>
+#include <iostream>
 #include "vil_nitf2_image.h"
 
 //:
@@ -72,6 +73,12 @@ vil_streampos vil_nitf2_image::get_offset_to( vil_nitf2_header::section_type sec
     //file header is the first thing
     p = 0;
   }
+  else if ( sec == vil_nitf2_header::enum_image_segments &&
+            index < m_image_subheader_offsets.size() ) {
+    // indexed once by parse_headers()
+    p = por == vil_nitf2_header::enum_subheader ? m_image_subheader_offsets[index]
+                                                : m_image_data_offsets[index];
+  }
   else {
     vil_nitf2_header::section_type preceding_section = (vil_nitf2_header::section_type)(sec-1);
     p = get_offset_to( preceding_section, vil_nitf2_header::enum_subheader, 0 ) +
@@ -288,12 +295,12 @@ bool vil_nitf2_image::parse_headers()
   if (!m_file_header.read(m_stream)) {
     return false;
   }
-  //now parse each image header
+  index_image_segments();
+  //now parse each image header (unless they are to be parsed on demand)
   clear_image_headers();
-  m_image_headers.resize(nimages());
-  for (unsigned int i = 0 ; i < nimages() ; i++) {
-    vil_streampos offset = get_offset_to( vil_nitf2_header::enum_image_segments, vil_nitf2_header::enum_subheader, i);
-    m_stream->seek(offset);
+  m_image_headers.resize(nimages(), VXL_NULLPTR);
+  for (unsigned int i = 0 ; i < nimages() && !vil_nitf2::s_lazy_parsing ; i++) {
+    m_stream->seek(m_image_subheader_offsets[i]);
     m_image_headers[i] = new vil_nitf2_image_subheader(file_version());
     if (!m_image_headers[i]->read(m_stream)) return false;
   }
@@ -314,6 +321,53 @@ bool vil_nitf2_image::parse_headers()
   return true;
 }
 
+void vil_nitf2_image::index_image_segments()
+{
+  m_image_subheader_offsets.clear();
+  m_image_data_offsets.clear();
+  unsigned int n = nimages();
+  if (n == 0) return;
+  // the offset of the first image segment has to be computed the slow way
+  vil_streampos offset =
+    get_offset_to( vil_nitf2_header::enum_image_segments, vil_nitf2_header::enum_subheader, 0 );
+  std::string sh = vil_nitf2_header::section_len_header_tag( vil_nitf2_header::enum_image_segments );
+  std::string s  = vil_nitf2_header::section_len_data_tag( vil_nitf2_header::enum_image_segments );
+  std::vector< vil_streampos > subheader_offsets( n ), data_offsets( n );
+  for (unsigned int i = 0 ; i < n ; i++) {
+    int header_size = 0;
+    vil_nitf2_long data_size = 0;
+    m_file_header.get_property(sh, i, header_size);
+    m_file_header.get_property(s, i, data_size);
+    subheader_offsets[i] = offset;
+    data_offsets[i] = offset + header_size;
+    offset = data_offsets[i] + data_size;
+  }
+  m_image_subheader_offsets.swap( subheader_offsets );
+  m_image_data_offsets.swap( data_offsets );
+}
+
+vil_nitf2_image_subheader* vil_nitf2_image::image_header( unsigned int index ) const
+{
+  assert(index < m_image_headers.size());
+  if (!m_image_headers[index]) {
+    // deferred by a lazy parse_headers(); parse it now
+    m_stream->seek(m_image_subheader_offsets[index]);
+    m_image_headers[index] = new vil_nitf2_image_subheader(file_version());
+    if (!m_image_headers[index]->read(m_stream)) {
+      std::cerr << "vil_nitf2_image: error parsing image subheader " << index << '\n';
+    }
+  }
+  return m_image_headers[index];
+}
+
+const std::vector< vil_nitf2_image_subheader* >& vil_nitf2_image::get_image_headers() const
+{
+  for (unsigned int i = 0 ; i < m_image_headers.size() ; i++) {
+    image_header(i);
+  }
+  return m_image_headers;
+}
+
 vil_nitf2_classification::file_version vil_nitf2_image::file_version() const
 {
   return m_file_header.file_version();
@@ -339,8 +393,7 @@ vil_nitf2_classification::file_version v = file_version();
 
 const vil_nitf2_image_subheader* vil_nitf2_image::current_image_header() const
 {
-  assert(m_current_image_index < m_image_headers.size());
-  return m_image_headers[ m_current_image_index ];
+  return image_header( m_current_image_index );
 }
 
 unsigned vil_nitf2_image::nplanes() const
@@ -703,10 +756,9 @@ vil_image_view_base_sptr vil_nitf2_image::get_block(unsigned int block_index_x,
         data_is_all_blank = true;
       }
       else {
-        m_stream->seek(current_offset);
         char* position_to_read_to = static_cast<char*>(image_memory->data());
         position_to_read_to += i*bytes_per_block_per_band;
-        if (m_stream->read((void*)position_to_read_to, bytes_per_block_per_band) != static_cast<int>(bytes_per_block_per_band)) {
+        if (m_stream->read_at(current_offset, (void*)position_to_read_to, bytes_per_block_per_band) != static_cast<int>(bytes_per_block_per_band)) {
           return VXL_NULLPTR;
         }
       }
@@ -723,10 +775,9 @@ vil_image_view_base_sptr vil_nitf2_image::get_block(unsigned int block_index_x,
       data_is_all_blank = true;
     }
     else {
-      //seek to the correct position in the stream
-      m_stream->seek(current_offset);
-      //read in the data
-      if (m_stream->read(image_memory->data(), block_size_bytes) != static_cast<int>(block_size_bytes)) {
+      //read in the data; read_at() leaves the file pointer alone where the
+      //stream supports it, so blocks may be read from several threads
+      if (m_stream->read_at(current_offset, image_memory->data(), block_size_bytes) != static_cast<int>(block_size_bytes)) {
         return VXL_NULLPTR;
       }
     }
@@ -855,7 +906,7 @@ vil_nitf2_field::field_tree* vil_nitf2_image::get_tree( ) const
   t->children.push_back( get_header().get_tree() );
   unsigned int i;
   for ( i = 0 ; i < m_image_headers.size() ; i++ ){
-    t->children.push_back( m_image_headers[i]->get_tree(i+1) );
+    t->children.push_back( image_header(i)->get_tree(i+1) );
   }
   for ( i = 0 ; i < m_des.size() ; i++ ){
     t->children.push_back( m_des[i]->get_tree(i+1) );
@@ -139,8 +139,9 @@ class vil_nitf2_image : public vil_blocked_image_resource
   virtual bool get_property (char const *tag, void *property_value=0) const;
 
   //const vil_nitf2_header& getFileHeader() const;
-  const std::vector< vil_nitf2_image_subheader* >& get_image_headers() const
-  { return m_image_headers; }
+  // Note that this decodes any image subheaders that a lazy parse_headers()
+  // (see vil_nitf2::s_lazy_parsing) has not decoded yet.
+  const std::vector< vil_nitf2_image_subheader* >& get_image_headers() const;
   const vil_nitf2_header& get_header() const
   { return m_file_header; }
   const std::vector< vil_nitf2_des* >& get_des() const
@@ -161,6 +162,9 @@ class vil_nitf2_image : public vil_blocked_image_resource
   virtual unsigned int current_image() const;
   virtual unsigned int nimages() const;
 
+  //: Read the file header and index the image segments.
+  // Image subheaders and DESs are parsed too, unless vil_nitf2::s_lazy_parsing
+  // is set, in which case image subheaders are parsed when first accessed.
   bool parse_headers();
   vil_nitf2_classification::file_version file_version() const;
 
@@ -211,10 +215,17 @@ class vil_nitf2_image : public vil_blocked_image_resource
 
   //main file header
   vil_nitf2_header m_file_header;
-  //image header(s)
-  std::vector< vil_nitf2_image_subheader* > m_image_headers;
+  //image header(s); null entries have not been parsed yet (lazy mode)
+  mutable std::vector< vil_nitf2_image_subheader* > m_image_headers;
   void clear_image_headers();
   const vil_nitf2_image_subheader* current_image_header() const;
+  // Returns the index'th image subheader, parsing it first if necessary
+  vil_nitf2_image_subheader* image_header( unsigned int index ) const;
+  // Byte offsets (from the start of the stream) of each image segment's
+  // subheader and data, so that get_offset_to() need not sum segment lengths
+  std::vector< vil_streampos > m_image_subheader_offsets;
+  std::vector< vil_streampos > m_image_data_offsets;
+  void index_image_segments();
   //DESs (if any)
   std::vector< vil_nitf2_des* > m_des;
   void clear_des();
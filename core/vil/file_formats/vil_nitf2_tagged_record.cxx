@@ -108,6 +108,17 @@ bool vil_nitf2_tagged_record::read(vil_nitf2_istream& input)
   // First save the position to check later that we read entire record
   vil_streampos record_data_start_pos = input.tell();
   m_definition = record_definition;
+
+  // In lazy mode just remember where the data is; fields() decodes it on demand
+  if (vil_nitf2::s_lazy_parsing) {
+    m_stream = &input;
+    m_stream->ref();
+    m_data_pos = record_data_start_pos;
+    vil_streampos expected_pos = record_data_start_pos;
+    expected_pos += m_length;
+    input.seek(expected_pos);
+    return input.ok();
+  }
   m_field_sequence = new vil_nitf2_field_sequence(record_definition->field_definitions());
   m_field_sequence->read(input);
 
@@ -127,67 +138,67 @@ bool vil_nitf2_tagged_record::read(vil_nitf2_istream& input)
 }
 
 bool vil_nitf2_tagged_record::get_value(std::string tag, int& out_value) const
-{ return m_field_sequence->get_value(tag, out_value); }
+{ return fields()->get_value(tag, out_value); }
 
 bool vil_nitf2_tagged_record::get_value(std::string tag, double& out_value) const
-{ return m_field_sequence->get_value(tag, out_value); }
+{ return fields()->get_value(tag, out_value); }
 
 bool vil_nitf2_tagged_record::get_value(std::string tag, char& out_value) const
-{ return m_field_sequence->get_value(tag, out_value); }
+{ return fields()->get_value(tag, out_value); }
 bool vil_nitf2_tagged_record::get_value(std::string tag, void*& out_value) const
-{ return m_field_sequence->get_value(tag, out_value); }
+{ return fields()->get_value(tag, out_value); }
 
 bool vil_nitf2_tagged_record::get_value(std::string tag, std::string& out_value) const
-{ return m_field_sequence->get_value(tag, out_value); }
+{ return fields()->get_value(tag, out_value); }
 
 bool vil_nitf2_tagged_record::get_value(std::string tag, vil_nitf2_location*& out_value) const
-{ return m_field_sequence->get_value(tag, out_value); }
+{ return fields()->get_value(tag, out_value); }
 
 bool vil_nitf2_tagged_record::get_value(std::string tag, vil_nitf2_date_time& out_value) const
-{ return m_field_sequence->get_value(tag, out_value); }
+{ return fields()->get_value(tag, out_value); }
 
 #if VXL_HAS_INT_64
 // if not VXL_HAS_INT_64 isn't defined the vil_nitf2_long is the same as just plain 'int'
 // and this function will be a duplicate of that get_value
 bool vil_nitf2_tagged_record::get_value(std::string tag, vil_nitf2_long& out_value) const
-{ return m_field_sequence->get_value(tag, out_value); }
+{ return fields()->get_value(tag, out_value); }
 #endif
 
 bool vil_nitf2_tagged_record::get_value(std::string tag, const vil_nitf2_index_vector& indexes, int& out_value) const
-{ return m_field_sequence->get_value(tag, indexes, out_value); }
+{ return fields()->get_value(tag, indexes, out_value); }
 
 bool vil_nitf2_tagged_record::get_value(std::string tag, const vil_nitf2_index_vector& indexes, double& out_value) const
-{ return m_field_sequence->get_value(tag, indexes, out_value); }
+{ return fields()->get_value(tag, indexes, out_value); }
 
 bool vil_nitf2_tagged_record::get_value(std::string tag, const vil_nitf2_index_vector& indexes, char& out_value) const
-{ return m_field_sequence->get_value(tag, indexes, out_value); }
+{ return fields()->get_value(tag, indexes, out_value); }
 
 bool vil_nitf2_tagged_record::get_value(std::string tag, const vil_nitf2_index_vector& indexes, void*& out_value) const
-{ return m_field_sequence->get_value(tag, indexes, out_value); }
+{ return fields()->get_value(tag, indexes, out_value); }
 
 bool vil_nitf2_tagged_record::get_value(std::string tag, const vil_nitf2_index_vector& indexes, std::string& out_value) const
-{ return m_field_sequence->get_value(tag, indexes, out_value); }
+{ return fields()->get_value(tag, indexes, out_value); }
 
 bool vil_nitf2_tagged_record::get_value(std::string tag, const vil_nitf2_index_vector& indexes, vil_nitf2_location*& out_value) const
-{ return m_field_sequence->get_value(tag, indexes, out_value); }
+{ return fields()->get_value(tag, indexes, out_value); }
 
 bool vil_nitf2_tagged_record::get_value(std::string tag, const vil_nitf2_index_vector& indexes, vil_nitf2_date_time& out_value) const
-{ return m_field_sequence->get_value(tag, indexes, out_value); }
+{ return fields()->get_value(tag, indexes, out_value); }
 
 #if VXL_HAS_INT_64
 // if not VXL_HAS_INT_64 isn't defined the vil_nitf2_long is the same as just plain 'int'
 // and this function will be a duplicate of that get_value
 bool vil_nitf2_tagged_record::get_value(std::string tag, const vil_nitf2_index_vector& indexes, vil_nitf2_long& out_value) const
-{ return m_field_sequence->get_value(tag, indexes, out_value); }
+{ return fields()->get_value(tag, indexes, out_value); }
 #endif
 
 // Macro to define both overloads of get_values()
 #define VIL_NITF2_TAGGED_RECORD_GET_VALUES(T) \
 bool vil_nitf2_tagged_record::get_values(std::string tag, const vil_nitf2_index_vector& indexes, \
                                          std::vector<T>& out_values, bool clear_out_values) const \
-{ return m_field_sequence->get_values(tag, indexes, out_values, clear_out_values); } \
+{ return fields()->get_values(tag, indexes, out_values, clear_out_values); } \
 bool vil_nitf2_tagged_record::get_values(std::string tag, std::vector<T>& out_values) const \
-{ return m_field_sequence->get_values(tag, out_values); }
+{ return fields()->get_values(tag, out_values); }
 
 VIL_NITF2_TAGGED_RECORD_GET_VALUES(int);
 VIL_NITF2_TAGGED_RECORD_GET_VALUES(double);
@@ -202,9 +213,32 @@ VIL_NITF2_TAGGED_RECORD_GET_VALUES(vil_nitf2_date_time);
 
 
 vil_nitf2_tagged_record::vil_nitf2_tagged_record()
-  : m_length_field(VXL_NULLPTR), m_tag_field(VXL_NULLPTR), m_length(0), m_definition(VXL_NULLPTR), m_field_sequence(VXL_NULLPTR)
+  : m_length_field(VXL_NULLPTR), m_tag_field(VXL_NULLPTR), m_length(0), m_definition(VXL_NULLPTR), m_field_sequence(VXL_NULLPTR),
+    m_stream(VXL_NULLPTR), m_data_pos(0)
 {}
 
+vil_nitf2_field_sequence* vil_nitf2_tagged_record::fields() const
+{
+  if (!m_field_sequence && m_definition && m_stream) {
+    // Decode the data whose offset was saved by a lazy read(), leaving the
+    // stream where we found it since other readers may be using it.
+    vil_streampos saved_pos = m_stream->tell();
+    m_stream->seek(m_data_pos);
+    m_field_sequence = new vil_nitf2_field_sequence(m_definition->field_definitions());
+    m_field_sequence->read(*m_stream);
+    vil_streampos expected_pos = m_data_pos;
+    expected_pos += m_length;
+    if (m_stream->tell() != expected_pos) {
+      std::cerr << "vil_nitf2_tagged_record::fields(): Read " << m_stream->tell() - m_data_pos
+               << " bytes instead of " << m_length << " as expected in " << name() << ".\n";
+    }
+    m_stream->seek(saved_pos);
+    m_stream->unref();
+    m_stream = VXL_NULLPTR;
+  }
+  return m_field_sequence;
+}
+
 // TO DO: rewrite this method a sequence of unit tests!
 //
 bool vil_nitf2_tagged_record::test()
@@ -470,7 +504,7 @@ bool vil_nitf2_tagged_record::write(vil_nitf2_ostream& output)
   }
   else return false;
   // Write data fields
-  m_field_sequence->write(output);
+  fields()->write(output);
   // Check whether the std::right amount was written
   vil_streampos end = output.tell();
   vil_streampos length_written = end - start;
@@ -482,6 +516,7 @@ bool vil_nitf2_tagged_record::write(vil_nitf2_ostream& output)
 vil_nitf2_tagged_record::~vil_nitf2_tagged_record()
 {
   delete m_field_sequence;
+  if (m_stream) m_stream->unref();
 }
 
 vil_nitf2_field_definition* vil_nitf2_field_sequence::find_field_definition(std::string tag)
@@ -507,8 +542,8 @@ vil_nitf2_field::field_tree* vil_nitf2_tagged_record::get_tree() const
   //we add the field definitions if the TRE was recognized, or we note that we
   //skipped it otherwise
   vil_nitf2_field::field_tree* tr;
-  if ( m_field_sequence ) {
-    tr = m_field_sequence->get_tree();
+  if ( m_definition ) {
+    tr = fields()->get_tree();
   }
   else {
     tr = new vil_nitf2_field::field_tree;
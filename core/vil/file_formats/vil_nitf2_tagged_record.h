@@ -262,7 +262,12 @@ class vil_nitf2_tagged_record
 
   // Returns a field with specified tag, or 0 if not found.
   vil_nitf2_field* get_field(std::string tag) const {
-    return m_field_sequence->get_field(tag); }
+    return fields()->get_field(tag); }
+
+  // Returns whether this record's fields have been decoded. This is false
+  // only for a known TRE read while vil_nitf2::s_lazy_parsing was set, until
+  // one of its fields is requested.
+  bool is_parsed() const { return m_field_sequence != VXL_NULLPTR || !m_definition; }
 
   // Removes a field with specified tag, returning whether successful.
   // Use this method to "undefine" an existing field.
@@ -283,6 +288,10 @@ class vil_nitf2_tagged_record
   // Reads tagged record members from input stream
   bool read(vil_nitf2_istream& input);
 
+  // Returns the field sequence, first decoding it from the stream if
+  // read() deferred that because of vil_nitf2::s_lazy_parsing
+  vil_nitf2_field_sequence* fields() const;
+
   // Static variables
   static vil_nitf2_field_definition & s_length_definition();
   static vil_nitf2_field_definition & s_tag_definition();
@@ -294,7 +303,11 @@ class vil_nitf2_tagged_record
   vil_nitf2_scalar_field* m_tag_field;
   int m_length;
   vil_nitf2_tagged_record_definition* m_definition;
-  vil_nitf2_field_sequence* m_field_sequence;
+  mutable vil_nitf2_field_sequence* m_field_sequence;
+
+  // Stream (referenced) and offset of the record data, while decoding is deferred
+  mutable vil_nitf2_istream* m_stream;
+  vil_streampos m_data_pos;
 };
 
 std::ostream& operator << (std::ostream& os, const vil_nitf2_tagged_record& record);
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cmath>
+#include <fstream>
 #include <sstream>
 #include "vil_pyramid_image_list.h"
 //:
@@ -13,6 +14,9 @@
 #include <vil/vil_new.h>
 #include <vil/vil_load.h>
 #include <vil/vil_copy.h>
+#include <vil/vil_pixel_format.h>
+#include <vil/vil_image_view.h>
+#include <vxl_config.h>
 
 //:Load a pyramid image.  The path should correspond to a directory.
 //If not, return a null resource.
@@ -140,17 +144,23 @@ vil_pyramid_image_resource_sptr vil_pyramid_image_list_format::
 static bool level_compare(pyramid_level* const l1, pyramid_level* const l2)
 {
   assert(l1&&l2);
-  return l1->image_->ni() > l2->image_->ni();
+  return l1->ni_ > l2->ni_;
 }
 
 
-vil_pyramid_image_list::vil_pyramid_image_list() : directory_("")
+vil_pyramid_image_list::vil_pyramid_image_list()
+  : directory_(""), on_demand_(false),
+    view_cache_bytes_(0), max_view_cache_bytes_(0)
 {}
 
-vil_pyramid_image_list::vil_pyramid_image_list(char const* directory) : directory_(directory)
+vil_pyramid_image_list::vil_pyramid_image_list(char const* directory)
+  : directory_(directory), on_demand_(false),
+    view_cache_bytes_(0), max_view_cache_bytes_(0)
 {}
 
-vil_pyramid_image_list::vil_pyramid_image_list(std::vector<vil_image_resource_sptr> const& images) : directory_("")
+vil_pyramid_image_list::vil_pyramid_image_list(std::vector<vil_image_resource_sptr> const& images)
+  : directory_(""), on_demand_(false),
+    view_cache_bytes_(0), max_view_cache_bytes_(0)
 {
   for (std::vector<vil_image_resource_sptr>::const_iterator rit = images.begin();
        rit != images.end(); ++rit)
@@ -185,16 +195,16 @@ void vil_pyramid_image_list::normalize_scales()
   levels_[0]->scale_ = 1.0f;
   if (nlevels==1)
     return;
-  float ni0 = static_cast<float>(levels_[0]->image_->ni());
+  float ni0 = static_cast<float>(levels_[0]->ni_);
   for (unsigned int i = 1; i<nlevels; ++i)
-    levels_[i]->scale_ = static_cast<float>(levels_[i]->image_->ni())/ni0;
+    levels_[i]->scale_ = static_cast<float>(levels_[i]->ni_)/ni0;
 }
 
 bool vil_pyramid_image_list::is_same_size(vil_image_resource_sptr const& image)
 {
   unsigned int ni = image->ni(), nj = image->nj();
   for (unsigned int L = 0; L<this->nlevels(); ++L)
-    if (levels_[L]->image_->ni()==ni&&levels_[L]->image_->nj()==nj)
+    if (levels_[L]->ni_==ni&&levels_[L]->nj_==nj)
       return true;
   return false;
 }
@@ -208,6 +218,10 @@ vil_pyramid_image_list::add_resource(vil_image_resource_sptr const& image)
   pyramid_level* level = new pyramid_level(image);
   levels_.push_back(level);
 
+  //level indices are about to change
+  view_cache_.clear();
+  view_cache_bytes_ = 0;
+
   //is this the first image added?
   if (levels_.size() == 1)
     return true;
@@ -312,6 +326,13 @@ vil_pyramid_image_list::get_copy_view(unsigned int i0, unsigned int n_i,
   }
   pyramid_level* pl = levels_[level];
   float actual_scale = pl->scale_;
+  vil_image_resource_sptr image = on_demand_ ? this->cached_level(level) : pl->image_;
+  if (!image)
+  {
+    std::cerr << "pyramid_image_list::get_copy_view(.) level = "
+             << level << " could not be generated\n";
+    return VXL_NULLPTR;
+  }
 
   float fi0 = actual_scale*i0, fni = actual_scale*n_i, fj0 = actual_scale*j0, fnj = actual_scale*n_j;
   //transform image coordinates by actual scale
@@ -321,7 +342,7 @@ vil_pyramid_image_list::get_copy_view(unsigned int i0, unsigned int n_i,
   unsigned int sj0 = static_cast<unsigned int>(fj0);
   unsigned int snj = static_cast<unsigned int>(fnj);
   if (snj == 0) snj = 1;//can't have less than one pixel
-  vil_image_view_base_sptr v = pl->image_->get_copy_view(si0, sni, sj0, snj);
+  vil_image_view_base_sptr v = image->get_copy_view(si0, sni, sj0, snj);
   if (!v)
   {
     std::cerr << "pyramid_image_list::get_copy_view(.) level = "
@@ -353,3 +374,202 @@ vil_pyramid_image_list::get_copy_view(unsigned int i0, unsigned int n_i,
   return this->get_copy_view(i0, n_i, j0, n_j, level);
 }
 
+
+vil_image_resource_sptr
+vil_pyramid_image_list::get_level(const unsigned int level) const
+{
+  if (level>=levels_.size())
+    return VXL_NULLPTR;
+  if (!levels_[level]->image_ && on_demand_)
+    this->generate_level(level);
+  return levels_[level]->image_;
+}
+
+//: Accumulate an FNV-1a hash of the pixels in a view
+template <class T>
+static void hash_pixels(vil_image_view<T> const& view, vxl_uint_32& h)
+{
+  for (unsigned int p = 0; p<view.nplanes(); ++p)
+    for (unsigned int j = 0; j<view.nj(); ++j)
+      for (unsigned int i = 0; i<view.ni(); ++i)
+      {
+        T v = view(i,j,p);
+        unsigned char const* b = reinterpret_cast<unsigned char const*>(&v);
+        for (unsigned int k = 0; k<sizeof(T); ++k)
+          h = (h ^ b[k]) * 16777619u;
+      }
+}
+
+//: A string identifying the base image of an on-demand pyramid.
+// Made from the image size and format and a hash of the pixels in five
+// small windows (the centre and the corners), so that level files left by a
+// different image of the same size are not mistaken for this one's.
+static std::string cache_key(vil_image_resource_sptr const& base)
+{
+  unsigned int ni = base->ni(), nj = base->nj();
+  unsigned int wi = std::min(ni, 32u), wj = std::min(nj, 32u);
+  unsigned int i0[5] = { 0, ni-wi, 0, ni-wi, (ni-wi)/2 };
+  unsigned int j0[5] = { 0, 0, nj-wj, nj-wj, (nj-wj)/2 };
+  vxl_uint_32 h = 2166136261u;
+  for (unsigned int w = 0; w<5; ++w)
+  {
+    vil_image_view_base_sptr v = base->get_copy_view(i0[w], wi, j0[w], wj);
+    if (!v)
+      continue;
+    switch (v->pixel_format())
+    {
+#define HASH_CASE(FORMAT, T) \
+     case FORMAT: hash_pixels(vil_image_view<T>(v), h); break
+      HASH_CASE(VIL_PIXEL_FORMAT_BYTE, vxl_byte);
+#if VXL_HAS_INT_64
+      HASH_CASE(VIL_PIXEL_FORMAT_UINT_64, vxl_uint_64);
+#endif
+      HASH_CASE(VIL_PIXEL_FORMAT_UINT_32, vxl_uint_32);
+      HASH_CASE(VIL_PIXEL_FORMAT_UINT_16, vxl_uint_16);
+      HASH_CASE(VIL_PIXEL_FORMAT_FLOAT, float);
+      HASH_CASE(VIL_PIXEL_FORMAT_DOUBLE, double);
+#undef HASH_CASE
+     default:
+      break;
+    }
+  }
+  std::stringstream ks;
+  ks << ni << ' ' << nj << ' ' << base->nplanes() << ' '
+     << base->pixel_format() << ' ' << std::hex << h;
+  return ks.str();
+}
+
+bool vil_pyramid_image_list::
+enable_on_demand_levels(unsigned int nlevels, char const* cache_directory,
+                        char const* level_file_format,
+                        unsigned long cache_bytes)
+{
+  if (levels_.size()==0 || nlevels==0)
+    return false;
+  if (!vil_image_list::vil_is_directory(cache_directory))
+    return false;
+  cache_directory_ = cache_directory;
+  level_file_format_ = level_file_format;
+  max_view_cache_bytes_ = cache_bytes;
+  view_cache_.clear();
+  view_cache_bytes_ = 0;
+
+  //The manifest records which base image the level files were made from.
+  //If it names another image, the level files are stale: they are ignored
+  //and will be overwritten as the levels are regenerated.
+  std::string dir = cache_directory_, manifest_name = "pyramid_cache";
+  std::string manifest = level_filename(dir, manifest_name, 0.0f) + ".txt";
+  std::string key = cache_key(levels_[0]->image_), cached_key;
+  {
+    std::ifstream is(manifest.c_str());
+    std::getline(is, cached_key);
+  }
+  bool reuse_files = cached_key == key;
+  if (!reuse_files)
+  {
+    std::ofstream os(manifest.c_str());
+    os << key << '\n';
+    if (!os)
+      return false;
+  }
+
+  //Lay out the dyadic level sizes, reusing levels that are already present
+  //and, if they belong to this base image, level files left in the cache
+  //directory by an earlier session
+  std::vector<pyramid_level*> levels(1, levels_[0]);
+  unsigned int ni = levels_[0]->ni_, nj = levels_[0]->nj_;
+  std::string prefix = "R";
+  for (unsigned int L = 1; L<nlevels; ++L)
+  {
+    //same rounding as vil_pyramid_image_resource::decimate
+    ni = ni/2 + ni%2;  nj = nj/2 + nj%2;
+    pyramid_level* pl = VXL_NULLPTR;
+    for (unsigned int k = 1; k<levels_.size()&&!pl; ++k)
+      if (levels_[k]&&levels_[k]->ni_==ni&&levels_[k]->nj_==nj)
+      {
+        pl = levels_[k];
+        levels_[k] = VXL_NULLPTR;
+      }
+    if (!pl)
+    {
+      std::string file = level_filename(dir, prefix, float(L)) + '.' + level_file_format_;
+      vil_image_resource_sptr cached;
+      if (reuse_files)
+        cached = vil_load_image_resource(file.c_str(), false);
+      if (cached && cached->ni()==ni && cached->nj()==nj)
+        pl = new pyramid_level(cached);
+      else
+        pl = new pyramid_level(ni, nj);
+    }
+    levels.push_back(pl);
+  }
+  for (unsigned int k = 1; k<levels_.size(); ++k)
+    delete levels_[k];
+  levels_ = levels;
+  this->normalize_scales();
+  on_demand_ = true;
+  return true;
+}
+
+bool vil_pyramid_image_list::generate_level(unsigned int level) const
+{
+  //find the nearest finer level that exists; the base level always does
+  unsigned int src = level;
+  while (src>0 && !levels_[src]->image_)
+    --src;
+  std::string dir = cache_directory_, prefix = "R";
+  for (unsigned int L = src+1; L<=level; ++L)
+  {
+    std::string file =
+      level_filename(dir, prefix, float(L)) + '.' + level_file_format_;
+    vil_image_resource_sptr dec =
+      vil_pyramid_image_resource::decimate(levels_[L-1]->image_, file.c_str(),
+                                           level_file_format_.c_str());
+    if (!dec)
+    {
+      std::cerr << "pyramid_image_list: failed to generate level " << L
+               << " in " << file << '\n';
+      return false;
+    }
+    levels_[L]->image_ = dec;
+  }
+  return true;
+}
+
+vil_image_resource_sptr
+vil_pyramid_image_list::cached_level(unsigned int level) const
+{
+  for (std::list<cached_view>::iterator cit = view_cache_.begin();
+       cit != view_cache_.end(); ++cit)
+    if (cit->level_ == level)
+    {
+      //move to the front of the list
+      view_cache_.splice(view_cache_.begin(), view_cache_, cit);
+      return cit->image_;
+    }
+
+  vil_image_resource_sptr image = this->get_level(level);
+  if (!image)
+    return VXL_NULLPTR;
+  unsigned long bytes = static_cast<unsigned long>(image->ni())*image->nj()*
+    image->nplanes()*vil_pixel_format_sizeof_components(image->pixel_format());
+  //too big to hold in memory, so read from the file each time
+  if (bytes > max_view_cache_bytes_)
+    return image;
+  vil_image_view_base_sptr view = image->get_view();
+  if (!view)
+    return image;
+
+  cached_view cv;
+  cv.level_ = level;
+  cv.bytes_ = bytes;
+  cv.image_ = vil_new_image_resource_of_view(*view);
+  view_cache_.push_front(cv);
+  view_cache_bytes_ += bytes;
+  while (view_cache_bytes_ > max_view_cache_bytes_)
+  {
+    view_cache_bytes_ -= view_cache_.back().bytes_;
+    view_cache_.pop_back();
+  }
+  return cv.image_;
+}
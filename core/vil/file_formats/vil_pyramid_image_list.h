@@ -15,6 +15,8 @@
 
 #include <string>
 #include <iostream>
+#include <list>
+#include <vector>
 #include <vcl_compiler.h>
 #include <vil/vil_file_format.h>
 #include <vil/vil_pyramid_image_resource.h>
@@ -68,21 +70,30 @@ class vil_pyramid_image_list_format : public vil_file_format
 struct pyramid_level
 {
   pyramid_level(vil_image_resource_sptr const& image)
-  : scale_(1.0f), image_(image), cur_level_(0) {}
+  : scale_(1.0f), image_(image), cur_level_(0),
+    ni_(image->ni()), nj_(image->nj()) {}
+
+  //: A level whose resource has not been generated yet
+  pyramid_level(unsigned int ni, unsigned int nj)
+  : scale_(1.0f), image_(VXL_NULLPTR), cur_level_(0), ni_(ni), nj_(nj) {}
+
   //: scale associated with level
   float scale_;
 
-  //:the resource
+  //:the resource (null if the level is to be generated on demand)
   vil_image_resource_sptr image_;
 
   //:the current pyramid level for this resource
   unsigned int cur_level_;
 
+  //:the size of the level, known even before its resource exists
+  unsigned int ni_, nj_;
+
   //:print ni and scale and values
   void print(const unsigned int l)
   {
     std::cout << "level[" << l <<  "]  scale: " << scale_
-             << "  ni: " << image_->ni() << '\n';
+             << "  ni: " << ni_ << (image_ ? "" : " (not generated)") << '\n';
   }
 };
 
@@ -169,9 +180,10 @@ class vil_pyramid_image_list : public vil_pyramid_image_resource
   vil_image_resource_sptr get_resource(const unsigned int level) const
     {return get_level(level);}
 
-  //: Get a level image resource of the pyramid
-  inline vil_image_resource_sptr get_level(const unsigned int level) const
-  { if (level<levels_.size()) return levels_[level]->image_; else return 0; }
+  //: Get a level image resource of the pyramid.
+  // In on-demand mode a missing level is generated (and written to the
+  // cache directory) by this call.
+  vil_image_resource_sptr get_level(const unsigned int level) const;
 
   //:Get a partial view from the image from a specified pyramid level
   virtual vil_image_view_base_sptr get_copy_view(unsigned int i0, unsigned int n_i,
@@ -191,6 +203,31 @@ class vil_pyramid_image_list : public vil_pyramid_image_resource
 
   void set_directory(char const* directory) { directory_ = directory; }
 
+  //: Generate missing pyramid levels on first access.
+  // The pyramid is given \a nlevels levels, each half the size of the one
+  // above it. Levels already present with the right size are used as they
+  // are; any other non-base level is dropped. Level files found in
+  // \a cache_directory (written by an earlier session) are reused. The rest
+  // are decimated from the nearest finer level the first time they are
+  // requested, and saved there in \a level_file_format.
+  //
+  // A cache directory holds the levels of one base image. A manifest file
+  // in it identifies that image by size, format and a hash of a sample of
+  // its pixels; if it names a different image, the level files there are
+  // not reused but regenerated.
+  //
+  // Views of whole levels no bigger than \a cache_bytes are kept in memory,
+  // least recently used first out, so that repeated get_copy_view() calls
+  // on a level don't go back to the file.
+  // Returns false if there is no base image or the cache directory doesn't exist.
+  bool enable_on_demand_levels(unsigned int nlevels,
+                               char const* cache_directory,
+                               char const* level_file_format = "tiff",
+                               unsigned long cache_bytes = 64*1024*1024);
+
+  //: True if missing levels are generated on demand
+  bool on_demand() const { return on_demand_; }
+
   //for debugging purposes
   void print(const unsigned int level)
   { if (level<levels_.size()) levels_[level]->print(level); }
@@ -213,12 +250,36 @@ class vil_pyramid_image_list : public vil_pyramid_image_resource
   //:find the nearest level to the image size
   float find_next_level(vil_image_resource_sptr const& image);
 
+  //:decimate the nearest finer levels down to \a level, saving each in the cache directory
+  bool generate_level(unsigned int level) const;
+
+  //:resource to read \a level from; an in-memory copy if it fits in the view cache
+  vil_image_resource_sptr cached_level(unsigned int level) const;
+
           //    ---  members ---
 
   std::string directory_;
 
   //The set of images in the pyramid. levels_[0] is the base image
   std::vector<pyramid_level*> levels_;
+
+  // on-demand level generation
+  bool on_demand_;
+  std::string cache_directory_;
+  std::string level_file_format_;
+
+  //: An in-memory copy of a whole level held in the view cache
+  struct cached_view
+  {
+    unsigned int level_;
+    unsigned long bytes_;
+    vil_image_resource_sptr image_;
+  };
+
+  //: The view cache, most recently used first
+  mutable std::list<cached_view> view_cache_;
+  mutable unsigned long view_cache_bytes_;
+  unsigned long max_view_cache_bytes_;
 };
 
 #endif // vil_pyramid_image_list_h_
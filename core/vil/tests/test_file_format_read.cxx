@@ -19,6 +19,13 @@
 
 // For testing specific file formats
 #include <vil/vil_stream_fstream.h>
+#include <vil/file_formats/vil_nitf2.h>
+#include <vil/file_formats/vil_nitf2_image.h>
+#include <vil/file_formats/vil_nitf2_image_subheader.h>
+#include <vil/file_formats/vil_nitf2_tagged_record.h>
+#if HAS_DCMTK
+#include <vil/file_formats/vil_dicom.h>
+#endif
 
 // \author Amitha Perera
 // \date Apr 2002
@@ -478,6 +485,100 @@ image_equals( const std::string &test_file, const std::string &ref_file)
   return vil_image_view_deep_equality(*view_test, *view_ref);
 }
 
+// ===========================================================================
+// Read TRE values from a NITF image subheader
+//
+// Opens the first image of the file and reads SUN_EL and SUN_AZ from its
+// USE00A TRE and MISSION from its STDIDC TRE. With lazy parsing, also
+// checks that both TREs stay undecoded until a field is asked for, and
+// that decoding them leaves the stream where it was.
+//
+static bool
+ReadNitfTREs( char const* img_data_file, bool lazy,
+              double& sun_el, double& sun_az, std::string& mission )
+{
+  bool ok = false;
+  vil_nitf2::s_lazy_parsing = lazy;
+  vil_stream* vs = new vil_stream_fstream( (image_base + img_data_file).c_str(), "r" );
+  vs->ref();
+  {
+    vil_nitf2_image* im = new vil_nitf2_image( vs );
+    vil_image_resource_sptr ir = im;
+    vil_nitf2_tagged_record_sequence tres;
+    vil_nitf2_tagged_record* use = VXL_NULLPTR;
+    vil_nitf2_tagged_record* stdid = VXL_NULLPTR;
+    if ( im->parse_headers() && !im->get_image_headers().empty() &&
+         im->get_image_headers()[0]->get_property( "IXSHD", tres ) ) {
+      for ( vil_nitf2_tagged_record_sequence::iterator it = tres.begin(); it != tres.end(); ++it ) {
+        if ( (*it)->name() == "USE00A" ) use = *it;
+        if ( (*it)->name() == "STDIDC" ) stdid = *it;
+      }
+    }
+    if ( use && stdid ) {
+      if ( lazy )
+        TEST( "TREs undecoded after open, lazy", !use->is_parsed() && !stdid->is_parsed(), true );
+      vil_streampos pos = vs->tell();
+      ok = use->get_value( "SUN_EL", sun_el ) && use->get_value( "SUN_AZ", sun_az ) &&
+           stdid->get_value( "MISSION", mission );
+      if ( lazy ) {
+        TEST( "TREs decoded on first access, lazy", use->is_parsed() && stdid->is_parsed(), true );
+        TEST( "TRE decoding restores stream position, lazy", vs->tell(), pos );
+      }
+    }
+    else
+      std::cout << "[ couldn't find USE00A and STDIDC TREs in " << img_data_file << " ]" << std::endl;
+  }
+  vs->unref();
+  vil_nitf2::s_lazy_parsing = false;
+  return ok;
+}
+
+#if HAS_DCMTK
+// ===========================================================================
+// Check a multi-frame DICOM image
+//
+// The frames of the test files are 4x3 images whose pixel (i,j) in frame
+// k is slope*(k*kstep + i + 4*j) + intercept. The frames are visited out of
+// order, so each one is decoded on its own first use.
+//
+template<class T>
+bool
+CheckDicomFrames( char const* img_data_file, unsigned nframes,
+                  double kstep, double slope = 1, double intercept = 0 )
+{
+  vil_image_resource_sptr ir = vil_load_image_resource((image_base + img_data_file).c_str());
+  vil_dicom_image* di = dynamic_cast<vil_dicom_image*>(ir.ptr());
+  if ( !di ) {
+    std::cout << "[ couldn't load image file " << img_data_file << " as DICOM ]" << std::endl;
+    return false;
+  }
+  if ( di->nframes() != nframes || di->ni() != 4 || di->nj() != 3 ) {
+    std::cout << "[ " << img_data_file << " has " << di->nframes() << " frames of "
+              << di->ni() << 'x' << di->nj() << " ]" << std::endl;
+    return false;
+  }
+  for ( unsigned n = 0; n < nframes; ++n ) {
+    unsigned k = (n + nframes - 1) % nframes;
+    di->set_current_frame( k );
+    vil_image_view<T> view = di->get_view( 0, di->ni(), 0, di->nj() );
+    if ( di->current_frame() != k || !view ) {
+      std::cout << "[ couldn't get frame " << k << " of " << img_data_file << " ]" << std::endl;
+      return false;
+    }
+    for ( unsigned j = 0; j < 3; ++j )
+      for ( unsigned i = 0; i < 4; ++i ) {
+        double expected = slope * (k * kstep + i + 4 * j) + intercept;
+        if ( std::fabs( view(i,j) - expected ) > 1e-6 ) {
+          std::cout << "[ frame " << k << " pixel (" << i << ',' << j << ") is "
+                    << view(i,j) << ", expected " << expected << " ]" << std::endl;
+          return false;
+        }
+      }
+  }
+  return true;
+}
+#endif // HAS_DCMTK
+
 
 static void
 test_file_format_read( int argc, char* argv[] )
@@ -567,6 +668,21 @@ test_file_format_read( int argc, char* argv[] )
   TEST("64-bit float (double)", CheckFile(CompareGreyFloat<double>(), "ff_nitf_float_true.txt", "ff_nitf_double.nitf" ), true);
   std::cout << "NSIF 1.0 [nitf] (uncompressed)\n";
   TEST("1-bit bool (NSIF w/ LUT to parse)", CheckFile(CompareGrey<bool>(), "ff_nitf_1bit_lut_true.txt", "ff_nitf_1bit_lut.nsif" ), true);
+  std::cout << "NITF 2.1 [nitf] (uncompressed, lazily parsed headers)\n";
+  vil_nitf2::s_lazy_parsing = true;
+  TEST("8-bit unsigned int (IMODE=P), lazy", CheckFile(ComparePlanes<vxl_byte,3>(), "ff_nitf_8bit_true.txt", "ff_nitf_8bit_p.nitf" ), true);
+  TEST("8-bit unsigned int (IMODE=S), lazy", CheckFile(ComparePlanes<vxl_byte,3>(), "ff_nitf_8bit_true.txt", "ff_nitf_8bit_s.nitf" ), true);
+  TEST("16-bit unsigned int (ABPP=13), lazy", CheckFile(CompareGrey<vxl_uint_16>(), "ff_nitf_16bit_true.txt", "ff_nitf_16bit.nitf" ), true);
+  TEST("1-bit bool (NSIF w/ LUT to parse), lazy", CheckFile(CompareGrey<bool>(), "ff_nitf_1bit_lut_true.txt", "ff_nitf_1bit_lut.nsif" ), true);
+  vil_nitf2::s_lazy_parsing = false;
+  {
+    double eager_el = 0, eager_az = 0, lazy_el = -1, lazy_az = -1;
+    std::string eager_mission, lazy_mission;
+    TEST("TREs read eagerly", ReadNitfTREs("ff_grey16bit_uncompressed.nitf", false, eager_el, eager_az, eager_mission), true);
+    TEST("TREs read lazily", ReadNitfTREs("ff_grey16bit_uncompressed.nitf", true, lazy_el, lazy_az, lazy_mission), true);
+    TEST("lazy TRE values match eager ones",
+         lazy_el == eager_el && lazy_az == eager_az && lazy_mission == eager_mission, true);
+  }
 
 #if HAS_J2K
   std::cout << "JPEG 2000 [j2k,jpc]\n";
@@ -615,6 +731,22 @@ test_file_format_read( int argc, char* argv[] )
   TEST("16-bit grey", CheckFile(CompareGrey<vxl_uint_16>(), "ff_grey16bit_true.txt", "ff_grey16bit.mit" ), true);
   TEST("8-bit RGB", CheckFile(CompareRGB<vxl_byte>(), "ff_rgb8bit_true.txt", "ff_rgb8bit.mit" ), true);
 
+  std::cout << "Magic number dispatch\n";
+  vil_load_reset_format_stats();
+  vil_load_enable_format_stats();
+  TEST("pgm loaded", bool(vil_load_image_resource_raw((image_base + "ff_grey8bit_raw.pgm").c_str())), true);
+  std::vector<vil_load_format_stats> stats = vil_load_format_stats_summary();
+  TEST("pgm dispatched directly to pnm", stats.size() == 1 && stats[0].tag == "pnm" &&
+       stats[0].attempts == 1 && stats[0].successes == 1, true);
+  vil_load_reset_format_stats();
+  // MIT files have no magic number, so they are found by probing
+  TEST("mit loaded", bool(vil_load_image_resource_raw((image_base + "ff_grey8bit.mit").c_str())), true);
+  stats = vil_load_format_stats_summary();
+  TEST("mit found by probing", !stats.empty() && stats.back().tag == "mit" &&
+       stats.back().successes == 1, true);
+  vil_load_enable_format_stats(false);
+  vil_load_reset_format_stats();
+
 #if HAS_DCMTK
   std::cout << "DICOM [dcm]\n";
   TEST("16-bit greyscale uncompressed", CheckFile(CompareGrey<vxl_uint_16>(), "ff_grey16bit_true_for_dicom.txt", "ff_grey16bit_uncompressed.dcm"), true);
@@ -624,6 +756,14 @@ test_file_format_read( int argc, char* argv[] )
   TEST("8-bit greyscale uncompressed 2", CheckFile(CompareGrey<vxl_uint_8>(), "ff_grey8bit_true.txt", "ff_grey8bit_uncompressed2.dcm" ), true);
   TEST("16-bit greyscale uncompressed 3", CheckFile(CompareGrey<vxl_uint_16>(), "ff_grey16bit_true.txt", "ff_grey16bit_uncompressed3.dcm" ), true);
   TEST("12-bit greyscale float uncompressed", CheckFile(CompareGreyFloat<float>(), "ff_grey_float_true_for_dicom.txt", "ff_grey_float_12bit_uncompressed.dcm" ), true);
+  // 16 bits stored in 16 are copied straight from the pixel data
+  TEST("16-bit multi-frame", CheckDicomFrames<vxl_uint_16>( "ff_grey16bit_3frames.dcm", 3, 1000 ), true);
+  // 12 bits stored in 16 are unpacked by DCMTK, all frames together
+  TEST("12-bit multi-frame", CheckDicomFrames<vxl_uint_16>( "ff_grey12bit_3frames.dcm", 3, 1000 ), true);
+  TEST("8-bit multi-frame rescaled", CheckDicomFrames<float>( "ff_grey8bit_2frames_rescaled.dcm", 2, 100, 0.5, -10 ), true);
+#if HAS_DCMTK_RLE
+  TEST("16-bit multi-frame RLE", CheckDicomFrames<vxl_uint_16>( "ff_grey16bit_3frames_rle.dcm", 3, 1000 ), true);
+#endif // HAS_DCMTK_RLE
 #endif // HAS_DCMTK
 }
 
@@ -59,6 +59,7 @@
 #include <vil/vil_stream_core.h>
 #include <vil/vil_stream_fstream.h>
 #include <vil/vil_stream_fstream64.h>
+#include <vil/vil_stream_pread.h>
 #include <vil/vil_stream_section.h>
 #include <vil/vil_stream_url.h>
 #include <vil/vil_transform.h>
@@ -208,6 +208,47 @@ static void test_pyramid_image_resource( int argc, char* argv[] )
   //Cleanup pyramid directory
   vl.clean_directory();
 
+  //Test on-demand generation of pyramid_image_list levels
+  {//scope for odpyr
+    std::vector<vil_image_resource_sptr> base(1, ir);
+    vil_pyramid_image_list* odpil = new vil_pyramid_image_list(base);
+    vil_pyramid_image_resource_sptr odpyr = odpil;
+    bool enabled = odpil->enable_on_demand_levels(3, d.c_str(), "tiff");
+    TEST("enable on-demand pyramid levels", enabled && odpyr->nlevels()==3, true);
+    vil_image_view<unsigned short> v2 = odpyr->get_copy_view(2);
+    TEST("on-demand level 2 size", v2.ni()==19 && v2.nj()==11, true);
+    vil_image_view<unsigned short> v1 = odpyr->get_copy_view(1);
+    TEST("on-demand level 1 value", v1 && v1(0,0)==37, true);
+    //the second request is served from the in-memory cache
+    vil_image_view<unsigned short> v1b = odpyr->get_copy_view(1);
+    TEST("on-demand cached view is a copy",
+         v1b && v1b.top_left_ptr()!=v1.top_left_ptr() && v1b(0,0)==37, true);
+    float actual_scale = 0;
+    odpyr->get_copy_view(0.25f, actual_scale);
+    TEST_NEAR("on-demand closest scale", actual_scale, 19.0f/73.0f, 1e-6);
+  }
+  {//a new pyramid picks up the levels written to the cache directory
+    std::vector<vil_image_resource_sptr> base(1, ir);
+    vil_pyramid_image_list* odpil = new vil_pyramid_image_list(base);
+    vil_pyramid_image_resource_sptr odpyr = odpil;
+    odpil->enable_on_demand_levels(3, d.c_str(), "tiff");
+    vil_image_resource_sptr l2 = odpil->get_level(2);
+    TEST("on-demand level reloaded from cache", l2 && l2->ni()==19, true);
+  }
+  {//levels cached for another base image of the same size are not reused
+    vil_image_view<unsigned short> other(ni, nj);
+    for (unsigned i = 0; i<ni; ++i)
+      for (unsigned j = 0; j<nj; ++j)
+        other(i,j) = static_cast<unsigned short>(image(i,j) + 100);
+    std::vector<vil_image_resource_sptr> base(1, vil_new_image_resource_of_view(other));
+    vil_pyramid_image_list* odpil = new vil_pyramid_image_list(base);
+    vil_pyramid_image_resource_sptr odpyr = odpil;
+    odpil->enable_on_demand_levels(3, d.c_str(), "tiff");
+    vil_image_view<unsigned short> v1 = odpyr->get_copy_view(1);
+    TEST("stale on-demand cache regenerated", v1 && v1(0,0)==137, true);
+  }
+  vl.clean_directory();
+
   ///Test the tiff pyramid resource with multiple levels in a single file
   std::string file = "tiff_pyramid.tif"; //  create_multi_file_resource(file);
   {//scope for pi
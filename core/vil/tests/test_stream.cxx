@@ -1,5 +1,7 @@
 // This is core/vil/tests/test_stream.cxx
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <testlib/testlib_test.h>
 #include <testlib/testlib_root_dir.h>
 
@@ -7,6 +9,7 @@
 #include <vul/vul_file.h>
 
 #include <vil/vil_stream_fstream.h>
+#include <vil/vil_stream_pread.h>
 #include <vxl_config.h>
 
 #if defined(VCL_WIN32) && VXL_USE_WIN_WCHAR_T
@@ -46,6 +49,54 @@ test_stream( int argc, char* argv[] )
     fs->unref();
   }
 
+#ifndef VCL_WIN32
+  {
+    std::string fn = dir+"/ff_grey8bit_compressed.jpg";
+    vil_stream* fs = new vil_stream_fstream( fn.c_str(), "r" );
+    fs->ref();
+    std::vector<char> truth(421);
+    fs->read(&truth[0], 421);
+    // the default read_at() seeks and reads
+    char at[8];
+    TEST( "fstream: read_at", fs->read_at(200, at, 8) == 8 &&
+          std::equal(at, at+8, truth.begin()+200) && fs->tell() == 208, true );
+    fs->unref();
+
+    // Use a tiny buffer so that reads straddle refills
+    vil_stream_pread* ps = new vil_stream_pread( fn.c_str(), 16 );
+    ps->ref();
+    TEST( "pread: Open file", ps->ok(), true );
+    TEST( "pread: Size file", ps->file_size(), 421 );
+
+    std::vector<char> data(421);
+    vil_streampos total = 0;
+    for (unsigned n = 1; total < 421; n = n % 37 + 1)
+    {
+      vil_streampos r = ps->read(&data[std::size_t(total)], total + n > 421 ? 421 - total : n);
+      if (r == 0) break;
+      total += r;
+    }
+    TEST( "pread: sequential reads", total == 421 && data == truth, true );
+    TEST( "pread: tell at end", ps->tell(), 421 );
+    char c;
+    TEST( "pread: read past end", ps->read(&c, 1), 0 );
+
+    ps->seek(100);
+    char buf[50];
+    TEST( "pread: read after seek", ps->read(buf, 50) == 50 &&
+          std::equal(buf, buf+50, truth.begin()+100), true );
+
+    TEST( "pread: read_at", ps->read_at(300, buf, 50) == 50 &&
+          std::equal(buf, buf+50, truth.begin()+300), true );
+    TEST( "pread: read_at leaves file pointer", ps->tell(), 150 );
+    TEST( "pread: short read_at at end", ps->read_at(400, buf, 50), 21 );
+    vil_stream* base = ps;
+    TEST( "pread: read_at through vil_stream", base->read_at(10, buf, 5) == 5 &&
+          std::equal(buf, buf+5, truth.begin()+10) && ps->tell() == 150, true );
+    ps->unref();
+  }
+#endif // VCL_WIN32
+
 #if defined(VCL_WIN32) && VXL_USE_WIN_WCHAR_T
   const unsigned int size = 4096;  // should be enough
   std::wstring wdir;
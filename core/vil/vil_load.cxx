@@ -6,8 +6,15 @@
 // \file
 
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 #include "vil_load.h"
 #include <vcl_compiler.h>
+#if defined(VCL_WIN32) && !defined(__CYGWIN__)
+#include <sys/timeb.h>
+#else
+#include <vcl_sys/time.h>
+#endif
 #include <vil/vil_open.h>
 #include <vil/vil_new.h>
 #include <vil/vil_file_format.h>
@@ -17,15 +24,169 @@
 #include <vil/vil_image_view.h>
 #include <vil/vil_exception.h>
 
+//: A magic number identifying the file format with the given tag
+struct vil_load_magic_number
+{
+  std::string tag;
+  unsigned offset;
+  std::string bytes;
+};
+
+static void vil_load_add_magic(std::vector<vil_load_magic_number>& table, char const* tag,
+                               unsigned offset, void const* bytes, unsigned nbytes)
+{
+  vil_load_magic_number m;
+  m.tag = tag;
+  m.offset = offset;
+  m.bytes.assign(static_cast<char const*>(bytes), nbytes);
+  table.push_back(m);
+}
+
+//: Magic numbers of the built-in formats.
+// Registering one for a format that is not configured is harmless, since
+// its tag never matches.
+static std::vector<vil_load_magic_number> vil_load_builtin_magic_numbers()
+{
+  std::vector<vil_load_magic_number> t;
+  vil_load_add_magic(t, "jpeg",  0, "\xFF\xD8\xFF", 3);
+  vil_load_add_magic(t, "png",   0, "\x89PNG\r\n\x1A\n", 8);
+  for (char c = '1'; c <= '6'; ++c) {
+    char const pnm[2] = { 'P', c };
+    vil_load_add_magic(t, "pnm", 0, pnm, 2);
+  }
+  vil_load_add_magic(t, "iris",  0, "\x01\xDA", 2);
+  vil_load_add_magic(t, "viff",  0, "\xAB\x01", 2);
+  vil_load_add_magic(t, "bmp",   0, "BM", 2);
+  vil_load_add_magic(t, "gif",   0, "GIF8", 4);
+  vil_load_add_magic(t, "ras",   0, "\x59\xA6\x6A\x95", 4);
+  vil_load_add_magic(t, "dicom", 128, "DICM", 4);
+  vil_load_add_magic(t, "nitf",  0, "NITF", 4);
+  vil_load_add_magic(t, "nitf",  0, "NSIF", 4);
+  vil_load_add_magic(t, "j2k",   0, "\xFF\x4F\xFF\x51", 4);
+  vil_load_add_magic(t, "jp2",   0, "\x00\x00\x00\x0CjP  ", 8);
+  vil_load_add_magic(t, "tiff",  0, "II*\0", 4);
+  vil_load_add_magic(t, "tiff",  0, "MM\0*", 4);
+  vil_load_add_magic(t, "tiff",  0, "II+\0", 4); // BigTIFF
+  vil_load_add_magic(t, "tiff",  0, "MM\0+", 4);
+  return t;
+}
+
+static std::vector<vil_load_magic_number>& vil_load_magic_numbers()
+{
+  static std::vector<vil_load_magic_number> table = vil_load_builtin_magic_numbers();
+  return table;
+}
+
+void vil_load_add_magic_number(char const* tag, unsigned offset,
+                               void const* bytes, unsigned nbytes)
+{
+  vil_load_add_magic(vil_load_magic_numbers(), tag, offset, bytes, nbytes);
+}
+
+static bool vil_load_stats_enabled = false;
+
+static std::vector<vil_load_format_stats>& vil_load_stats()
+{
+  static std::vector<vil_load_format_stats> stats;
+  return stats;
+}
+
+void vil_load_enable_format_stats(bool enable)
+{
+  vil_load_stats_enabled = enable;
+}
+
+std::vector<vil_load_format_stats> vil_load_format_stats_summary()
+{
+  return vil_load_stats();
+}
+
+void vil_load_reset_format_stats()
+{
+  vil_load_stats().clear();
+}
+
+//: Wall-clock time in seconds, so that time spent waiting on I/O is counted
+static double vil_load_wall_seconds()
+{
+#if defined(VCL_WIN32) && !defined(__CYGWIN__)
+  struct _timeb t;
+  _ftime(&t);
+  return double(t.time) + t.millitm * 1e-3;
+#else
+  struct timeval t;
+  gettimeofday(&t, VXL_NULLPTR);
+  return double(t.tv_sec) + t.tv_usec * 1e-6;
+#endif
+}
+
+//: Call ff->make_input_image(is), recording statistics if enabled
+static vil_image_resource_sptr vil_load_try_format(vil_file_format* ff, vil_stream* is)
+{
+#if 0 // debugging
+  std::cerr << __FILE__ " : trying \'" << ff->tag() << "\'\n";
+#endif
+  is->seek(0);
+  if (!vil_load_stats_enabled)
+    return ff->make_input_image(is);
+
+  double start = vil_load_wall_seconds();
+  vil_image_resource_sptr im = ff->make_input_image(is);
+  double seconds = vil_load_wall_seconds() - start;
+
+  std::vector<vil_load_format_stats>& stats = vil_load_stats();
+  std::vector<vil_load_format_stats>::iterator s = stats.begin();
+  while (s != stats.end() && s->tag != ff->tag()) ++s;
+  if (s == stats.end()) {
+    vil_load_format_stats fresh;
+    fresh.tag = ff->tag();
+    fresh.attempts = fresh.successes = 0;
+    fresh.seconds = 0.0;
+    s = stats.insert(stats.end(), fresh);
+  }
+  ++s->attempts;
+  if (im) ++s->successes;
+  s->seconds += seconds;
+  return im;
+}
+
 vil_image_resource_sptr vil_load_image_resource_raw(vil_stream *is,
                                                     bool verbose)
 {
+  // Read the start of the stream once, and offer it first to the
+  // formats whose magic number matches.
+  std::vector<vil_load_magic_number> const& magic = vil_load_magic_numbers();
+  std::vector<vil_file_format*> tried;
+  unsigned header_size = 0;
+  for (unsigned m = 0; m < magic.size(); ++m)
+    if (magic[m].offset + magic[m].bytes.size() > header_size)
+      header_size = magic[m].offset + unsigned(magic[m].bytes.size());
+  std::vector<char> header(header_size);
+  is->seek(0);
+  vil_streampos n = header_size ? is->read(&header[0], header_size) : 0;
+
+  for (unsigned m = 0; m < magic.size(); ++m) {
+    vil_load_magic_number const& mn = magic[m];
+    if (mn.offset + mn.bytes.size() > (unsigned long)n ||
+        std::memcmp(&header[mn.offset], mn.bytes.data(), mn.bytes.size()) != 0)
+      continue;
+    for (vil_file_format** p = vil_file_format::all(); *p; ++p) {
+      if (mn.tag != (*p)->tag() ||
+          std::find(tried.begin(), tried.end(), *p) != tried.end())
+        continue;
+      tried.push_back(*p);
+      vil_image_resource_sptr im = vil_load_try_format(*p, is);
+      if (im)
+        return im;
+    }
+  }
+
+  // No magic number matched (or the matching format refused the stream),
+  // so probe the remaining formats in turn.
   for (vil_file_format** p = vil_file_format::all(); *p; ++p) {
-#if 0 // debugging
-    std::cerr << __FILE__ " : trying \'" << (*p)->tag() << "\'\n";
-#endif
-    is->seek(0);
-    vil_image_resource_sptr im = (*p)->make_input_image(is);
+    if (std::find(tried.begin(), tried.end(), *p) != tried.end())
+      continue;
+    vil_image_resource_sptr im = vil_load_try_format(*p, is);
     if (im)
       return im;
   }
@@ -25,6 +25,8 @@
 //     24 Sep 2002 Ian Scott - converted to vil
 //\endverbatim
 
+#include <string>
+#include <vector>
 #include <vil/vil_fwd.h>
 #include <vil/vil_image_resource.h>
 #include <vil/vil_pyramid_image_resource.h>
@@ -37,6 +39,10 @@ vil_image_resource_sptr vil_load_image_resource(char const* filename,
 
 //: Load from a stream.
 // Won't use plugins.
+// The first bytes of the stream are read once and compared against the
+// registered magic numbers (see vil_load_add_magic_number()); formats whose
+// magic number matches are tried first, then all remaining formats are
+// probed in turn, as before.
 // \relatesalso vil_image_resource
 vil_image_resource_sptr vil_load_image_resource_raw(vil_stream *,
                                                     bool verbose = true);
@@ -61,6 +67,35 @@ vil_load_pyramid_resource(char const* directory_or_file, bool verbose = true);
 // \relatesalso vil_image_view
 vil_image_view_base_sptr vil_load(const char *, bool verbose = true);
 
+//: Register a magic number for the file format whose tag() is \p tag.
+// A stream whose bytes [offset, offset+nbytes) equal \p bytes is offered to
+// that format before any other. The magic numbers of the built-in formats are
+// registered already; use this for formats added by vil_file_format::add_file_format().
+void vil_load_add_magic_number(char const* tag, unsigned offset,
+                               void const* bytes, unsigned nbytes);
+
+//: Timing statistics of the calls vil_load_image_resource_raw() made to one format.
+struct vil_load_format_stats
+{
+  std::string tag;
+  //: Number of calls to vil_file_format::make_input_image()
+  unsigned long attempts;
+  //: Number of those calls that returned an image resource
+  unsigned long successes;
+  //: Total elapsed (wall-clock) time, in seconds, spent in those calls
+  double seconds;
+};
+
+//: Switch collection of per-format statistics on or off (default off).
+// Collection is not thread safe; only enable it while loading from one thread.
+void vil_load_enable_format_stats(bool enable = true);
+
+//: Return the statistics collected so far, one entry per format tried.
+std::vector<vil_load_format_stats> vil_load_format_stats_summary();
+
+//: Clear the collected statistics.
+void vil_load_reset_format_stats();
+
 
 #if defined(VCL_WIN32) && VXL_USE_WIN_WCHAR_T
 //: Load an image resource object from a file.
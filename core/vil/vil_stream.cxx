@@ -28,6 +28,13 @@ vil_stream::~vil_stream()
 }
 
 
+vil_streampos vil_stream::read_at(vil_streampos position, void* buf, vil_streampos n)
+{
+  seek(position);
+  return read(buf, n);
+}
+
+
 void vil_stream::unref()
 {
   assert(refcount_ >= 0); // negative refcount is very serious
@@ -44,6 +44,14 @@ class vil_stream
   //: Amount of data in the stream
   virtual vil_streampos file_size() const = 0;
 
+  //: Read n bytes starting at position into buf. Returns number of bytes read.
+  //  The default seeks and then reads, so it moves the file pointer and must
+  //  not be called while another thread uses the stream. Streams that can
+  //  read at an offset directly (e.g. vil_stream_pread) override it with a
+  //  version that leaves the file pointer alone and is safe to call from
+  //  several threads at once.
+  virtual vil_streampos read_at(vil_streampos position, void* buf, vil_streampos n);
+
   //: up/down the reference count
   void ref() { ++refcount_; }
 
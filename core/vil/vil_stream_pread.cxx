@@ -0,0 +1,100 @@
+// This is core/vil/vil_stream_pread.cxx
+#ifdef VCL_NEEDS_PRAGMA_INTERFACE
+#pragma implementation
+#endif
+//:
+// \file
+
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include "vil_stream_pread.h"
+#include <vcl_cassert.h>
+#include <vcl_compiler.h>
+
+#ifndef VCL_WIN32
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+vil_stream_pread::vil_stream_pread(char const* fn, unsigned buffer_size)
+  : fd_(::open(fn, O_RDONLY)),
+    pos_(0),
+    buffer_(buffer_size),
+    buffer_pos_(0),
+    buffer_fill_(0)
+{
+}
+
+vil_stream_pread::~vil_stream_pread()
+{
+  if (ok())
+    ::close(fd_);
+}
+
+vil_streampos vil_stream_pread::write(void const* /*buf*/, vil_streampos /*n*/)
+{
+  std::cerr << "vil_stream_pread: write failed, stream is read-only\n";
+  return 0;
+}
+
+vil_streampos vil_stream_pread::read_at(vil_streampos position, void* buf, vil_streampos n)
+{
+  assert(ok());
+  if (position < 0 || n <= 0)
+    return 0;
+  char* dest = static_cast<char*>(buf);
+  vil_streampos total = 0;
+  while (total < n) {
+    ssize_t r = ::pread(fd_, dest + total, size_t(n - total), off_t(position + total));
+    if (r < 0 && errno == EINTR)
+      continue;
+    if (r <= 0) // end of file or error
+      break;
+    total += r;
+  }
+  return total;
+}
+
+vil_streampos vil_stream_pread::read(void* buf, vil_streampos n)
+{
+  assert(ok());
+  char* dest = static_cast<char*>(buf);
+  vil_streampos total = 0;
+  while (total < n) {
+    // serve what we can from the buffer
+    if (pos_ >= buffer_pos_ && pos_ < buffer_pos_ + buffer_fill_) {
+      vil_streampos k = buffer_pos_ + buffer_fill_ - pos_;
+      if (k > n - total) k = n - total;
+      std::memcpy(dest + total, &buffer_[std::size_t(pos_ - buffer_pos_)], std::size_t(k));
+      total += k;
+      pos_ += k;
+      continue;
+    }
+    vil_streampos remaining = n - total;
+    if (remaining >= vil_streampos(buffer_.size())) {
+      // a large read gains nothing from the buffer
+      vil_streampos r = read_at(pos_, dest + total, remaining);
+      total += r;
+      pos_ += r;
+      break;
+    }
+    // refill the buffer from the current position
+    buffer_pos_ = pos_;
+    buffer_fill_ = read_at(pos_, &buffer_[0], vil_streampos(buffer_.size()));
+    if (buffer_fill_ == 0) // end of file
+      break;
+  }
+  return total;
+}
+
+vil_streampos vil_stream_pread::file_size() const
+{
+  struct stat st;
+  if (!ok() || ::fstat(fd_, &st) != 0)
+    return 0;
+  return vil_streampos(st.st_size);
+}
+
+#endif // VCL_WIN32
@@ -0,0 +1,78 @@
+// This is core/vil/vil_stream_pread.h
+#ifndef vil_stream_pread_h_
+#define vil_stream_pread_h_
+#ifdef VCL_NEEDS_PRAGMA_INTERFACE
+#pragma interface
+#endif
+//:
+// \file
+// \brief A read-only vil_stream on a file descriptor, using pread() and a readahead buffer
+//
+// vil_stream_fstream turns every read() and seek() into a call on a
+// std::fstream, which is slow for the many small header reads image loaders
+// make, and cannot be shared between threads since every read moves the one
+// file pointer.  vil_stream_pread keeps its own file pointer and serves
+// sequential read() calls from a readahead buffer.  Its override of
+// vil_stream::read_at() reads from an explicit position without touching
+// the file pointer or the buffer, so several threads (e.g. tile decoders
+// such as vil_nitf2_image::get_block()) may call it concurrently on one
+// shared stream.
+//
+// Only available on POSIX systems.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vector>
+#include <vcl_compiler.h>
+#include <vil/vil_stream.h>
+
+#ifndef VCL_WIN32
+
+//: A read-only vil_stream using pread() with a readahead buffer
+class vil_stream_pread : public vil_stream
+{
+ public:
+  //: Open \p filename for reading.
+  // Sequential reads smaller than \p buffer_size bytes are served from a
+  // readahead buffer of that size; 0 disables buffering.
+  vil_stream_pread(char const* filename, unsigned buffer_size = 65536);
+
+  // implement virtual vil_stream interface:
+  bool ok() const { return fd_ != -1; }
+  vil_streampos write(void const* buf, vil_streampos n);
+  vil_streampos read(void* buf, vil_streampos n);
+  vil_streampos tell() const { return pos_; }
+  void seek(vil_streampos position) { pos_ = position; }
+
+  vil_streampos file_size() const;
+
+  //: Read \p n bytes starting at \p position into \p buf.
+  // Neither uses nor moves the file pointer, and may be called concurrently
+  // from several threads. Returns the number of bytes read, which is less
+  // than \p n only at end of file or on error.
+  vil_streampos read_at(vil_streampos position, void* buf, vil_streampos n);
+
+  //: Size of the readahead buffer in bytes
+  unsigned buffer_size() const { return unsigned(buffer_.size()); }
+
+ protected:
+  ~vil_stream_pread();
+
+ private:
+  int fd_;
+  vil_streampos pos_;
+  //: Readahead buffer, holding buffer_fill_ bytes of the file from buffer_pos_
+  std::vector<char> buffer_;
+  vil_streampos buffer_pos_;
+  vil_streampos buffer_fill_;
+
+  // disallow copying
+  vil_stream_pread(vil_stream_pread const&);
+  vil_stream_pread& operator=(vil_stream_pread const&);
+};
+
+#endif // VCL_WIN32
+
+#endif // vil_stream_pread_h_
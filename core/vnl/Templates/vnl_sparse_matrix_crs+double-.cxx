@@ -0,0 +1,3 @@
+#include <vnl/vnl_sparse_matrix_crs.hxx>
+
+VNL_SPARSE_MATRIX_CRS_INSTANTIATE(double);
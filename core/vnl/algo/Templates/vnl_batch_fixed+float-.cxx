@@ -0,0 +1,3 @@
+#include <vnl/algo/vnl_batch_fixed.hxx>
+
+VNL_BATCH_FIXED_INSTANTIATE(float);
@@ -0,0 +1,2 @@
+#include <vnl/algo/vnl_fft_1d_real.hxx>
+VNL_FFT_1D_REAL_INSTANTIATE(double);
@@ -0,0 +1,2 @@
+#include <vnl/algo/vnl_fft_2d_real.hxx>
+VNL_FFT_2D_REAL_INSTANTIATE(double);
@@ -0,0 +1,218 @@
+// This is core/vnl/algo/tests/test_batch_fixed.cxx
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <testlib/testlib_test.h>
+#include <vcl_compiler.h>
+#include <vnl/vnl_matrix_fixed.h>
+#include <vnl/vnl_vector_fixed.h>
+#include <vnl/vnl_inverse.h>
+#include <vnl/vnl_random.h>
+#include <vnl/algo/vnl_batch_fixed.h>
+#include <vnl/algo/vnl_svd.h>
+#include <vnl/algo/vnl_symmetric_eigensystem.h>
+
+//: Rotation taking the z axis to a random direction, for repeated eigenvalues
+static vnl_matrix_fixed<double,3,3> random_rotation(vnl_random& rng)
+{
+  vnl_matrix<double> X(3, 3);
+  for (unsigned i = 0; i < 3; ++i)
+    for (unsigned j = 0; j < 3; ++j)
+      X(i,j) = rng.normal();
+  return vnl_matrix_fixed<double,3,3>(vnl_svd<double>(X).U());
+}
+
+//: Largest element of |V' V - I|
+template <unsigned int N>
+static double orthogonality_error(vnl_matrix_fixed<double,N,N> const& V)
+{
+  vnl_matrix_fixed<double,N,N> I;
+  I.set_identity();
+  return (V.transpose() * V - I).absolute_value_max();
+}
+
+template <unsigned int N>
+static void test_inverse(vnl_random& rng)
+{
+  const unsigned n = 133;
+  std::vector<vnl_matrix_fixed<double,N,N> > M(n), Minv(n);
+  for (unsigned k = 0; k < n; ++k)
+    for (unsigned i = 0; i < N; ++i)
+      for (unsigned j = 0; j < N; ++j)
+        M[k](i,j) = rng.normal();
+  M[7].set_row(1, 0.0);  // singular
+  std::vector<double> A(N*N*n), Ainv(N*N*n), det(n);
+  vnl_batch_pack(n, &M[0], &A[0]);
+  if (N == 3)
+    vnl_batch_inverse_3x3(n, &A[0], &Ainv[0], &det[0]);
+  else
+    vnl_batch_inverse_4x4(n, &A[0], &Ainv[0], &det[0]);
+  vnl_batch_unpack(n, &Ainv[0], &Minv[0]);
+
+  double err = 0.0, derr = 0.0;
+  for (unsigned k = 0; k < n; ++k)
+  {
+    if (k == 7)
+      continue;
+    err = std::max(err, (Minv[k] - vnl_inverse(M[k])).absolute_value_max());
+    derr = std::max(derr, std::abs(det[k] - vnl_det(M[k])));
+  }
+  std::cout << N << 'x' << N << ":\n";
+  TEST_NEAR("inverse matches vnl_inverse", err, 0.0, 1e-10);
+  TEST_NEAR("determinant matches vnl_det", derr, 0.0, 1e-10);
+  TEST("singular: zero determinant", det[7], 0.0);
+  TEST("singular: zero inverse", Minv[7].absolute_value_max(), 0.0);
+}
+
+template <unsigned int N>
+static void check_eigensystem(std::vector<vnl_matrix_fixed<double,N,N> > const& S)
+{
+  const unsigned n = S.size();
+  std::vector<double> A(N*N*n), D(N*n), Dv(N*n), V(N*N*n);
+  vnl_batch_pack(n, &S[0], &A[0]);
+  if (N == 3) {
+    vnl_batch_symmetric_eigensystem_3x3(n, &A[0], &D[0], &V[0]);
+    vnl_batch_symmetric_eigensystem_3x3(n, &A[0], &Dv[0]);
+  }
+  else {
+    vnl_batch_symmetric_eigensystem_4x4(n, &A[0], &D[0], &V[0]);
+    vnl_batch_symmetric_eigensystem_4x4(n, &A[0], &Dv[0]);
+  }
+  std::vector<vnl_matrix_fixed<double,N,N> > Vk(n);
+  std::vector<vnl_vector_fixed<double,N> > Dk(n);
+  vnl_batch_unpack(n, &V[0], &Vk[0]);
+  vnl_batch_unpack(n, &D[0], &Dk[0]);
+
+  double derr = 0.0, rerr = 0.0, oerr = 0.0;
+  for (unsigned k = 0; k < n; ++k)
+  {
+    vnl_matrix<double> V0;
+    vnl_vector<double> D0;
+    vnl_symmetric_eigensystem_compute(S[k].as_ref(), V0, D0);
+    const double scale = std::max(S[k].absolute_value_max(), 1.0);
+    derr = std::max(derr, (Dk[k].as_ref() - D0).inf_norm() / scale);
+    vnl_matrix_fixed<double,N,N> R = S[k] * Vk[k];
+    for (unsigned j = 0; j < N; ++j)
+      R.set_column(j, R.get_column(j) - Dk[k][j] * Vk[k].get_column(j));
+    rerr = std::max(rerr, R.absolute_value_max() / scale);
+    oerr = std::max(oerr, orthogonality_error(Vk[k]));
+  }
+  TEST_NEAR("eigenvalues match vnl_symmetric_eigensystem", derr, 0.0, 1e-12);
+  TEST_NEAR("A V = V D", rerr, 0.0, 1e-12);
+  TEST_NEAR("V orthogonal", oerr, 0.0, 1e-12);
+  TEST("eigenvalues without eigenvectors", D == Dv, true);
+}
+
+template <unsigned int N>
+static void test_eigensystem(vnl_random& rng)
+{
+  std::vector<vnl_matrix_fixed<double,N,N> > S(201);
+  for (unsigned k = 0; k < S.size(); ++k)
+    for (unsigned i = 0; i < N; ++i)
+      for (unsigned j = i; j < N; ++j)
+        S[k](i,j) = S[k](j,i) = rng.normal() * 10.0;
+  // repeated, nearly repeated and zero eigenvalues, and large scales
+  S[0].fill(0.0);
+  S[1].set_identity();
+  S[1] *= 5.0;
+  for (unsigned k = 2; k < 12; ++k)
+  {
+    vnl_matrix_fixed<double,N,N> Q;
+    Q.set_identity();
+    Q.update(random_rotation(rng).as_ref());
+    vnl_matrix_fixed<double,N,N> L(0.0);
+    for (unsigned i = 0; i < N; ++i)
+      L(i,i) = double(i);
+    L(0,0) = L(1,1) = (k % 2) ? 1.0 : -2.0;  // double eigenvalue
+    if (k >= 6) L(2,2) = L(1,1) + 1e-9;    // and a nearly triple one
+    S[k] = Q * L * Q.transpose();
+    S[k] *= (k >= 9) ? 1e150 : 1.0;
+  }
+  std::cout << N << 'x' << N << ":\n";
+  check_eigensystem<N>(S);
+}
+
+template <unsigned int N>
+static void test_svd(vnl_random& rng)
+{
+  std::vector<vnl_matrix_fixed<double,N,N> > M(150);
+  for (unsigned k = 0; k < M.size(); ++k)
+    for (unsigned i = 0; i < N; ++i)
+      for (unsigned j = 0; j < N; ++j)
+        M[k](i,j) = rng.normal();
+  M[0].fill(0.0);
+  M[1].set_row(2, M[1].get_row(0) * 2.0);    // rank N-1
+  M[2] = outer_product(M[2].get_row(0), M[2].get_row(1));  // rank 1
+  M[3].set_column(1, M[3].get_column(0) * 1e-20);
+  const unsigned n = M.size();
+  std::vector<double> A(N*N*n), U(N*N*n), W(N*n), V(N*N*n), W2(N*n), V2(N*N*n);
+  vnl_batch_pack(n, &M[0], &A[0]);
+  if (N == 3) {
+    vnl_batch_svd_3x3(n, &A[0], &U[0], &W[0], &V[0]);
+    vnl_batch_svd_3x3(n, &A[0], (double*)VXL_NULLPTR, &W2[0], &V2[0]);
+  }
+  else {
+    vnl_batch_svd_4x4(n, &A[0], &U[0], &W[0], &V[0]);
+    vnl_batch_svd_4x4(n, &A[0], (double*)VXL_NULLPTR, &W2[0], &V2[0]);
+  }
+  std::vector<vnl_matrix_fixed<double,N,N> > Uk(n), Vk(n);
+  std::vector<vnl_vector_fixed<double,N> > Wk(n);
+  vnl_batch_unpack(n, &U[0], &Uk[0]);
+  vnl_batch_unpack(n, &V[0], &Vk[0]);
+  vnl_batch_unpack(n, &W[0], &Wk[0]);
+
+  double werr = 0.0, rerr = 0.0, uerr = 0.0, verr = 0.0;
+  for (unsigned k = 0; k < n; ++k)
+  {
+    vnl_svd<double> svd(M[k].as_ref());
+    for (unsigned i = 0; i < N; ++i)
+      werr = std::max(werr, std::abs(Wk[k][i] - svd.W(i)));
+    vnl_matrix_fixed<double,N,N> UW = Uk[k];
+    for (unsigned j = 0; j < N; ++j)
+      UW.set_column(j, UW.get_column(j) * Wk[k][j]);
+    rerr = std::max(rerr, (UW * Vk[k].transpose() - M[k]).absolute_value_max());
+    uerr = std::max(uerr, orthogonality_error(Uk[k]));
+    verr = std::max(verr, orthogonality_error(Vk[k]));
+  }
+  std::cout << N << 'x' << N << ":\n";
+  TEST_NEAR("singular values match vnl_svd", werr, 0.0, 1e-12);
+  TEST_NEAR("U W V' = A", rerr, 0.0, 1e-12);
+  TEST_NEAR("U orthogonal", uerr, 0.0, 1e-12);
+  TEST_NEAR("V orthogonal", verr, 0.0, 1e-12);
+  TEST("without U", W == W2 && V == V2, true);
+}
+
+static void test_float(vnl_random& rng)
+{
+  const unsigned n = 70;
+  std::vector<vnl_matrix_fixed<float,3,3> > S(n), V(n);
+  std::vector<vnl_vector_fixed<float,3> > D(n);
+  for (unsigned k = 0; k < n; ++k)
+    for (unsigned i = 0; i < 3; ++i)
+      for (unsigned j = i; j < 3; ++j)
+        S[k](i,j) = S[k](j,i) = float(rng.normal());
+  std::vector<float> A(9*n), Dp(3*n), Vp(9*n);
+  vnl_batch_pack(n, &S[0], &A[0]);
+  vnl_batch_symmetric_eigensystem_3x3(n, &A[0], &Dp[0], &Vp[0]);
+  vnl_batch_unpack(n, &Dp[0], &D[0]);
+  vnl_batch_unpack(n, &Vp[0], &V[0]);
+  float rerr = 0.0f;
+  for (unsigned k = 0; k < n; ++k)
+    for (unsigned j = 0; j < 3; ++j)
+      rerr = std::max(rerr, (S[k] * V[k].get_column(j) - D[k][j] * V[k].get_column(j)).inf_norm());
+  TEST_NEAR("float: A V = V D", rerr, 0.0f, 1e-5f);
+}
+
+static void test_batch_fixed()
+{
+  vnl_random rng(9667566);
+  test_inverse<3>(rng);
+  test_inverse<4>(rng);
+  test_eigensystem<3>(rng);
+  test_eigensystem<4>(rng);
+  test_svd<3>(rng);
+  test_svd<4>(rng);
+  test_float(rng);
+}
+
+TESTMAIN(test_batch_fixed);
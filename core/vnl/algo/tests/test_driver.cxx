@@ -1,6 +1,7 @@
 #include <testlib/testlib_register.h>
 
 DECLARE( test_amoeba );
+DECLARE( test_batch_fixed );
 DECLARE( test_cholesky );
 DECLARE( test_complex_eigensystem );
 DECLARE( test_convolve );
@@ -10,12 +11,14 @@ DECLARE( test_rank );
 DECLARE( test_fft );
 DECLARE( test_fft1d );
 DECLARE( test_fft2d );
+DECLARE( test_fft_real );
 DECLARE( test_functions );
 DECLARE( test_generalized_eigensystem );
 DECLARE( test_ldl_cholesky );
 DECLARE( test_levenberg_marquardt );
 DECLARE( test_matrix_update );
 DECLARE( test_minimizers );
+DECLARE( test_multistart );
 DECLARE( test_powell );
 DECLARE( test_qr );
 DECLARE( test_qsvd );
@@ -26,11 +29,13 @@ DECLARE( test_rpoly_roots );
 DECLARE( test_sparse_matrix );
 DECLARE( test_integral );
 DECLARE( test_svd );
+DECLARE( test_randomized_svd );
 DECLARE( test_svd_fixed );
 DECLARE( test_symmetric_eigensystem );
 DECLARE( test_algo );
 DECLARE( test_solve_qp );
 DECLARE( test_sparse_lu );
+DECLARE( test_sparse_cholesky );
 DECLARE( test_bracket_minimum );
 DECLARE( test_brent_minimizer );
 DECLARE( test_sparse_lm );
@@ -40,6 +45,7 @@ void
 register_tests()
 {
   REGISTER( test_amoeba );
+  REGISTER( test_batch_fixed );
   REGISTER( test_cholesky );
   REGISTER( test_complex_eigensystem );
   REGISTER( test_convolve );
@@ -49,12 +55,14 @@ register_tests()
   REGISTER( test_fft );
   REGISTER( test_fft1d );
   REGISTER( test_fft2d );
+  REGISTER( test_fft_real );
   REGISTER( test_functions );
   REGISTER( test_generalized_eigensystem );
   REGISTER( test_ldl_cholesky );
   REGISTER( test_levenberg_marquardt );
   REGISTER( test_matrix_update );
   REGISTER( test_minimizers );
+  REGISTER( test_multistart );
   REGISTER( test_powell );
   REGISTER( test_qr );
   REGISTER( test_qsvd );
@@ -64,11 +72,13 @@ register_tests()
   REGISTER( test_rpoly_roots );
   REGISTER( test_sparse_matrix );
   REGISTER( test_svd );
+  REGISTER( test_randomized_svd );
   REGISTER( test_svd_fixed );
   REGISTER( test_symmetric_eigensystem );
   REGISTER( test_algo );
   REGISTER( test_solve_qp );
   REGISTER( test_sparse_lu );
+  REGISTER( test_sparse_cholesky );
   REGISTER( test_bracket_minimum );
   REGISTER( test_brent_minimizer );
   REGISTER( test_sparse_lm );
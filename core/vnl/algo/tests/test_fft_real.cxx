@@ -0,0 +1,159 @@
+// This is core/vnl/algo/tests/test_fft_real.cxx
+#include <iostream>
+#include <complex>
+#include <ctime>
+#include <algorithm>
+#include <testlib/testlib_test.h>
+//:
+// \file
+// \brief Tests of the real-input FFTs, the shared twiddle tables and batched multi-D FFTs.
+
+#include <vcl_compiler.h>
+#include <vnl/vnl_vector.h>
+#include <vnl/vnl_matrix.h>
+#include <vnl/vnl_random.h>
+#include <vnl/algo/vnl_fft_1d.h>
+#include <vnl/algo/vnl_fft_2d.h>
+#include <vnl/algo/vnl_fft_1d_real.h>
+#include <vnl/algo/vnl_fft_2d_real.h>
+
+static void test_real_1d(int n, vnl_random &rng)
+{
+  vnl_vector<double> x(n);
+  vnl_vector<std::complex<double> > z(n);
+  for (int i = 0; i < n; ++i)
+    z[i] = x[i] = rng.normal();
+
+  vnl_fft_1d<double> fft(n);
+  fft.fwd_transform(z);
+  vnl_fft_1d_real<double> rfft(n);
+  TEST("spectrum_size", rfft.spectrum_size(), unsigned(n/2 + 1));
+  vnl_vector<std::complex<double> > X;
+  rfft.fwd_transform(x, X);
+  double err = 0.0;
+  for (unsigned k = 0; k < X.size(); ++k)
+    err = std::max(err, std::abs(X[k] - z[k]));
+  std::cout << "n = " << n << ": ";
+  TEST_NEAR("forward matches vnl_fft_1d", err, 0.0, 1e-12 * n);
+
+  vnl_vector<double> y;
+  rfft.bwd_transform(X, y);
+  TEST_NEAR("backward gives n x", (y - double(n) * x).inf_norm(), 0.0, 1e-12 * n);
+}
+
+static void test_real_2d(int m, int n, vnl_random &rng)
+{
+  vnl_matrix<double> x(m, n);
+  vnl_matrix<std::complex<double> > z(m, n);
+  for (int i = 0; i < m; ++i)
+    for (int j = 0; j < n; ++j)
+      z(i,j) = x(i,j) = rng.normal();
+
+  vnl_fft_2d<double> fft(m, n);
+  fft.fwd_transform(z);
+  vnl_fft_2d_real<double> rfft(m, n);
+  vnl_matrix<std::complex<double> > X;
+  rfft.fwd_transform(x, X);
+  TEST("spectrum size", X.rows() == unsigned(m) && X.cols() == unsigned(n/2 + 1), true);
+  double err = 0.0;
+  for (unsigned i = 0; i < X.rows(); ++i)
+    for (unsigned j = 0; j < X.cols(); ++j)
+      err = std::max(err, std::abs(X(i,j) - z(i,j)));
+  std::cout << m << 'x' << n << ": ";
+  TEST_NEAR("2D forward matches vnl_fft_2d", err, 0.0, 1e-11 * m * n);
+
+  vnl_matrix<double> y;
+  rfft.bwd_transform(X, y);
+  TEST_NEAR("2D backward gives m n x", (y - double(m * n) * x).absolute_value_max(), 0.0, 1e-11 * m * n);
+}
+
+//: vnl_fft_2d against transforms of each row and column in turn
+static void test_batched_2d(int m, int n, vnl_random &rng)
+{
+  vnl_matrix<std::complex<double> > a(m, n);
+  for (int i = 0; i < m; ++i)
+    for (int j = 0; j < n; ++j)
+      a(i,j) = std::complex<double>(rng.normal(), rng.normal());
+  vnl_matrix<std::complex<double> > b = a;
+
+  vnl_fft_2d<double> fft(m, n);
+  fft.fwd_transform(a);
+
+  vnl_fft_1d<double> rows(n), cols(m);
+  for (int i = 0; i < m; ++i)
+    rows.fwd_transform(b[i]);
+  vnl_vector<std::complex<double> > c(m);
+  for (int j = 0; j < n; ++j) {
+    for (int i = 0; i < m; ++i) c[i] = b(i,j);
+    cols.fwd_transform(c);
+    for (int i = 0; i < m; ++i) b(i,j) = c[i];
+  }
+  std::cout << m << 'x' << n << ": ";
+  TEST_NEAR("vnl_fft_2d matches row and column transforms", (a - b).absolute_value_max(), 0.0, 1e-10);
+}
+
+static void test_fft_real()
+{
+  vnl_random rng(2718);
+
+  // The twiddle factors are computed once per size.
+  vnl_fft_prime_factors<double> f1(48), f2(48), f3(50);
+  TEST("shared twiddle factors", f1.trigs() == f2.trigs() && f1.trigs() != f3.trigs(), true);
+  f3.resize(48);
+  TEST("resize shares twiddle factors", f3.trigs() == f1.trigs() && f3.number() == 48, true);
+  TEST("factors of 48", f3.pqr()[0] == 4 && f3.pqr()[1] == 1 && f3.pqr()[2] == 0, true);
+
+  int const sizes[] = { 1, 2, 3, 4, 5, 6, 8, 15, 16, 30, 45, 64, 100, 360 };
+  for (unsigned i = 0; i < sizeof sizes / sizeof sizes[0]; ++i)
+    test_real_1d(sizes[i], rng);
+
+  test_real_2d(8, 6, rng);
+  test_real_2d(15, 16, rng);
+  test_real_2d(30, 45, rng);
+  test_real_2d(72, 160, rng);
+
+  test_batched_2d(5, 3, rng);
+  test_batched_2d(12, 200, rng);
+  test_batched_2d(150, 8, rng);
+
+  vnl_fft_1d_real<float> ffloat(64);
+  vnl_vector<float> xf(64), yf;
+  for (unsigned i = 0; i < 64; ++i)
+    xf[i] = float(rng.normal());
+  vnl_vector<std::complex<float> > Xf;
+  ffloat.fwd_transform(xf, Xf);
+  ffloat.bwd_transform(Xf, yf);
+  TEST_NEAR("float round trip", (yf / 64.0f - xf).inf_norm(), 0.0f, 1e-5f);
+
+  // TIMING: forward and backward transforms of a real 480x640 image
+  const int m = 480, n = 640, ntimes = 5;
+  vnl_matrix<double> img(m, n);
+  for (int i = 0; i < m; ++i)
+    for (int j = 0; j < n; ++j)
+      img(i,j) = rng.normal();
+
+  const std::clock_t t0 = std::clock();
+  for (int t = 0; t < ntimes; ++t) {
+    vnl_matrix<std::complex<double> > z(m, n);
+    for (int i = 0; i < m; ++i)
+      for (int j = 0; j < n; ++j)
+        z(i,j) = img(i,j);
+    vnl_fft_2d<double> fft(m, n);
+    fft.fwd_transform(z);
+    fft.bwd_transform(z);
+  }
+  const std::clock_t t1 = std::clock();
+  for (int t = 0; t < ntimes; ++t) {
+    vnl_matrix<std::complex<double> > X;
+    vnl_matrix<double> y;
+    vnl_fft_2d_real<double> fft(m, n);
+    fft.fwd_transform(img, X);
+    fft.bwd_transform(X, y);
+  }
+  const std::clock_t t2 = std::clock();
+  std::cout << "480x640 forward and backward: complex "
+            << 1000.0 * (t1 - t0) / CLOCKS_PER_SEC / ntimes << " ms, real "
+            << 1000.0 * (t2 - t1) / CLOCKS_PER_SEC / ntimes << " ms\n";
+}
+
+TESTMAIN(test_fft_real);
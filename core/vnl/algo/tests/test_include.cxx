@@ -3,6 +3,8 @@
 #include <vnl/algo/vnl_adaptsimpson_integral.h>
 #include <vnl/algo/vnl_adjugate.h>
 #include <vnl/algo/vnl_amoeba.h>
+#include <vnl/algo/vnl_batch_fixed.h>
+#include <vnl/algo/vnl_batch_line_search.h>
 #include <vnl/algo/vnl_bracket_minimum.h>
 #include <vnl/algo/vnl_brent.h>
 #include <vnl/algo/vnl_brent_minimizer.h>
@@ -16,7 +18,9 @@
 #include <vnl/algo/vnl_determinant.h>
 #include <vnl/algo/vnl_discrete_diff.h>
 #include <vnl/algo/vnl_fft_1d.h>
+#include <vnl/algo/vnl_fft_1d_real.h>
 #include <vnl/algo/vnl_fft_2d.h>
+#include <vnl/algo/vnl_fft_2d_real.h>
 #include <vnl/algo/vnl_fft.h>
 #include <vnl/algo/vnl_fit_parabola.h>
 #include <vnl/algo/vnl_gaussian_kernel_1d.h>
@@ -29,16 +33,19 @@
 #include <vnl/algo/vnl_lsqr.h>
 #include <vnl/algo/vnl_matrix_inverse.h>
 #include <vnl/algo/vnl_matrix_update.h>
+#include <vnl/algo/vnl_multistart.h>
 #include <vnl/algo/vnl_netlib.h>
 #include <vnl/algo/vnl_orthogonal_complement.h>
 #include <vnl/algo/vnl_powell.h>
 #include <vnl/algo/vnl_qr.h>
+#include <vnl/algo/vnl_randomized_svd.h>
 #include <vnl/algo/vnl_real_eigensystem.h>
 #include <vnl/algo/vnl_rnpoly_solve.h>
 #include <vnl/algo/vnl_rpoly_roots.h>
 #include <vnl/algo/vnl_scatter_3x3.h>
 #include <vnl/algo/vnl_simpson_integral.h>
 #include <vnl/algo/vnl_solve_qp.h>
+#include <vnl/algo/vnl_sparse_cholesky.h>
 #include <vnl/algo/vnl_sparse_lm.h>
 #include <vnl/algo/vnl_sparse_lu.h>
 #include <vnl/algo/vnl_sparse_symmetric_eigensystem.h>
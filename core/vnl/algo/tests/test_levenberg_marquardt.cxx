@@ -46,6 +46,76 @@ struct linear_est : public vnl_least_squares_function
   vnl_vector<double> b_;
 };
 
+//: linear_est computed a few residuals at a time, counting the calls to f
+struct linear_est_blocks : public vnl_least_squares_function
+{
+  linear_est_blocks(vnl_matrix<double> const& A, vnl_vector<double> const& b, unsigned int block_size)
+  : vnl_least_squares_function(A.cols(), A.rows(), use_gradient),
+    A_(A), b_(b), num_f_(0)
+  { set_block_size(block_size); }
+
+  void f(vnl_vector<double> const& x, vnl_vector<double>& y) {
+    ++num_f_;
+    f_blocks(x, y);
+  }
+
+  void gradf(vnl_vector<double> const& x, vnl_matrix<double> &J) {
+    gradf_blocks(x, J);
+  }
+
+  void f_block(vnl_vector<double> const& x, unsigned int first, vnl_vector<double>& y) {
+    for (unsigned int i = 0; i < y.size(); ++i)
+      y[i] = dot_product(A_.get_row(first+i), x) - b_[first+i];
+  }
+
+  void gradf_block(vnl_vector<double> const& /*x*/, unsigned int first, vnl_matrix<double> &J) {
+    for (unsigned int i = 0; i < J.rows(); ++i)
+      J.set_row(i, A_.get_row(first+i));
+  }
+
+  vnl_matrix<double> A_;
+  vnl_vector<double> b_;
+  unsigned int num_f_;
+};
+
+static
+void do_block_test()
+{
+  vnl_matrix<double> A(11,3);
+  vnl_vector<double> b(11);
+  for (unsigned int i = 0; i < 11; ++i) {
+    A(i,0) = 1.0; A(i,1) = i; A(i,2) = double(i*i) / 10.0;
+    b[i] = 2.0 - 0.5*i + 0.3*i*i/10.0 + ((i%3) - 1.0)*0.01;
+  }
+  vnl_vector<double> x(3);
+  x[0] = 0.5; x[1] = -1.0; x[2] = 2.0;
+
+  linear_est_blocks f(A, b, 4); // last block is short
+  vnl_vector<double> fx(11);
+  f.f(x, fx);
+  TEST_NEAR("f_blocks", (fx - (A*x - b)).inf_norm(), 0.0, 1e-12);
+  vnl_matrix<double> J(11,3);
+  f.gradf(x, J);
+  TEST_NEAR("gradf_blocks", (J - A).array_inf_norm(), 0.0, 0.0);
+
+  vnl_levenberg_marquardt lm(f);
+  lm.minimize_using_gradient(x);
+  lm.diagnose_outcome(std::cout);
+  vnl_vector<double> residual = A*x - b;
+  TEST_NEAR("block evaluation: normal equations hold", (A.transpose()*residual).inf_norm(), 0.0, 1e-8);
+
+  // The residuals at the last accepted point are cached.
+  TEST("accepted evaluation is cached", f.cached_f(x, fx), true);
+  TEST_NEAR("cached residuals", (fx - residual).inf_norm(), 0.0, 1e-12);
+  unsigned int num_f = f.num_f_;
+  f.rms(x);
+  TEST("rms reuses the cached residuals", f.num_f_, num_f);
+  f.ffdgradf(x, J, 1e-6);
+  TEST("ffdgradf reuses the cached residuals", f.num_f_, num_f + 3);
+  f.clear_cache();
+  TEST("clear_cache", f.cached_f(x, fx), false);
+}
+
 static
 void do_rosenbrock_test(bool with_grad)
 {
@@ -131,6 +201,8 @@ void test_levenberg_marquardt()
 
   do_linear_test(true);
   do_linear_test(false);
+
+  do_block_test();
 }
 
 TESTMAIN(test_levenberg_marquardt);
@@ -0,0 +1,162 @@
+// This is core/vnl/algo/tests/test_multistart.cxx
+#include <iostream>
+#include <vector>
+#include <testlib/testlib_test.h>
+//:
+// \file
+// \brief Tests of the batched line search and vnl_multistart
+
+#include <vcl_compiler.h>
+#include <vnl/vnl_vector.h>
+#include <vnl/vnl_matrix.h>
+#include <vnl/vnl_cost_function.h>
+#include <vnl/algo/vnl_lbfgs.h>
+#include <vnl/algo/vnl_conjugate_gradient.h>
+#include <vnl/algo/vnl_batch_line_search.h>
+#include <vnl/algo/vnl_multistart.h>
+
+//: Rosenbrock's function, counting the calls of compute_batch.
+class rosenbrock_batch : public vnl_cost_function
+{
+ public:
+  rosenbrock_batch() : vnl_cost_function(2), batches(0) {}
+
+  void compute(vnl_vector<double> const& x, double* f, vnl_vector<double>* g)
+  {
+    double a = x[1] - x[0]*x[0], b = 1 - x[0];
+    if (f) *f = 100*a*a + b*b;
+    if (g) { (*g)[0] = -400*a*x[0] - 2*b; (*g)[1] = 200*a; }
+  }
+
+  void compute_batch(vnl_matrix<double> const& X, vnl_vector<double>& fx, vnl_matrix<double>* G)
+  {
+    ++batches;
+    vnl_cost_function::compute_batch(X, fx, G);
+  }
+
+  unsigned batches;
+};
+
+//: sum (x_i^2 - 1)^2 + 0.2 sum x_i, with its lowest minimum near x_i = -1.
+class double_well : public vnl_cost_function
+{
+ public:
+  double_well(unsigned n) : vnl_cost_function(n) {}
+
+  void compute(vnl_vector<double> const& x, double* f, vnl_vector<double>* g)
+  {
+    if (f) *f = 0;
+    for (unsigned i = 0; i < x.size(); ++i) {
+      double a = x[i]*x[i] - 1;
+      if (f) *f += a*a + 0.2*x[i];
+      if (g) (*g)[i] = 4*a*x[i] + 0.2;
+    }
+  }
+};
+
+static void test_compute_batch()
+{
+  rosenbrock_batch f;
+  vnl_matrix<double> X(3, 2);
+  X(0,0) = 1; X(0,1) = 1; X(1,0) = 0; X(1,1) = 0; X(2,0) = -1; X(2,1) = 2;
+  vnl_vector<double> fx;
+  vnl_matrix<double> G;
+  f.compute_batch(X, fx, &G);
+  TEST("compute_batch sizes", fx.size() == 3 && G.rows() == 3 && G.cols() == 2, true);
+  TEST_NEAR("compute_batch values", fx[0] + fx[1] + fx[2], 0 + 1 + 104, 1e-12);
+  TEST_NEAR("compute_batch gradient", G(2,0), -400*1*-1 - 2*2, 1e-12);
+
+  vnl_batch_line_search search(f, 6);
+  vnl_vector<double> x(2, 0.0), g(2);
+  double fv;
+  f.compute(x, &fv, &g);
+  vnl_vector<double> d = -g;
+  double f0 = fv;
+  double t = search.search(x, fv, g, d, 1.0);
+  TEST("line search step", t > 0, true);
+  TEST("line search decreases f", fv < f0, true);
+  TEST("line search evaluates a ladder per call", search.num_evaluations() % 6, 0u);
+  TEST("line search rejects ascent", search.search(x, fv, g, g, 1.0), 0.0);
+}
+
+static void test_batched_minimizers()
+{
+  vnl_vector<double> x0(2);
+  x0[0] = -1.2; x0[1] = 1;
+
+  rosenbrock_batch f1;
+  vnl_lbfgs lb(f1);
+  lb.line_search_batch_size = 8;
+  lb.set_g_tolerance(1e-8);
+  lb.set_max_function_evals(20000);
+  vnl_vector<double> x = x0;
+  bool ok = lb.minimize(x);
+  std::cout << "batched lbfgs: " << x << ' ' << lb.get_num_evaluations()
+            << " evaluations in " << f1.batches << " batches\n";
+  TEST("batched lbfgs converges", ok, true);
+  TEST_NEAR("batched lbfgs x0", x[0], 1.0, 1e-5);
+  TEST_NEAR("batched lbfgs x1", x[1], 1.0, 1e-5);
+  TEST("batched lbfgs uses compute_batch", f1.batches > 0, true);
+
+  rosenbrock_batch f2;
+  vnl_conjugate_gradient cg(f2);
+  cg.set_line_search_batch_size(8);
+  cg.set_g_tolerance(1e-6);
+  cg.set_max_function_evals(100000);
+  x = x0;
+  ok = cg.minimize(x);
+  std::cout << "batched cg: " << x << ' ' << cg.get_num_evaluations()
+            << " evaluations in " << f2.batches << " batches\n";
+  TEST("batched cg converges", ok, true);
+  TEST_NEAR("batched cg x0", x[0], 1.0, 1e-4);
+  TEST_NEAR("batched cg x1", x[1], 1.0, 1e-4);
+}
+
+static void test_multistart_driver()
+{
+  const unsigned n = 3, starts = 8;
+  double_well f(n);
+  vnl_matrix<double> S(starts, n);
+  for (unsigned i = 0; i < starts; ++i)
+    for (unsigned j = 0; j < n; ++j)
+      S(i,j) = ((i >> j) & 1) ? -1.5 : 1.5;
+
+  vnl_multistart ms(f);
+  ms.set_g_tolerance(1e-8);
+  vnl_vector<double> x;
+  bool ok = ms.minimize(S, x);
+  TEST("multistart succeeds", ok, true);
+  TEST("multistart results", ms.get_results().rows() == starts && ms.get_result_errors().size() == starts, true);
+  TEST("multistart picks the deepest well", ms.get_best_start(), starts - 1);
+  TEST("multistart x", x[0] < -0.9 && x[1] < -0.9 && x[2] < -0.9, true);
+  TEST_NEAR("multistart end error", ms.get_end_error(), ms.get_result_errors().min_value(), 1e-12);
+  TEST("multistart reduces", ms.obj_value_reduced(), true);
+
+  // one function object per start, with conjugate gradients and batched searches
+  std::vector<rosenbrock_batch> fs(4);
+  std::vector<vnl_cost_function*> fp;
+  for (unsigned i = 0; i < fs.size(); ++i)
+    fp.push_back(&fs[i]);
+  vnl_matrix<double> R(4, 2);
+  R(0,0) = -1.2; R(0,1) = 1; R(1,0) = 2; R(1,1) = 2; R(2,0) = 0; R(2,1) = 0; R(3,0) = -0.5; R(3,1) = 3;
+  vnl_multistart ms2(fp, vnl_multistart::conjugate_gradient);
+  ms2.line_search_batch_size = 4;
+  ms2.set_g_tolerance(1e-6);
+  ms2.set_max_function_evals(100000);
+  ok = ms2.minimize(R, x);
+  TEST("multistart cg succeeds", ok, true);
+  TEST_NEAR("multistart cg x", (x - vnl_vector<double>(2, 1.0)).inf_norm(), 0.0, 1e-4);
+  bool all_used = true;
+  for (unsigned i = 0; i < fs.size(); ++i)
+    all_used = all_used && fs[i].batches > 0;
+  TEST("each start used its own function", all_used, true);
+}
+
+static void test_multistart()
+{
+  test_compute_batch();
+  test_batched_minimizers();
+  test_multistart_driver();
+}
+
+TESTMAIN(test_multistart);
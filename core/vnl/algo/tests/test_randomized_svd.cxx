@@ -0,0 +1,158 @@
+// This is core/vnl/algo/tests/test_randomized_svd.cxx
+#include <iostream>
+#include <algorithm>
+#include <testlib/testlib_test.h>
+#include <vcl_compiler.h>
+#include <vnl/vnl_matrix.h>
+#include <vnl/vnl_vector.h>
+#include <vnl/vnl_diag_matrix.h>
+#include <vnl/vnl_random.h>
+#include <vnl/algo/vnl_randomized_svd.h>
+#include <vnl/algo/vnl_svd.h>
+#include <vnl/algo/vnl_qr.h>
+
+//: Delivers the rows of a matrix a few at a time.
+class test_block_source : public vnl_randomized_svd::row_source
+{
+ public:
+  test_block_source(vnl_matrix<double> const& A, unsigned int block)
+    : A_(A), block_(block), next_(0), passes_(0) {}
+  unsigned int rows() const { return A_.rows(); }
+  unsigned int cols() const { return A_.cols(); }
+  void reset() { next_ = 0; ++passes_; }
+  vnl_matrix<double> const* next_block()
+  {
+    if (next_ >= A_.rows())
+      return VXL_NULLPTR;
+    unsigned int r = std::min(block_, A_.rows() - next_);
+    B_ = A_.extract(r, A_.cols(), next_, 0);
+    next_ += r;
+    return &B_;
+  }
+  unsigned int passes() const { return passes_; }
+
+ private:
+  vnl_matrix<double> const& A_;
+  vnl_matrix<double> B_;
+  unsigned int block_, next_, passes_;
+};
+
+//: Random m x n matrix with the given leading singular values plus noise
+static vnl_matrix<double> low_rank(unsigned int m, unsigned int n,
+                                   vnl_vector<double> const& s, double noise,
+                                   vnl_random& rng)
+{
+  vnl_matrix<double> X(m, s.size()), Y(n, s.size());
+  for (unsigned int i = 0; i < m; ++i)
+    for (unsigned int j = 0; j < s.size(); ++j)
+      X(i,j) = rng.normal();
+  for (unsigned int i = 0; i < n; ++i)
+    for (unsigned int j = 0; j < s.size(); ++j)
+      Y(i,j) = rng.normal();
+  vnl_matrix<double> U = vnl_qr<double>(X).Q().extract(m, s.size());
+  vnl_matrix<double> V = vnl_qr<double>(Y).Q().extract(n, s.size());
+  for (unsigned int i = 0; i < m; ++i)
+    for (unsigned int j = 0; j < s.size(); ++j)
+      U(i,j) *= s[j];
+  vnl_matrix<double> A = U * V.transpose();
+  for (unsigned int i = 0; i < m; ++i)
+    for (unsigned int j = 0; j < n; ++j)
+      A(i,j) += noise * rng.normal();
+  return A;
+}
+
+//: Largest angle-like difference between the column spaces of V1 and V2
+static double subspace_distance(vnl_matrix<double> const& V1, vnl_matrix<double> const& V2)
+{
+  vnl_matrix<double> R = V2 - V1 * (V1.transpose() * V2);
+  return R.frobenius_norm();
+}
+
+static void test_randomized_svd()
+{
+  vnl_random rng(1234);
+  const unsigned int m = 300, n = 80, k = 5;
+  double sv[] = { 100.0, 50.0, 20.0, 10.0, 5.0 };
+  vnl_matrix<double> A = low_rank(m, n, vnl_vector<double>(sv, k), 1e-3, rng);
+  vnl_svd<double> full(A);
+  vnl_matrix<double> Vk = full.V().extract(n, k);
+
+  vnl_randomized_svd rsvd(k);
+  rsvd.compute(A);
+  TEST("rank", rsvd.rank(), k);
+  double werr = 0.0;
+  for (unsigned int i = 0; i < k; ++i)
+    werr = std::max(werr, std::abs(rsvd.W()[i] - full.W(i)) / full.W(i));
+  TEST_NEAR("range finder: singular values", werr, 0.0, 1e-8);
+  TEST_NEAR("range finder: right singular vectors", subspace_distance(Vk, rsvd.V()), 0.0, 1e-6);
+  TEST_NEAR("range finder: U is orthonormal",
+            (rsvd.U().transpose() * rsvd.U() - vnl_matrix<double>(k, k).set_identity()).absolute_value_max(),
+            0.0, 1e-10);
+
+  // The error estimate bounds the residual, which is about the noise level.
+  double resid = vnl_svd<double>(A - rsvd.recompose()).W(0);
+  std::cout << "residual norm " << resid << ", estimate " << rsvd.error_estimate() << '\n';
+  TEST("error estimate bounds the residual", rsvd.error_estimate() >= resid, true);
+  TEST("error estimate is not too pessimistic", rsvd.error_estimate() < 100.0 * resid, true);
+  TEST_NEAR("recompose", (A - rsvd.recompose()).absolute_value_max(), 0.0, 1e-2);
+
+  vnl_randomized_svd lanczos(k);
+  lanczos.set_method(vnl_randomized_svd::lanczos);
+  lanczos.compute(A);
+  werr = 0.0;
+  for (unsigned int i = 0; i < k; ++i)
+    werr = std::max(werr, std::abs(lanczos.W()[i] - full.W(i)) / full.W(i));
+  TEST_NEAR("lanczos: singular values", werr, 0.0, 1e-8);
+  TEST_NEAR("lanczos: right singular vectors", subspace_distance(Vk, lanczos.V()), 0.0, 1e-6);
+
+  // Streaming the rows in blocks gives the same answer as the dense matrix.
+  test_block_source source(A, 37);
+  vnl_randomized_svd streamed(k);
+  streamed.compute(source);
+  TEST("streamed: U not formed", streamed.U().empty(), true);
+  TEST_NEAR("streamed: singular values", (streamed.W() - rsvd.W()).inf_norm(), 0.0, 1e-8);
+  TEST_NEAR("streamed: right singular vectors", subspace_distance(rsvd.V(), streamed.V()), 0.0, 1e-8);
+  std::cout << "passes over the data: " << source.passes() << '\n';
+  TEST("streamed: passes", source.passes(), 3 + 2); // power iterations + 1, Rayleigh-Ritz, error
+  TEST_NEAR("streamed: error estimate", streamed.error_estimate(), rsvd.error_estimate(), 1e-8);
+
+  // PCA: with an offset added to every row, subtracting the mean recovers
+  // the same components.
+  vnl_vector<double> offset(n);
+  for (unsigned int j = 0; j < n; ++j)
+    offset[j] = 1000.0 + j;
+  vnl_matrix<double> Ac = A;
+  for (unsigned int j = 0; j < n; ++j)
+    Ac.set_column(j, A.get_column(j) - A.get_column(j).mean());
+  vnl_matrix<double> B = Ac;
+  for (unsigned int i = 0; i < m; ++i)
+    B.set_row(i, Ac.get_row(i) + offset);
+  vnl_svd<double> centred(Ac);
+  vnl_randomized_svd pca(k);
+  pca.set_subtract_mean(true);
+  pca.compute(B);
+  TEST_NEAR("pca: mean", (pca.mean() - offset).inf_norm(), 0.0, 1e-9);
+  werr = 0.0;
+  for (unsigned int i = 0; i < k; ++i)
+    werr = std::max(werr, std::abs(pca.W()[i] - centred.W(i)) / centred.W(i));
+  TEST_NEAR("pca: singular values", werr, 0.0, 1e-8);
+  TEST_NEAR("pca: components", subspace_distance(centred.V().extract(n, k), pca.V()), 0.0, 1e-6);
+  TEST_NEAR("pca: project", (pca.project(B) - pca.U() * vnl_diag_matrix<double>(pca.W())).absolute_value_max(),
+            0.0, 1e-8);
+  TEST_NEAR("pca: recompose", (B - pca.recompose()).absolute_value_max(), 0.0, 1e-2);
+
+  test_block_source bsource(B, 64);
+  vnl_randomized_svd spca(k);
+  spca.set_subtract_mean(true);
+  spca.compute(bsource);
+  TEST_NEAR("streamed pca: singular values", (spca.W() - pca.W()).inf_norm(), 0.0, 1e-8);
+
+  // Asking for more than the matrix has
+  vnl_matrix<double> S = A.extract(6, 4);
+  vnl_randomized_svd small(10);
+  small.compute(S);
+  TEST("rank limited by size", small.rank(), 4);
+  TEST_NEAR("small: exact", (S - small.recompose()).absolute_value_max(), 0.0, 1e-10);
+}
+
+TESTMAIN(test_randomized_svd);
@@ -0,0 +1,94 @@
+// This is core/vnl/algo/tests/test_sparse_cholesky.cxx
+#include <iostream>
+#include <testlib/testlib_test.h>
+#include <vcl_compiler.h>
+#include <vnl/vnl_sparse_matrix.h>
+#include <vnl/vnl_matrix.h>
+#include <vnl/vnl_vector.h>
+#include <vnl/algo/vnl_sparse_cholesky.h>
+#include <vnl/algo/vnl_cholesky.h>
+
+//: 5-point Laplacian on an n x n grid, plus shift on the diagonal.
+// Only the lower triangle is stored when lower_only is set.
+static vnl_sparse_matrix<double> laplacian(unsigned n, double shift, bool lower_only)
+{
+  vnl_sparse_matrix<double> A(n*n, n*n);
+  for (unsigned i = 0; i < n; ++i)
+    for (unsigned j = 0; j < n; ++j) {
+      unsigned r = i*n+j;
+      A(r, r) = 4.0 + shift;
+      if (j > 0)   A(r, r-1) = -1.0;
+      if (i > 0)   A(r, r-n) = -1.0;
+      if (lower_only) continue;
+      if (j+1 < n) A(r, r+1) = -1.0;
+      if (i+1 < n) A(r, r+n) = -1.0;
+    }
+  return A;
+}
+
+static vnl_matrix<double> dense(vnl_sparse_matrix<double>& A)
+{
+  vnl_matrix<double> D(A.rows(), A.cols(), 0.0);
+  for (A.reset(); A.next(); )
+    D(A.getrow(), A.getcolumn()) = A.value();
+  return D;
+}
+
+static void test_sparse_cholesky()
+{
+  const unsigned n = 12;
+  vnl_sparse_matrix<double> A = laplacian(n, 0.5, false);
+  vnl_matrix<double> Ad = dense(A);
+  vnl_vector<double> b(n*n);
+  for (unsigned i = 0; i < b.size(); ++i)
+    b[i] = double(int(i*7 % 11) - 5);
+
+  vnl_sparse_cholesky chol(A);
+  TEST("factored", chol.factored(), true);
+  TEST("positive definite", chol.positive_definite(), true);
+  vnl_vector<double> x = chol.solve(b);
+  TEST_NEAR("residual", (Ad*x - b).inf_norm(), 0.0, 1e-10);
+
+  vnl_cholesky dchol(Ad);
+  TEST_NEAR("solution matches dense Cholesky", (x - dchol.solve(b)).inf_norm(), 0.0, 1e-10);
+  TEST_NEAR("determinant matches dense Cholesky",
+            chol.determinant() / dchol.determinant(), 1.0, 1e-10);
+
+  vnl_sparse_cholesky natural(A, vnl_sparse_cholesky::natural);
+  std::cout << "non-zeros in L: natural " << natural.num_non_zero_L()
+            << ", minimum degree " << chol.num_non_zero_L() << '\n';
+  TEST("minimum degree reduces fill", chol.num_non_zero_L() < natural.num_non_zero_L(), true);
+  TEST_NEAR("natural ordering residual", (Ad*natural.solve(b) - b).inf_norm(), 0.0, 1e-10);
+
+  // Lower triangle only gives the same factorisation.
+  vnl_sparse_cholesky lower(laplacian(n, 0.5, true));
+  TEST_NEAR("lower triangle input", (lower.solve(b) - x).inf_norm(), 0.0, 1e-12);
+
+  // Refactor with new values: the ordering is kept.
+  std::vector<int> perm = chol.permutation();
+  vnl_sparse_matrix<double> A2 = laplacian(n, 2.0, false);
+  TEST("refactor", chol.factor(A2), true);
+  TEST("refactor keeps the ordering", chol.permutation() == perm, true);
+  TEST_NEAR("refactor residual", (dense(A2)*chol.solve(b) - b).inf_norm(), 0.0, 1e-10);
+
+  // Multiple right hand sides.
+  vnl_matrix<double> B(n*n, 3);
+  for (unsigned i = 0; i < B.rows(); ++i)
+    for (unsigned j = 0; j < 3; ++j)
+      B(i, j) = double(int((i+j)*5 % 13) - 6);
+  vnl_matrix<double> X = chol.solve(B);
+  TEST_NEAR("multiple right hand sides", (dense(A2)*X - B).absolute_value_max(), 0.0, 1e-10);
+
+  // Indefinite and singular matrices.
+  vnl_sparse_matrix<double> S(3, 3);
+  S(0,0) = 1.0; S(1,0) = 2.0; S(1,1) = 1.0; S(2,2) = 3.0;
+  vnl_sparse_cholesky ind(S, vnl_sparse_cholesky::natural);
+  TEST("indefinite: factored", ind.factored(), true);
+  TEST("indefinite: not positive definite", ind.positive_definite(), false);
+  S(1,1) = 4.0;
+  TEST("singular: zero pivot", ind.factor(S), false);
+  TEST("singular: failed column", ind.failed_column(), 1);
+  TEST("singular: not factored", ind.factored(), false);
+}
+
+TESTMAIN(test_sparse_cholesky);
@@ -278,6 +278,29 @@ void test_prob1()
      TEST("convergence with missing projections",rms_error_a + rms_error_b < 1e-10, true);
    }
 
+   // same problem, solving the reduced camera system by conjugate gradients
+   {
+     vnl_vector<double> pa(12,0.0), pb(50,0.0), pc;
+     pa[2]=pa[5]=pa[8]=pa[11]=10;
+     pa[4]=5;
+     pa[7]=-5;
+     pa[10]=-2;
+
+     bundle_2d my_func(4,25,proj2,mask,vnl_sparse_lst_sqr_function::use_gradient);
+
+     vnl_sparse_lm slm(my_func);
+     slm.set_use_pcg(true);
+     slm.minimize(pa,pb,pc);
+     slm.diagnose_outcome();
+     normalize(pa,pb);
+
+     double rms_error_a = camera_diff(a,pa).rms();
+     double rms_error_b = (b-pb).rms();
+     std::cout << "RMS camera error: "<<rms_error_a
+              << "\nRMS points error: "<<rms_error_b << std::endl;
+     TEST("PCG: convergence with missing projections",rms_error_a + rms_error_b < 1e-10, true);
+   }
+
    vnl_random rnd;
 
    // add uniform random noise to each measurement
@@ -509,6 +532,32 @@ void test_prob2()
           rms_error_a + rms_error_b + rms_error_c < 1e-10, true);
    }
 
+   // same problem, solving the reduced camera system by conjugate gradients
+   {
+     vnl_vector<double> pa(12,0.0), pb(50,0.0), pc(1,1.0);
+     pa[2]=pa[5]=pa[8]=pa[11]=10;
+     pa[4]=5;
+     pa[7]=-5;
+     pa[10]=-2;
+
+     bundle_2d_shared my_func(4,25,proj2,mask,vnl_sparse_lst_sqr_function::use_gradient);
+
+     vnl_sparse_lm slm(my_func);
+     slm.set_use_pcg(true);
+     slm.minimize(pa,pb,pc);
+     slm.diagnose_outcome();
+     normalize(pa,pb);
+
+     double rms_error_a = camera_diff(a,pa).rms();
+     double rms_error_b = (b-pb).rms();
+     double rms_error_c = (c-pc).rms();
+     std::cout << "RMS camera error: "<<rms_error_a
+              << "\nRMS points error: "<<rms_error_b
+              << "\nRMS globals error: "<<rms_error_c << std::endl;
+     TEST("w/ globals, PCG: convergence with missing projections",
+          rms_error_a + rms_error_b + rms_error_c < 1e-10, true);
+   }
+
    vnl_random rnd;
 
    // add uniform random noise to each measurement
@@ -3,7 +3,9 @@
 #include <vnl/algo/vnl_convolve.hxx>
 #include <vnl/algo/vnl_determinant.hxx>
 #include <vnl/algo/vnl_fft_1d.hxx>
+#include <vnl/algo/vnl_fft_1d_real.hxx>
 #include <vnl/algo/vnl_fft_2d.hxx>
+#include <vnl/algo/vnl_fft_2d_real.hxx>
 #include <vnl/algo/vnl_fft_base.hxx>
 #include <vnl/algo/vnl_fft_prime_factors.hxx>
 #include <vnl/algo/vnl_matrix_inverse.hxx>
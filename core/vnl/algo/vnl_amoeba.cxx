@@ -12,6 +12,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include "vnl_amoeba.h"
 
 #include <vcl_compiler.h>
@@ -89,16 +90,17 @@ int vnl_amoeba_SimplexCorner::compare(vnl_amoeba_SimplexCorner const& s1,
 }
 
 static
-int compare_aux(const void * s1, const void * s2)
+bool compare_aux(vnl_amoeba_SimplexCorner const& s1, vnl_amoeba_SimplexCorner const& s2)
 {
-  return vnl_amoeba_SimplexCorner::compare(*(const vnl_amoeba_SimplexCorner*)s1,
-                                           *(const vnl_amoeba_SimplexCorner*)s2);
+  return vnl_amoeba_SimplexCorner::compare(s1, s2) < 0;
 }
 
+// The corners are not moved bytewise (as by qsort) since a vnl_vector may
+// point into its own inline storage.
 static
 void sort_simplex(std::vector<vnl_amoeba_SimplexCorner>& simplex)
 {
-  std::qsort(&simplex[0], simplex.size(), sizeof simplex[0], compare_aux);
+  std::stable_sort(simplex.begin(), simplex.end(), compare_aux);
 }
 
 static
@@ -0,0 +1,120 @@
+// This is core/vnl/algo/vnl_batch_fixed.h
+#ifndef vnl_batch_fixed_h_
+#define vnl_batch_fixed_h_
+//:
+// \file
+// \brief Inverse, symmetric eigensystem and SVD of many 3x3 or 4x4 matrices at once
+//
+//    Code that fits a plane or a normal to every point of a cloud, or
+//    analyses a structure tensor at every pixel, decomposes millions of tiny
+//    matrices.  Calling vnl_inverse, vnl_symmetric_eigensystem_compute or
+//    vnl_svd_fixed once per matrix is dominated by per-call overhead, and
+//    the arithmetic of a single 3x3 matrix is too small to vectorise.
+//
+//    The functions here take a batch of n matrices in "structure of arrays"
+//    layout instead: element (r,c) of matrix k is held at
+//    \code
+//      A[(r*C + c)*n + k]
+//    \endcode
+//    so that each element forms a contiguous plane of n values.  The work is
+//    done a block of instances at a time with straight-line, branch-free
+//    arithmetic across the instances, which the compiler vectorises.
+//    vnl_batch_pack() and vnl_batch_unpack() convert to and from arrays of
+//    vnl_matrix_fixed.
+//
+//    The 3x3 symmetric eigensystem is found in closed form by Eberly's
+//    method: the best separated eigenvalue comes from the trigonometric
+//    solution of the characteristic cubic and its eigenvector from a cross
+//    product, and the other two eigenpairs from the 2x2 problem in the
+//    orthogonal complement.  Unlike taking all three roots of the cubic,
+//    this stays accurate for close and repeated eigenvalues.  The 4x4
+//    eigensystem uses cyclic Jacobi and the SVDs one-sided Jacobi, sweeping
+//    until every matrix of a block has converged.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vnl/vnl_matrix_fixed.h>
+#include <vnl/vnl_vector_fixed.h>
+#include <vcl_compiler.h>
+
+//: Copy n matrices into the planes of A (see vnl_batch_fixed.h).
+template <class T, unsigned int R, unsigned int C>
+inline void vnl_batch_pack(unsigned int n, vnl_matrix_fixed<T,R,C> const* M, T* A)
+{
+  for (unsigned int k = 0; k < n; ++k)
+    for (unsigned int i = 0; i < R*C; ++i)
+      A[i*n + k] = M[k].data_block()[i];
+}
+
+//: Copy the planes of A (see vnl_batch_fixed.h) into n matrices.
+template <class T, unsigned int R, unsigned int C>
+inline void vnl_batch_unpack(unsigned int n, T const* A, vnl_matrix_fixed<T,R,C>* M)
+{
+  for (unsigned int k = 0; k < n; ++k)
+    for (unsigned int i = 0; i < R*C; ++i)
+      M[k].data_block()[i] = A[i*n + k];
+}
+
+//: Copy n vectors into the planes of A.
+template <class T, unsigned int N>
+inline void vnl_batch_pack(unsigned int n, vnl_vector_fixed<T,N> const* v, T* A)
+{
+  for (unsigned int k = 0; k < n; ++k)
+    for (unsigned int i = 0; i < N; ++i)
+      A[i*n + k] = v[k][i];
+}
+
+//: Copy the planes of A into n vectors.
+template <class T, unsigned int N>
+inline void vnl_batch_unpack(unsigned int n, T const* A, vnl_vector_fixed<T,N>* v)
+{
+  for (unsigned int k = 0; k < n; ++k)
+    for (unsigned int i = 0; i < N; ++i)
+      v[k][i] = A[i*n + k];
+}
+
+//: Invert n 3x3 matrices.
+//  A and Ainv hold 9 planes.  A singular matrix gives a zero inverse and,
+//  unlike vnl_inverse, no assertion.  If det is not null it receives the n
+//  determinants.
+template <class T>
+void vnl_batch_inverse_3x3(unsigned int n, T const* A, T* Ainv, T* det = VXL_NULLPTR);
+
+//: Invert n 4x4 matrices.
+//  A and Ainv hold 16 planes; otherwise as vnl_batch_inverse_3x3.
+template <class T>
+void vnl_batch_inverse_4x4(unsigned int n, T const* A, T* Ainv, T* det = VXL_NULLPTR);
+
+//: Eigensystems of n symmetric 3x3 matrices, in closed form.
+//  A holds 9 planes, of which only the upper triangle is read.  D receives
+//  3 planes of eigenvalues in increasing order, as from
+//  vnl_symmetric_eigensystem_compute, and V, unless null, 9 planes of
+//  eigenvectors, one per column.
+template <class T>
+void vnl_batch_symmetric_eigensystem_3x3(unsigned int n, T const* A, T* D, T* V = VXL_NULLPTR);
+
+//: Eigensystems of n symmetric 4x4 matrices by Jacobi rotations.
+//  A holds 16 planes (upper triangle read), D receives 4 planes of
+//  eigenvalues in increasing order and V, unless null, 16 planes of
+//  eigenvectors, one per column.
+template <class T>
+void vnl_batch_symmetric_eigensystem_4x4(unsigned int n, T const* A, T* D, T* V = VXL_NULLPTR);
+
+//: SVDs A = U diag(W) V' of n 3x3 matrices.
+//  A, U and V hold 9 planes, W 3 planes of singular values in decreasing
+//  order, as from vnl_svd_fixed.  U and V are orthogonal even when A is
+//  rank deficient.  U may be null if only W and V are wanted.
+template <class T>
+void vnl_batch_svd_3x3(unsigned int n, T const* A, T* U, T* W, T* V);
+
+//: SVDs A = U diag(W) V' of n 4x4 matrices.
+//  As vnl_batch_svd_3x3, with 16 planes for A, U and V and 4 for W.
+template <class T>
+void vnl_batch_svd_4x4(unsigned int n, T const* A, T* U, T* W, T* V);
+
+#define VNL_BATCH_FIXED_INSTANTIATE(T) \
+extern "please include vnl/algo/vnl_batch_fixed.hxx first"
+
+#endif // vnl_batch_fixed_h_
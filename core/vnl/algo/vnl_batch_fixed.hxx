@@ -0,0 +1,530 @@
+// This is core/vnl/algo/vnl_batch_fixed.hxx
+#ifndef vnl_batch_fixed_hxx_
+#define vnl_batch_fixed_hxx_
+//:
+// \file
+//
+// Each function works on blocks of vnl_batch_fixed_block instances, held in
+// small local planes.  The loops over the instances of a block contain no
+// branches other than selections (?:), so that they compile to SIMD code;
+// the few genuinely per-instance decisions (the arc cosine of the cubic,
+// repairing U for a rank-deficient matrix) are kept in separate scalar
+// loops.
+//
+//-----------------------------------------------------------------------------
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "vnl_batch_fixed.h"
+#include <vcl_compiler.h>
+#include <vnl/vnl_math.h>
+
+//: Number of instances held in local planes at a time
+const unsigned int vnl_batch_fixed_block = 64;
+
+//: Maximum number of Jacobi sweeps
+const unsigned int vnl_batch_fixed_max_sweeps = 16;
+
+//: Set x = sign(x)/(|x| + sqrt(1 + x^2)), the smaller root of t^2 + 2 x t - 1 = 0.
+template <class T>
+inline T vnl_batch_fixed_jacobi_tangent(T x)
+{
+  const T t = T(1) / (std::abs(x) + std::sqrt(T(1) + x*x));
+  return x >= T(0) ? t : -t;
+}
+
+//: Apply the plane rotation (c,s) to columns p and q of the N x N planes X.
+template <class T, unsigned int N>
+inline void vnl_batch_fixed_rotate_columns(T (*X)[vnl_batch_fixed_block], unsigned int p, unsigned int q,
+                                           T const* c, T const* s, unsigned int b)
+{
+  for (unsigned int r = 0; r < N; ++r)
+  {
+    T* xp = X[r*N+p];
+    T* xq = X[r*N+q];
+    for (unsigned int k = 0; k < b; ++k)
+    {
+      const T g = xp[k], h = xq[k];
+      xp[k] = c[k]*g - s[k]*h;
+      xq[k] = s[k]*g + c[k]*h;
+    }
+  }
+}
+
+//: Sort the keys d, and with them the columns of the N x N planes X and Y (if not null).
+template <class T, unsigned int N>
+inline void vnl_batch_fixed_sort(T (*d)[vnl_batch_fixed_block], T (*X)[vnl_batch_fixed_block],
+                                 T (*Y)[vnl_batch_fixed_block], bool increasing, unsigned int b)
+{
+  // odd-even transposition sort, which is a sorting network for any N
+  for (unsigned int pass = 0; pass < N; ++pass)
+    for (unsigned int i = pass % 2; i+1 < N; i += 2)
+    {
+      const unsigned int j = i+1;
+      bool swap[vnl_batch_fixed_block];
+      for (unsigned int k = 0; k < b; ++k)
+        swap[k] = increasing ? d[j][k] < d[i][k] : d[i][k] < d[j][k];
+      for (unsigned int k = 0; k < b; ++k)
+      {
+        const T di = d[i][k], dj = d[j][k];
+        d[i][k] = swap[k] ? dj : di;
+        d[j][k] = swap[k] ? di : dj;
+      }
+      for (unsigned int r = 0; r < N; ++r)
+        for (unsigned int k = 0; k < b; ++k)
+        {
+          const T xi = X[r*N+i][k], xj = X[r*N+j][k];
+          X[r*N+i][k] = swap[k] ? xj : xi;
+          X[r*N+j][k] = swap[k] ? xi : xj;
+        }
+      if (Y)
+        for (unsigned int r = 0; r < N; ++r)
+          for (unsigned int k = 0; k < b; ++k)
+          {
+            const T yi = Y[r*N+i][k], yj = Y[r*N+j][k];
+            Y[r*N+i][k] = swap[k] ? yj : yi;
+            Y[r*N+j][k] = swap[k] ? yi : yj;
+          }
+    }
+}
+
+//: Cyclic Jacobi eigensystem of n symmetric N x N matrices.
+template <class T, unsigned int N>
+void vnl_batch_fixed_jacobi_eigensystem(unsigned int n, T const* A, T* D, T* V)
+{
+  const T eps2 = vnl_math::sqr(std::numeric_limits<T>::epsilon());
+  T a[N*N][vnl_batch_fixed_block], v[N*N][vnl_batch_fixed_block], d[N][vnl_batch_fixed_block];
+  T c[vnl_batch_fixed_block], s[vnl_batch_fixed_block];
+  for (unsigned int k0 = 0; k0 < n; k0 += vnl_batch_fixed_block)
+  {
+    const unsigned int b = std::min(vnl_batch_fixed_block, n - k0);
+    for (unsigned int i = 0; i < N; ++i)
+      for (unsigned int j = i; j < N; ++j)
+        for (unsigned int k = 0; k < b; ++k)
+          a[i*N+j][k] = a[j*N+i][k] = A[(i*N+j)*n + k0+k];
+    for (unsigned int i = 0; i < N*N; ++i)
+      for (unsigned int k = 0; k < b; ++k)
+        v[i][k] = (i % (N+1) == 0) ? T(1) : T(0);
+
+    for (unsigned int sweep = 0; sweep < vnl_batch_fixed_max_sweeps; ++sweep)
+    {
+      // stop when every matrix of the block is diagonal to working precision
+      bool converged = true;
+      for (unsigned int k = 0; k < b; ++k)
+      {
+        T off = 0, diag = 0;
+        for (unsigned int i = 0; i < N; ++i)
+        {
+          diag += a[i*N+i][k]*a[i*N+i][k];
+          for (unsigned int j = i+1; j < N; ++j)
+            off += a[i*N+j][k]*a[i*N+j][k];
+        }
+        converged = converged && off <= eps2 * diag;
+      }
+      if (converged)
+        break;
+
+      for (unsigned int p = 0; p+1 < N; ++p)
+        for (unsigned int q = p+1; q < N; ++q)
+        {
+          T* apq = a[p*N+q];
+          T* app = a[p*N+p];
+          T* aqq = a[q*N+q];
+          for (unsigned int k = 0; k < b; ++k)
+          {
+            const bool nz = apq[k] != T(0);
+            const T theta = (aqq[k] - app[k]) / (nz ? 2*apq[k] : T(1));
+            const T t = nz ? vnl_batch_fixed_jacobi_tangent(theta) : T(0);
+            c[k] = T(1) / std::sqrt(T(1) + t*t);
+            s[k] = t * c[k];
+          }
+          // A <- J' A J
+          vnl_batch_fixed_rotate_columns<T,N>(a, p, q, c, s, b);
+          for (unsigned int j = 0; j < N; ++j)
+          {
+            T* ap = a[p*N+j];
+            T* aq = a[q*N+j];
+            for (unsigned int k = 0; k < b; ++k)
+            {
+              const T g = ap[k], h = aq[k];
+              ap[k] = c[k]*g - s[k]*h;
+              aq[k] = s[k]*g + c[k]*h;
+            }
+          }
+          if (V)
+            vnl_batch_fixed_rotate_columns<T,N>(v, p, q, c, s, b);
+        }
+    }
+
+    for (unsigned int i = 0; i < N; ++i)
+      for (unsigned int k = 0; k < b; ++k)
+        d[i][k] = a[i*N+i][k];
+    vnl_batch_fixed_sort<T,N>(d, v, VXL_NULLPTR, true, b);
+    for (unsigned int i = 0; i < N; ++i)
+      for (unsigned int k = 0; k < b; ++k)
+        D[i*n + k0+k] = d[i][k];
+    if (V)
+      for (unsigned int i = 0; i < N*N; ++i)
+        for (unsigned int k = 0; k < b; ++k)
+          V[i*n + k0+k] = v[i][k];
+  }
+}
+
+//: One-sided Jacobi SVD of n N x N matrices.
+template <class T, unsigned int N>
+void vnl_batch_fixed_jacobi_svd(unsigned int n, T const* A, T* U, T* W, T* V)
+{
+  const T eps = std::numeric_limits<T>::epsilon();
+  T a[N*N][vnl_batch_fixed_block], v[N*N][vnl_batch_fixed_block], w[N][vnl_batch_fixed_block];
+  T c[vnl_batch_fixed_block], s[vnl_batch_fixed_block], g[vnl_batch_fixed_block];
+  for (unsigned int k0 = 0; k0 < n; k0 += vnl_batch_fixed_block)
+  {
+    const unsigned int b = std::min(vnl_batch_fixed_block, n - k0);
+    for (unsigned int i = 0; i < N*N; ++i)
+      for (unsigned int k = 0; k < b; ++k)
+      {
+        a[i][k] = A[i*n + k0+k];
+        v[i][k] = (i % (N+1) == 0) ? T(1) : T(0);
+      }
+
+    // Rotate pairs of columns of A until they are all orthogonal; then
+    // A V = U diag(W) with the column norms as W.
+    for (unsigned int sweep = 0; sweep < vnl_batch_fixed_max_sweeps; ++sweep)
+    {
+      bool converged = true;
+      for (unsigned int p = 0; p+1 < N; ++p)
+        for (unsigned int q = p+1; q < N; ++q)
+        {
+          T alpha[vnl_batch_fixed_block], beta[vnl_batch_fixed_block];
+          for (unsigned int k = 0; k < b; ++k)
+            alpha[k] = beta[k] = g[k] = T(0);
+          for (unsigned int r = 0; r < N; ++r)
+            for (unsigned int k = 0; k < b; ++k)
+            {
+              const T ap = a[r*N+p][k], aq = a[r*N+q][k];
+              alpha[k] += ap*ap;
+              beta[k] += aq*aq;
+              g[k] += ap*aq;
+            }
+          for (unsigned int k = 0; k < b; ++k)
+          {
+            converged = converged && g[k]*g[k] <= eps*eps * alpha[k]*beta[k];
+            const bool nz = g[k] != T(0);
+            const T zeta = (beta[k] - alpha[k]) / (nz ? 2*g[k] : T(1));
+            const T t = nz ? vnl_batch_fixed_jacobi_tangent(zeta) : T(0);
+            c[k] = T(1) / std::sqrt(T(1) + t*t);
+            s[k] = t * c[k];
+          }
+          vnl_batch_fixed_rotate_columns<T,N>(a, p, q, c, s, b);
+          vnl_batch_fixed_rotate_columns<T,N>(v, p, q, c, s, b);
+        }
+      if (converged)
+        break;
+    }
+
+    for (unsigned int j = 0; j < N; ++j)
+    {
+      for (unsigned int k = 0; k < b; ++k)
+        w[j][k] = T(0);
+      for (unsigned int r = 0; r < N; ++r)
+        for (unsigned int k = 0; k < b; ++k)
+          w[j][k] += a[r*N+j][k]*a[r*N+j][k];
+      for (unsigned int k = 0; k < b; ++k)
+        w[j][k] = std::sqrt(w[j][k]);
+    }
+    vnl_batch_fixed_sort<T,N>(w, a, v, false, b);
+
+    for (unsigned int i = 0; i < N; ++i)
+      for (unsigned int k = 0; k < b; ++k)
+        W[i*n + k0+k] = w[i][k];
+    for (unsigned int i = 0; i < N*N; ++i)
+      for (unsigned int k = 0; k < b; ++k)
+        V[i*n + k0+k] = v[i][k];
+    if (!U)
+      continue;
+
+    // U = A V diag(W)^-1, where W is not negligible
+    const T tol = T(N) * eps;
+    for (unsigned int j = 0; j < N; ++j)
+      for (unsigned int k = 0; k < b; ++k)
+      {
+        const T wj = w[j][k] > tol * w[0][k] ? T(1) / w[j][k] : T(0);
+        for (unsigned int r = 0; r < N; ++r)
+          a[r*N+j][k] *= wj;
+      }
+    // Complete U to an orthogonal matrix for a rank-deficient A: each
+    // missing column is the unit vector, orthogonalised against the
+    // columns before it, with the largest remainder.
+    for (unsigned int k = 0; k < b; ++k)
+    {
+      if (w[N-1][k] > tol * w[0][k])
+        continue;
+      for (unsigned int j = 0; j < N; ++j)
+      {
+        if (w[j][k] > tol * w[0][k])
+          continue;
+        T best[N], best_norm = T(-1);
+        for (unsigned int e = 0; e < N; ++e)
+        {
+          T x[N];
+          for (unsigned int r = 0; r < N; ++r)
+            x[r] = r == e ? T(1) : T(0);
+          for (int pass = 0; pass < 2; ++pass)
+            for (unsigned int i = 0; i < j; ++i)
+            {
+              T dot = T(0);
+              for (unsigned int r = 0; r < N; ++r)
+                dot += a[r*N+i][k]*x[r];
+              for (unsigned int r = 0; r < N; ++r)
+                x[r] -= dot*a[r*N+i][k];
+            }
+          T norm = T(0);
+          for (unsigned int r = 0; r < N; ++r)
+            norm += x[r]*x[r];
+          if (norm > best_norm)
+          {
+            best_norm = norm;
+            std::copy(x, x+N, best);
+          }
+        }
+        const T scale = T(1) / std::sqrt(best_norm);
+        for (unsigned int r = 0; r < N; ++r)
+          a[r*N+j][k] = best[r]*scale;
+      }
+    }
+    for (unsigned int i = 0; i < N*N; ++i)
+      for (unsigned int k = 0; k < b; ++k)
+        U[i*n + k0+k] = a[i][k];
+  }
+}
+
+//--------------------------------------------------------------------------------
+
+template <class T>
+void vnl_batch_inverse_3x3(unsigned int n, T const* A, T* Ainv, T* det)
+{
+  T const* a[9];
+  T* d[9];
+  for (unsigned int i = 0; i < 9; ++i)
+  {
+    a[i] = A + i*n;
+    d[i] = Ainv + i*n;
+  }
+  // The adjugate, as in vnl_inverse
+  for (unsigned int k = 0; k < n; ++k)
+  {
+    const T m00 = a[0][k], m01 = a[1][k], m02 = a[2][k];
+    const T m10 = a[3][k], m11 = a[4][k], m12 = a[5][k];
+    const T m20 = a[6][k], m21 = a[7][k], m22 = a[8][k];
+    const T d0 = m11*m22 - m12*m21;
+    const T d1 = m21*m02 - m22*m01;
+    const T d2 = m01*m12 - m02*m11;
+    const T d3 = m12*m20 - m10*m22;
+    const T d4 = m00*m22 - m02*m20;
+    const T d5 = m10*m02 - m12*m00;
+    const T d6 = m10*m21 - m11*m20;
+    const T d7 = m01*m20 - m00*m21;
+    const T d8 = m00*m11 - m01*m10;
+    const T dt = m00*d0 + m01*d3 + m02*d6;
+    const T s = dt != T(0) ? T(1) / dt : T(0);
+    d[0][k] = d0*s; d[1][k] = d1*s; d[2][k] = d2*s;
+    d[3][k] = d3*s; d[4][k] = d4*s; d[5][k] = d5*s;
+    d[6][k] = d6*s; d[7][k] = d7*s; d[8][k] = d8*s;
+    if (det)
+      det[k] = dt;
+  }
+}
+
+template <class T>
+void vnl_batch_inverse_4x4(unsigned int n, T const* A, T* Ainv, T* det)
+{
+  T const* a[16];
+  T* d[16];
+  for (unsigned int i = 0; i < 16; ++i)
+  {
+    a[i] = A + i*n;
+    d[i] = Ainv + i*n;
+  }
+  // The adjugate, as in vnl_inverse
+  for (unsigned int k = 0; k < n; ++k)
+  {
+    const T m00 = a[0][k],  m01 = a[1][k],  m02 = a[2][k],  m03 = a[3][k];
+    const T m10 = a[4][k],  m11 = a[5][k],  m12 = a[6][k],  m13 = a[7][k];
+    const T m20 = a[8][k],  m21 = a[9][k],  m22 = a[10][k], m23 = a[11][k];
+    const T m30 = a[12][k], m31 = a[13][k], m32 = a[14][k], m33 = a[15][k];
+    T c[16];
+    c[0] =  m11*m22*m33 - m11*m23*m32 - m21*m12*m33 + m21*m13*m32 + m31*m12*m23 - m31*m13*m22;
+    c[1] = -m01*m22*m33 + m01*m23*m32 + m21*m02*m33 - m21*m03*m32 - m31*m02*m23 + m31*m03*m22;
+    c[2] =  m01*m12*m33 - m01*m13*m32 - m11*m02*m33 + m11*m03*m32 + m31*m02*m13 - m31*m03*m12;
+    c[3] = -m01*m12*m23 + m01*m13*m22 + m11*m02*m23 - m11*m03*m22 - m21*m02*m13 + m21*m03*m12;
+    c[4] = -m10*m22*m33 + m10*m23*m32 + m20*m12*m33 - m20*m13*m32 - m30*m12*m23 + m30*m13*m22;
+    c[5] =  m00*m22*m33 - m00*m23*m32 - m20*m02*m33 + m20*m03*m32 + m30*m02*m23 - m30*m03*m22;
+    c[6] = -m00*m12*m33 + m00*m13*m32 + m10*m02*m33 - m10*m03*m32 - m30*m02*m13 + m30*m03*m12;
+    c[7] =  m00*m12*m23 - m00*m13*m22 - m10*m02*m23 + m10*m03*m22 + m20*m02*m13 - m20*m03*m12;
+    c[8] =  m10*m21*m33 - m10*m23*m31 - m20*m11*m33 + m20*m13*m31 + m30*m11*m23 - m30*m13*m21;
+    c[9] = -m00*m21*m33 + m00*m23*m31 + m20*m01*m33 - m20*m03*m31 - m30*m01*m23 + m30*m03*m21;
+    c[10]=  m00*m11*m33 - m00*m13*m31 - m10*m01*m33 + m10*m03*m31 + m30*m01*m13 - m30*m03*m11;
+    c[11]= -m00*m11*m23 + m00*m13*m21 + m10*m01*m23 - m10*m03*m21 - m20*m01*m13 + m20*m03*m11;
+    c[12]= -m10*m21*m32 + m10*m22*m31 + m20*m11*m32 - m20*m12*m31 - m30*m11*m22 + m30*m12*m21;
+    c[13]=  m00*m21*m32 - m00*m22*m31 - m20*m01*m32 + m20*m02*m31 + m30*m01*m22 - m30*m02*m21;
+    c[14]= -m00*m11*m32 + m00*m12*m31 + m10*m01*m32 - m10*m02*m31 - m30*m01*m12 + m30*m02*m11;
+    c[15]=  m00*m11*m22 - m00*m12*m21 - m10*m01*m22 + m10*m02*m21 + m20*m01*m12 - m20*m02*m11;
+    const T dt = m00*c[0] + m01*c[4] + m02*c[8] + m03*c[12];
+    const T s = dt != T(0) ? T(1) / dt : T(0);
+    for (unsigned int i = 0; i < 16; ++i)
+      d[i][k] = c[i]*s;
+    if (det)
+      det[k] = dt;
+  }
+}
+
+template <class T>
+void vnl_batch_symmetric_eigensystem_3x3(unsigned int n, T const* A, T* D, T* V)
+{
+  const unsigned int B = vnl_batch_fixed_block;
+  const T sqrt3 = std::sqrt(T(3));
+  T a00[B], a01[B], a02[B], a11[B], a12[B], a22[B];
+  T scale[B], mean[B], p[B], q[B];
+  for (unsigned int k0 = 0; k0 < n; k0 += B)
+  {
+    const unsigned int b = std::min(B, n - k0);
+    T const* A0 = A + k0;
+
+    // Scale by the largest element, shift by the mean eigenvalue and
+    // reduce the characteristic cubic of B = (A - mean I)/p to
+    // beta^3 - 3 beta - 2 q = 0, with q = det(B)/2 in [-1,1].
+    for (unsigned int k = 0; k < b; ++k)
+    {
+      T x00 = A0[0*n+k], x01 = A0[1*n+k], x02 = A0[2*n+k];
+      T x11 = A0[4*n+k], x12 = A0[5*n+k], x22 = A0[8*n+k];
+      T amax = std::max(std::max(std::max(std::abs(x00), std::abs(x01)), std::max(std::abs(x02), std::abs(x11))),
+                        std::max(std::abs(x12), std::abs(x22)));
+      scale[k] = amax;
+      const T inv = amax > T(0) ? T(1) / amax : T(1);
+      x00 *= inv; x01 *= inv; x02 *= inv; x11 *= inv; x12 *= inv; x22 *= inv;
+      a00[k] = x00; a01[k] = x01; a02[k] = x02; a11[k] = x11; a12[k] = x12; a22[k] = x22;
+      const T m = (x00 + x11 + x22) / T(3);
+      const T b00 = x00 - m, b11 = x11 - m, b22 = x22 - m;
+      const T pk = std::sqrt((b00*b00 + b11*b11 + b22*b22 + T(2)*(x01*x01 + x02*x02 + x12*x12)) / T(6));
+      const T ip = pk > T(0) ? T(1) / pk : T(0);
+      const T c00 = b00*ip, c01 = x01*ip, c02 = x02*ip, c11 = b11*ip, c12 = x12*ip, c22 = b22*ip;
+      const T hd = (c00*(c11*c22 - c12*c12) - c01*(c01*c22 - c12*c02) + c02*(c01*c12 - c11*c02)) / T(2);
+      mean[k] = m;
+      p[k] = pk;
+      q[k] = std::min(std::max(hd, T(-1)), T(1));
+    }
+
+    // beta = 2 cos(phi) is the largest root, with phi = acos(q)/3 in [0,pi/3].
+    // The libm calls do not vectorise, so they have a loop of their own.
+    T* cphi = q;
+    for (unsigned int k = 0; k < b; ++k)
+      cphi[k] = std::cos(std::acos(q[k]) / T(3));
+
+    for (unsigned int k = 0; k < b; ++k)
+    {
+      // Only the best separated eigenvalue li is taken from the cubic: it
+      // is the largest when q >= 0, i.e. when 2 cos(phi) >= sqrt(3).  The
+      // other two roots lose half the digits when they are close together.
+      const T c = cphi[k];
+      const bool top = T(2)*c >= sqrt3;
+      const T beta = top ? T(2)*c : -c - sqrt3*std::sqrt(std::max(T(1) - c*c, T(0)));
+      const T li = mean[k] + p[k]*beta;
+
+      // Its eigenvector w: the largest cross product of two rows of A - li I
+      const T r00 = a00[k]-li, r01 = a01[k], r02 = a02[k];
+      const T r11 = a11[k]-li, r12 = a12[k], r22 = a22[k]-li;
+      // rows are (r00 r01 r02), (r01 r11 r12), (r02 r12 r22)
+      const T x0 = r01*r12 - r02*r11, y0 = r02*r01 - r00*r12, z0 = r00*r11 - r01*r01;
+      const T x1 = r01*r22 - r02*r12, y1 = r02*r02 - r00*r22, z1 = r00*r12 - r01*r02;
+      const T x2 = r11*r22 - r12*r12, y2 = r12*r02 - r01*r22, z2 = r01*r12 - r11*r02;
+      const T d0 = x0*x0 + y0*y0 + z0*z0;
+      const T d1 = x1*x1 + y1*y1 + z1*z1;
+      const T d2 = x2*x2 + y2*y2 + z2*z2;
+      const bool use1 = d1 > d0 && d1 >= d2;
+      const bool use2 = d2 > d0 && d2 > d1;
+      T wx = use2 ? x2 : use1 ? x1 : x0;
+      T wy = use2 ? y2 : use1 ? y1 : y0;
+      T wz = use2 ? z2 : use1 ? z1 : z0;
+      const T dmax = std::max(d0, std::max(d1, d2));
+      const T iw = dmax > T(0) ? T(1) / std::sqrt(dmax) : T(0);
+      wx = dmax > T(0) ? wx*iw : T(1);
+      wy *= iw;
+      wz *= iw;
+
+      // Orthonormal basis u, v of the complement of w
+      const bool big0 = std::abs(wx) > std::abs(wy);
+      T ux = big0 ? -wz : T(0), uy = big0 ? T(0) : wz, uz = big0 ? wx : -wy;
+      const T iu = T(1) / std::sqrt(ux*ux + uy*uy + uz*uz);
+      ux *= iu; uy *= iu; uz *= iu;
+      const T vx = wy*uz - wz*uy, vy = wz*ux - wx*uz, vz = wx*uy - wy*ux;
+
+      // The other two eigenvalues are those of A restricted to span(u,v)
+      const T aux = a00[k]*ux + a01[k]*uy + a02[k]*uz;
+      const T auy = a01[k]*ux + a11[k]*uy + a12[k]*uz;
+      const T auz = a02[k]*ux + a12[k]*uy + a22[k]*uz;
+      const T avx = a00[k]*vx + a01[k]*vy + a02[k]*vz;
+      const T avy = a01[k]*vx + a11[k]*vy + a12[k]*vz;
+      const T avz = a02[k]*vx + a12[k]*vy + a22[k]*vz;
+      const T m00 = ux*aux + uy*auy + uz*auz;
+      const T m01 = ux*avx + uy*avy + uz*avz;
+      const T m11 = vx*avx + vy*avy + vz*avz;
+      const T h = (m00 + m11) / T(2), e = (m00 - m11) / T(2);
+      const T r = std::sqrt(e*e + m01*m01);
+      const T lo = h - r, hi = h + r;
+      D[0*n + k0+k] = (top ? lo : li) * scale[k];
+      D[1*n + k0+k] = (top ? hi : lo) * scale[k];
+      D[2*n + k0+k] = (top ? li : hi) * scale[k];
+      if (!V)
+        continue;
+
+      // The 2x2 matrix less the middle eigenvalue has rank at most one; its
+      // eigenvector is orthogonal to the larger row.
+      const T lm = top ? hi : lo;
+      const T n00 = m00 - lm, n11 = m11 - lm;
+      const bool row0 = n00*n00 >= n11*n11;
+      const T sa = row0 ? m01 : n11, sb = row0 ? -n00 : -m01;
+      const T len2 = sa*sa + sb*sb;
+      const T il = len2 > T(0) ? T(1) / std::sqrt(len2) : T(0);
+      const T ca = len2 > T(0) ? sa*il : T(1), cb = sb*il;
+      const T ex = ca*ux + cb*vx, ey = ca*uy + cb*vy, ez = ca*uz + cb*vz;
+      const T fx = wy*ez - wz*ey, fy = wz*ex - wx*ez, fz = wx*ey - wy*ex;
+
+      // columns in increasing order of eigenvalue
+      V[0*n + k0+k] = top ? fx : wx;  V[1*n + k0+k] = ex;  V[2*n + k0+k] = top ? wx : fx;
+      V[3*n + k0+k] = top ? fy : wy;  V[4*n + k0+k] = ey;  V[5*n + k0+k] = top ? wy : fy;
+      V[6*n + k0+k] = top ? fz : wz;  V[7*n + k0+k] = ez;  V[8*n + k0+k] = top ? wz : fz;
+    }
+  }
+}
+
+template <class T>
+void vnl_batch_symmetric_eigensystem_4x4(unsigned int n, T const* A, T* D, T* V)
+{
+  vnl_batch_fixed_jacobi_eigensystem<T,4>(n, A, D, V);
+}
+
+template <class T>
+void vnl_batch_svd_3x3(unsigned int n, T const* A, T* U, T* W, T* V)
+{
+  vnl_batch_fixed_jacobi_svd<T,3>(n, A, U, W, V);
+}
+
+template <class T>
+void vnl_batch_svd_4x4(unsigned int n, T const* A, T* U, T* W, T* V)
+{
+  vnl_batch_fixed_jacobi_svd<T,4>(n, A, U, W, V);
+}
+
+//--------------------------------------------------------------------------------
+
+#undef VNL_BATCH_FIXED_INSTANTIATE
+#define VNL_BATCH_FIXED_INSTANTIATE(T) \
+template void vnl_batch_inverse_3x3(unsigned int, T const*, T*, T*); \
+template void vnl_batch_inverse_4x4(unsigned int, T const*, T*, T*); \
+template void vnl_batch_symmetric_eigensystem_3x3(unsigned int, T const*, T*, T*); \
+template void vnl_batch_symmetric_eigensystem_4x4(unsigned int, T const*, T*, T*); \
+template void vnl_batch_svd_3x3(unsigned int, T const*, T*, T*, T*); \
+template void vnl_batch_svd_4x4(unsigned int, T const*, T*, T*, T*)
+
+#endif // vnl_batch_fixed_hxx_
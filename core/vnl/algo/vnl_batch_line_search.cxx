@@ -0,0 +1,63 @@
+// This is core/vnl/algo/vnl_batch_line_search.cxx
+//:
+// \file
+//
+//-----------------------------------------------------------------------------
+
+#include <cmath>
+#include "vnl_batch_line_search.h"
+#include <vcl_compiler.h>
+
+vnl_batch_line_search::vnl_batch_line_search(vnl_cost_function& f, unsigned int n)
+  : points(n), c1(1e-4), c2(0.9), max_batches(4), f_(&f), num_evaluations_(0)
+{
+}
+
+double vnl_batch_line_search::search(vnl_vector<double>& x, double& fx, vnl_vector<double>& g,
+                                     vnl_vector<double> const& d, double step)
+{
+  num_evaluations_ = 0;
+  const double gd = dot_product(g, d);
+  if (!(gd < 0) || !(step > 0))
+    return 0;
+
+  const unsigned int k = points < 2 ? 2 : points;
+  const unsigned int n = x.size();
+  vnl_matrix<double> X(k, n), G;
+  vnl_vector<double> fX;
+
+  // The first ladder also tries steps longer than the given one.
+  double t0 = step * std::pow(2.0, double(k / 4));
+  for (unsigned int batch = 0; batch < max_batches; ++batch, t0 *= std::pow(0.5, double(k))) {
+    for (unsigned int j = 0; j < k; ++j) {
+      const double t = t0 * std::pow(0.5, double(j));
+      for (unsigned int i = 0; i < n; ++i)
+        X(j,i) = x[i] + t * d[i];
+    }
+    f_->compute_batch(X, fX, &G);
+    num_evaluations_ += k;
+
+    int best = -1;
+    bool best_wolfe = false;
+    for (unsigned int j = 0; j < k; ++j) {
+      const double t = t0 * std::pow(0.5, double(j));
+      if (!(fX[j] <= fx + c1 * t * gd)) // also rejects NaN
+        continue;
+      double gdj = 0;
+      for (unsigned int i = 0; i < n; ++i)
+        gdj += G(j,i) * d[i];
+      const bool wolfe = std::fabs(gdj) <= c2 * -gd;
+      if (best < 0 || (wolfe && !best_wolfe) || (wolfe == best_wolfe && fX[j] < fX[best])) {
+        best = j;
+        best_wolfe = wolfe;
+      }
+    }
+    if (best >= 0) {
+      x = X.get_row(best);
+      g = G.get_row(best);
+      fx = fX[best];
+      return t0 * std::pow(0.5, double(best));
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,64 @@
+// This is core/vnl/algo/vnl_batch_line_search.h
+#ifndef vnl_batch_line_search_h_
+#define vnl_batch_line_search_h_
+//:
+// \file
+// \brief Line search that evaluates several trial steps at once
+//
+//    A classical line search (as in the netlib routines behind vnl_lbfgs and
+//    vnl_conjugate_gradient) tries one step at a time, each chosen from the
+//    values at the previous ones.  This one passes a whole ladder of steps,
+//    step*2^(k/4) ... step*2^(k/4-k+1) for k trial points, to a single call
+//    of vnl_cost_function::compute_batch, and keeps the one with the lowest
+//    value among those satisfying the strong Wolfe conditions, or failing
+//    that the sufficient decrease (Armijo) condition.  If no step decreases
+//    f enough, the ladder is continued below the smallest step.
+//
+//    It uses more evaluations than a sequential search, but the evaluations
+//    of one ladder are independent, so a cost function that evaluates them
+//    together (vectorised, or on several threads) takes less time.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vnl/vnl_vector.h>
+#include <vnl/vnl_matrix.h>
+#include <vnl/vnl_cost_function.h>
+
+//: Line search that evaluates several trial steps per call of compute_batch
+class vnl_batch_line_search
+{
+ public:
+  //: Search f, trying points steps per call of f.compute_batch.
+  vnl_batch_line_search(vnl_cost_function& f, unsigned int points = 8);
+
+  //: Search from x along the descent direction d, starting from step.
+  //  fx and g are f and its gradient at x.  On success x, fx and g are
+  //  replaced by the new point, its value and gradient, and the step taken
+  //  is returned.  Returns 0, leaving them unchanged, if d is not a descent
+  //  direction or no step gave a sufficient decrease.
+  double search(vnl_vector<double>& x, double& fx, vnl_vector<double>& g,
+                vnl_vector<double> const& d, double step);
+
+  //: Number of points evaluated by the last call of search.
+  unsigned int num_evaluations() const { return num_evaluations_; }
+
+  //: Number of trial steps evaluated together; at least 2.
+  unsigned int points;
+
+  //: Sufficient decrease constant, f(x + t d) <= f(x) + c1 t g.d; default 1e-4.
+  double c1;
+
+  //: Curvature constant, |g(x + t d).d| <= c2 |g.d|; default 0.9.
+  double c2;
+
+  //: Maximum number of ladders tried in one search; default 4.
+  unsigned int max_batches;
+
+ private:
+  vnl_cost_function* f_;
+  unsigned int num_evaluations_;
+};
+
+#endif // vnl_batch_line_search_h_
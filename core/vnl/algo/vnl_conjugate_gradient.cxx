@@ -9,6 +9,7 @@
 //
 //-----------------------------------------------------------------------------
 #include <iostream>
+#include <algorithm>
 #include "vnl_conjugate_gradient.h"
 
 #include <vcl_compiler.h>
@@ -16,6 +17,7 @@
 #include <vnl/vnl_cost_function.h>
 #include <vnl/vnl_vector_ref.h>
 #include <vnl/algo/vnl_netlib.h>
+#include <vnl/algo/vnl_batch_line_search.h>
 
 /////////////////////////////////////
 
@@ -26,6 +28,7 @@ vnl_conjugate_gradient::~vnl_conjugate_gradient()
 void vnl_conjugate_gradient::init(vnl_cost_function &f)
 {
   f_= &f;
+  line_search_batch_size_ = 0;
   num_iterations_ = 0;
   num_evaluations_ = 0;
   start_error_ = 0;
@@ -85,6 +88,9 @@ void vnl_conjugate_gradient::preconditioner_( double *out, double *in, void* use
 ///////////////////////////////////////
 bool vnl_conjugate_gradient::minimize( vnl_vector<double> &x)
 {
+  if (line_search_batch_size_ > 0)
+    return minimize_batched(x);
+
   double *xp = x.data_block();
   double max_norm_of_gradient;
   long number_of_iterations;
@@ -117,7 +123,9 @@ bool vnl_conjugate_gradient::minimize( vnl_vector<double> &x)
        &error_code);
 
   // Check for an error condition.
-  if (error_code > 0)
+  if (error_code == 0)
+    failure_code_ = CONVERGED_GTOL;
+  else if (error_code > 0)
   {
     failure_code_ = ERROR_DODGY_INPUT;
     if (verbose_)
@@ -141,6 +149,63 @@ bool vnl_conjugate_gradient::minimize( vnl_vector<double> &x)
 }
 
 
+//: Polak-Ribiere conjugate gradients with a vnl_batch_line_search.
+// Stops as the netlib routine does, when the largest gradient component is
+// below gtol, or after maxfev evaluations.
+bool vnl_conjugate_gradient::minimize_batched(vnl_vector<double>& x)
+{
+  const unsigned int n = f_->get_number_of_unknowns();
+  vnl_batch_line_search search(*f_, line_search_batch_size_);
+  search.c2 = 0.1; // conjugate directions need a fairly exact search
+
+  num_evaluations_ = 0;
+  num_iterations_ = 0;
+  final_step_size_ = 0;
+
+  double f;
+  vnl_vector<double> g(n);
+  f_->compute(x, &f, &g);
+  start_error_ = f;
+  num_evaluations_ = 1;
+
+  vnl_vector<double> d = -g, g0;
+  double step = 1.0 / std::max(g.magnitude(), 1e-300);
+  bool ok = true;
+  while (g.inf_norm() > gtol) {
+    if (num_evaluations_ >= maxfev) {
+      failure_code_ = TOO_MANY_ITERATIONS;
+      ok = false;
+      break;
+    }
+    g0 = g;
+    double gd0 = dot_product(g0, d);
+    double t = search.search(x, f, g, d, step);
+    num_evaluations_ += search.num_evaluations();
+    if (t == 0) {
+      failure_code_ = ERROR_FAILURE;
+      ok = false;
+      break;
+    }
+    final_step_size_ = t;
+    ++num_iterations_;
+
+    // Polak-Ribiere, restarting along -g when that gives no descent
+    double beta = std::max(0.0, dot_product(g, g - g0) / g0.squared_magnitude());
+    d = beta * d - g;
+    double gd = dot_product(g, d);
+    if (!(gd < 0)) {
+      d = -g;
+      gd = -g.squared_magnitude();
+    }
+    // the next search starts where a quadratic model along the old direction would
+    step = t * gd0 / gd;
+  }
+  if (ok)
+    failure_code_ = CONVERGED_GTOL;
+  end_error_ = f;
+  return ok;
+}
+
 void vnl_conjugate_gradient::diagnose_outcome(std::ostream& os) const
 {
   os << "vnl_conjugate_gradient: "
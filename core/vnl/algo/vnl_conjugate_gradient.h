@@ -61,11 +61,20 @@ class vnl_conjugate_gradient : public vnl_nonlinear_minimizer
   // Returns true for convergence, false for failure.
   bool minimize(vnl_vector<double>& x);
 
+  //: Number of line search steps evaluated together.
+  // If positive, minimize() uses its own Polak-Ribiere iteration with a
+  // vnl_batch_line_search, which passes this many trial steps to each call
+  // of vnl_cost_function::compute_batch.  The default, 0, uses the netlib
+  // routine, which evaluates one point at a time.
+  void set_line_search_batch_size(int n) { line_search_batch_size_ = n; }
+  int get_line_search_batch_size() const { return line_search_batch_size_; }
+
  protected:
   // Data Members--------------------------------------------------------------
 
   vnl_cost_function *f_;
   double final_step_size_;
+  int line_search_batch_size_;
 
   // Helpers-------------------------------------------------------------------
 
@@ -73,6 +82,7 @@ class vnl_conjugate_gradient : public vnl_nonlinear_minimizer
   static void gradientcomputer_( double *g, double *x, void* userdata);
   static void valueandgradientcomputer_( double *v, double *g, double *x, void* userdata);
   static void preconditioner_( double *out, double *in, void* userdata);
+  bool minimize_batched(vnl_vector<double>& x);
 
 };
 
@@ -0,0 +1,74 @@
+// This is core/vnl/algo/vnl_fft_1d_real.h
+#ifndef vnl_fft_1d_real_h_
+#define vnl_fft_1d_real_h_
+//:
+// \file
+// \brief 1D fast Fourier transform of a real signal
+//
+//    The spectrum X of a real signal x of length N is Hermitian,
+//    X[N-k] = conj(X[k]), so only X[0] ... X[N/2] are computed and stored.
+//    For even N the signal is packed into a complex signal of length N/2,
+//    z[k] = x[2k] + i x[2k+1], whose transform is then split into the
+//    spectra of the even and odd samples; this is about twice as fast as
+//    transforming x with vnl_fft_1d.  Odd N falls back to a complex
+//    transform of length N.
+//
+//    The sign conventions and (lack of) scaling are those of vnl_fft_1d:
+//    \code
+//      fwd: X[k] = sum_j x[j] exp(+2 pi i j k / N)
+//      bwd: x[j] = sum_k X[k] exp(-2 pi i j k / N)  (over all N values of k)
+//    \endcode
+//    so that bwd_transform(fwd_transform(x)) gives N x.
+//
+//    The transforms do not modify the object, so one object may be used
+//    by several threads at once.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <complex>
+#include <vector>
+#include <vcl_compiler.h>
+#include <vnl/vnl_vector.h>
+#include <vnl/algo/vnl_fft_1d.h>
+
+//: 1D fast Fourier transform of a real signal
+template <class T>
+class vnl_fft_1d_real
+{
+ public:
+  //: constructor takes length of signal.
+  vnl_fft_1d_real(int N);
+
+  //: return length of signal.
+  unsigned int size() const { return n_; }
+
+  //: return number of stored spectrum values, size()/2+1.
+  unsigned int spectrum_size() const { return n_/2 + 1; }
+
+  //: forward FFT of the size() values of x into the spectrum_size() values of X.
+  void fwd_transform(T const *x, std::complex<T> *X);
+
+  //: forward FFT; X is resized to spectrum_size().
+  void fwd_transform(vnl_vector<T> const &x, vnl_vector<std::complex<T> > &X);
+
+  //: backward (inverse) FFT of the spectrum_size() values of X into the size() values of x.
+  //  The imaginary parts of X[0] and, for even size(), X[size()/2] are ignored.
+  void bwd_transform(std::complex<T> const *X, T *x);
+
+  //: backward (inverse) FFT; x is resized to size().
+  void bwd_transform(vnl_vector<std::complex<T> > const &X, vnl_vector<T> &x);
+
+ private:
+  unsigned int n_;
+  //: complex transform of length n_/2, or n_ if n_ is odd.
+  vnl_fft_1d<T> fft_;
+  //: exp(2 pi i k / n_) for k < n_/2.
+  std::vector<std::complex<T> > twiddle_;
+};
+
+#define VNL_FFT_1D_REAL_INSTANTIATE(T) \
+extern "please include vnl/algo/vnl_fft_1d_real.hxx first"
+
+#endif // vnl_fft_1d_real_h_
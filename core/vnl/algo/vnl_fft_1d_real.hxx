@@ -0,0 +1,114 @@
+// This is core/vnl/algo/vnl_fft_1d_real.hxx
+#ifndef vnl_fft_1d_real_hxx_
+#define vnl_fft_1d_real_hxx_
+//:
+// \file
+
+#include <cmath>
+#include <algorithm>
+#include "vnl_fft_1d_real.h"
+#include <vnl/vnl_math.h>
+#include <vcl_cassert.h>
+
+template <class T>
+vnl_fft_1d_real<T>::vnl_fft_1d_real(int N)
+  : n_(N)
+  , fft_((N % 2) ? N : N/2)
+{
+  if (n_ % 2 == 0) {
+    twiddle_.resize(n_/2);
+    for (unsigned int k = 0; k < n_/2; ++k) {
+      double a = 2 * vnl_math::pi * k / n_;
+      twiddle_[k] = std::complex<T>(T(std::cos(a)), T(std::sin(a)));
+    }
+  }
+}
+
+template <class T>
+void vnl_fft_1d_real<T>::fwd_transform(T const *x, std::complex<T> *X)
+{
+  if (n_ % 2) {
+    std::vector<std::complex<T> > z(x, x + n_);
+    fft_.fwd_transform(&z[0]);
+    std::copy(z.begin(), z.begin() + spectrum_size(), X);
+    return;
+  }
+
+  // Transform z[k] = x[2k] + i x[2k+1] in the first m values of X.  Its
+  // transform Z holds the spectra of the even and odd samples,
+  //   E[k] = (Z[k] + conj(Z[m-k])) / 2,  O[k] = (Z[k] - conj(Z[m-k])) / 2i
+  // and X[k] = E[k] + w^k O[k], X[m-k] = conj(E[k] - w^k O[k]).
+  const unsigned int m = n_/2;
+  std::complex<T> *z = X;
+  for (unsigned int k = 0; k < m; ++k)
+    z[k] = std::complex<T>(x[2*k], x[2*k+1]);
+  fft_.fwd_transform(z);
+
+  const T e0 = z[0].real(), o0 = z[0].imag();
+  X[0] = std::complex<T>(e0 + o0, 0);
+  X[m] = std::complex<T>(e0 - o0, 0);
+  for (unsigned int k = 1; 2*k <= m; ++k) {
+    const unsigned int j = m - k;
+    const std::complex<T> zk = z[k], zj = std::conj(z[j]);
+    const std::complex<T> e = (zk + zj) * T(0.5);
+    const std::complex<T> o = (zk - zj) * std::complex<T>(0, T(-0.5));
+    const std::complex<T> wo = twiddle_[k] * o;
+    X[k] = e + wo;
+    if (j != k)
+      X[j] = std::conj(e - wo);
+  }
+}
+
+template <class T>
+void vnl_fft_1d_real<T>::fwd_transform(vnl_vector<T> const &x, vnl_vector<std::complex<T> > &X)
+{
+  assert(x.size() == n_);
+  X.set_size(spectrum_size());
+  fwd_transform(x.data_block(), X.data_block());
+}
+
+template <class T>
+void vnl_fft_1d_real<T>::bwd_transform(std::complex<T> const *X, T *x)
+{
+  if (n_ % 2) {
+    std::vector<std::complex<T> > z(n_);
+    z[0] = X[0].real();
+    for (unsigned int k = 1; k < spectrum_size(); ++k) {
+      z[k] = X[k];
+      z[n_-k] = std::conj(X[k]);
+    }
+    fft_.bwd_transform(&z[0]);
+    for (unsigned int j = 0; j < n_; ++j)
+      x[j] = z[j].real();
+    return;
+  }
+
+  // The reverse of fwd_transform: rebuild Z[k] = E[k] + i O[k] from
+  //   E[k] = X[k] + conj(X[m-k]),  O[k] = (X[k] - conj(X[m-k])) w^-k
+  // in the storage of x, whose inverse transform is x[2k] + i x[2k+1].
+  const unsigned int m = n_/2;
+  std::complex<T> *z = reinterpret_cast<std::complex<T> *>(x);
+  const T a = X[0].real(), b = X[m].real();
+  z[0] = std::complex<T>(a + b, a - b);
+  for (unsigned int k = 1; k < m; ++k) {
+    const std::complex<T> Xk = X[k], Xj = std::conj(X[m-k]);
+    const std::complex<T> e = Xk + Xj;
+    const std::complex<T> o = (Xk - Xj) * std::conj(twiddle_[k]);
+    z[k] = std::complex<T>(e.real() - o.imag(), e.imag() + o.real());
+  }
+  fft_.bwd_transform(z);
+}
+
+template <class T>
+void vnl_fft_1d_real<T>::bwd_transform(vnl_vector<std::complex<T> > const &X, vnl_vector<T> &x)
+{
+  assert(X.size() == spectrum_size());
+  x.set_size(n_);
+  bwd_transform(X.data_block(), x.data_block());
+}
+
+#undef VNL_FFT_1D_REAL_INSTANTIATE
+#define VNL_FFT_1D_REAL_INSTANTIATE(T) \
+template class vnl_fft_1d_real<T >
+
+#endif // vnl_fft_1d_real_hxx_
@@ -0,0 +1,60 @@
+// This is core/vnl/algo/vnl_fft_2d_real.h
+#ifndef vnl_fft_2d_real_h_
+#define vnl_fft_2d_real_h_
+//:
+// \file
+// \brief 2D fast Fourier transform of a real image
+//
+//    The spectrum of a real M x N image is Hermitian, so only its first
+//    N/2+1 columns are computed and stored.  The rows are transformed with
+//    vnl_fft_1d_real and then the N/2+1 columns with complex transforms,
+//    which is about twice as fast as vnl_fft_2d on the complex image.  The
+//    sign conventions and (lack of) scaling are those of vnl_fft_2d, so
+//    bwd_transform(fwd_transform(x)) gives M N x.
+//
+//    When VNL_CONFIG_ENABLE_OPENMP is on, the rows, and chunks of columns,
+//    of a large image are shared among OpenMP threads.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <complex>
+#include <vcl_compiler.h>
+#include <vnl/vnl_matrix.h>
+#include <vnl/algo/vnl_fft_1d_real.h>
+#include <vnl/algo/vnl_fft_prime_factors.h>
+
+//: 2D fast Fourier transform of a real image
+template <class T>
+class vnl_fft_2d_real
+{
+ public:
+  //: constructor takes size of signal.
+  vnl_fft_2d_real(int M, int N);
+
+  //: return size of signal.
+  unsigned rows() const { return col_factors_.number(); }
+  unsigned cols() const { return row_fft_.size(); }
+
+  //: return number of stored spectrum columns, cols()/2+1.
+  unsigned spectrum_cols() const { return row_fft_.spectrum_size(); }
+
+  //: forward FFT; X is resized to rows() x spectrum_cols().
+  void fwd_transform(vnl_matrix<T> const &x, vnl_matrix<std::complex<T> > &X);
+
+  //: backward (inverse) FFT of a rows() x spectrum_cols() spectrum; x is resized to rows() x cols().
+  void bwd_transform(vnl_matrix<std::complex<T> > const &X, vnl_matrix<T> &x);
+
+ private:
+  //: In-place complex transforms of the columns of the rows() x spectrum_cols() matrix S.
+  void transform_columns(std::complex<T> *S, int dir);
+
+  vnl_fft_1d_real<T> row_fft_;
+  vnl_fft_prime_factors<T> col_factors_;
+};
+
+#define VNL_FFT_2D_REAL_INSTANTIATE(T) \
+extern "please include vnl/algo/vnl_fft_2d_real.hxx first"
+
+#endif // vnl_fft_2d_real_h_
@@ -0,0 +1,75 @@
+// This is core/vnl/algo/vnl_fft_2d_real.hxx
+#ifndef vnl_fft_2d_real_hxx_
+#define vnl_fft_2d_real_hxx_
+//:
+// \file
+
+#include <algorithm>
+#include "vnl_fft_2d_real.h"
+#include <vnl/algo/vnl_fft_1d_real.hxx>
+#include <vnl/algo/vnl_fft_base.hxx> // for vnl_fft_base_chunk
+#include <vnl/algo/vnl_fft.h>
+#include <vcl_cassert.h>
+
+template <class T>
+vnl_fft_2d_real<T>::vnl_fft_2d_real(int M, int N)
+  : row_fft_(N)
+  , col_factors_(M)
+{
+}
+
+template <class T>
+void vnl_fft_2d_real<T>::transform_columns(std::complex<T> *S, int dir)
+{
+  const int M = rows();
+  const int H = spectrum_cols();
+  const int chunks = (H + vnl_fft_base_chunk - 1) / vnl_fft_base_chunk;
+  T const *trigs = col_factors_.trigs();
+  long const *pqr = col_factors_.pqr();
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) if (chunks > 1 && M*H >= vnl_fft_base_parallel_size)
+#endif
+  for (int c=0; c<chunks; ++c) {
+    int first = c * vnl_fft_base_chunk;
+    int count = std::min(vnl_fft_base_chunk, H - first);
+    T *data = (T *) (S + first);
+    long info = 0;
+    vnl_fft_gpfa(data, data + 1, trigs, 2*H, 2, M, count, dir, pqr, &info);
+    assert(info != -1);
+  }
+}
+
+template <class T>
+void vnl_fft_2d_real<T>::fwd_transform(vnl_matrix<T> const &x, vnl_matrix<std::complex<T> > &X)
+{
+  assert(x.rows() == rows() && x.cols() == cols());
+  const int M = rows();
+  X.set_size(M, spectrum_cols());
+#if defined(_OPENMP)
+#pragma omp parallel for if (M*int(cols()) >= vnl_fft_base_parallel_size)
+#endif
+  for (int r=0; r<M; ++r)
+    row_fft_.fwd_transform(x[r], X[r]);
+  transform_columns(X.data_block(), +1);
+}
+
+template <class T>
+void vnl_fft_2d_real<T>::bwd_transform(vnl_matrix<std::complex<T> > const &X, vnl_matrix<T> &x)
+{
+  assert(X.rows() == rows() && X.cols() == spectrum_cols());
+  const int M = rows();
+  vnl_matrix<std::complex<T> > Y(X);
+  transform_columns(Y.data_block(), -1);
+  x.set_size(M, cols());
+#if defined(_OPENMP)
+#pragma omp parallel for if (M*int(cols()) >= vnl_fft_base_parallel_size)
+#endif
+  for (int r=0; r<M; ++r)
+    row_fft_.bwd_transform(Y[r], x[r]);
+}
+
+#undef VNL_FFT_2D_REAL_INSTANTIATE
+#define VNL_FFT_2D_REAL_INSTANTIATE(T) \
+template class vnl_fft_2d_real<T >
+
+#endif // vnl_fft_2d_real_hxx_
@@ -3,10 +3,19 @@
 /*
   fsm
 */
+#include <algorithm>
 #include "vnl_fft_base.h"
 #include <vnl/algo/vnl_fft.h>
+#include <vcl_compiler.h>
 #include <vcl_cassert.h>
 
+//: Most transforms done by one call to gpfa.
+//  Small enough that a chunk of columns of an image stays in cache.
+const int vnl_fft_base_chunk = 64;
+
+//: Smallest number of elements for which a transform is multithreaded.
+const int vnl_fft_base_parallel_size = 1 << 15;
+
 template <int D, class T>
 void vnl_fft_base<D, T>::transform(std::complex<T> *signal, int dir)
 {
@@ -25,30 +34,44 @@ void vnl_fft_base<D, T>::transform(std::complex<T> *signal, int dir)
     }
 
     // pretend the signal is N1xN2xN3. we want to transform
-    // along the second dimension.
-    for (int n1=0; n1<N1; ++n1) {
-      // FIXME: we could avoid one loop by using the LOT parameter
-      // but it's not entirely clear that would save us anything.
-
-      for (int n3=0; n3<N3; ++n3) {
-        // This relies on the assumption that std::complex<T> is layout
-        // compatible with "struct { T real; T imag; }". It is probably
-        // a valid assumption for all sane C++ libraries.
-        T *data = (T *) (signal + n1*N2*N3 + n3);
-
-        long info = 0;
-        vnl_fft_gpfa (/* A */     data,
-                      /* B */     data + 1,
-                      /* TRIGS */ factors_[i].trigs (),
-                      /* INC */   2*N3,
-                      /* JUMP */  0,
-                      /* N */     N2,
-                      /* LOT */   1,
-                      /* ISIGN */ dir,
-                      /* NIPQ */  factors_[i].pqr (),
-                      /* INFO */  &info);
-        assert(info != -1);
-      }
+    // along the second dimension.  Each call to gpfa does a "lot" of
+    // transforms: those for consecutive n3 if N3 > 1, otherwise those
+    // for consecutive n1.  The lots are split into chunks of at most
+    // vnl_fft_base_chunk transforms, which are independent and are shared
+    // among OpenMP threads if the signal is big enough.
+    //
+    // This relies on the assumption that std::complex<T> is layout
+    // compatible with "struct { T real; T imag; }". It is probably
+    // a valid assumption for all sane C++ libraries.
+    const int  outer  = (N3 > 1) ? N1 : 1;
+    const int  lot    = (N3 > 1) ? N3 : N1;
+    const long inc    = 2*N3;
+    const long jump   = (N3 > 1) ? 2 : 2*N2;
+    const int  chunks = (lot + vnl_fft_base_chunk - 1) / vnl_fft_base_chunk;
+    const int  tasks  = outer * chunks;
+    T const *trigs = factors_[i].trigs();
+    long const *pqr = factors_[i].pqr();
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) if (tasks > 1 && N1*N2*N3 >= vnl_fft_base_parallel_size)
+#endif
+    for (int t=0; t<tasks; ++t) {
+      int o = t / chunks;
+      int first = (t % chunks) * vnl_fft_base_chunk;
+      int count = std::min(vnl_fft_base_chunk, lot - first);
+      T *data = (T *) (signal + o*N2*N3 + first*(jump/2));
+
+      long info = 0;
+      vnl_fft_gpfa (/* A */     data,
+                    /* B */     data + 1,
+                    /* TRIGS */ trigs,
+                    /* INC */   inc,
+                    /* JUMP */  jump,
+                    /* N */     N2,
+                    /* LOT */   count,
+                    /* ISIGN */ dir,
+                    /* NIPQ */  pqr,
+                    /* INFO */  &info);
+      assert(info != -1);
     }
   }
 }
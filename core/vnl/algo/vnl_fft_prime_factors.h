@@ -11,6 +11,13 @@
 //  Modifications
 //   10/4/2001 Ian Scott (Manchester) Converted perceps header to doxygen
 // \endverbatim
+//
+// The twiddle factors for a given N are computed once per process and
+// shared by every vnl_fft_prime_factors<T> of that size, so that creating
+// vnl_fft_1d objects in a loop, or one per thread, costs a table lookup.
+// The shared tables are kept until the program exits.  The table cache is
+// guarded by a mutex when compiled as C++11; with older compilers the
+// first object of each size must be created by a single thread.
 
 #include <vcl_compiler.h> // for "export" keyword
 
@@ -54,7 +61,7 @@ public:
   }
 
  private:
-  T *trigs_;
+  T const *trigs_; // owned by the cache of tables, see construct()
   long number_;   // the number that is being split into prime-facs
   long pqr_[3];   // store P, Q and R
   long info_;
@@ -3,9 +3,15 @@
 /*
   fsm
 */
+#include <map>
+#include <vector>
 #include "vnl_fft_prime_factors.h"
 #include <vnl/algo/vnl_fft.h>
+#include <vcl_compiler.h>
 #include <vcl_cassert.h>
+#if VXL_CXX11
+#include <mutex>
+#endif
 
 template <class T>
 vnl_fft_prime_factors<T>::vnl_fft_prime_factors()
@@ -14,13 +20,39 @@ vnl_fft_prime_factors<T>::vnl_fft_prime_factors()
 {
 }
 
+//: Twiddle factors and factorisation of one signal size.
+template <class T>
+struct vnl_fft_prime_factors_plan
+{
+  std::vector<T> trigs;
+  long pqr[3];
+  long info;
+};
+
 template <class T>
 void vnl_fft_prime_factors<T>::construct(int N)
 {
   assert(N>0);
-  trigs_ = new T[2*N];
   number_ = N;
-  vnl_fft_setgpfa (trigs_, number_, pqr_, &info_);
+
+  // Plans are never removed from the map, so the pointers into it stay valid.
+  static std::map<long, vnl_fft_prime_factors_plan<T> > plans;
+#if VXL_CXX11
+  static std::mutex plans_mutex;
+  std::lock_guard<std::mutex> lock(plans_mutex);
+#endif
+  typename std::map<long, vnl_fft_prime_factors_plan<T> >::iterator it = plans.find(number_);
+  if (it == plans.end()) {
+    it = plans.insert(std::make_pair(number_, vnl_fft_prime_factors_plan<T>())).first;
+    vnl_fft_prime_factors_plan<T>& plan = it->second;
+    plan.trigs.resize(2*N);
+    vnl_fft_setgpfa (&plan.trigs[0], number_, plan.pqr, &plan.info);
+  }
+  trigs_ = &it->second.trigs[0];
+  pqr_[0] = it->second.pqr[0];
+  pqr_[1] = it->second.pqr[1];
+  pqr_[2] = it->second.pqr[2];
+  info_ = it->second.info;
   // info_ == -1 if cannot split into primes
   if (info_ == -1)
     assert(!"you probably gave a signal size not of the form 2^p 3^q 5^r");
@@ -29,8 +61,8 @@ void vnl_fft_prime_factors<T>::construct(int N)
 template <class T>
 void vnl_fft_prime_factors<T>::destruct()
 {
-  if (trigs_)
-    delete [] trigs_;
+  // the twiddle factors belong to the cache in construct().
+  trigs_ = 0;
 }
 
 #undef VNL_FFT_PRIME_FACTORS_INSTANTIATE
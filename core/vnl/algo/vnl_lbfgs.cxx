@@ -13,10 +13,13 @@
 #include <cmath>
 #include <iostream>
 #include <iomanip>
+#include <vector>
+#include <algorithm>
 #include "vnl_lbfgs.h"
 #include <vcl_compiler.h>
 
 #include <vnl/algo/vnl_netlib.h> // lbfgs_()
+#include <vnl/algo/vnl_batch_line_search.h>
 
 //: Default constructor.
 // memory is set to 5, line_search_accuracy to 0.9.
@@ -36,16 +39,21 @@ vnl_lbfgs::vnl_lbfgs(vnl_cost_function& f):
 }
 
 //: Called by constructors.
-// Memory is set to 5, line_search_accuracy to 0.9, default_step_length to 1.
+// Memory is set to 5, line_search_accuracy to 0.9, default_step_length to 1,
+// line_search_batch_size to 0.
 void vnl_lbfgs::init_parameters()
 {
   memory = 5;
   line_search_accuracy = 0.9;
   default_step_length = 1.0;
+  line_search_batch_size = 0;
 }
 
 bool vnl_lbfgs::minimize(vnl_vector<double>& x)
 {
+  if (line_search_batch_size > 0)
+    return minimize_batched(x);
+
   // Local variables
   // The driver for vnl_lbfgs must always declare LB2 as EXTERNAL
 
@@ -153,6 +161,7 @@ bool vnl_lbfgs::minimize(vnl_vector<double>& x)
 
     if (iflag == 0) {
       // Successful return
+      failure_code_ = CONVERGED_GTOL;
       this->end_error_ = f;
       ok = true;
       x = best_x;
@@ -179,3 +188,90 @@ bool vnl_lbfgs::minimize(vnl_vector<double>& x)
 
   return ok;
 }
+
+//: The L-BFGS iteration of the netlib routine, with a vnl_batch_line_search.
+// The search direction comes from the usual two-loop recursion over the last
+// memory steps, and the iteration stops as the netlib routine does, when
+// |g| <= gtol max(1, |x|).
+bool vnl_lbfgs::minimize_batched(vnl_vector<double>& x)
+{
+  const unsigned int n = f_->get_number_of_unknowns();
+  const unsigned int m = memory > 0 ? memory : 1;
+  vnl_batch_line_search search(*f_, line_search_batch_size);
+  search.c2 = line_search_accuracy;
+
+  this->num_evaluations_ = 0;
+  this->num_iterations_ = 0;
+
+  double f;
+  vnl_vector<double> g(n);
+  f_->compute(x, &f, &g);
+  this->report_eval(f);
+
+  std::vector<vnl_vector<double> > s(m), y(m);
+  std::vector<double> rho(m), alpha(m);
+  unsigned int stored = 0, newest = m - 1;
+  vnl_vector<double> d, x0, g0;
+
+  bool ok;
+  while (true) {
+    if (g.magnitude() <= gtol * std::max(1.0, x.magnitude())) {
+      failure_code_ = CONVERGED_GTOL;
+      ok = true;
+      break;
+    }
+
+    // d = -H g, with H the inverse Hessian estimate
+    d = -g;
+    for (unsigned int k = 0; k < stored; ++k) {
+      unsigned int j = (newest + m - k) % m;
+      alpha[j] = rho[j] * dot_product(s[j], d);
+      d -= alpha[j] * y[j];
+    }
+    if (stored)
+      d *= 1.0 / (rho[newest] * y[newest].squared_magnitude());
+    for (unsigned int k = stored; k-- > 0; ) {
+      unsigned int j = (newest + m - k) % m;
+      double beta = rho[j] * dot_product(y[j], d);
+      d += (alpha[j] - beta) * s[j];
+    }
+
+    // As in the netlib routine, the first step has length default_step_length.
+    double step = stored ? default_step_length : default_step_length / g.magnitude();
+    x0 = x; g0 = g;
+    double t = search.search(x, f, g, d, step);
+    this->num_evaluations_ += search.num_evaluations() - 1;
+    this->report_eval(f);
+
+    if (t == 0) {
+      // no step along d decreased f
+      failure_code_ = ERROR_FAILURE;
+      ok = false;
+      break;
+    }
+
+    vnl_vector<double> sk = x - x0, yk = g - g0;
+    double sy = dot_product(sk, yk);
+    if (sy > 1e-16 * yk.squared_magnitude()) {
+      newest = (newest + 1) % m;
+      s[newest] = sk;
+      y[newest] = yk;
+      rho[newest] = 1.0 / sy;
+      if (stored < m) ++stored;
+    }
+
+    if (this->report_iter()) {
+      failure_code_ = FAILED_USER_REQUEST;
+      ok = false;
+      break;
+    }
+
+    if (this->num_evaluations_ > get_max_function_evals()) {
+      failure_code_ = TOO_MANY_ITERATIONS;
+      ok = false;
+      break;
+    }
+  }
+  this->end_error_ = f;
+  return ok;
+}
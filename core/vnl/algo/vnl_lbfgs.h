@@ -68,8 +68,16 @@ class vnl_lbfgs : public vnl_nonlinear_minimizer
   // single evaluation.
   double default_step_length;
 
+  //: Number of line search steps evaluated together.
+  // If positive, minimize() uses its own L-BFGS iteration with a
+  // vnl_batch_line_search, which passes this many trial steps to each call
+  // of vnl_cost_function::compute_batch.  The default, 0, uses the netlib
+  // routine, which evaluates one point at a time.
+  int line_search_batch_size;
+
  private:
   void init_parameters();
+  bool minimize_batched(vnl_vector<double>& x);
   vnl_cost_function* f_;
   //  vnl_lbfgs() {} // default constructor makes no sense
   // does too.  Can set values for parameters.
@@ -91,6 +91,8 @@ void vnl_levenberg_marquardt::lmdif_lsqfun(long* n,     // I   Number of residua
                << x[0] << ", " << x[1] << ", " << x[2] << ", " << x[3] << ", "
                << x[4] << ", ... ] = " << ref_fx.magnitude() << '\n';
 
+    // MINPACK reports each accepted point with its residuals
+    f->cache_evaluation(ref_x, ref_fx);
     f->trace(self->num_iterations_, ref_x, ref_fx);
     ++(self->num_iterations_);
   } else {
@@ -167,6 +169,7 @@ bool vnl_levenberg_marquardt::minimize_without_gradient(vnl_vector<double>& x)
   set_covariance_ = false;
   long info;
   start_error_ = 0; // Set to 0 so first call to lmdif_lsqfun will know to set it.
+  f_->clear_cache();
   v3p_netlib_lmdif_(
          lmdif_lsqfun, &m, &n,
          x.data_block(),
@@ -235,6 +238,8 @@ void vnl_levenberg_marquardt::lmder_lsqfun(long* n,     // I   Number of residua
     ++(self->num_iterations_);
   }
   else if (*iflag == 2) {
+    // the Jacobian is only requested at accepted points, with fx = f(x)
+    f->cache_evaluation(ref_x, ref_fx);
     f->gradf(ref_x, ref_fJ);
     ref_fJ.inplace_transpose();
 
@@ -249,7 +254,8 @@ void vnl_levenberg_marquardt::lmder_lsqfun(long* n,     // I   Number of residua
       vnl_vector<double> wa1( *n );
       long info=1;
       double diff;
-      f->f( ref_x, feval );
+      if (!f->cached_f( ref_x, feval ))
+        f->f( ref_x, feval );
       v3p_netlib_fdjac2_(
               lmdif_lsqfun, n, p, x,
               feval.data_block(),
@@ -304,6 +310,7 @@ bool vnl_levenberg_marquardt::minimize_using_gradient(vnl_vector<double>& x)
   set_covariance_ = false;
   long info;
   start_error_ = 0; // Set to 0 so first call to lmder_lsqfun will know to set it.
+  f_->clear_cache();
 
 
   double factor = 100;
@@ -0,0 +1,94 @@
+// This is core/vnl/algo/vnl_multistart.cxx
+//:
+// \file
+//
+//-----------------------------------------------------------------------------
+
+#include "vnl_multistart.h"
+#include <vcl_cassert.h>
+#include <vcl_compiler.h>
+#include <vnl/algo/vnl_lbfgs.h>
+#include <vnl/algo/vnl_conjugate_gradient.h>
+
+vnl_multistart::vnl_multistart(vnl_cost_function& f, method m)
+  : local_method(m), memory(5), line_search_batch_size(0), f_(1, &f), best_(0)
+{
+}
+
+vnl_multistart::vnl_multistart(std::vector<vnl_cost_function*> const& f, method m)
+  : local_method(m), memory(5), line_search_batch_size(0), f_(f), best_(0)
+{
+  assert(!f_.empty());
+}
+
+bool vnl_multistart::minimize(vnl_matrix<double> const& starts, vnl_vector<double>& x)
+{
+  const int n = starts.rows();
+  assert(n > 0);
+  assert(f_.size() == 1 || f_.size() >= starts.rows());
+  assert(int(starts.cols()) == f_[0]->get_number_of_unknowns());
+
+  results_ = starts;
+  result_errors_.set_size(n);
+  result_codes_.assign(n, ERROR_FAILURE);
+  std::vector<double> start_errors(n);
+  std::vector<long> evaluations(n);
+  std::vector<unsigned> iterations(n);
+  std::vector<char> succeeded(n);
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int i = 0; i < n; ++i) {
+    vnl_cost_function& f = *f_[f_.size() == 1 ? 0 : i];
+    vnl_vector<double> xi = starts.get_row(i);
+    vnl_nonlinear_minimizer* local;
+    vnl_lbfgs lb(f);
+    vnl_conjugate_gradient cg(f);
+    if (local_method == lbfgs) {
+      lb.memory = memory;
+      lb.line_search_batch_size = line_search_batch_size;
+      local = &lb;
+    }
+    else {
+      cg.set_line_search_batch_size(line_search_batch_size);
+      local = &cg;
+    }
+    local->set_f_tolerance(ftol);
+    local->set_x_tolerance(xtol);
+    local->set_g_tolerance(gtol);
+    local->set_epsilon_function(epsfcn);
+    local->set_max_function_evals(maxfev);
+    local->set_trace(trace);
+    local->set_verbose(verbose_);
+
+    succeeded[i] = local_method == lbfgs ? lb.minimize(xi) : cg.minimize(xi);
+
+    results_.set_row(i, xi);
+    result_errors_[i] = local->get_end_error();
+    result_codes_[i] = local->get_failure_code();
+    start_errors[i] = local->get_start_error();
+    evaluations[i] = local->get_num_evaluations();
+    iterations[i] = local->get_num_iterations();
+  }
+
+  // Prefer the lowest successful minimum; fall back to the lowest point.
+  best_ = 0;
+  bool found = false;
+  num_evaluations_ = 0;
+  num_iterations_ = 0;
+  for (int i = 0; i < n; ++i) {
+    num_evaluations_ += evaluations[i];
+    num_iterations_ += iterations[i];
+    bool ok = succeeded[i] != 0;
+    if ((ok && !found) || (ok == found && result_errors_[i] < result_errors_[best_])) {
+      best_ = i;
+      found = ok;
+    }
+  }
+  x = results_.get_row(best_);
+  start_error_ = start_errors[best_];
+  end_error_ = result_errors_[best_];
+  failure_code_ = result_codes_[best_];
+  return found;
+}
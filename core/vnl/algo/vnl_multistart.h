@@ -0,0 +1,83 @@
+// This is core/vnl/algo/vnl_multistart.h
+#ifndef vnl_multistart_h_
+#define vnl_multistart_h_
+//:
+// \file
+// \brief Minimise a cost function from several starting points concurrently
+//
+//    Functions with many local minima are often minimised from a number of
+//    starting points, keeping the best result.  The minimisations are
+//    independent, so when vnl_algo is built with VNL_CONFIG_ENABLE_OPENMP
+//    they run on separate threads.
+//
+//    The cost function is then called from several threads at once.  Either
+//    its compute() must be safe for that, or a separate function object
+//    is given for each start.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vector>
+#include <vcl_compiler.h>
+#include <vnl/vnl_vector.h>
+#include <vnl/vnl_matrix.h>
+#include <vnl/vnl_cost_function.h>
+#include <vnl/vnl_nonlinear_minimizer.h>
+
+//: Minimise a cost function from several starting points concurrently
+//  The tolerances, maximum number of evaluations and trace settings of this
+//  object are passed on to the minimiser of each start.  After minimize(),
+//  get_start_error(), get_end_error() and get_failure_code() refer to the
+//  start with the lowest end error, and get_num_evaluations() and
+//  get_num_iterations() are totals over all starts.
+class vnl_multistart : public vnl_nonlinear_minimizer
+{
+ public:
+  //: Local minimiser used for each start.
+  enum method { lbfgs, conjugate_gradient };
+
+  //: Minimise f, which must be safe to call from several threads.
+  vnl_multistart(vnl_cost_function& f, method m = lbfgs);
+
+  //: Minimise f[i] from the i-th start.
+  //  All functions must have the same number of unknowns.  If f holds a
+  //  single function it is used for all starts.
+  vnl_multistart(std::vector<vnl_cost_function*> const& f, method m = lbfgs);
+
+  //: Minimise from each row of starts, and set x to the best minimum found.
+  //  Returns false if none of the minimisations succeeded, in which case
+  //  x is still set to the lowest point reached.
+  bool minimize(vnl_matrix<double> const& starts, vnl_vector<double>& x);
+
+  //: Point reached from each start, one per row.
+  vnl_matrix<double> const& get_results() const { return results_; }
+
+  //: Function value at each point of get_results().
+  vnl_vector<double> const& get_result_errors() const { return result_errors_; }
+
+  //: Failure code of the minimisation from each start.
+  std::vector<ReturnCodes> const& get_result_codes() const { return result_codes_; }
+
+  //: Index of the start that gave the lowest value.
+  unsigned int get_best_start() const { return best_; }
+
+  //: Local minimiser used for each start; default lbfgs.
+  method local_method;
+
+  //: Number of correction vectors kept by vnl_lbfgs; default 5.
+  int memory;
+
+  //: Trial steps evaluated together by the line searches; default 0.
+  //  See vnl_lbfgs::line_search_batch_size.
+  int line_search_batch_size;
+
+ private:
+  std::vector<vnl_cost_function*> f_;
+  vnl_matrix<double> results_;
+  vnl_vector<double> result_errors_;
+  std::vector<ReturnCodes> result_codes_;
+  unsigned int best_;
+};
+
+#endif // vnl_multistart_h_
@@ -0,0 +1,307 @@
+// This is core/vnl/algo/vnl_randomized_svd.cxx
+//:
+// \file
+//
+// The basis is held as the rows of a matrix Qt, so that the products with
+// the rows of A are vnl_fastops calls on row-major data.  Every access to A
+// goes through a row_source; a vnl_matrix is a source with a single block.
+//
+//-----------------------------------------------------------------------------
+
+#include <cmath>
+#include <algorithm>
+#include "vnl_randomized_svd.h"
+#include <vcl_compiler.h>
+#include <vcl_cassert.h>
+#include <vnl/vnl_c_vector.h>
+#include <vnl/vnl_fastops.h>
+#include <vnl/vnl_math.h>
+#include <vnl/vnl_random.h>
+#include <vnl/algo/vnl_svd.h>
+#include <vnl/algo/vnl_symmetric_eigensystem.h>
+
+//: Number of Gaussian test vectors for error_estimate()
+static const unsigned int vnl_randomized_svd_num_test_vectors = 10;
+
+//: A vnl_matrix seen as a single block of rows
+class vnl_randomized_svd_dense_source : public vnl_randomized_svd::row_source
+{
+ public:
+  vnl_randomized_svd_dense_source(vnl_matrix<double> const& A) : A_(A), done_(false) {}
+  unsigned int rows() const { return A_.rows(); }
+  unsigned int cols() const { return A_.cols(); }
+  void reset() { done_ = false; }
+  vnl_matrix<double> const* next_block()
+  {
+    if (done_)
+      return VXL_NULLPTR;
+    done_ = true;
+    return &A_;
+  }
+
+ private:
+  vnl_matrix<double> const& A_;
+  bool done_;
+};
+
+//: Orthonormalise rows first to last-1 of Qt against all earlier rows.
+//  Classical Gram-Schmidt is applied twice, which is enough to keep the rows
+//  orthogonal to working precision.  A row that is (nearly) dependent on the
+//  earlier ones is replaced by a random vector.
+static void vnl_randomized_svd_orthonormalize(vnl_matrix<double>& Qt,
+                                              unsigned int first, unsigned int last,
+                                              vnl_random& rng)
+{
+  const unsigned int n = Qt.cols();
+  for (unsigned int i = first; i < last; ++i)
+  {
+    double* q = Qt[i];
+    for (int attempt = 0; attempt < 3; ++attempt)
+    {
+      const double norm0 = vnl_c_vector<double>::two_norm(q, n);
+      for (int pass = 0; pass < 2; ++pass)
+        for (unsigned int j = 0; j < i; ++j)
+          vnl_c_vector<double>::saxpy(-vnl_c_vector<double>::dot_product(Qt[j], q, n), Qt[j], q, n);
+      const double norm = vnl_c_vector<double>::two_norm(q, n);
+      if (norm > 1e-10 * norm0 && norm > 0.0)
+      {
+        vnl_c_vector<double>::scale(q, q, n, 1.0 / norm);
+        break;
+      }
+      for (unsigned int j = 0; j < n; ++j)
+        q[j] = rng.normal();
+    }
+  }
+}
+
+vnl_randomized_svd::vnl_randomized_svd(unsigned int rank)
+  : rank_(rank), oversampling_(10), power_iterations_(2), method_(range_finder),
+    subtract_mean_(false), seed_(9667566), error_estimate_(0.0)
+{
+}
+
+void vnl_randomized_svd::compute_mean(row_source& source)
+{
+  mean_.clear();
+  if (!subtract_mean_)
+    return;
+  const unsigned int n = source.cols();
+  mean_.set_size(n);
+  mean_.fill(0.0);
+  unsigned int rows = 0;
+  source.reset();
+  for (vnl_matrix<double> const* B = source.next_block(); B; B = source.next_block())
+  {
+    assert(B->cols() == n);
+    for (unsigned int r = 0; r < B->rows(); ++r)
+      vnl_c_vector<double>::add(mean_.data_block(), (*B)[r], mean_.data_block(), n);
+    rows += B->rows();
+  }
+  if (rows > 0)
+    mean_ /= double(rows);
+}
+
+//: Set P = (block - 1 mean') Xt'
+void vnl_randomized_svd::times(vnl_matrix<double> const& block, vnl_matrix<double> const& Xt,
+                               vnl_matrix<double>& P) const
+{
+  vnl_fastops::ABt(P, block, Xt);
+  if (mean_.empty())
+    return;
+  vnl_vector<double> mx = Xt * mean_;
+  for (unsigned int r = 0; r < P.rows(); ++r)
+    vnl_c_vector<double>::subtract(P[r], mx.data_block(), P[r], P.cols());
+}
+
+void vnl_randomized_svd::gram_times(row_source& source, vnl_matrix<double> const& Xt,
+                                    vnl_matrix<double>& Zt) const
+{
+  Zt.set_size(Xt.rows(), Xt.cols());
+  Zt.fill(0.0);
+  vnl_vector<double> s(Xt.rows(), 0.0);
+  vnl_matrix<double> P;
+  source.reset();
+  for (vnl_matrix<double> const* B = source.next_block(); B; B = source.next_block())
+  {
+    assert(B->cols() == Xt.cols());
+    times(*B, Xt, P);
+    vnl_fastops::inc_X_by_AtB(Zt, P, *B);  // Zt += P' B
+    if (!mean_.empty())
+      for (unsigned int r = 0; r < P.rows(); ++r)
+        vnl_c_vector<double>::add(s.data_block(), P[r], s.data_block(), P.cols());
+  }
+  // Zt -= s mean', the mean's share of P' (B - 1 mean')
+  if (!mean_.empty())
+    for (unsigned int c = 0; c < Zt.rows(); ++c)
+      vnl_c_vector<double>::saxpy(-s[c], mean_.data_block(), Zt[c], Zt.cols());
+}
+
+void vnl_randomized_svd::find_basis(row_source& source, unsigned int l,
+                                    vnl_matrix<double>& Qt) const
+{
+  const unsigned int n = source.cols();
+  vnl_random rng(seed_);
+  Qt.set_size(l, n);
+
+  if (method_ == range_finder)
+  {
+    // A'A applied to Gaussian vectors spans the range of A'; each power
+    // iteration applies A'A once more to sharpen the leading directions.
+    for (unsigned int i = 0; i < l; ++i)
+      for (unsigned int j = 0; j < n; ++j)
+        Qt(i,j) = rng.normal();
+    vnl_matrix<double> Zt;
+    for (unsigned int it = 0; it <= power_iterations_; ++it)
+    {
+      gram_times(source, Qt, Zt);
+      Qt.swap(Zt);
+      vnl_randomized_svd_orthonormalize(Qt, 0, l, rng);
+    }
+  }
+  else
+  {
+    // Krylov basis of A'A from a Gaussian vector, i.e. Lanczos with full
+    // reorthogonalisation; the tridiagonal matrix is not needed since the
+    // Rayleigh-Ritz step works from the basis itself.
+    for (unsigned int j = 0; j < n; ++j)
+      Qt(0,j) = rng.normal();
+    vnl_randomized_svd_orthonormalize(Qt, 0, 1, rng);
+    vnl_matrix<double> q(1, n), z;
+    for (unsigned int i = 1; i < l; ++i)
+    {
+      q.set_row(0, Qt[i-1]);
+      gram_times(source, q, z);
+      Qt.set_row(i, z[0]);
+      vnl_randomized_svd_orthonormalize(Qt, i, i+1, rng);
+    }
+  }
+}
+
+void vnl_randomized_svd::estimate_error(row_source& source)
+{
+  const unsigned int n = source.cols();
+  const unsigned int r = vnl_randomized_svd_num_test_vectors;
+  vnl_random rng(seed_ + 1);
+  vnl_matrix<double> Ot(r, n);
+  for (unsigned int i = 0; i < r; ++i)
+    for (unsigned int j = 0; j < n; ++j)
+      Ot(i,j) = rng.normal();
+  // project the test vectors onto the orthogonal complement of V
+  vnl_matrix<double> T;
+  vnl_fastops::AB(T, Ot, V_);
+  vnl_fastops::dec_X_by_ABt(Ot, T, V_);
+
+  vnl_vector<double> sq(r, 0.0);
+  vnl_matrix<double> P;
+  source.reset();
+  for (vnl_matrix<double> const* B = source.next_block(); B; B = source.next_block())
+  {
+    times(*B, Ot, P);
+    for (unsigned int i = 0; i < P.rows(); ++i)
+      for (unsigned int c = 0; c < r; ++c)
+        sq[c] += P(i,c) * P(i,c);
+  }
+  // Halko et al., lemma 4.1: fails with probability at most 10^-r
+  error_estimate_ = 10.0 * std::sqrt(2.0 / vnl_math::pi) * std::sqrt(sq.max_value());
+}
+
+void vnl_randomized_svd::compute(vnl_matrix<double> const& A)
+{
+  vnl_randomized_svd_dense_source source(A);
+  compute_mean(source);
+  const unsigned int m = A.rows(), n = A.cols();
+  const unsigned int l = std::min(rank_ + oversampling_, std::min(m, n));
+  const unsigned int k = std::min(rank_, l);
+  if (l == 0)
+  {
+    U_.set_size(m, 0);
+    W_.clear();
+    V_.set_size(n, 0);
+    error_estimate_ = 0.0;
+    return;
+  }
+
+  vnl_matrix<double> Qt;
+  find_basis(source, l, Qt);
+
+  // Rayleigh-Ritz: the SVD of the m x l matrix (A - 1 mean') Q
+  vnl_matrix<double> C;
+  times(A, Qt, C);
+  vnl_svd<double> svd(C);
+  U_ = svd.U().extract(m, k);
+  W_.set_size(k);
+  for (unsigned int c = 0; c < k; ++c)
+    W_[c] = svd.W(c);
+  vnl_fastops::AtB(V_, Qt, svd.V().extract(l, k));
+
+  estimate_error(source);
+}
+
+void vnl_randomized_svd::compute(row_source& source)
+{
+  compute_mean(source);
+  const unsigned int m = source.rows(), n = source.cols();
+  const unsigned int l = std::min(rank_ + oversampling_, std::min(m, n));
+  const unsigned int k = std::min(rank_, l);
+  U_.clear();
+  if (l == 0)
+  {
+    W_.clear();
+    V_.set_size(n, 0);
+    error_estimate_ = 0.0;
+    return;
+  }
+
+  vnl_matrix<double> Qt;
+  find_basis(source, l, Qt);
+
+  // Rayleigh-Ritz: the eigensystem of the l x l matrix Q' A' A Q, summed
+  // over the blocks (with the mean removed).
+  vnl_matrix<double> G(l, l, 0.0), P;
+  source.reset();
+  for (vnl_matrix<double> const* B = source.next_block(); B; B = source.next_block())
+  {
+    times(*B, Qt, P);
+    vnl_fastops::inc_X_by_AtA(G, P);
+  }
+  vnl_symmetric_eigensystem<double> eig(G);  // increasing eigenvalues
+  vnl_matrix<double> E(l, k);
+  W_.set_size(k);
+  for (unsigned int c = 0; c < k; ++c)
+  {
+    W_[c] = std::sqrt(std::max(eig.get_eigenvalue(l-1-c), 0.0));
+    E.set_column(c, eig.get_eigenvector(l-1-c));
+  }
+  vnl_fastops::AtB(V_, Qt, E);
+
+  estimate_error(source);
+}
+
+vnl_matrix<double> vnl_randomized_svd::project(vnl_matrix<double> const& rows) const
+{
+  assert(rows.cols() == V_.rows());
+  vnl_matrix<double> P;
+  vnl_fastops::AB(P, rows, V_);
+  if (!mean_.empty())
+  {
+    vnl_vector<double> mv = mean_ * V_;
+    for (unsigned int r = 0; r < P.rows(); ++r)
+      vnl_c_vector<double>::subtract(P[r], mv.data_block(), P[r], P.cols());
+  }
+  return P;
+}
+
+vnl_matrix<double> vnl_randomized_svd::recompose() const
+{
+  assert(U_.cols() == W_.size());
+  vnl_matrix<double> US(U_);
+  for (unsigned int r = 0; r < US.rows(); ++r)
+    for (unsigned int c = 0; c < US.cols(); ++c)
+      US(r,c) *= W_[c];
+  vnl_matrix<double> A;
+  vnl_fastops::ABt(A, US, V_);
+  if (!mean_.empty())
+    for (unsigned int r = 0; r < A.rows(); ++r)
+      vnl_c_vector<double>::add(A[r], mean_.data_block(), A[r], A.cols());
+  return A;
+}
@@ -0,0 +1,139 @@
+// This is core/vnl/algo/vnl_randomized_svd.h
+#ifndef vnl_randomized_svd_h_
+#define vnl_randomized_svd_h_
+//:
+// \file
+// \brief Truncated SVD and PCA of a large matrix by randomised projection
+//
+//    For an m x n matrix A of which only the leading k singular triplets are
+//    wanted, vnl_svd does far too much work.  vnl_randomized_svd instead finds
+//    an orthonormal basis Q of l = k + p vectors (p the oversampling) which
+//    nearly spans the leading right singular subspace of A, and then solves
+//    the small problem A Q exactly (Rayleigh-Ritz).  Q comes either from a
+//    block power iteration with a Gaussian start, or from a Lanczos (Krylov)
+//    basis for A'A with full reorthogonalisation.  See Halko, Martinsson and
+//    Tropp, "Finding structure with randomness", SIAM Review 53(2), 2011.
+//
+//    A may be a vnl_matrix, or a row_source which delivers the rows a block
+//    at a time, so that a matrix too large for memory is read in passes: one
+//    per power iteration (or per Lanczos vector), plus two more.  For a
+//    row_source, U is not formed; project() maps rows onto the components.
+//
+//    With set_subtract_mean(true) the column means are removed first, which
+//    gives the principal components of the rows of A.
+//
+//    error_estimate() bounds the spectral norm of the residual
+//    A - U diag(W) V' with probability at least 1 - 10^-10.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vnl/vnl_vector.h>
+#include <vnl/vnl_matrix.h>
+
+//: Truncated SVD and PCA of a large matrix by randomised projection.
+//  \code
+//    vnl_randomized_svd svd(20);
+//    svd.set_subtract_mean(true);
+//    svd.compute(data);            // data is 100000 x 2000
+//    vnl_matrix<double> modes = svd.V();
+//  \endcode
+class vnl_randomized_svd
+{
+ public:
+  //: How the basis Q is found
+  enum Method {
+    range_finder,  //!< block power iteration from a Gaussian start
+    lanczos        //!< Lanczos basis of A'A, one vector per pass
+  };
+
+  //: A matrix read a block of rows at a time.
+  class row_source
+  {
+   public:
+    virtual ~row_source() {}
+    //: Number of rows of the matrix
+    virtual unsigned int rows() const = 0;
+    //: Number of columns of the matrix
+    virtual unsigned int cols() const = 0;
+    //: Start a new pass over the rows
+    virtual void reset() = 0;
+    //: The next block of rows (each with cols() columns), or a null pointer after the last.
+    //  The block need only stay valid until the next call.
+    virtual vnl_matrix<double> const* next_block() = 0;
+  };
+
+  //: Prepare to find the leading rank singular triplets.
+  vnl_randomized_svd(unsigned int rank);
+
+  //: Number of extra basis vectors (default 10)
+  void set_oversampling(unsigned int p) { oversampling_ = p; }
+  //: Number of power iterations for range_finder (default 2)
+  void set_power_iterations(unsigned int q) { power_iterations_ = q; }
+  //: Choice of basis (default range_finder)
+  void set_method(Method method) { method_ = method; }
+  //: Remove the column means before decomposing (default false)
+  void set_subtract_mean(bool subtract) { subtract_mean_ = subtract; }
+  //: Seed for the random start (default fixed, so results are repeatable)
+  void set_seed(unsigned long seed) { seed_ = seed; }
+
+  //: Decompose A.
+  void compute(vnl_matrix<double> const& A);
+
+  //: Decompose the matrix delivered by source; U() is left empty.
+  void compute(row_source& source);
+
+  //: Number of singular triplets found; at most min(rows, cols).
+  unsigned int rank() const { return W_.size(); }
+
+  //: Left singular vectors, one per column (only after compute(vnl_matrix))
+  vnl_matrix<double> const& U() const { return U_; }
+
+  //: Singular values in decreasing order
+  vnl_vector<double> const& W() const { return W_; }
+
+  //: Right singular vectors, one per column
+  vnl_matrix<double> const& V() const { return V_; }
+
+  //: Column means removed before decomposing, or empty
+  vnl_vector<double> const& mean() const { return mean_; }
+
+  //: Probabilistic upper bound on the spectral norm of A - U diag(W) V' (after removing the mean)
+  double error_estimate() const { return error_estimate_; }
+
+  //: Coordinates of some rows of A in the basis V, i.e. (rows - mean) V
+  vnl_matrix<double> project(vnl_matrix<double> const& rows) const;
+
+  //: U diag(W) V', plus the mean if it was removed
+  vnl_matrix<double> recompose() const;
+
+ private:
+  //: Fill mean_ if required.
+  void compute_mean(row_source& source);
+  //: Set P = (block - 1 mean') Xt'.  Xt holds a vector in each row.
+  void times(vnl_matrix<double> const& block, vnl_matrix<double> const& Xt,
+             vnl_matrix<double>& P) const;
+  //: Set Zt = Xt (A - 1 mean')' (A - 1 mean'); one pass.
+  void gram_times(row_source& source, vnl_matrix<double> const& Xt,
+                  vnl_matrix<double>& Zt) const;
+  //: Find the orthonormal rows of Qt spanning the leading right singular subspace.
+  void find_basis(row_source& source, unsigned int l, vnl_matrix<double>& Qt) const;
+  //: Estimate the residual norm from Gaussian test vectors; one pass.
+  void estimate_error(row_source& source);
+
+  unsigned int rank_;
+  unsigned int oversampling_;
+  unsigned int power_iterations_;
+  Method method_;
+  bool subtract_mean_;
+  unsigned long seed_;
+
+  vnl_matrix<double> U_;
+  vnl_vector<double> W_;
+  vnl_matrix<double> V_;
+  vnl_vector<double> mean_;
+  double error_estimate_;
+};
+
+#endif // vnl_randomized_svd_h_
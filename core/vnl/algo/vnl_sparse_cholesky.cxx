@@ -0,0 +1,274 @@
+// This is core/vnl/algo/vnl_sparse_cholesky.cxx
+//:
+// \file
+//
+// The symbolic and numeric phases follow the simplicial up-looking LDL'
+// algorithm: row k of L is found by a triangular solve whose pattern is the
+// set of elimination tree paths from the non-zeros of column k of the upper
+// triangle of P M P' up to k.
+//
+//-----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <utility>
+#include "vnl_sparse_cholesky.h"
+#include <vcl_compiler.h>
+#include <vcl_cassert.h>
+
+vnl_sparse_cholesky::vnl_sparse_cholesky(Ordering ordering)
+  : ordering_(ordering), n_(0), failed_column_(-2)
+{
+}
+
+vnl_sparse_cholesky::vnl_sparse_cholesky(vnl_sparse_matrix<double> const& M, Ordering ordering)
+  : ordering_(ordering), n_(0), failed_column_(-2)
+{
+  factor(M);
+}
+
+//: Greedy minimum degree ordering.
+// The elimination graph is held explicitly: eliminating a node joins its
+// remaining neighbours into a clique.  Ties go to the lowest index, so the
+// ordering is deterministic.
+void vnl_sparse_cholesky::order(vnl_sparse_matrix<double> const& M)
+{
+  perm_.resize(n_);
+  if (ordering_ == natural) {
+    for (unsigned int k = 0; k < n_; ++k)
+      perm_[k] = int(k);
+    return;
+  }
+
+  std::vector<std::vector<int> > adj(n_);
+  for (unsigned int r = 0; r < n_; ++r) {
+    vnl_sparse_matrix<double>::row const& rw = M.get_row(r);
+    for (vnl_sparse_matrix<double>::row::const_iterator it = rw.begin(); it != rw.end(); ++it)
+      if (it->first < r) {
+        adj[r].push_back(int(it->first));
+        adj[it->first].push_back(int(r));
+      }
+  }
+  std::set<std::pair<std::size_t, int> > queue;
+  for (unsigned int i = 0; i < n_; ++i) {
+    std::sort(adj[i].begin(), adj[i].end());
+    adj[i].erase(std::unique(adj[i].begin(), adj[i].end()), adj[i].end());
+    queue.insert(std::make_pair(adj[i].size(), int(i)));
+  }
+
+  std::vector<int> merged;
+  for (unsigned int k = 0; k < n_; ++k) {
+    const int v = queue.begin()->second;
+    queue.erase(queue.begin());
+    perm_[k] = v;
+    std::vector<int> const& nbrs = adj[v];
+    for (std::vector<int>::const_iterator u = nbrs.begin(); u != nbrs.end(); ++u) {
+      queue.erase(std::make_pair(adj[*u].size(), *u));
+      merged.clear();
+      std::set_union(adj[*u].begin(), adj[*u].end(), nbrs.begin(), nbrs.end(),
+                     std::back_inserter(merged));
+      std::vector<int>::iterator end = std::remove(merged.begin(), merged.end(), *u);
+      end = std::remove(merged.begin(), end, v);
+      adj[*u].assign(merged.begin(), end);
+      queue.insert(std::make_pair(adj[*u].size(), *u));
+    }
+    std::vector<int>().swap(adj[v]);
+  }
+}
+
+void vnl_sparse_cholesky::permuted_upper(vnl_sparse_matrix<double> const& M)
+{
+  Mp_.assign(n_+1, 0);
+  for (unsigned int r = 0; r < n_; ++r) {
+    vnl_sparse_matrix<double>::row const& rw = M.get_row(r);
+    for (vnl_sparse_matrix<double>::row::const_iterator it = rw.begin(); it != rw.end(); ++it)
+      if (it->first <= r)
+        ++Mp_[std::max(pinv_[r], pinv_[it->first]) + 1];
+  }
+  for (unsigned int k = 0; k < n_; ++k)
+    Mp_[k+1] += Mp_[k];
+  Mi_.resize(Mp_[n_]);
+  Mx_.resize(Mp_[n_]);
+  std::vector<int> next(Mp_.begin(), Mp_.end()-1);
+  for (unsigned int r = 0; r < n_; ++r) {
+    vnl_sparse_matrix<double>::row const& rw = M.get_row(r);
+    for (vnl_sparse_matrix<double>::row::const_iterator it = rw.begin(); it != rw.end(); ++it)
+      if (it->first <= r) {
+        int i = pinv_[r], j = pinv_[it->first];
+        int p = next[std::max(i, j)]++;
+        Mi_[p] = std::min(i, j);
+        Mx_[p] = it->second;
+      }
+  }
+}
+
+bool vnl_sparse_cholesky::same_pattern(vnl_sparse_matrix<double> const& M) const
+{
+  if (M.rows() != n_ || M.cols() != n_)
+    return false;
+  for (unsigned int r = 0; r < n_; ++r) {
+    vnl_sparse_matrix<double>::row const& rw = M.get_row(r);
+    int p = pattern_ptr_[r];
+    for (vnl_sparse_matrix<double>::row::const_iterator it = rw.begin(); it != rw.end(); ++it)
+      if (it->first <= r)
+        if (p == pattern_ptr_[r+1] || pattern_col_[p++] != int(it->first))
+          return false;
+    if (p != pattern_ptr_[r+1])
+      return false;
+  }
+  return true;
+}
+
+void vnl_sparse_cholesky::analyse(vnl_sparse_matrix<double> const& M)
+{
+  assert(M.rows() == M.cols());
+  n_ = M.rows();
+
+  pattern_ptr_.assign(1, 0);
+  pattern_col_.clear();
+  for (unsigned int r = 0; r < n_; ++r) {
+    vnl_sparse_matrix<double>::row const& rw = M.get_row(r);
+    for (vnl_sparse_matrix<double>::row::const_iterator it = rw.begin(); it != rw.end(); ++it)
+      if (it->first <= r)
+        pattern_col_.push_back(int(it->first));
+    pattern_ptr_.push_back(int(pattern_col_.size()));
+  }
+
+  order(M);
+  pinv_.resize(n_);
+  for (unsigned int k = 0; k < n_; ++k)
+    pinv_[perm_[k]] = int(k);
+  permuted_upper(M);
+
+  // Elimination tree and the number of non-zeros in each column of L.
+  parent_.assign(n_, -1);
+  Lnz_.assign(n_, 0);
+  std::vector<int> flag(n_);
+  for (unsigned int k = 0; k < n_; ++k) {
+    flag[k] = int(k);
+    for (int p = Mp_[k]; p < Mp_[k+1]; ++p)
+      for (int i = Mi_[p]; flag[i] != int(k); i = parent_[i]) {
+        if (parent_[i] == -1)
+          parent_[i] = int(k);
+        ++Lnz_[i];
+        flag[i] = int(k);
+      }
+  }
+  Lp_.assign(n_+1, 0);
+  for (unsigned int k = 0; k < n_; ++k)
+    Lp_[k+1] = Lp_[k] + Lnz_[k];
+  Li_.resize(Lp_[n_]);
+  Lx_.resize(Lp_[n_]);
+  D_.set_size(n_);
+  failed_column_ = -2;
+}
+
+bool vnl_sparse_cholesky::factor(vnl_sparse_matrix<double> const& M)
+{
+  if (Lp_.empty() || !same_pattern(M))
+    analyse(M);
+  else
+    permuted_upper(M);
+
+  std::vector<double> y(n_, 0.0);
+  std::vector<int> pattern(n_), flag(n_);
+  for (unsigned int k = 0; k < n_; ++k) {
+    // Scatter column k of the upper triangle and find the pattern of row k of L.
+    int top = int(n_);
+    flag[k] = int(k);
+    Lnz_[k] = 0;
+    for (int p = Mp_[k]; p < Mp_[k+1]; ++p) {
+      int i = Mi_[p];
+      y[i] += Mx_[p];
+      int len = 0;
+      for (; flag[i] != int(k); i = parent_[i]) {
+        pattern[len++] = i;
+        flag[i] = int(k);
+      }
+      while (len > 0)
+        pattern[--top] = pattern[--len];
+    }
+    // Sparse triangular solve for row k of L, and the pivot D(k).
+    double d = y[k];
+    y[k] = 0.0;
+    for (; top < int(n_); ++top) {
+      const int i = pattern[top];
+      const double yi = y[i];
+      y[i] = 0.0;
+      const int p2 = Lp_[i] + Lnz_[i];
+      for (int p = Lp_[i]; p < p2; ++p)
+        y[Li_[p]] -= Lx_[p] * yi;
+      const double l_ki = yi / D_[i];
+      d -= l_ki * yi;
+      Li_[p2] = int(k);
+      Lx_[p2] = l_ki;
+      ++Lnz_[i];
+    }
+    D_[k] = d;
+    if (d == 0.0) {
+      failed_column_ = int(k);
+      return false;
+    }
+  }
+  failed_column_ = -1;
+  return true;
+}
+
+bool vnl_sparse_cholesky::positive_definite() const
+{
+  if (!factored())
+    return false;
+  for (unsigned int k = 0; k < n_; ++k)
+    if (!(D_[k] > 0.0))
+      return false;
+  return true;
+}
+
+void vnl_sparse_cholesky::solve(vnl_vector<double> const& b, vnl_vector<double>* x) const
+{
+  assert(factored());
+  assert(b.size() == n_);
+  vnl_vector<double> y(n_);
+  for (unsigned int k = 0; k < n_; ++k)
+    y[k] = b[perm_[k]];
+  for (unsigned int j = 0; j < n_; ++j)
+    for (int p = Lp_[j]; p < Lp_[j+1]; ++p)
+      y[Li_[p]] -= Lx_[p] * y[j];
+  for (unsigned int j = 0; j < n_; ++j)
+    y[j] /= D_[j];
+  for (int j = int(n_)-1; j >= 0; --j)
+    for (int p = Lp_[j]; p < Lp_[j+1]; ++p)
+      y[j] -= Lx_[p] * y[Li_[p]];
+  x->set_size(n_);
+  for (unsigned int k = 0; k < n_; ++k)
+    (*x)[perm_[k]] = y[k];
+}
+
+vnl_vector<double> vnl_sparse_cholesky::solve(vnl_vector<double> const& b) const
+{
+  vnl_vector<double> x;
+  solve(b, &x);
+  return x;
+}
+
+vnl_matrix<double> vnl_sparse_cholesky::solve(vnl_matrix<double> const& B) const
+{
+  assert(B.rows() == n_);
+  vnl_matrix<double> X(n_, B.cols());
+  vnl_vector<double> x;
+  for (unsigned int c = 0; c < B.cols(); ++c) {
+    solve(B.get_column(c), &x);
+    X.set_column(c, x);
+  }
+  return X;
+}
+
+double vnl_sparse_cholesky::determinant() const
+{
+  assert(factored());
+  double det = 1.0;
+  for (unsigned int k = 0; k < n_; ++k)
+    det *= D_[k];
+  return det;
+}
@@ -0,0 +1,124 @@
+// This is core/vnl/algo/vnl_sparse_cholesky.h
+#ifndef vnl_sparse_cholesky_h_
+#define vnl_sparse_cholesky_h_
+//:
+// \file
+// \brief Sparse LDL' decomposition of a symmetric matrix
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vector>
+#include <vnl/vnl_vector.h>
+#include <vnl/vnl_matrix.h>
+#include <vnl/vnl_sparse_matrix.h>
+
+//: Sparse LDL' decomposition of a symmetric matrix.
+//  Computes P M P' = L D L', with P a fill-reducing permutation, L unit
+//  lower triangular and D diagonal, using the simplicial up-looking
+//  algorithm.  Only the lower triangle of M (entries with column <= row) is
+//  read, so M may hold either both triangles or just the lower one.
+//
+//  The work is split in two phases.  analyse() chooses the ordering and
+//  computes the elimination tree and the non-zero count of each column of L
+//  from the pattern of M alone; factor() then computes the numbers.  A
+//  sequence of matrices with the same pattern but different values, as in
+//  the iterations of a Gauss-Newton solver, needs only one analysis:
+//  \code
+//    vnl_sparse_cholesky chol(J);            // analyse and factor
+//    for (...) {
+//      ...update the values of J...
+//      chol.factor(J);                       // reuses the analysis
+//      chol.solve(b, &x);
+//    }
+//  \endcode
+//
+//  The factorisation does not pivot, so it is meant for positive definite
+//  (and, with care, quasi-definite) matrices; factor() stops at the first
+//  zero pivot.  Use positive_definite() to check the result.
+class vnl_sparse_cholesky
+{
+ public:
+  //: Choice of fill-reducing ordering
+  enum Ordering {
+    natural,         //!< no permutation
+    minimum_degree   //!< greedy minimum degree on the elimination graph
+  };
+
+  //: Default constructor; call factor() before use.
+  vnl_sparse_cholesky(Ordering ordering = minimum_degree);
+
+  //: Analyse and factor M.
+  vnl_sparse_cholesky(vnl_sparse_matrix<double> const& M, Ordering ordering = minimum_degree);
+
+  //: Compute the ordering and symbolic factorisation for the pattern of M.
+  void analyse(vnl_sparse_matrix<double> const& M);
+
+  //: Compute the numeric factorisation of M.
+  //  The previous analysis is reused when M has the same pattern as the
+  //  analysed matrix; otherwise M is analysed first.
+  //  Returns false if a zero pivot was met.
+  bool factor(vnl_sparse_matrix<double> const& M);
+
+  //: True if the last factorisation completed.
+  bool factored() const { return failed_column_ == -1; }
+
+  //: True if the last factorisation completed with every element of D positive.
+  bool positive_definite() const;
+
+  //: Solve M x = b
+  vnl_vector<double> solve(vnl_vector<double> const& b) const;
+
+  //: Solve M x = b
+  void solve(vnl_vector<double> const& b, vnl_vector<double>* x) const;
+
+  //: Solve M X = B for each column of B
+  vnl_matrix<double> solve(vnl_matrix<double> const& B) const;
+
+  //: Compute determinant
+  double determinant() const;
+
+  //: Size of the matrix
+  unsigned int size() const { return n_; }
+
+  //: Number of non-zeros in L, excluding its unit diagonal
+  unsigned int num_non_zero_L() const { return Lp_.empty() ? 0 : (unsigned int)(Lp_[n_]); }
+
+  //: The elimination order: row k of P M P' is row permutation()[k] of M
+  std::vector<int> const& permutation() const { return perm_; }
+
+  //: The diagonal D
+  vnl_vector<double> const& D() const { return D_; }
+
+  //: The column of M at which factor() met a zero pivot, or -1
+  int failed_column() const { return failed_column_ < 0 ? -1 : perm_[failed_column_]; }
+
+ private:
+  //: Fill Mp_, Mi_ and Mx_ with the upper triangle of P M P' in column order.
+  void permuted_upper(vnl_sparse_matrix<double> const& M);
+  //: True if M has the pattern that was analysed
+  bool same_pattern(vnl_sparse_matrix<double> const& M) const;
+  //: Compute perm_ from the pattern of M
+  void order(vnl_sparse_matrix<double> const& M);
+
+  Ordering ordering_;
+  unsigned int n_;
+  //: P: perm_[k] is the row of M eliminated k-th; pinv_ is its inverse.
+  std::vector<int> perm_, pinv_;
+  //: Pattern (lower triangle, row order) of the analysed matrix
+  std::vector<int> pattern_ptr_, pattern_col_;
+  //: Upper triangle of P M P', compressed by columns
+  std::vector<int> Mp_, Mi_;
+  std::vector<double> Mx_;
+  //: Elimination tree and column counts of L
+  std::vector<int> parent_, Lnz_;
+  //: L, compressed by columns, without its unit diagonal
+  std::vector<int> Lp_, Li_;
+  std::vector<double> Lx_;
+  vnl_vector<double> D_;
+  //: -1 after a successful factor(), -2 before any, else the failing column of P M P'
+  int failed_column_;
+};
+
+#endif // vnl_sparse_cholesky_h_
@@ -11,6 +11,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <cmath>
 #include <algorithm>
 #include "vnl_sparse_lm.h"
 
@@ -76,6 +77,10 @@ void vnl_sparse_lm::init(vnl_sparse_lst_sqr_function* f)
 
   tau_ = 0.001;
 
+  use_pcg_ = false;
+  pcg_tol_ = 1e-10;
+  pcg_max_iter_ = 0;
+
   allocate_matrices();
 }
 
@@ -102,7 +107,8 @@ bool vnl_sparse_lm::minimize(vnl_vector<double>& a,
     return false;
 
   //: Systems to solve will be Sc*dc=sec and Sa*da=sea
-  vnl_matrix<double> Sc(size_c_,size_c_), Sa(size_a_, size_a_);
+  // Sa is not formed when solving with conjugate gradients
+  vnl_matrix<double> Sa(use_pcg_ ? 0 : size_a_, use_pcg_ ? 0 : size_a_);
   vnl_vector<double> sec(size_c_), sea(size_a_);
   // update vectors
   vnl_vector<double> da(size_a_), db(size_b_), dc(size_c_);
@@ -178,7 +184,20 @@ bool vnl_sparse_lm::minimize(vnl_vector<double>& a,
       // compute inv(Vj) and Yij
       compute_invV_Y();
 
-      if ( size_c_ > 0 )
+      if ( use_pcg_ )
+      {
+        // compute Z = RYt-Q and the preconditioner, then Ma = Z inv(Sa)
+        compute_Z_inv_Sd();
+        if ( size_c_ > 0 )
+        {
+          compute_Ma_pcg();
+          compute_Mb();
+          solve_dc(dc);
+        }
+        compute_sea(dc,sea);
+        pcg_solve(sea, da);
+      }
+      else if ( size_c_ > 0 )
       {
         // compute Z = RYt-Q and Sa
         compute_Z_Sa(Sa);
@@ -409,22 +428,21 @@ void vnl_sparse_lm::compute_normal_equations()
   // sparse vector iterator
   typedef vnl_crs_index::sparse_vector::iterator sv_itr;
 
-  // clear the ea and eb for summation
-  ea_.fill(0.0);
-  eb_.fill(0.0);
-  ec_.fill(0.0);
-  // clear the V for summation
-  for (unsigned int j=0; j<f_->number_of_b(); ++j)
-  {
-    V_[j].fill(0.0);
-    R_[j].fill(0.0);
-  }
-  T_.fill(0.0);
   // compute blocks T, Q, R, U, V, W, ea, eb, and ec
   // JtJ = |T  Q  R|
   //       |Qt U  W|  with U and V block diagonal
   //       |Rt Wt V|  and W with same sparsity as residuals
-  for (unsigned int i=0; i<f_->number_of_a(); ++i)
+  //
+  // Blocks indexed by i (U, Q, W, ea) are summed along the rows of the
+  // residual indices and blocks indexed by j (V, R, eb) along its columns,
+  // so each block has one writer.  T and ec are summed per row, then over
+  // the rows in order.
+  std::vector<vnl_matrix<double> > Ti(size_c_ > 0 ? num_a_ : 0);
+  std::vector<vnl_vector<double> > eci(size_c_ > 0 ? num_a_ : 0);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int i=0; i<num_a_; ++i)
   {
     vnl_matrix<double>& Ui = U_[i];
     Ui.fill(0.0);
@@ -432,32 +450,69 @@ void vnl_sparse_lm::compute_normal_equations()
     Qi.fill(0.0);
     unsigned int ai_size = f_->number_of_params_a(i);
     vnl_vector_ref<double> eai(ai_size, ea_.data_block()+f_->index_a(i));
+    eai.fill(0.0);
+    if (size_c_ > 0)
+    {
+      Ti[i].set_size(size_c_,size_c_);
+      Ti[i].fill(0.0);
+      eci[i].set_size(size_c_);
+      eci[i].fill(0.0);
+    }
 
     vnl_crs_index::sparse_vector row = crs.sparse_row(i);
     for (sv_itr r_itr=row.begin(); r_itr!=row.end(); ++r_itr)
     {
-      unsigned int j = r_itr->second;
-      unsigned int k = r_itr->first;;
+      unsigned int k = r_itr->first;
       vnl_matrix<double>& Aij = A_[k];
       vnl_matrix<double>& Bij = B_[k];
       vnl_matrix<double>& Cij = C_[k];
-      vnl_matrix<double>& Vj = V_[j];
-      vnl_matrix<double>& Rj = R_[j];
-      vnl_vector_ref<double> ebj(Bij.cols(), eb_.data_block()+f_->index_b(j));
+      vnl_vector_ref<double> eij(f_->number_of_residuals(k), e_.data_block()+f_->index_e(k));
 
-      vnl_fastops::inc_X_by_AtA(T_, Cij);       // T = C^T * C
       vnl_fastops::inc_X_by_AtA(Ui,Aij);       // Ui += A_ij^T * A_ij
-      vnl_fastops::inc_X_by_AtA(Vj,Bij);       // Vj += B_ij^T * B_ij
       vnl_fastops::AtB(W_[k],Aij,Bij);          // Wij = A_ij^T * B_ij
-      vnl_fastops::inc_X_by_AtB(Qi,Cij,Aij);   // Qi += C_ij^T * A_ij
-      vnl_fastops::inc_X_by_AtB(Rj,Cij,Bij);   // Rj += C_ij^T * B_ij
+      vnl_fastops::inc_X_by_AtB(eai,Aij,eij);  // e_a_i += A_ij^T * e_ij
+      if (size_c_ > 0)
+      {
+        vnl_fastops::inc_X_by_AtA(Ti[i],Cij);     // T += C^T * C
+        vnl_fastops::inc_X_by_AtB(Qi,Cij,Aij);    // Qi += C_ij^T * A_ij
+        vnl_fastops::inc_X_by_AtB(eci[i],Cij,eij); // e_c += C_ij^T * e_ij
+      }
+    }
+  }
 
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int j=0; j<num_b_; ++j)
+  {
+    vnl_matrix<double>& Vj = V_[j];
+    Vj.fill(0.0);
+    vnl_matrix<double>& Rj = R_[j];
+    Rj.fill(0.0);
+    vnl_vector_ref<double> ebj(f_->number_of_params_b(j), eb_.data_block()+f_->index_b(j));
+    ebj.fill(0.0);
+
+    vnl_crs_index::sparse_vector col = crs.sparse_col(j);
+    for (sv_itr c_itr=col.begin(); c_itr!=col.end(); ++c_itr)
+    {
+      unsigned int k = c_itr->first;
+      vnl_matrix<double>& Bij = B_[k];
       vnl_vector_ref<double> eij(f_->number_of_residuals(k), e_.data_block()+f_->index_e(k));
-      vnl_fastops::inc_X_by_AtB(eai,Aij,eij);  // e_a_i += A_ij^T * e_ij
+
+      vnl_fastops::inc_X_by_AtA(Vj,Bij);       // Vj += B_ij^T * B_ij
       vnl_fastops::inc_X_by_AtB(ebj,Bij,eij);  // e_b_j += B_ij^T * e_ij
-      vnl_fastops::inc_X_by_AtB(ec_,Cij,eij);   // e_c   += C_ij^T * e_ij
+      if (size_c_ > 0)
+        vnl_fastops::inc_X_by_AtB(Rj,C_[k],Bij); // Rj += C_ij^T * B_ij
     }
   }
+
+  T_.fill(0.0);
+  ec_.fill(0.0);
+  for (unsigned int i=0; i<Ti.size(); ++i)
+  {
+    T_ += Ti[i];
+    ec_ += eci[i];
+  }
 }
 
 
@@ -511,6 +566,9 @@ void vnl_sparse_lm::compute_invV_Y()
   // sparse vector iterator
   typedef vnl_crs_index::sparse_vector::iterator sv_itr;
 
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
   for (int j=0; j<num_b_; ++j) {
     vnl_matrix<double>& inv_Vj = inv_V_[j];
     vnl_cholesky Vj_cholesky(V_[j],vnl_cholesky::quiet);
@@ -542,6 +600,9 @@ void vnl_sparse_lm::compute_Z_Sa(vnl_matrix<double>& Sa)
   typedef vnl_crs_index::sparse_vector::iterator sv_itr;
 
   // compute Z = RYt-Q and Sa
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
   for (int i=0; i<num_a_; ++i)
   {
     vnl_crs_index::sparse_vector row_i = crs.sparse_row(i);
@@ -597,12 +658,15 @@ void vnl_sparse_lm::compute_Z_Sa(vnl_matrix<double>& Sa)
 void vnl_sparse_lm::compute_Ma(const vnl_matrix<double>& H)
 {
   // construct Ma = ZH
-  vnl_matrix<double> Hik;
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
   for (int i=0; i<num_a_; ++i)
   {
     vnl_matrix<double>& Mai = Ma_[i];
     Mai.fill(0.0);
 
+    vnl_matrix<double> Hik;
     for (int k=0; k<num_a_; ++k)
     {
       Hik.set_size(f_->number_of_params_a(i), f_->number_of_params_a(k));
@@ -621,12 +685,13 @@ void vnl_sparse_lm::compute_Mb()
   // sparse vector iterator
   typedef vnl_crs_index::sparse_vector::iterator sv_itr;
 
-  vnl_matrix<double> temp;
   // construct Mb = (-R-MaW)inv(V)
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
   for (int j=0; j<num_b_; ++j)
   {
-    temp.set_size(size_c_,f_->number_of_params_b(j));
-    temp.fill(0.0);
+    vnl_matrix<double> temp(size_c_,f_->number_of_params_b(j), 0.0);
     temp -= R_[j];
 
     vnl_crs_index::sparse_vector col = crs.sparse_col(j);
@@ -692,12 +757,16 @@ void vnl_sparse_lm::compute_sea(vnl_vector<double> const& dc,
   typedef vnl_crs_index::sparse_vector::iterator sv_itr;
 
   sea = ea_; // initialize se to ea_
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
   for (int i=0; i<num_a_; ++i)
   {
     vnl_vector_ref<double> sei(f_->number_of_params_a(i),sea.data_block()+f_->index_a(i));
     vnl_crs_index::sparse_vector row_i = crs.sparse_row(i);
 
-    vnl_fastops::inc_X_by_AtB(sei,Z_[i],dc);
+    if (size_c_ > 0)
+      vnl_fastops::inc_X_by_AtB(sei,Z_[i],dc);
 
     for (sv_itr ri = row_i.begin(); ri != row_i.end();  ++ri)
     {
@@ -721,6 +790,9 @@ void vnl_sparse_lm::compute_Sa_sea(vnl_matrix<double>& Sa,
   typedef vnl_crs_index::sparse_vector::iterator sv_itr;
 
   sea = ea_; // initialize se to ea_
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
   for (int i=0; i<num_a_; ++i)
   {
     vnl_vector_ref<double> sei(f_->number_of_params_a(i),sea.data_block()+f_->index_a(i));
@@ -769,6 +841,179 @@ void vnl_sparse_lm::compute_Sa_sea(vnl_matrix<double>& Sa,
 }
 
 
+//: compute Z (if size_c_ > 0) and the inverses of the diagonal blocks of Sa
+void vnl_sparse_lm::compute_Z_inv_Sd()
+{
+  // CRS matrix of indices into e, A, B, C, W, Y
+  const vnl_crs_index& crs = f_->residual_indices();
+  // sparse vector iterator
+  typedef vnl_crs_index::sparse_vector::iterator sv_itr;
+
+  inv_Sd_.resize(num_a_);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int i=0; i<num_a_; ++i)
+  {
+    vnl_crs_index::sparse_vector row_i = crs.sparse_row(i);
+    vnl_matrix<double>& Zi = Z_[i];
+    if (size_c_ > 0)
+    {
+      Zi.fill(0.0);
+      Zi -= Q_[i];
+    }
+
+    vnl_matrix<double> Sii(U_[i]); // copy Ui to initialize Sii
+    for (sv_itr ri = row_i.begin(); ri != row_i.end();  ++ri)
+    {
+      unsigned int k = ri->first;
+      vnl_fastops::dec_X_by_ABt(Sii,Y_[k],W_[k]);           // S_ii -= Y_ij * W_ij^T
+      if (size_c_ > 0)
+        vnl_fastops::inc_X_by_ABt(Zi,R_[ri->second],Y_[k]);  // Z_i  += R_j * Y_ij^T
+    }
+
+    vnl_cholesky Sii_cholesky(Sii,vnl_cholesky::quiet);
+    // use SVD as a backup if Cholesky is deficient
+    if ( Sii_cholesky.rank_deficiency() > 0 )
+      inv_Sd_[i] = vnl_svd<double>(Sii).inverse();
+    else
+      inv_Sd_[i] = Sii_cholesky.inverse();
+  }
+}
+
+
+//: compute y = Sa*x without forming Sa
+void vnl_sparse_lm::Sa_multiply(vnl_vector<double> const& x,
+                                vnl_vector<double>& y) const
+{
+  // CRS matrix of indices into e, A, B, C, W, Y
+  const vnl_crs_index& crs = f_->residual_indices();
+  // sparse vector iterator
+  typedef vnl_crs_index::sparse_vector::iterator sv_itr;
+
+  // Sa*x = U*x - Y*(Wt*x), with t = Wt*x computed once per point
+  vnl_vector<double> t(size_b_);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for (int j=0; j<num_b_; ++j)
+  {
+    vnl_vector_ref<double> tj(f_->number_of_params_b(j), t.data_block()+f_->index_b(j));
+    tj.fill(0.0);
+    vnl_crs_index::sparse_vector col = crs.sparse_col(j);
+    for (sv_itr c_itr=col.begin(); c_itr!=col.end(); ++c_itr)
+    {
+      unsigned int k = c_itr->first;
+      unsigned int i = c_itr->second;
+      const vnl_vector_ref<double> xi(f_->number_of_params_a(i),
+                                      const_cast<double*>(x.data_block()+f_->index_a(i)));
+      vnl_fastops::inc_X_by_AtB(tj,W_[k],xi);  // t_j += W_ij^T * x_i
+    }
+  }
+
+  y.set_size(size_a_);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for (int i=0; i<num_a_; ++i)
+  {
+    const vnl_vector_ref<double> xi(f_->number_of_params_a(i),
+                                    const_cast<double*>(x.data_block()+f_->index_a(i)));
+    vnl_vector_ref<double> yi(f_->number_of_params_a(i), y.data_block()+f_->index_a(i));
+    vnl_fastops::Ab(yi,U_[i],xi);
+    vnl_crs_index::sparse_vector row_i = crs.sparse_row(i);
+    for (sv_itr ri = row_i.begin(); ri != row_i.end();  ++ri)
+    {
+      const vnl_matrix<double>& Yij = Y_[ri->first];
+      vnl_vector_ref<double> tj(Yij.cols(), t.data_block()+f_->index_b(ri->second));
+      yi -= Yij*tj;  // y_i -= Y_ij * t_j
+    }
+  }
+}
+
+
+//: apply the block-Jacobi preconditioner: z = inv(diag blocks of Sa) * r
+void vnl_sparse_lm::precondition(vnl_vector<double> const& r,
+                                 vnl_vector<double>& z) const
+{
+  z.set_size(size_a_);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for (int i=0; i<num_a_; ++i)
+  {
+    const vnl_vector_ref<double> ri(f_->number_of_params_a(i),
+                                    const_cast<double*>(r.data_block()+f_->index_a(i)));
+    vnl_vector_ref<double> zi(f_->number_of_params_a(i), z.data_block()+f_->index_a(i));
+    vnl_fastops::Ab(zi,inv_Sd_[i],ri);
+  }
+}
+
+
+//: solve Sa*x = b with block-Jacobi preconditioned conjugate gradients
+unsigned int vnl_sparse_lm::pcg_solve(vnl_vector<double> const& b,
+                                      vnl_vector<double>& x) const
+{
+  const unsigned int max_iter = pcg_max_iter_ > 0 ? pcg_max_iter_ : (unsigned int)size_a_;
+  const double stop = pcg_tol_*pcg_tol_*b.squared_magnitude();
+
+  x.set_size(size_a_);
+  x.fill(0.0);
+  vnl_vector<double> r(b), z, q;
+  if (r.squared_magnitude() <= stop)
+    return 0;
+  precondition(r,z);
+  vnl_vector<double> p(z);
+  double rz = dot_product(r,z);
+
+  unsigned int iter = 0;
+  while (iter < max_iter)
+  {
+    ++iter;
+    Sa_multiply(p,q);
+    double pq = dot_product(p,q);
+    if (!(pq > 0.0))  // Sa is not numerically positive definite along p
+      break;
+    double alpha = rz/pq;
+    for (int n=0; n<size_a_; ++n)
+    {
+      x[n] += alpha*p[n];
+      r[n] -= alpha*q[n];
+    }
+    if (r.squared_magnitude() <= stop)
+      break;
+    precondition(r,z);
+    double rz_new = dot_product(r,z);
+    double beta = rz_new/rz;
+    rz = rz_new;
+    for (int n=0; n<size_a_; ++n)
+      p[n] = z[n] + beta*p[n];
+  }
+  if (verbose_)
+    std::cout << "               conjugate gradients: " << iter << " iterations, relative residual "
+              << std::sqrt(r.squared_magnitude()/b.squared_magnitude()) << std::endl;
+  return iter;
+}
+
+
+//: compute Ma = Z inv(Sa) by conjugate gradients, one row at a time
+void vnl_sparse_lm::compute_Ma_pcg()
+{
+  // inv(Sa) is symmetric, so row r of Ma solves Sa * Ma(r,:)^T = Z(r,:)^T
+  vnl_vector<double> zr(size_a_), mr;
+  for (int r=0; r<size_c_; ++r)
+  {
+    for (int i=0; i<num_a_; ++i)
+      for (unsigned int ii=0; ii<Z_[i].cols(); ++ii)
+        zr[f_->index_a(i)+ii] = Z_[i](r,ii);
+    pcg_solve(zr,mr);
+    for (int i=0; i<num_a_; ++i)
+      for (unsigned int ii=0; ii<Ma_[i].cols(); ++ii)
+        Ma_[i](r,ii) = mr[f_->index_a(i)+ii];
+  }
+}
+
+
 //: back solve to find db using da and dc
 void vnl_sparse_lm::backsolve_db(vnl_vector<double> const& da,
                                  vnl_vector<double> const& dc,
@@ -779,6 +1024,9 @@ void vnl_sparse_lm::backsolve_db(vnl_vector<double> const& da,
   // sparse vector iterator
   typedef vnl_crs_index::sparse_vector::iterator sv_itr;
 
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
   for (int j=0; j<num_b_; ++j)
   {
     vnl_vector<double> seb(eb_.data_block()+f_->index_b(j),f_->number_of_params_b(j));
@@ -31,6 +31,16 @@ class vnl_sparse_lst_sqr_function;
 //  the Hartley and Zisserman "Multiple View Geometry" book and further
 //  described in a technical report on sparse bundle adjustment available
 //  at http://www.ics.forth.gr/~lourakis/sba
+//
+//  The normal equations and the reduced camera system (Sa) are assembled
+//  block by block.  With VNL_CONFIG_ENABLE_OPENMP the blocks are shared among
+//  threads; every block has a single writer and every sum is taken in a fixed
+//  order, so the result does not depend on the number of threads.
+//
+//  By default Sa is formed densely and factored.  When that does not fit in
+//  memory, set_use_pcg(true) solves the reduced camera system with conjugate
+//  gradients instead, preconditioned by the diagonal blocks of Sa, using
+//  products with Sa = U - W inv(V) W' that never form it.
 class vnl_sparse_lm : public vnl_nonlinear_minimizer
 {
  public:
@@ -67,6 +77,20 @@ class vnl_sparse_lm : public vnl_nonlinear_minimizer
   //: Access the final weights after optimization
   const vnl_vector<double>& get_weights() const { return weights_; }
 
+  //: Solve the reduced camera system with preconditioned conjugate gradients.
+  //  Sa is never formed, so memory grows with the number of non-zero blocks
+  //  rather than with the square of the number of "a" parameters.
+  void set_use_pcg(bool use_pcg) { use_pcg_ = use_pcg; }
+  bool get_use_pcg() const { return use_pcg_; }
+
+  //: Stop conjugate gradients when the residual norm drops below tol times that of the right hand side.
+  void set_pcg_tolerance(double tol) { pcg_tol_ = tol; }
+  double get_pcg_tolerance() const { return pcg_tol_; }
+
+  //: Maximum number of conjugate gradient iterations per solve; 0 means the size of Sa.
+  void set_pcg_max_iterations(unsigned int n) { pcg_max_iter_ = n; }
+  unsigned int get_pcg_max_iterations() const { return pcg_max_iter_; }
+
 protected:
 
   //: used to compute the initial damping
@@ -77,6 +101,10 @@ protected:
   vnl_matrix<double> inv_covar_;
   bool set_covariance_; // Set if covariance_ holds J'*J
 
+  bool use_pcg_;
+  double pcg_tol_;
+  unsigned int pcg_max_iter_;
+
   void init(vnl_sparse_lst_sqr_function* f);
 
 private:
@@ -121,6 +149,22 @@ private:
   // only used when size_c_ == 0
   void compute_Sa_sea(vnl_matrix<double>& Sa, vnl_vector<double>& sea);
 
+  //: compute Z (if size_c_ > 0) and the inverses of the diagonal blocks of Sa
+  void compute_Z_inv_Sd();
+
+  //: compute y = Sa*x without forming Sa
+  void Sa_multiply(vnl_vector<double> const& x, vnl_vector<double>& y) const;
+
+  //: solve Sa*x = b with block-Jacobi preconditioned conjugate gradients
+  //  Returns the number of iterations used.
+  unsigned int pcg_solve(vnl_vector<double> const& b, vnl_vector<double>& x) const;
+
+  //: apply the block-Jacobi preconditioner: z = inv(diag blocks of Sa) * r
+  void precondition(vnl_vector<double> const& r, vnl_vector<double>& z) const;
+
+  //: compute Ma = Z inv(Sa) by conjugate gradients, one row at a time
+  void compute_Ma_pcg();
+
   //: back solve to find db using da and dc
   void backsolve_db(vnl_vector<double> const& da,
                     vnl_vector<double> const& dc,
@@ -167,6 +211,8 @@ private:
   std::vector<vnl_matrix<double> > Z_;
   std::vector<vnl_matrix<double> > Ma_;
   std::vector<vnl_matrix<double> > Mb_;
+  // inverses of the diagonal blocks of Sa, only used with conjugate gradients
+  std::vector<vnl_matrix<double> > inv_Sd_;
 
 };
 
@@ -0,0 +1,87 @@
+// This is core/vnl/tests/test_c_vector_simd.cxx
+#include <iostream>
+#include <vector>
+#include <testlib/testlib_test.h>
+//:
+// \file
+// Run every kernel set this CPU supports against plain loops, for lengths
+// which exercise the unrolled, single-vector and scalar tail paths.
+
+#include <vnl/vnl_c_vector.h>
+#include <vnl/vnl_c_vector_simd.h>
+
+template <class T>
+static void test_kernels(char const* type_name, T tol)
+{
+  const unsigned nmax = 70;
+  std::vector<T> a(nmax), b(nmax);
+  for (unsigned i = 0; i < nmax; ++i) {
+    a[i] = T(int(i*7 % 11) - 5) / T(4);
+    b[i] = T(int(i*5 % 13) - 6) / T(8);
+  }
+
+  bool reductions_ok = true, elementwise_ok = true, aliased_ok = true;
+  for (unsigned n = 0; n <= nmax; ++n) {
+    T sum(0), dot(0), nrm(0), dist(0);
+    for (unsigned i = 0; i < n; ++i) {
+      sum += a[i]; dot += a[i]*b[i]; nrm += a[i]*a[i]; dist += (a[i]-b[i])*(a[i]-b[i]);
+    }
+    // The inputs are multiples of 1/8, so only the summation order can differ.
+    if (vnl_c_vector<T>::sum(&a[0], n) != sum ||
+        vnl_c_vector<T>::dot_product(&a[0], &b[0], n) != dot ||
+        vnl_c_vector<T>::two_nrm2(&a[0], n) != nrm ||
+        vnl_c_vector<T>::euclid_dist_sq(&a[0], &b[0], n) != dist) {
+      std::cout << "reduction mismatch for n = " << n << '\n';
+      reductions_ok = false;
+    }
+
+    std::vector<T> z(nmax+1, T(99)), y(b);
+    vnl_c_vector<T>::add(&a[0], &b[0], &z[0], n);
+    for (unsigned i = 0; i < n; ++i) elementwise_ok = elementwise_ok && z[i] == a[i]+b[i];
+    vnl_c_vector<T>::subtract(&a[0], &b[0], &z[0], n);
+    for (unsigned i = 0; i < n; ++i) elementwise_ok = elementwise_ok && z[i] == a[i]-b[i];
+    vnl_c_vector<T>::multiply(&a[0], &b[0], &z[0], n);
+    for (unsigned i = 0; i < n; ++i) elementwise_ok = elementwise_ok && z[i] == a[i]*b[i];
+    elementwise_ok = elementwise_ok && z[n] == T(99);
+
+    vnl_c_vector<T>::saxpy(T(2), &a[0], &y[0], n);
+    for (unsigned i = 0; i < n; ++i) elementwise_ok = elementwise_ok && y[i] == b[i]+T(2)*a[i];
+    for (unsigned i = n; i < nmax; ++i) elementwise_ok = elementwise_ok && y[i] == b[i];
+
+    y = b;
+    vnl_c_vector<T>::add(&a[0], &y[0], &y[0], n);
+    for (unsigned i = 0; i < n; ++i) aliased_ok = aliased_ok && y[i] == a[i]+b[i];
+  }
+  std::cout << type_name << ' ';
+  TEST("reductions", reductions_ok, true);
+  TEST("element-wise operations", elementwise_ok, true);
+  TEST("element-wise operation in place", aliased_ok, true);
+
+  // Longer vectors, where the summation order does change the rounding.
+  std::vector<T> u(10001), v(10001);
+  double ref = 0;
+  for (unsigned i = 0; i < u.size(); ++i) {
+    u[i] = T(1) / T(i+1); v[i] = T(i % 3) - T(1);
+    ref += double(u[i]) * double(v[i]);
+  }
+  TEST_NEAR("long dot_product", vnl_c_vector<T>::dot_product(&u[0], &v[0], unsigned(u.size())), ref, tol);
+}
+
+void test_c_vector_simd()
+{
+  const vnl_c_vector_simd::isa_t best = vnl_c_vector_simd::best_isa();
+  std::cout << "Best instruction set: " << vnl_c_vector_simd::isa_name(best) << '\n';
+  TEST("kernels selected at start-up are the best available", vnl_c_vector_simd::isa(), best);
+
+  for (int i = vnl_c_vector_simd::generic; i <= best; ++i) {
+    vnl_c_vector_simd::isa_t isa = vnl_c_vector_simd::isa_t(i);
+    std::cout << "\n--- " << vnl_c_vector_simd::isa_name(isa) << " ---\n";
+    TEST("set_isa", vnl_c_vector_simd::set_isa(isa), isa);
+    test_kernels<double>("double", 1e-12);
+    test_kernels<float>("float", 1e-3f);
+  }
+  TEST("set_isa clamps to the best available",
+       vnl_c_vector_simd::set_isa(vnl_c_vector_simd::avx512), best);
+}
+
+TESTMAIN(test_c_vector_simd);
@@ -29,6 +29,9 @@ DECLARE( test_sym_matrix );
 DECLARE( test_transpose );
 DECLARE( test_fastops );
 DECLARE( test_vector );
+DECLARE( test_expression );
+DECLARE( test_small_buffer );
+DECLARE( test_c_vector_simd );
 DECLARE( test_vector_fixed_ref );
 DECLARE( test_gamma );
 DECLARE( test_random );
@@ -74,6 +77,9 @@ register_tests()
   REGISTER( test_transpose );
   REGISTER( test_fastops );
   REGISTER( test_vector );
+  REGISTER( test_expression );
+  REGISTER( test_small_buffer );
+  REGISTER( test_c_vector_simd );
   REGISTER( test_vector_fixed_ref );
   REGISTER( test_gamma );
   REGISTER( test_random );
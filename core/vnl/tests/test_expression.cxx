@@ -0,0 +1,96 @@
+// This is core/vnl/tests/test_expression.cxx
+#include <iostream>
+#include <testlib/testlib_test.h>
+//:
+// \file
+// \brief Tests of the lazy element-wise expressions of vnl_expression.h
+
+#include <vnl/vnl_expression.h>
+#include <vnl/vnl_vector.h>
+#include <vnl/vnl_vector_ref.h>
+#include <vnl/vnl_matrix.h>
+#include <vnl/vnl_random.h>
+#include <vcl_compiler.h>
+
+static double sum_of(vnl_vector<double> const& v) { return v.sum(); }
+
+static void test_vector_expression(vnl_random& rng)
+{
+  const unsigned n = 37;
+  vnl_vector<double> x(n), y(n), z(n);
+  for (unsigned i = 0; i < n; ++i) {
+    x[i] = rng.normal(); y[i] = rng.normal(); z[i] = rng.normal() + 3.0;
+  }
+  const double a = 2.5, b = -0.75;
+
+  vnl_vector<double> r = a * vnl_expr(x) + b * vnl_expr(y) - z;
+  TEST_NEAR("construct from a*x + b*y - z", (r - (a*x + b*y - z)).inf_norm(), 0.0, 1e-14);
+
+  double const* block = r.data_block();
+  r = vnl_expr(x) / a - y * b + 1.0;
+  TEST("assignment does not reallocate", r.data_block(), block);
+  TEST_NEAR("x/a - y*b + 1", (r - (x/a - y*b + 1.0)).inf_norm(), 0.0, 1e-14);
+
+  r = -vnl_expr(x) + element_product(vnl_expr(y), z) - element_quotient(x, vnl_expr(z));
+  TEST_NEAR("-x + y.*z - x./z", (r - (-x + element_product(y, z) - element_quotient(x, z))).inf_norm(), 0.0, 1e-14);
+
+  r = 2.0 - vnl_expr(x) * 3.0;
+  TEST_NEAR("2 - x*3", (r - (2.0 - x * 3.0)).inf_norm(), 0.0, 1e-14);
+
+  // an expression may be assigned to one of its operands
+  vnl_vector<double> w = x;
+  w = vnl_expr(w) * 2.0 + w;
+  TEST_NEAR("w = 2w + w", (w - 3.0 * x).inf_norm(), 0.0, 1e-14);
+
+  w = x;
+  w += vnl_expr(y) * a;
+  TEST_NEAR("w += a*y", (w - (x + a * y)).inf_norm(), 0.0, 1e-14);
+  w -= vnl_expr(y) * a;
+  TEST_NEAR("w -= a*y", (w - x).inf_norm(), 0.0, 1e-14);
+
+  TEST_NEAR("passed as vnl_vector const&", sum_of(vnl_expr(x) + y), (x + y).sum(), 1e-12);
+
+  vnl_vector<double> e;
+  e = vnl_expr(x) + y;
+  TEST("assignment resizes", e.size(), n);
+
+  double buf[3] = { 0.0, 0.0, 0.0 };
+  vnl_vector_ref<double> ref(3, buf);
+  vnl_vector<double> three(3, 1.0);
+  ref += vnl_expr(three) * 4.0;
+  TEST("vnl_vector_ref +=", buf[0] == 4.0 && buf[2] == 4.0, true);
+
+  vnl_vector<float> xf(4, 1.5f), rf;
+  rf = 2 * vnl_expr(xf) - xf;
+  TEST("float", rf == xf, true);
+}
+
+static void test_matrix_expression(vnl_random& rng)
+{
+  vnl_matrix<double> A(5, 7), B(5, 7), C(5, 7);
+  for (unsigned i = 0; i < 5; ++i)
+    for (unsigned j = 0; j < 7; ++j) {
+      A(i,j) = rng.normal(); B(i,j) = rng.normal(); C(i,j) = rng.normal();
+    }
+  vnl_matrix<double> R = 0.5 * vnl_expr(A) - vnl_expr(B) * 2.0 + C;
+  TEST("matrix: size", R.rows() == 5 && R.cols() == 7, true);
+  TEST_NEAR("matrix: A/2 - 2B + C", (R - (0.5 * A - B * 2.0 + C)).absolute_value_max(), 0.0, 1e-14);
+
+  double const* block = R.data_block();
+  R = element_product(vnl_expr(A), B) + 1.0;
+  TEST("matrix: assignment does not reallocate", R.data_block(), block);
+  TEST_NEAR("matrix: A.*B + 1", (R - (element_product(A, B) + 1.0)).absolute_value_max(), 0.0, 1e-14);
+
+  R -= vnl_expr(C) * 2.0;
+  R += C + vnl_expr(C);
+  TEST_NEAR("matrix: -= and +=", (R - (element_product(A, B) + 1.0)).absolute_value_max(), 0.0, 1e-14);
+}
+
+static void test_expression()
+{
+  vnl_random rng(1492);
+  test_vector_expression(rng);
+  test_matrix_expression(rng);
+}
+
+TESTMAIN(test_expression);
@@ -6,6 +6,59 @@
 // \date 17 June 2004
 #include <vnl/vnl_fastops.h>
 
+//: Compare the cache-blocked products with a plain triple loop.
+// Sizes straddle the blocking factors and the entries are small integers,
+// so every summation order gives exactly the same result.
+template <class T>
+static vnl_matrix<T> naive_product(vnl_matrix<T> const& A, vnl_matrix<T> const& B)
+{
+  vnl_matrix<T> C(A.rows(), B.cols(), T(0));
+  for (unsigned int i=0; i<A.rows(); ++i)
+    for (unsigned int j=0; j<B.cols(); ++j)
+      for (unsigned int k=0; k<A.cols(); ++k)
+        C(i,j) += A(i,k) * B(k,j);
+  return C;
+}
+
+template <class T>
+static void fill_small_integers(vnl_matrix<T>& M, unsigned int seed)
+{
+  for (unsigned int i=0; i<M.rows(); ++i)
+    for (unsigned int j=0; j<M.cols(); ++j)
+      M(i,j) = T(int((i*31 + j*17 + seed) % 7) - 3);
+}
+
+static void test_blocked_products()
+{
+  vnl_matrix<double> A(133,300), B(300,37);
+  fill_small_integers(A, 1);
+  fill_small_integers(B, 2);
+  vnl_matrix<double> AB = naive_product(A, B);
+  TEST("blocked operator*", A*B, AB);
+
+  vnl_matrix<float> Af(A.rows(),A.cols()), Bf(B.rows(),B.cols());
+  fill_small_integers(Af, 1);
+  fill_small_integers(Bf, 2);
+  TEST("blocked operator* <float>", Af*Bf, naive_product(Af, Bf));
+
+  vnl_matrix<double> At = A.transpose(), Bt = B.transpose(), result;
+  vnl_fastops::AB(result, A, B);
+  TEST("blocked vnl_fastops::AB", result, AB);
+  vnl_fastops::AtB(result, At, B);
+  TEST("blocked vnl_fastops::AtB", result, AB);
+  vnl_fastops::ABt(result, A, Bt);
+  TEST("blocked vnl_fastops::ABt", result, AB);
+  vnl_fastops::AtA(result, A);
+  TEST("blocked vnl_fastops::AtA", result, naive_product(At, A));
+  TEST("blocked vnl_fastops::AtA is symmetric", result, result.transpose());
+
+  vnl_matrix<double> X = AB;
+  vnl_fastops::inc_X_by_AB(X, A, B);
+  TEST("blocked vnl_fastops::inc_X_by_AB", X, AB*2.0);
+  vnl_fastops::dec_X_by_AtB(X, At, B);
+  TEST("blocked vnl_fastops::dec_X_by_AtB", X, AB);
+}
+
 void test_fastops()
 {
   // The data to work with
@@ -264,6 +317,8 @@ void test_fastops()
   TEST("vnl_fastops::inc_X_by_AtB(X, m2x10,v2)", Y, m10x2*v2+v10);
   vnl_fastops::dec_X_by_AtB(Y, m2x10, v2);
   TEST("vnl_fastops::dec_X_by_AtB(X, m2x10,v2)", Y, v10);
+
+  test_blocked_products();
 }
 
 TESTMAIN(test_fastops);
@@ -10,6 +10,7 @@
 #include <vnl/vnl_block.h>
 #include <vnl/vnl_c_na_vector.h>
 #include <vnl/vnl_c_vector.h>
+#include <vnl/vnl_c_vector_simd.h>
 #include <vnl/vnl_complex.h>
 #include <vnl/vnl_complexify.h>
 #include <vnl/vnl_complex_traits.h>
@@ -41,7 +42,9 @@
 #include <vnl/vnl_double_4x4.h>
 #include <vnl/vnl_erf.h>
 #include <vnl/vnl_error.h>
+#include <vnl/vnl_expression.h>
 #include <vnl/vnl_fastops.h>
+#include <vnl/vnl_gemm.h>
 #include <vnl/vnl_file_matrix.h>
 #include <vnl/vnl_file_vector.h>
 #include <vnl/vnl_finite.h>
@@ -112,6 +115,7 @@
 #include <vnl/vnl_scalar_join_iterator.h>
 #include <vnl/vnl_sparse_lst_sqr_function.h>
 #include <vnl/vnl_sparse_matrix.h>
+#include <vnl/vnl_sparse_matrix_crs.h>
 #include <vnl/vnl_sparse_matrix_linear_system.h>
 #include <vnl/vnl_sse.h>
 #include <vnl/vnl_sym_matrix.h>
@@ -0,0 +1,216 @@
+// This is core/vnl/tests/test_small_buffer.cxx
+#include <iostream>
+#include <testlib/testlib_test.h>
+//:
+// \file
+// \brief Tests of the inline storage and move operations of the vnl containers
+
+#include <vnl/vnl_vector.h>
+#include <vnl/vnl_vector_ref.h>
+#include <vnl/vnl_vector_fixed.h>
+#include <vnl/vnl_matrix.h>
+#include <vnl/vnl_matrix_ref.h>
+#include <vnl/vnl_diag_matrix.h>
+#include <vnl/vnl_sparse_matrix.h>
+#include <vnl/vnl_rational.h>
+#include <vnl/vnl_rational_traits.h>
+#include <vnl/vnl_math.h>
+#include <vnl/vnl_c_vector.h>
+#include <vnl/vnl_config.h>
+#include <vcl_compiler.h>
+
+static vnl_vector<double> make_vector(unsigned n, double v0)
+{
+  vnl_vector<double> v(n);
+  for (unsigned i = 0; i < n; ++i)
+    v[i] = v0 + i;
+  return v;
+}
+
+static vnl_matrix<double> make_matrix(unsigned r, unsigned c, double v0)
+{
+  vnl_matrix<double> M(r, c);
+  for (unsigned i = 0; i < r; ++i)
+    for (unsigned j = 0; j < c; ++j)
+      M(i,j) = v0 + i * c + j;
+  return M;
+}
+
+static bool vector_is(vnl_vector<double> const& v, unsigned n, double v0)
+{
+  if (v.size() != n) return false;
+  for (unsigned i = 0; i < n; ++i)
+    if (v[i] != v0 + i) return false;
+  return true;
+}
+
+static bool matrix_is(vnl_matrix<double> const& M, unsigned r, unsigned c, double v0)
+{
+  if (M.rows() != r || M.cols() != c) return false;
+  for (unsigned i = 0; i < r; ++i)
+    for (unsigned j = 0; j < c; ++j)
+      if (M(i,j) != v0 + i * c + j || M[i] + j != M.data_block() + i * c + j) return false;
+  return true;
+}
+
+static void test_small_vectors()
+{
+  // a residual computation of the kind found in inner loops
+  vnl_matrix<double> R = make_matrix(3, 3, 0.5);
+  vnl_vector<double> t = make_vector(3, 1.0);
+  double sum = 0.0;
+  unsigned long count = vnl_c_vector_allocation_count();
+  for (int i = 0; i < 100; ++i) {
+    vnl_vector<double> p = make_vector(3, i);
+    vnl_vector<double> q = R * p + t;
+    vnl_matrix<double> S = R * 2.0 - R.transpose();
+    sum += (q - p).squared_magnitude() + S(1,2);
+  }
+  unsigned long allocated = vnl_c_vector_allocation_count() - count;
+  std::cout << "blocks allocated by 100 small residuals: " << allocated << '\n';
+#if VNL_CONFIG_SMALL_BUFFER
+  TEST("small vectors and matrices are not allocated", allocated, 0ul);
+#else
+  TEST("heap allocations are counted", allocated > 0, true);
+#endif
+
+  count = vnl_c_vector_allocation_count();
+  vnl_vector<double> big(100, 1.0);
+  vnl_matrix<double> bigM(10, 10, 1.0);
+  TEST("large vectors and matrices are allocated", vnl_c_vector_allocation_count() - count >= 3, true);
+  TEST("residuals finite", vnl_math::isfinite(sum), true);
+}
+
+static void test_vector_moves()
+{
+  vnl_vector<double> a = make_vector(3, 1.0), b = make_vector(50, 2.0);
+  double const* bdata = b.data_block();
+
+  unsigned long count = vnl_c_vector_allocation_count();
+  vnl_vector<double> c(static_cast<vnl_vector<double>&&>(b));
+  TEST("move construct: elements", vector_is(c, 50, 2.0), true);
+  TEST("move construct: storage taken over", c.data_block(), bdata);
+  TEST("move construct: source empty", b.size() == 0 && b.data_block() == VXL_NULLPTR, true);
+
+  vnl_vector<double> d(static_cast<vnl_vector<double>&&>(a));
+  TEST("move construct small", vector_is(d, 3, 1.0), true);
+
+  b = static_cast<vnl_vector<double>&&>(c);
+  TEST("move assign: storage taken over", b.data_block() == bdata && vector_is(b, 50, 2.0), true);
+  a = static_cast<vnl_vector<double>&&>(d);
+  TEST("move assign small", vector_is(a, 3, 1.0), true);
+  TEST("moves allocate nothing", vnl_c_vector_allocation_count() - count, 0ul);
+
+  // swaps with inline and heap storage on either side
+  a.swap(b);
+  TEST("swap small/large", vector_is(a, 50, 2.0) && vector_is(b, 3, 1.0), true);
+  TEST("swap keeps heap storage", a.data_block(), bdata);
+  b.swap(a);
+  TEST("swap large/small", vector_is(a, 3, 1.0) && vector_is(b, 50, 2.0), true);
+  vnl_vector<double> e = make_vector(4, 7.0);
+  a.swap(e);
+  TEST("swap small/small", vector_is(a, 4, 7.0) && vector_is(e, 3, 1.0), true);
+  vnl_vector<double> empty;
+  a.swap(empty);
+  TEST("swap with empty", a.size() == 0 && vector_is(empty, 4, 7.0), true);
+
+  // a vnl_vector_ref keeps its storage
+  vnl_vector_fixed<double,3> f(0.0);
+  vnl_vector<double> three = make_vector(3, 5.0);
+  vnl_vector_ref<double> ref(3, f.data_block());
+  static_cast<vnl_vector<double>&>(ref) = static_cast<vnl_vector<double>&&>(three);
+  TEST("move assign into vnl_vector_ref copies", f[0] == 5.0 && f[2] == 7.0 && ref.data_block() == f.data_block(), true);
+  vnl_vector<double> g(static_cast<vnl_vector<double>&&>(static_cast<vnl_vector<double>&>(ref)));
+  TEST("move construct from vnl_vector_ref copies", vector_is(g, 3, 5.0) && g.data_block() != f.data_block() && ref.size() == 3, true);
+
+  // elements with constructors and destructors
+  vnl_vector<vnl_rational> q(2, vnl_rational(1, 3));
+  vnl_vector<vnl_rational> q2(static_cast<vnl_vector<vnl_rational>&&>(q));
+  TEST("vnl_rational moved", q2.size() == 2 && q2[1] == vnl_rational(1, 3) && q.size() == 0, true);
+
+  // pre_multiply with inline storage
+  vnl_vector<double> x = make_vector(2, 1.0);
+  x.pre_multiply(make_matrix(3, 2, 0.0));
+  TEST("pre_multiply", x.size() == 3 && x[0] == 2.0 && x[2] == 14.0, true);
+  x.post_multiply(make_matrix(3, 20, 0.0));
+  TEST("post_multiply", x.size() == 20 && x[0] == 2.0*0 + 8.0*20 + 14.0*40, true);
+}
+
+static void test_matrix_moves()
+{
+  vnl_matrix<double> A = make_matrix(3, 3, 1.0), B = make_matrix(20, 30, 2.0);
+  vnl_matrix<double> C = make_matrix(2, 40, 3.0), D = make_matrix(10, 1, 4.0);
+  double const* bdata = B.data_block();
+  double const* cdata = C.data_block();
+
+  unsigned long count = vnl_c_vector_allocation_count();
+  vnl_matrix<double> E(static_cast<vnl_matrix<double>&&>(B));
+  TEST("move construct: elements", matrix_is(E, 20, 30, 2.0), true);
+  TEST("move construct: storage taken over", E.data_block(), bdata);
+  TEST("move construct: source empty", B.rows() == 0 && B.cols() == 0 && B.empty(), true);
+  vnl_matrix<double> F(static_cast<vnl_matrix<double>&&>(C));
+  TEST("move construct with inline rows", matrix_is(F, 2, 40, 3.0) && F.data_block() == cdata, true);
+  vnl_matrix<double> G(static_cast<vnl_matrix<double>&&>(A));
+  TEST("move construct small", matrix_is(G, 3, 3, 1.0), true);
+  A = static_cast<vnl_matrix<double>&&>(G);
+  TEST("move assign small", matrix_is(A, 3, 3, 1.0), true);
+  B = static_cast<vnl_matrix<double>&&>(E);
+  TEST("move assign: storage taken over", B.data_block() == bdata && matrix_is(B, 20, 30, 2.0), true);
+  TEST("moves allocate nothing", vnl_c_vector_allocation_count() - count, 0ul);
+
+  A.swap(B);
+  TEST("swap small/large", matrix_is(A, 20, 30, 2.0) && matrix_is(B, 3, 3, 1.0), true);
+  A.swap(F);
+  TEST("swap large/inline rows", matrix_is(A, 2, 40, 3.0) && matrix_is(F, 20, 30, 2.0), true);
+  B.swap(D);
+  TEST("swap small/heap rows", matrix_is(B, 10, 1, 4.0) && matrix_is(D, 3, 3, 1.0), true);
+  vnl_matrix<double> empty;
+  D.swap(empty);
+  TEST("swap with empty", D.rows() == 0 && matrix_is(empty, 3, 3, 1.0), true);
+
+  vnl_matrix<double> T = make_matrix(2, 3, 0.0);
+  T.inplace_transpose();
+  TEST("inplace_transpose", T.rows() == 3 && T.cols() == 2 && T(2,1) == 5.0 && T[2] == T.data_block() + 4, true);
+  vnl_matrix<double> T2 = make_matrix(6, 2, 0.0);
+  T2.inplace_transpose();
+  TEST("inplace_transpose to inline rows", T2.rows() == 2 && T2(1,5) == 11.0 && T2[1] == T2.data_block() + 6, true);
+
+  // a vnl_matrix_ref keeps its storage
+  double block[6] = { 0, 0, 0, 0, 0, 0 };
+  vnl_matrix_ref<double> ref(2, 3, block);
+  static_cast<vnl_matrix<double>&>(ref) = make_matrix(2, 3, 1.0);
+  TEST("move assign into vnl_matrix_ref copies", block[0] == 1.0 && block[5] == 6.0 && ref.data_block() == block, true);
+  vnl_matrix<double> H(static_cast<vnl_matrix<double>&&>(static_cast<vnl_matrix<double>&>(ref)));
+  TEST("move construct from vnl_matrix_ref copies", matrix_is(H, 2, 3, 1.0) && H.data_block() != block && ref.rows() == 2, true);
+}
+
+static void test_diag_and_sparse_moves()
+{
+  vnl_diag_matrix<double> D(make_vector(30, 1.0));
+  double const* ddata = D.diagonal().data_block();
+  vnl_diag_matrix<double> D2(static_cast<vnl_diag_matrix<double>&&>(D));
+  TEST("diag move construct", D2.diagonal().data_block() == ddata && D.rows() == 0, true);
+  vnl_diag_matrix<double> D3;
+  D3 = static_cast<vnl_diag_matrix<double>&&>(D2);
+  TEST("diag move assign", D3.diagonal().data_block() == ddata && D3(29,29) == 30.0, true);
+
+  vnl_sparse_matrix<double> S(100, 50);
+  S(3, 4) = 2.0; S(99, 0) = -1.0;
+  vnl_sparse_matrix<double> S2(static_cast<vnl_sparse_matrix<double>&&>(S));
+  TEST("sparse move construct", S2.rows() == 100 && S2(3,4) == 2.0 && S2(99,0) == -1.0 && S.rows() == 0, true);
+  vnl_sparse_matrix<double> S3(2, 2);
+  S3 = static_cast<vnl_sparse_matrix<double>&&>(S2);
+  TEST("sparse move assign", S3.rows() == 100 && S3.cols() == 50 && S3(3,4) == 2.0 && S2.rows() == 0, true);
+}
+
+static void test_small_buffer()
+{
+  test_small_vectors();
+#ifdef VXL_HAS_CXX11_RVREF
+  test_vector_moves();
+  test_matrix_moves();
+  test_diag_and_sparse_moves();
+#endif
+}
+
+TESTMAIN(test_small_buffer);
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <vcl_compiler.h>
 #include <vnl/vnl_sparse_matrix.h>
+#include <vnl/vnl_sparse_matrix_crs.h>
 #include <vnl/vnl_matrix.h>
 #include <testlib/testlib_test.h>
 
@@ -185,6 +186,52 @@ void test_sparse_complex()
   TEST_NEAR("normalize_rows()", d2(1,1), 3.0/13.0, 1e-12);
 }
 
+void test_sparse_crs()
+{
+  std::cout << "***************************************\n"
+           << " Testing vnl_sparse_matrix_crs<double>\n"
+           << "***************************************\n";
+  // 2000 rows so that the products are large enough to be shared among threads
+  const unsigned int nr = 2000, nc = 300;
+  vnl_sparse_matrix<double> A(nr, nc);
+  for (unsigned int i = 0; i < nr; ++i)
+    for (unsigned int j = (i*7) % 11; j < nc; j += 13 + i % 5)
+      A(i, j) = double(int(i + 3*j) % 17 - 8) / 4.0;
+  A.put(5, 0, 0.0); // an explicitly stored zero
+
+  vnl_sparse_matrix_crs<double> C(A);
+  TEST("rows()", C.rows(), nr);
+  TEST("cols()", C.cols(), nc);
+  unsigned int nnz = 0;
+  for (unsigned int i = 0; i < nr; ++i) nnz += (unsigned int)A.get_row(i).size();
+  TEST("num_non_zero()", C.num_non_zero(), nnz);
+  TEST("index().num_non_zero()", C.index().num_non_zero(), int(nnz));
+  TEST("index().num_rows()", C.index().num_rows(), int(nr));
+  bool same = true;
+  for (unsigned int i = 0; i < nr; i += 7)
+    for (unsigned int j = 0; j < nc; ++j)
+      same = same && C(i, j) == A(i, j);
+  TEST("operator()", same, true);
+
+  vnl_vector<double> x(nc), y(nr);
+  for (unsigned int j = 0; j < nc; ++j) x[j] = double(j % 9) - 4.0;
+  for (unsigned int i = 0; i < nr; ++i) y[i] = double(i % 5) - 2.0;
+  vnl_vector<double> r1, r2;
+  A.mult(x, r1);
+  C.mult(x, r2);
+  TEST("mult() as vnl_sparse_matrix", r1, r2);
+  A.pre_mult(y, r1);
+  C.pre_mult(y, r2);
+  TEST("pre_mult() as vnl_sparse_matrix", r1, r2);
+
+  vnl_sparse_matrix<double> E(3, 4);
+  vnl_sparse_matrix_crs<double> CE(E);
+  CE.mult(vnl_vector<double>(4, 1.0), r2);
+  TEST("mult() without entries", r2, vnl_vector<double>(3, 0.0));
+  CE.pre_mult(vnl_vector<double>(3, 1.0), r2);
+  TEST("pre_mult() without entries", r2, vnl_vector<double>(4, 0.0));
+}
+
 static
 void test_sparse_matrix()
 {
@@ -192,6 +239,7 @@ void test_sparse_matrix()
   test_sparse_float();
   test_sparse_double();
   test_sparse_complex();
+  test_sparse_crs();
 }
 
 TESTMAIN(test_sparse_matrix);
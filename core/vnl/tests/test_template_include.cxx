@@ -19,6 +19,7 @@
 #include <vnl/vnl_rank.hxx>
 #include <vnl/vnl_scalar_join_iterator.hxx>
 #include <vnl/vnl_sparse_matrix.hxx>
+#include <vnl/vnl_sparse_matrix_crs.hxx>
 #include <vnl/vnl_sym_matrix.hxx>
 #include <vnl/vnl_unary_function.hxx>
 #include <vnl/vnl_vector_fixed_ref.hxx>
@@ -0,0 +1,40 @@
+// This is core/vnl/vnl_c_vector.cxx
+//:
+// \file
+// \brief Heap storage for vnl_c_vector<T>, with a count of the blocks allocated
+//
+//-----------------------------------------------------------------------------
+
+#include <cstddef>
+#include "vnl_c_vector.h"
+#include <vnl/vnl_sse.h>
+#include <vcl_compiler.h>
+#if VXL_CXX11
+#include <atomic>
+#endif
+
+#if VXL_CXX11
+static std::atomic<unsigned long> vnl_c_vector_allocations(0);
+#else
+static unsigned long vnl_c_vector_allocations = 0;
+#endif
+
+unsigned long vnl_c_vector_allocation_count()
+{
+  return vnl_c_vector_allocations;
+}
+
+void* vnl_c_vector_alloc(std::size_t n, unsigned size)
+{
+#if VXL_CXX11
+  vnl_c_vector_allocations.fetch_add(1, std::memory_order_relaxed);
+#else
+  ++vnl_c_vector_allocations;
+#endif
+  return vnl_sse_alloc(n,size);
+}
+
+void vnl_c_vector_dealloc(void* v, std::size_t n, unsigned size)
+{
+  vnl_sse_dealloc(v,n,size);
+}
@@ -147,8 +147,19 @@ class VNL_EXPORT vnl_c_vector
   static T*  allocate_T(std::size_t n);
   static void deallocate(T**, std::size_t n_when_allocated);
   static void deallocate(T*, std::size_t n_when_allocated);
+
+  //: Construct (destroy) n elements in storage not obtained from allocate_T().
+  static void construct(T*, std::size_t n);
+  static void destruct(T*, std::size_t n);
 };
 
+//: Number of blocks allocated by vnl_c_vector<T>::allocate_T() and allocate_Tptr(), for all T.
+// vnl_vector and vnl_matrix take their heap storage from these, so the
+// difference between two calls shows whether the code in between allocated.
+// The count is exact when compiled as C++11; with older compilers, blocks
+// allocated by different threads at once may be missed.
+VNL_EXPORT unsigned long vnl_c_vector_allocation_count();
+
 //: Input & output
 // \relatesalso vnl_c_vector
 template <class T> VNL_EXPORT
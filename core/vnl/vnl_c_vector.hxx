@@ -17,11 +17,52 @@
 #include <vnl/vnl_numeric_traits.h>
 
 #include <vnl/vnl_sse.h>
+#include <vnl/vnl_c_vector_simd.h>
+
+//----------------------------------------------------------------------------
+// float and double use the run-time selected kernels of vnl_c_vector_simd;
+// other types fall back to vnl_sse<T> or, where the helper returns false,
+// to the loops below.
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <class T> inline T vnl_c_vector_sum_kernel(T const* v, unsigned n)
+{ return vnl_sse<T>::sum(v,n); }
+inline double vnl_c_vector_sum_kernel(double const* v, unsigned n) { return vnl_c_vector_simd::sum(v,n); }
+inline float  vnl_c_vector_sum_kernel(float  const* v, unsigned n) { return vnl_c_vector_simd::sum(v,n); }
+
+template <class T> inline T vnl_c_vector_dot_kernel(T const* a, T const* b, unsigned n)
+{ return vnl_sse<T>::dot_product(a,b,n); }
+inline double vnl_c_vector_dot_kernel(double const* a, double const* b, unsigned n) { return vnl_c_vector_simd::dot_product(a,b,n); }
+inline float  vnl_c_vector_dot_kernel(float  const* a, float  const* b, unsigned n) { return vnl_c_vector_simd::dot_product(a,b,n); }
+
+template <class T> inline T vnl_c_vector_euclid_dist_sq_kernel(T const* a, T const* b, unsigned n)
+{ return vnl_sse<T>::euclid_dist_sq(a,b,n); }
+inline double vnl_c_vector_euclid_dist_sq_kernel(double const* a, double const* b, unsigned n) { return vnl_c_vector_simd::euclid_dist_sq(a,b,n); }
+inline float  vnl_c_vector_euclid_dist_sq_kernel(float  const* a, float  const* b, unsigned n) { return vnl_c_vector_simd::euclid_dist_sq(a,b,n); }
+
+template <class T, class S> inline bool vnl_c_vector_two_nrm2_kernel(T const*, unsigned, S*) { return false; }
+inline bool vnl_c_vector_two_nrm2_kernel(double const* p, unsigned n, double* out) { *out = vnl_c_vector_simd::two_nrm2(p,n); return true; }
+inline bool vnl_c_vector_two_nrm2_kernel(float  const* p, unsigned n, float*  out) { *out = vnl_c_vector_simd::two_nrm2(p,n); return true; }
+
+template <class T> inline bool vnl_c_vector_saxpy_kernel(T const&, T const*, T*, unsigned) { return false; }
+inline bool vnl_c_vector_saxpy_kernel(double const& a, double const* x, double* y, unsigned n) { vnl_c_vector_simd::saxpy(a,x,y,n); return true; }
+inline bool vnl_c_vector_saxpy_kernel(float  const& a, float  const* x, float*  y, unsigned n) { vnl_c_vector_simd::saxpy(a,x,y,n); return true; }
+
+#define vnl_c_vector_elmt_wise_kernel(name) \
+template <class T> inline bool vnl_c_vector_##name##_kernel(T const*, T const*, T*, unsigned) { return false; } \
+inline bool vnl_c_vector_##name##_kernel(double const* x, double const* y, double* z, unsigned n) \
+{ vnl_c_vector_simd::name(x,y,z,n); return true; } \
+inline bool vnl_c_vector_##name##_kernel(float const* x, float const* y, float* z, unsigned n) \
+{ vnl_c_vector_simd::name(x,y,z,n); return true; }
+vnl_c_vector_elmt_wise_kernel(add)
+vnl_c_vector_elmt_wise_kernel(subtract)
+vnl_c_vector_elmt_wise_kernel(multiply)
+#undef vnl_c_vector_elmt_wise_kernel
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
 template <class T>
 T vnl_c_vector<T>::sum(T const* v, unsigned n)
 {
-  return vnl_sse<T>::sum(v,n);
+  return vnl_c_vector_sum_kernel(v,n);
 }
 
 template <class T>
@@ -114,6 +155,8 @@ void vnl_c_vector<T>::scale(T const *x, T *y, unsigned n, T const &a_)
 template <class T>
 void vnl_c_vector<T>::add(T const *x, T const *y, T *z, unsigned n)
 {
+  if (vnl_c_vector_add_kernel(x, y, z, n))
+    return;
   impl_elmt_wise_commutative(+);
 }
 
@@ -126,6 +169,8 @@ void vnl_c_vector<T>::add(T const *x, T const& y, T *z, unsigned n)
 template <class T>
 void vnl_c_vector<T>::subtract(T const *x, T const *y, T *z, unsigned n)
 {
+  if (vnl_c_vector_subtract_kernel(x, y, z, n))
+    return;
   impl_elmt_wise_non_commutative(-);
 }
 
@@ -138,6 +183,8 @@ void vnl_c_vector<T>::subtract(T const *x, T const& y, T *z, unsigned n)
 template <class T>
 void vnl_c_vector<T>::multiply(T const *x, T const *y, T *z, unsigned n)
 {
+  if (vnl_c_vector_multiply_kernel(x, y, z, n))
+    return;
   impl_elmt_wise_commutative(*);
 }
 
@@ -188,6 +235,8 @@ void vnl_c_vector<T>::invert(T const *x, T *y, unsigned n)
 template <class T>
 void vnl_c_vector<T>::saxpy(T const &a_, T const *x, T *y, unsigned n)
 {
+  if (vnl_c_vector_saxpy_kernel(a_, x, y, n))
+    return;
   T a = a_;
   for (unsigned i=0; i<n; ++i)
     y[i] += a*x[i];
@@ -215,7 +264,7 @@ void vnl_c_vector<T>::reverse(T *x, unsigned n)
 template<class T>
 T vnl_c_vector<T>::dot_product(T const *a, T const *b, unsigned n)
 {
-  return vnl_sse<T>::dot_product(a,b,n);
+  return vnl_c_vector_dot_kernel(a,b,n);
 }
 
 // conjugating "dot" product.
@@ -274,7 +323,7 @@ unsigned vnl_c_vector<T>::arg_min(T const *src, unsigned n)
 template<class T>
 T vnl_c_vector<T>::euclid_dist_sq(T const *a, T const *b, unsigned n)
 {
-  return vnl_sse<T>::euclid_dist_sq(a,b,n);
+  return vnl_c_vector_euclid_dist_sq_kernel(a,b,n);
 }
 
 template <class T>
@@ -296,6 +345,8 @@ T vnl_c_vector<T>::sum_sq_diff_means(T const* v, unsigned n)
 template <class T, class S>
 void vnl_c_vector_two_norm_squared(T const *p, unsigned n, S *out)
 {
+  if (vnl_c_vector_two_nrm2_kernel(p, n, out))
+    return;
 #if 1
   // IMS: MSVC's optimiser does much better with *p++ than with p[i];
   // consistently about 30% better over vectors from 4 to 20000 dimensions.
@@ -354,16 +405,9 @@ void vnl_c_vector_inf_norm(T const *p, unsigned n, S *out)
 //---------------------------------------------------------------------------
 
 
-inline void* vnl_c_vector_alloc(std::size_t n, unsigned size)
-{
-  return vnl_sse_alloc(n,size);
-}
-
-
-inline void vnl_c_vector_dealloc(void* v, std::size_t n, unsigned size)
-{
-  vnl_sse_dealloc(v,n,size);
-}
+// Defined in vnl_c_vector.cxx, which counts the allocations.
+VNL_EXPORT void* vnl_c_vector_alloc(std::size_t n, unsigned size);
+VNL_EXPORT void vnl_c_vector_dealloc(void* v, std::size_t n, unsigned size);
 
 template<class T>
 T** vnl_c_vector<T>::allocate_Tptr(std::size_t n)
@@ -420,6 +464,18 @@ void vnl_c_vector<T>::deallocate(T* p, std::size_t n)
   vnl_c_vector_dealloc(p, n, sizeof (T));
 }
 
+template<class T>
+void vnl_c_vector<T>::construct(T* p, std::size_t n)
+{
+  vnl_c_vector_construct(p, n);
+}
+
+template<class T>
+void vnl_c_vector<T>::destruct(T* p, std::size_t n)
+{
+  vnl_c_vector_destruct(p, n);
+}
+
 template<class T>
 std::ostream& print_vector(std::ostream& s, T const* v, unsigned size)
 {
@@ -0,0 +1,341 @@
+// This is core/vnl/vnl_c_vector_simd.cxx
+//:
+// \file
+//
+// Each instruction set supplies a handful of vector primitives (load, store,
+// add, fused multiply-add, horizontal sum, ...) compiled with the matching
+// gcc/clang target attribute; VNL_C_VECTOR_SIMD_KERNELS then builds the same
+// set of kernels from each.  Only the kernels that the CPU supports are ever
+// called, so the rest of the library is still compiled for the baseline
+// architecture.
+//
+//-----------------------------------------------------------------------------
+
+#include "vnl_c_vector_simd.h"
+#include <vnl/vnl_sse.h>
+#include <vcl_compiler.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+# define VNL_C_VECTOR_SIMD_AVX2 1
+# include <immintrin.h>
+#else
+# define VNL_C_VECTOR_SIMD_AVX2 0
+#endif
+
+// _mm512_reduce_add_pd/ps first appeared in gcc 7.
+#if VNL_C_VECTOR_SIMD_AVX2 && (defined(__clang__) || __GNUC__ >= 7)
+# define VNL_C_VECTOR_SIMD_AVX512 1
+#else
+# define VNL_C_VECTOR_SIMD_AVX512 0
+#endif
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Generic kernels
+
+  template <class T> T generic_sum(T const* v, unsigned n) { return vnl_sse<T>::sum(v,n); }
+  template <class T> T generic_dot_product(T const* a, T const* b, unsigned n) { return vnl_sse<T>::dot_product(a,b,n); }
+  template <class T> T generic_euclid_dist_sq(T const* a, T const* b, unsigned n) { return vnl_sse<T>::euclid_dist_sq(a,b,n); }
+
+  template <class T> T generic_two_nrm2(T const* v, unsigned n)
+  {
+    T val(0);
+    for (unsigned i=0; i<n; ++i)
+      val += v[i]*v[i];
+    return val;
+  }
+
+  template <class T> void generic_saxpy(T a, T const* x, T* y, unsigned n)
+  {
+    for (unsigned i=0; i<n; ++i)
+      y[i] += a*x[i];
+  }
+
+  template <class T> void generic_add(T const* x, T const* y, T* z, unsigned n)
+  {
+    for (unsigned i=0; i<n; ++i)
+      z[i] = x[i] + y[i];
+  }
+
+  template <class T> void generic_subtract(T const* x, T const* y, T* z, unsigned n)
+  {
+    for (unsigned i=0; i<n; ++i)
+      z[i] = x[i] - y[i];
+  }
+
+  template <class T> void generic_multiply(T const* x, T const* y, T* z, unsigned n)
+  {
+    for (unsigned i=0; i<n; ++i)
+      z[i] = x[i] * y[i];
+  }
+
+  //----------------------------------------------------------------------------
+  // Kernels built from the primitives P##_zero, P##_load, P##_store, P##_set1,
+  // P##_vadd, P##_vsub, P##_vmul, P##_fmadd and P##_reduce, on vectors of type
+  // V holding W elements of type T.  Reductions use two accumulators to hide
+  // the latency of the adds.
+
+#define VNL_C_VECTOR_SIMD_REDUCTION(P, T, V, W, TARGET, NAME, ARGS, STEP, SCALAR) \
+  TARGET T P##_##NAME ARGS \
+  { \
+    V s0 = P##_zero(), s1 = P##_zero(); \
+    unsigned i = 0; \
+    for (; i + 2*W <= n; i += 2*W) { \
+      s0 = STEP(s0, i); \
+      s1 = STEP(s1, i+W); \
+    } \
+    if (i + W <= n) { \
+      s0 = STEP(s0, i); \
+      i += W; \
+    } \
+    T val = P##_reduce(P##_vadd(s0, s1)); \
+    for (; i < n; ++i) \
+      val += SCALAR; \
+    return val; \
+  }
+
+#define VNL_C_VECTOR_SIMD_ELEMENTWISE(P, T, W, TARGET, NAME, OP) \
+  TARGET void P##_##NAME(T const* x, T const* y, T* z, unsigned n) \
+  { \
+    unsigned i = 0; \
+    for (; i + W <= n; i += W) \
+      P##_store(z+i, P##_##OP(P##_load(x+i), P##_load(y+i))); \
+    for (; i < n; ++i) \
+      z[i] = P##_##OP(x[i], y[i]); \
+  }
+
+#define VNL_C_VECTOR_SIMD_KERNELS(P, T, V, W, TARGET) \
+  TARGET inline T P##_vadd(T a, T b) { return a + b; } \
+  TARGET inline T P##_vsub(T a, T b) { return a - b; } \
+  TARGET inline T P##_vmul(T a, T b) { return a * b; } \
+  TARGET inline V P##_sum_step(V s, T const* v, unsigned i) { return P##_vadd(s, P##_load(v+i)); } \
+  TARGET inline V P##_dot_step(V s, T const* a, T const* b, unsigned i) { return P##_fmadd(P##_load(a+i), P##_load(b+i), s); } \
+  TARGET inline V P##_diff_step(V s, T const* a, T const* b, unsigned i) \
+  { V d = P##_vsub(P##_load(a+i), P##_load(b+i)); return P##_fmadd(d, d, s); } \
+  VNL_C_VECTOR_SIMD_REDUCTION(P, T, V, W, TARGET, sum, (T const* v, unsigned n), \
+                              P##_SUM_STEP, v[i]) \
+  VNL_C_VECTOR_SIMD_REDUCTION(P, T, V, W, TARGET, two_nrm2, (T const* v, unsigned n), \
+                              P##_NRM_STEP, v[i]*v[i]) \
+  VNL_C_VECTOR_SIMD_REDUCTION(P, T, V, W, TARGET, dot_product, (T const* a, T const* b, unsigned n), \
+                              P##_DOT_STEP, a[i]*b[i]) \
+  VNL_C_VECTOR_SIMD_REDUCTION(P, T, V, W, TARGET, euclid_dist_sq, (T const* a, T const* b, unsigned n), \
+                              P##_DIFF_STEP, (a[i]-b[i])*(a[i]-b[i])) \
+  TARGET void P##_saxpy(T a, T const* x, T* y, unsigned n) \
+  { \
+    V va = P##_set1(a); \
+    unsigned i = 0; \
+    for (; i + W <= n; i += W) \
+      P##_store(y+i, P##_fmadd(va, P##_load(x+i), P##_load(y+i))); \
+    for (; i < n; ++i) \
+      y[i] += a*x[i]; \
+  } \
+  VNL_C_VECTOR_SIMD_ELEMENTWISE(P, T, W, TARGET, add, vadd) \
+  VNL_C_VECTOR_SIMD_ELEMENTWISE(P, T, W, TARGET, subtract, vsub) \
+  VNL_C_VECTOR_SIMD_ELEMENTWISE(P, T, W, TARGET, multiply, vmul)
+
+  // The per-kernel accumulate steps, as seen from inside the reductions.
+#define avx2_d_SUM_STEP(s, j)    avx2_d_sum_step(s, v, j)
+#define avx2_d_NRM_STEP(s, j)    avx2_d_dot_step(s, v, v, j)
+#define avx2_d_DOT_STEP(s, j)    avx2_d_dot_step(s, a, b, j)
+#define avx2_d_DIFF_STEP(s, j)   avx2_d_diff_step(s, a, b, j)
+#define avx2_f_SUM_STEP(s, j)    avx2_f_sum_step(s, v, j)
+#define avx2_f_NRM_STEP(s, j)    avx2_f_dot_step(s, v, v, j)
+#define avx2_f_DOT_STEP(s, j)    avx2_f_dot_step(s, a, b, j)
+#define avx2_f_DIFF_STEP(s, j)   avx2_f_diff_step(s, a, b, j)
+#define avx512_d_SUM_STEP(s, j)  avx512_d_sum_step(s, v, j)
+#define avx512_d_NRM_STEP(s, j)  avx512_d_dot_step(s, v, v, j)
+#define avx512_d_DOT_STEP(s, j)  avx512_d_dot_step(s, a, b, j)
+#define avx512_d_DIFF_STEP(s, j) avx512_d_diff_step(s, a, b, j)
+#define avx512_f_SUM_STEP(s, j)  avx512_f_sum_step(s, v, j)
+#define avx512_f_NRM_STEP(s, j)  avx512_f_dot_step(s, v, v, j)
+#define avx512_f_DOT_STEP(s, j)  avx512_f_dot_step(s, a, b, j)
+#define avx512_f_DIFF_STEP(s, j) avx512_f_diff_step(s, a, b, j)
+
+#if VNL_C_VECTOR_SIMD_AVX2
+  //----------------------------------------------------------------------------
+  // AVX2 + FMA
+
+#define VNL_AVX2_TARGET __attribute__((target("avx2,fma")))
+
+  VNL_AVX2_TARGET inline __m256d avx2_d_zero() { return _mm256_setzero_pd(); }
+  VNL_AVX2_TARGET inline __m256d avx2_d_load(double const* p) { return _mm256_loadu_pd(p); }
+  VNL_AVX2_TARGET inline void avx2_d_store(double* p, __m256d v) { _mm256_storeu_pd(p, v); }
+  VNL_AVX2_TARGET inline __m256d avx2_d_set1(double a) { return _mm256_set1_pd(a); }
+  VNL_AVX2_TARGET inline __m256d avx2_d_vadd(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+  VNL_AVX2_TARGET inline __m256d avx2_d_vsub(__m256d a, __m256d b) { return _mm256_sub_pd(a, b); }
+  VNL_AVX2_TARGET inline __m256d avx2_d_vmul(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+  VNL_AVX2_TARGET inline __m256d avx2_d_fmadd(__m256d a, __m256d b, __m256d c) { return _mm256_fmadd_pd(a, b, c); }
+  VNL_AVX2_TARGET inline double avx2_d_reduce(__m256d v)
+  {
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+  }
+  VNL_C_VECTOR_SIMD_KERNELS(avx2_d, double, __m256d, 4, VNL_AVX2_TARGET)
+
+  VNL_AVX2_TARGET inline __m256 avx2_f_zero() { return _mm256_setzero_ps(); }
+  VNL_AVX2_TARGET inline __m256 avx2_f_load(float const* p) { return _mm256_loadu_ps(p); }
+  VNL_AVX2_TARGET inline void avx2_f_store(float* p, __m256 v) { _mm256_storeu_ps(p, v); }
+  VNL_AVX2_TARGET inline __m256 avx2_f_set1(float a) { return _mm256_set1_ps(a); }
+  VNL_AVX2_TARGET inline __m256 avx2_f_vadd(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+  VNL_AVX2_TARGET inline __m256 avx2_f_vsub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+  VNL_AVX2_TARGET inline __m256 avx2_f_vmul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+  VNL_AVX2_TARGET inline __m256 avx2_f_fmadd(__m256 a, __m256 b, __m256 c) { return _mm256_fmadd_ps(a, b, c); }
+  VNL_AVX2_TARGET inline float avx2_f_reduce(__m256 v)
+  {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+  }
+  VNL_C_VECTOR_SIMD_KERNELS(avx2_f, float, __m256, 8, VNL_AVX2_TARGET)
+#endif // VNL_C_VECTOR_SIMD_AVX2
+
+#if VNL_C_VECTOR_SIMD_AVX512
+  //----------------------------------------------------------------------------
+  // AVX-512 foundation
+
+#define VNL_AVX512_TARGET __attribute__((target("avx512f")))
+
+  VNL_AVX512_TARGET inline __m512d avx512_d_zero() { return _mm512_setzero_pd(); }
+  VNL_AVX512_TARGET inline __m512d avx512_d_load(double const* p) { return _mm512_loadu_pd(p); }
+  VNL_AVX512_TARGET inline void avx512_d_store(double* p, __m512d v) { _mm512_storeu_pd(p, v); }
+  VNL_AVX512_TARGET inline __m512d avx512_d_set1(double a) { return _mm512_set1_pd(a); }
+  VNL_AVX512_TARGET inline __m512d avx512_d_vadd(__m512d a, __m512d b) { return _mm512_add_pd(a, b); }
+  VNL_AVX512_TARGET inline __m512d avx512_d_vsub(__m512d a, __m512d b) { return _mm512_sub_pd(a, b); }
+  VNL_AVX512_TARGET inline __m512d avx512_d_vmul(__m512d a, __m512d b) { return _mm512_mul_pd(a, b); }
+  VNL_AVX512_TARGET inline __m512d avx512_d_fmadd(__m512d a, __m512d b, __m512d c) { return _mm512_fmadd_pd(a, b, c); }
+  VNL_AVX512_TARGET inline double avx512_d_reduce(__m512d v) { return _mm512_reduce_add_pd(v); }
+  VNL_C_VECTOR_SIMD_KERNELS(avx512_d, double, __m512d, 8, VNL_AVX512_TARGET)
+
+  VNL_AVX512_TARGET inline __m512 avx512_f_zero() { return _mm512_setzero_ps(); }
+  VNL_AVX512_TARGET inline __m512 avx512_f_load(float const* p) { return _mm512_loadu_ps(p); }
+  VNL_AVX512_TARGET inline void avx512_f_store(float* p, __m512 v) { _mm512_storeu_ps(p, v); }
+  VNL_AVX512_TARGET inline __m512 avx512_f_set1(float a) { return _mm512_set1_ps(a); }
+  VNL_AVX512_TARGET inline __m512 avx512_f_vadd(__m512 a, __m512 b) { return _mm512_add_ps(a, b); }
+  VNL_AVX512_TARGET inline __m512 avx512_f_vsub(__m512 a, __m512 b) { return _mm512_sub_ps(a, b); }
+  VNL_AVX512_TARGET inline __m512 avx512_f_vmul(__m512 a, __m512 b) { return _mm512_mul_ps(a, b); }
+  VNL_AVX512_TARGET inline __m512 avx512_f_fmadd(__m512 a, __m512 b, __m512 c) { return _mm512_fmadd_ps(a, b, c); }
+  VNL_AVX512_TARGET inline float avx512_f_reduce(__m512 v) { return _mm512_reduce_add_ps(v); }
+  VNL_C_VECTOR_SIMD_KERNELS(avx512_f, float, __m512, 16, VNL_AVX512_TARGET)
+#endif // VNL_C_VECTOR_SIMD_AVX512
+
+  //----------------------------------------------------------------------------
+  // Dispatch
+
+  template <class T>
+  struct kernel_table
+  {
+    T (*sum)(T const*, unsigned);
+    T (*dot_product)(T const*, T const*, unsigned);
+    T (*two_nrm2)(T const*, unsigned);
+    T (*euclid_dist_sq)(T const*, T const*, unsigned);
+    void (*saxpy)(T, T const*, T*, unsigned);
+    void (*add)(T const*, T const*, T*, unsigned);
+    void (*subtract)(T const*, T const*, T*, unsigned);
+    void (*multiply)(T const*, T const*, T*, unsigned);
+  };
+
+#define VNL_C_VECTOR_SIMD_TABLE(P, T) \
+  { P##_sum, P##_dot_product, P##_two_nrm2, P##_euclid_dist_sq, \
+    P##_saxpy, P##_add, P##_subtract, P##_multiply }
+
+  const kernel_table<double> generic_d = VNL_C_VECTOR_SIMD_TABLE(generic, double);
+  const kernel_table<float>  generic_f = VNL_C_VECTOR_SIMD_TABLE(generic, float);
+#if VNL_C_VECTOR_SIMD_AVX2
+  const kernel_table<double> avx2_d = VNL_C_VECTOR_SIMD_TABLE(avx2_d, double);
+  const kernel_table<float>  avx2_f = VNL_C_VECTOR_SIMD_TABLE(avx2_f, float);
+#endif
+#if VNL_C_VECTOR_SIMD_AVX512
+  const kernel_table<double> avx512_d = VNL_C_VECTOR_SIMD_TABLE(avx512_d, double);
+  const kernel_table<float>  avx512_f = VNL_C_VECTOR_SIMD_TABLE(avx512_f, float);
+#endif
+
+  vnl_c_vector_simd::isa_t detect_isa()
+  {
+#if VNL_C_VECTOR_SIMD_AVX2
+    __builtin_cpu_init();
+# if VNL_C_VECTOR_SIMD_AVX512
+    if (__builtin_cpu_supports("avx512f"))
+      return vnl_c_vector_simd::avx512;
+# endif
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return vnl_c_vector_simd::avx2;
+#endif
+    return vnl_c_vector_simd::generic;
+  }
+
+  struct dispatch_state
+  {
+    vnl_c_vector_simd::isa_t isa;
+    kernel_table<double> const* d;
+    kernel_table<float> const* f;
+
+    void select(vnl_c_vector_simd::isa_t i)
+    {
+      isa = vnl_c_vector_simd::generic; d = &generic_d; f = &generic_f;
+#if VNL_C_VECTOR_SIMD_AVX2
+      if (i >= vnl_c_vector_simd::avx2) { isa = vnl_c_vector_simd::avx2; d = &avx2_d; f = &avx2_f; }
+#endif
+#if VNL_C_VECTOR_SIMD_AVX512
+      if (i >= vnl_c_vector_simd::avx512) { isa = vnl_c_vector_simd::avx512; d = &avx512_d; f = &avx512_f; }
+#endif
+    }
+  };
+
+  //: The selected kernels; chosen the first time any kernel is used.
+  dispatch_state& state()
+  {
+    static dispatch_state s = { vnl_c_vector_simd::generic, VXL_NULLPTR, VXL_NULLPTR };
+    if (!s.d)
+      s.select(detect_isa());
+    return s;
+  }
+}
+
+vnl_c_vector_simd::isa_t vnl_c_vector_simd::isa() { return state().isa; }
+
+vnl_c_vector_simd::isa_t vnl_c_vector_simd::best_isa()
+{
+  static const isa_t best = detect_isa();
+  return best;
+}
+
+vnl_c_vector_simd::isa_t vnl_c_vector_simd::set_isa(isa_t i)
+{
+  state().select(i < best_isa() ? i : best_isa());
+  return state().isa;
+}
+
+char const* vnl_c_vector_simd::isa_name(isa_t i)
+{
+  switch (i) {
+    case avx512: return "avx512";
+    case avx2:   return "avx2";
+    default:     return "generic";
+  }
+}
+
+double vnl_c_vector_simd::sum(double const* v, unsigned n) { return state().d->sum(v, n); }
+float  vnl_c_vector_simd::sum(float  const* v, unsigned n) { return state().f->sum(v, n); }
+
+double vnl_c_vector_simd::dot_product(double const* a, double const* b, unsigned n) { return state().d->dot_product(a, b, n); }
+float  vnl_c_vector_simd::dot_product(float  const* a, float  const* b, unsigned n) { return state().f->dot_product(a, b, n); }
+
+double vnl_c_vector_simd::two_nrm2(double const* v, unsigned n) { return state().d->two_nrm2(v, n); }
+float  vnl_c_vector_simd::two_nrm2(float  const* v, unsigned n) { return state().f->two_nrm2(v, n); }
+
+double vnl_c_vector_simd::euclid_dist_sq(double const* a, double const* b, unsigned n) { return state().d->euclid_dist_sq(a, b, n); }
+float  vnl_c_vector_simd::euclid_dist_sq(float  const* a, float  const* b, unsigned n) { return state().f->euclid_dist_sq(a, b, n); }
+
+void vnl_c_vector_simd::saxpy(double a, double const* x, double* y, unsigned n) { state().d->saxpy(a, x, y, n); }
+void vnl_c_vector_simd::saxpy(float  a, float  const* x, float*  y, unsigned n) { state().f->saxpy(a, x, y, n); }
+
+void vnl_c_vector_simd::add(double const* x, double const* y, double* z, unsigned n) { state().d->add(x, y, z, n); }
+void vnl_c_vector_simd::add(float  const* x, float  const* y, float*  z, unsigned n) { state().f->add(x, y, z, n); }
+
+void vnl_c_vector_simd::subtract(double const* x, double const* y, double* z, unsigned n) { state().d->subtract(x, y, z, n); }
+void vnl_c_vector_simd::subtract(float  const* x, float  const* y, float*  z, unsigned n) { state().f->subtract(x, y, z, n); }
+
+void vnl_c_vector_simd::multiply(double const* x, double const* y, double* z, unsigned n) { state().d->multiply(x, y, z, n); }
+void vnl_c_vector_simd::multiply(float  const* x, float  const* y, float*  z, unsigned n) { state().f->multiply(x, y, z, n); }
@@ -0,0 +1,73 @@
+// This is core/vnl/vnl_c_vector_simd.h
+#ifndef vnl_c_vector_simd_h_
+#define vnl_c_vector_simd_h_
+//:
+// \file
+// \brief Run-time selected SIMD kernels for float and double vnl_c_vector operations
+//
+// vnl_c_vector<float> and vnl_c_vector<double> forward their reductions
+// (sum, dot_product, two_nrm2, euclid_dist_sq) and element-wise kernels
+// (saxpy, add, subtract, multiply) to this class.  On x86 processors the
+// first call inspects the CPU and chooses AVX-512, AVX2+FMA or the generic
+// code, so a single binary uses the widest instruction set each machine has.
+// The generic code is that of vnl_sse<T>, and so still honours
+// VNL_CONFIG_ENABLE_SSE2.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include "vnl/vnl_export.h"
+
+class VNL_EXPORT vnl_c_vector_simd
+{
+ public:
+  //: Instruction sets for which kernels exist, in increasing order of width.
+  enum isa_t { generic = 0, avx2 = 1, avx512 = 2 };
+
+  //: The instruction set in use.
+  static isa_t isa();
+
+  //: The widest instruction set supported by this CPU and this build.
+  static isa_t best_isa();
+
+  //: Use the given instruction set, or the best supported one if it is not available.
+  // Intended for testing and benchmarking; call it before starting other threads.
+  // Returns the instruction set actually selected.
+  static isa_t set_isa(isa_t);
+
+  //: Name of an instruction set, e.g. "avx2".
+  static char const* isa_name(isa_t);
+
+  static double sum(double const* v, unsigned n);
+  static float  sum(float  const* v, unsigned n);
+
+  static double dot_product(double const* a, double const* b, unsigned n);
+  static float  dot_product(float  const* a, float  const* b, unsigned n);
+
+  //: Sum of squares.
+  static double two_nrm2(double const* v, unsigned n);
+  static float  two_nrm2(float  const* v, unsigned n);
+
+  //: Sum of squared differences.
+  static double euclid_dist_sq(double const* a, double const* b, unsigned n);
+  static float  euclid_dist_sq(float  const* a, float  const* b, unsigned n);
+
+  //: y[i] += a*x[i]
+  static void saxpy(double a, double const* x, double* y, unsigned n);
+  static void saxpy(float  a, float  const* x, float*  y, unsigned n);
+
+  //: z[i] = x[i] + y[i]; z may be x or y.
+  static void add(double const* x, double const* y, double* z, unsigned n);
+  static void add(float  const* x, float  const* y, float*  z, unsigned n);
+
+  //: z[i] = x[i] - y[i]; z may be x or y.
+  static void subtract(double const* x, double const* y, double* z, unsigned n);
+  static void subtract(float  const* x, float  const* y, float*  z, unsigned n);
+
+  //: z[i] = x[i] * y[i]; z may be x or y.
+  static void multiply(double const* x, double const* y, double* z, unsigned n);
+  static void multiply(float  const* x, float  const* y, float*  z, unsigned n);
+};
+
+#endif // vnl_c_vector_simd_h_
@@ -10,9 +10,16 @@
 //-----------------------------------------------------------------------------
 
 #include "vnl_cost_function.h"
+#include <vnl/vnl_vector_ref.h>
 #include <vcl_cassert.h>
+#include <vcl_compiler.h>
 
+// One flag per thread, so that separate minimisations may run concurrently.
+#if VXL_CXX11
+static thread_local bool f_calling_compute;
+#else
 static bool f_calling_compute;
+#endif
 
 void vnl_cost_function::compute(vnl_vector<double> const& x, double *val, vnl_vector<double>* g)
 {
@@ -20,6 +27,19 @@ void vnl_cost_function::compute(vnl_vector<double> const& x, double *val, vnl_ve
   if (g) this->gradf(x, *g);
 }
 
+//: Default implementation of compute_batch calls compute for each point.
+void vnl_cost_function::compute_batch(vnl_matrix<double> const& X, vnl_vector<double>& fx, vnl_matrix<double>* G)
+{
+  fx.set_size(X.rows());
+  if (G) G->set_size(X.rows(), X.cols());
+  vnl_vector<double> g(X.cols());
+  for (unsigned int i = 0; i < X.rows(); ++i) {
+    vnl_vector_ref<double> x(X.cols(), const_cast<double*>(X[i]));
+    this->compute(x, &fx[i], G ? &g : VXL_NULLPTR);
+    if (G) G->set_row(i, g);
+  }
+}
+
 //: Default implementation of f is compute...
 double vnl_cost_function::f(vnl_vector<double> const& x)
 {
@@ -21,6 +21,7 @@
 
 #include <vnl/vnl_unary_function.h>
 #include <vnl/vnl_vector.h>
+#include <vnl/vnl_matrix.h>
 #include "vnl/vnl_export.h"
 
 //:   An object that represents a function from R^n -> R.
@@ -48,6 +49,13 @@ class VNL_EXPORT vnl_cost_function : public vnl_unary_function<double, vnl_vecto
   //   Normally implemented in terms of the above two, but may be faster if specialized. f != 0 => compute f
   virtual void compute(vnl_vector<double> const& x, double *f, vnl_vector<double>* g);
 
+  //:  Compute f, and the gradients if G != 0, at each row of X.
+  //   fx is resized to X.rows() and *G to the size of X.  Used by line
+  //   searches that try several steps at once; the default calls compute
+  //   for each row, and may be overridden to evaluate the points together
+  //   (vectorised, or on several threads).
+  virtual void compute_batch(vnl_matrix<double> const& X, vnl_vector<double>& fx, vnl_matrix<double>* G);
+
   //:  Return the number of unknowns
   int get_number_of_unknowns() const { return dim; }
 
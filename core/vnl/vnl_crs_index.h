@@ -36,6 +36,14 @@ class VNL_EXPORT vnl_crs_index
   //: Constructor - from a binary mask
   vnl_crs_index(const std::vector<std::vector<bool> >& mask);
 
+  //: Constructor - from compressed row arrays
+  //  \p row_ptr has one entry per row plus a final entry equal to the number
+  //  of non-zeros; \p col_idx lists the columns of each row in increasing order.
+  vnl_crs_index(unsigned int num_cols,
+                const std::vector<int>& row_ptr,
+                const std::vector<int>& col_idx)
+    : num_cols_(num_cols), col_idx_(col_idx), row_ptr_(row_ptr) {}
+
   //: Destructor
   ~vnl_crs_index(){}
 
@@ -59,6 +67,12 @@ class VNL_EXPORT vnl_crs_index
   //  returns -1 if the entry is 0
   int operator() (int i, int j) const;
 
+  //: the column of each non-zero element, in row order
+  const std::vector<int>& col_idx() const { return col_idx_; }
+
+  //: the index of the first non-zero element in each row, plus num_non_zero()
+  const std::vector<int>& row_ptr() const { return row_ptr_; }
+
  private:
   //: The number of columns in the matrix
   unsigned int num_cols_;
@@ -61,6 +61,21 @@ class VNL_EXPORT vnl_diag_matrix
     return *this;
   }
 
+#ifdef VXL_HAS_CXX11_RVREF
+  vnl_diag_matrix(vnl_diag_matrix<T> const& that) : diagonal_(that.diagonal_) {}
+
+  //: Move constructor; that is left empty.
+  vnl_diag_matrix(vnl_diag_matrix<T>&& that) : diagonal_(static_cast<vnl_vector<T>&&>(that.diagonal_)) {}
+
+  //: Construct a diagonal matrix from the elements of a vnl_vector, leaving it empty.
+  vnl_diag_matrix(vnl_vector<T>&& that) : diagonal_(static_cast<vnl_vector<T>&&>(that)) {}
+
+  inline vnl_diag_matrix& operator=(vnl_diag_matrix<T>&& that) {
+    this->diagonal_ = static_cast<vnl_vector<T>&&>(that.diagonal_);
+    return *this;
+  }
+#endif
+
   // Operations----------------------------------------------------------------
 
   //: In-place arithmetic operation
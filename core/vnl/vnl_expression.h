@@ -0,0 +1,216 @@
+// This is core/vnl/vnl_expression.h
+#ifndef vnl_expression_h_
+#define vnl_expression_h_
+//:
+// \file
+// \brief Lazy element-wise arithmetic on vnl_vector and vnl_matrix
+//
+//    Every operator of vnl_vector and vnl_matrix returns a new object, so
+//    evaluating a*x + b*y - z allocates and fills a temporary at each step.
+//    Wrapping the operands in vnl_expr() builds a small expression object
+//    instead, which is evaluated element by element in a single loop when
+//    it is assigned to a vnl_vector or vnl_matrix:
+//    \code
+//      #include <vnl/vnl_expression.h>
+//      r = a * vnl_expr(x) + b * vnl_expr(y) - z;
+//    \endcode
+//    No temporary is allocated, and r is only reallocated if its size
+//    changes.  An expression can also construct a vnl_vector or vnl_matrix,
+//    be added to or subtracted from one with += and -=, and be passed where
+//    a vnl_vector const& or vnl_matrix const& is expected, which evaluates
+//    it into a temporary.
+//
+//    Only element-wise operations are lazy: + and -, element_product() and
+//    element_quotient() between expressions and vectors or matrices of the
+//    same size, +, -, * and / with a scalar, and unary minus.  A plain
+//    operand like z above may appear on either side of a lazy operator, but
+//    an operation between a plain vector and a scalar, such as b * y, is
+//    still done eagerly, so each such term needs its own vnl_expr().
+//
+//    An expression refers to the vectors and matrices it was made from, so
+//    it must be evaluated while they exist.  An expression may be assigned
+//    to one of its own operands, since each element of the result depends
+//    only on the elements at the same position.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vcl_compiler.h>
+#include <vnl/vnl_vector.h>
+#include <vnl/vnl_matrix.h>
+#include <vnl/vnl_error.h>
+
+//: Base of the lazy expressions; E is the derived class.
+//  E provides value_type, rows(), cols() and operator[](i), which gives
+//  element i in row-major order.  A vector expression has one column.
+template <class E>
+class vnl_expression
+{
+ public:
+  E const& self() const { return static_cast<E const&>(*this); }
+};
+
+//: The elements of a vnl_vector or vnl_matrix.
+template <class T>
+class vnl_expression_leaf : public vnl_expression<vnl_expression_leaf<T> >
+{
+ public:
+  typedef T value_type;
+  vnl_expression_leaf(T const* data, unsigned int r, unsigned int c)
+    : data_(data), rows_(r), cols_(c) {}
+  unsigned int rows() const { return rows_; }
+  unsigned int cols() const { return cols_; }
+  T operator[](unsigned int i) const { return data_[i]; }
+
+ private:
+  T const* data_;
+  unsigned int rows_;
+  unsigned int cols_;
+};
+
+struct vnl_expression_add { template <class T> static T apply(T a, T b) { return a + b; } };
+struct vnl_expression_sub { template <class T> static T apply(T a, T b) { return a - b; } };
+struct vnl_expression_mul { template <class T> static T apply(T a, T b) { return a * b; } };
+struct vnl_expression_div { template <class T> static T apply(T a, T b) { return a / b; } };
+
+//: Element-wise l Op r of two expressions of the same size.
+template <class L, class R, class Op>
+class vnl_expression_binary : public vnl_expression<vnl_expression_binary<L, R, Op> >
+{
+ public:
+  typedef typename L::value_type value_type;
+  vnl_expression_binary(L const& l, R const& r) : l_(l), r_(r)
+  {
+#if VNL_CONFIG_CHECK_BOUNDS  && (!defined NDEBUG)
+    if (l.rows() != r.rows() || l.cols() != r.cols())
+      vnl_error_matrix_dimension("vnl_expression_binary", l.rows(), l.cols(), r.rows(), r.cols());
+#endif
+  }
+  unsigned int rows() const { return l_.rows(); }
+  unsigned int cols() const { return l_.cols(); }
+  value_type operator[](unsigned int i) const { return Op::apply(l_[i], r_[i]); }
+
+ private:
+  L l_;
+  R r_;
+};
+
+//: e Op s for each element of e.
+template <class E, class Op>
+class vnl_expression_scalar_right : public vnl_expression<vnl_expression_scalar_right<E, Op> >
+{
+ public:
+  typedef typename E::value_type value_type;
+  vnl_expression_scalar_right(E const& e, value_type s) : e_(e), s_(s) {}
+  unsigned int rows() const { return e_.rows(); }
+  unsigned int cols() const { return e_.cols(); }
+  value_type operator[](unsigned int i) const { return Op::apply(e_[i], s_); }
+
+ private:
+  E e_;
+  value_type s_;
+};
+
+//: s Op e for each element of e.
+template <class E, class Op>
+class vnl_expression_scalar_left : public vnl_expression<vnl_expression_scalar_left<E, Op> >
+{
+ public:
+  typedef typename E::value_type value_type;
+  vnl_expression_scalar_left(value_type s, E const& e) : s_(s), e_(e) {}
+  unsigned int rows() const { return e_.rows(); }
+  unsigned int cols() const { return e_.cols(); }
+  value_type operator[](unsigned int i) const { return Op::apply(s_, e_[i]); }
+
+ private:
+  value_type s_;
+  E e_;
+};
+
+//: -e
+template <class E>
+class vnl_expression_negate : public vnl_expression<vnl_expression_negate<E> >
+{
+ public:
+  typedef typename E::value_type value_type;
+  explicit vnl_expression_negate(E const& e) : e_(e) {}
+  unsigned int rows() const { return e_.rows(); }
+  unsigned int cols() const { return e_.cols(); }
+  value_type operator[](unsigned int i) const { return -e_[i]; }
+
+ private:
+  E e_;
+};
+
+//: Start a lazy expression with the elements of v.
+// \relatesalso vnl_vector
+template <class T>
+inline vnl_expression_leaf<T> vnl_expr(vnl_vector<T> const& v)
+{
+  return vnl_expression_leaf<T>(v.data_block(), v.size(), 1);
+}
+
+//: Start a lazy expression with the elements of M.
+// \relatesalso vnl_matrix
+template <class T>
+inline vnl_expression_leaf<T> vnl_expr(vnl_matrix<T> const& M)
+{
+  return vnl_expression_leaf<T>(M.data_block(), M.rows(), M.cols());
+}
+
+// Element-wise operations between two expressions, or an expression and a
+// vector or matrix.
+#define VNL_EXPRESSION_BINARY(fn, Op) \
+template <class L, class R> \
+inline vnl_expression_binary<L, R, Op > \
+fn(vnl_expression<L> const& l, vnl_expression<R> const& r) \
+{ return vnl_expression_binary<L, R, Op >(l.self(), r.self()); } \
+template <class L> \
+inline vnl_expression_binary<L, vnl_expression_leaf<typename L::value_type>, Op > \
+fn(vnl_expression<L> const& l, vnl_vector<typename L::value_type> const& r) \
+{ return vnl_expression_binary<L, vnl_expression_leaf<typename L::value_type>, Op >(l.self(), vnl_expr(r)); } \
+template <class R> \
+inline vnl_expression_binary<vnl_expression_leaf<typename R::value_type>, R, Op > \
+fn(vnl_vector<typename R::value_type> const& l, vnl_expression<R> const& r) \
+{ return vnl_expression_binary<vnl_expression_leaf<typename R::value_type>, R, Op >(vnl_expr(l), r.self()); } \
+template <class L> \
+inline vnl_expression_binary<L, vnl_expression_leaf<typename L::value_type>, Op > \
+fn(vnl_expression<L> const& l, vnl_matrix<typename L::value_type> const& r) \
+{ return vnl_expression_binary<L, vnl_expression_leaf<typename L::value_type>, Op >(l.self(), vnl_expr(r)); } \
+template <class R> \
+inline vnl_expression_binary<vnl_expression_leaf<typename R::value_type>, R, Op > \
+fn(vnl_matrix<typename R::value_type> const& l, vnl_expression<R> const& r) \
+{ return vnl_expression_binary<vnl_expression_leaf<typename R::value_type>, R, Op >(vnl_expr(l), r.self()); }
+
+VNL_EXPRESSION_BINARY(operator+, vnl_expression_add)
+VNL_EXPRESSION_BINARY(operator-, vnl_expression_sub)
+VNL_EXPRESSION_BINARY(element_product, vnl_expression_mul)
+VNL_EXPRESSION_BINARY(element_quotient, vnl_expression_div)
+#undef VNL_EXPRESSION_BINARY
+
+// Operations between an expression and a scalar.
+#define VNL_EXPRESSION_SCALAR(op, Op) \
+template <class E> \
+inline vnl_expression_scalar_right<E, Op > \
+operator op(vnl_expression<E> const& e, typename E::value_type s) \
+{ return vnl_expression_scalar_right<E, Op >(e.self(), s); } \
+template <class E> \
+inline vnl_expression_scalar_left<E, Op > \
+operator op(typename E::value_type s, vnl_expression<E> const& e) \
+{ return vnl_expression_scalar_left<E, Op >(s, e.self()); }
+
+VNL_EXPRESSION_SCALAR(+, vnl_expression_add)
+VNL_EXPRESSION_SCALAR(-, vnl_expression_sub)
+VNL_EXPRESSION_SCALAR(*, vnl_expression_mul)
+VNL_EXPRESSION_SCALAR(/, vnl_expression_div)
+#undef VNL_EXPRESSION_SCALAR
+
+//: Negate each element.
+template <class E>
+inline vnl_expression_negate<E> operator-(vnl_expression<E> const& e)
+{
+  return vnl_expression_negate<E>(e.self());
+}
+
+#endif // vnl_expression_h_
@@ -10,9 +10,9 @@
 //-----------------------------------------------------------------------------
 
 #include <cstdlib>
-#include <cstring>
 #include <iostream>
 #include "vnl_fastops.h"
+#include <vnl/vnl_gemm.h>
 
 #include <vcl_compiler.h>
 
@@ -26,32 +26,8 @@ void vnl_fastops::AtA(vnl_matrix<double>& out, const vnl_matrix<double>& A)
 
   const unsigned int m = A.rows();
 
-  double const* const* a = A.data_array();
-  double** ata = out.data_array();
-
-/* Simple Implementation for reference:
-    for (unsigned int i = 0; i < n; ++i)
-      for (unsigned int j = i; j < n; ++j) {
-        double accum = 0;
-        for (unsigned int k = 0; k < m; ++k)
-          accum += a[k][i] * a[k][j];
-        ata[i][j] = ata[j][i] = accum;
-      }
- Next is 5 times faster on 600 Mhz Pentium III for m = 10000, n = 50
-*/
-    std::memset(ata[0], 0, n * n * sizeof ata[0][0]);
-    for (unsigned int k = 0; k < m; ++k)
-      for (unsigned int i = 0; i < n; ++i) {
-        const double aki = a[k][i];
-        double const* arow = a[k] + i;
-        double* atarow = ata[i] + i;
-        double const* arowend = a[k] + n;
-        while (arow != arowend)
-          *atarow++ += aki * *arow++;
-      }
-      for (unsigned int i = 0; i < n; ++i)
-        for (unsigned int j = i+1; j < n; ++j)
-          ata[j][i] = ata[i][j];
+  vnl_gemm(true, false, n, n, m, 1.0, A.data_block(), n, A.data_block(), n,
+           0.0, out.data_block(), n);
 }
 
 //: Compute AxB.
@@ -73,17 +49,8 @@ void vnl_fastops::AB(vnl_matrix<double>& out, const vnl_matrix<double>& A, const
   if (out.rows() != ma || out.columns() != nb)
     out.set_size(ma,nb);
 
-  double const* const* a = A.data_array();
-  double const* const* b = B.data_array();
-  double** outdata = out.data_array();
-
-  for (unsigned int i = 0; i < ma; ++i)
-    for (unsigned int j = 0; j < nb; ++j) {
-      double accum = 0;
-      for (unsigned int k = 0; k < na; ++k)
-        accum += a[i][k] * b[k][j];
-      outdata[i][j] = accum;
-    }
+  vnl_gemm(false, false, ma, nb, na, 1.0, A.data_block(), na, B.data_block(), nb,
+           0.0, out.data_block(), nb);
 }
 
 //: Compute $A^\top B$.
@@ -105,17 +72,8 @@ void vnl_fastops::AtB(vnl_matrix<double>& out, const vnl_matrix<double>& A, cons
   if (out.rows() != na || out.columns() != nb)
     out.set_size(na,nb);
 
-  double const* const* a = A.data_array();
-  double const* const* b = B.data_array();
-  double** outdata = out.data_array();
-
-  for (unsigned int i = 0; i < na; ++i)
-    for (unsigned int j = 0; j < nb; ++j) {
-      double accum = 0;
-      for (unsigned int k = 0; k < ma; ++k)
-        accum += a[k][i] * b[k][j];
-      outdata[i][j] = accum;
-    }
+  vnl_gemm(true, false, na, nb, ma, 1.0, A.data_block(), na, B.data_block(), nb,
+           0.0, out.data_block(), nb);
 }
 
 //: Compute $A^\top b$ for vector b. out may not be b.
@@ -197,17 +155,8 @@ void vnl_fastops::ABt(vnl_matrix<double>& out, const vnl_matrix<double>& A, cons
   if (out.rows() != ma || out.columns() != mb)
     out.set_size(ma,mb);
 
-  double const* const* a = A.data_array();
-  double const* const* b = B.data_array();
-  double** outdata = out.data_array();
-
-  for (unsigned int i = 0; i < ma; ++i)
-    for (unsigned int j = 0; j < mb; ++j) {
-      double accum = 0;
-      for (unsigned int k = 0; k < na; ++k)
-        accum += a[i][k] * b[j][k];
-      outdata[i][j] = accum;
-    }
+  vnl_gemm(false, true, ma, mb, na, 1.0, A.data_block(), na, B.data_block(), nb,
+           0.0, out.data_block(), mb);
 }
 
 //: Compute $A B A^\top$.
@@ -311,15 +260,8 @@ void vnl_fastops::inc_X_by_AtA(vnl_matrix<double>& X, const vnl_matrix<double>&
       }
     }
   } else {
-    for (unsigned int i = 0; i < n; ++i)
-      for (unsigned int j = i; j < n; ++j) {
-        double accum = 0;
-        for (unsigned int k = 0; k < l; ++k)
-          accum += a[k][i] * a[k][j];
-        x[i][j] += accum;
-        if (i != j)
-          x[j][i] += accum;
-      }
+    vnl_gemm(true, false, n, n, l, 1.0, A.data_block(), n, A.data_block(), n,
+             1.0, X.data_block(), n);
   }
 }
 
@@ -346,14 +288,8 @@ void vnl_fastops::inc_X_by_AB(vnl_matrix<double>& X, const vnl_matrix<double>& A
     std::abort();
   }
 
-  double const* const* a = A.data_array();
-  double const* const* b = B.data_array();
-  double** x = X.data_array();
-
-  for (unsigned int i = 0; i < ma; ++i)
-    for (unsigned int j = 0; j < nb; ++j)
-      for (unsigned int k = 0; k < na; ++k)
-        x[i][j] += a[i][k] * b[k][j];
+  vnl_gemm(false, false, ma, nb, na, 1.0, A.data_block(), na, B.data_block(), nb,
+           1.0, X.data_block(), nx);
 }
 
 //: Compute $X -= A B$
@@ -379,14 +315,8 @@ void vnl_fastops::dec_X_by_AB(vnl_matrix<double>& X, const vnl_matrix<double>& A
     std::abort();
   }
 
-  double const* const* a = A.data_array();
-  double const* const* b = B.data_array();
-  double** x = X.data_array();
-
-  for (unsigned int i = 0; i < ma; ++i)
-    for (unsigned int j = 0; j < nb; ++j)
-      for (unsigned int k = 0; k < na; ++k)
-        x[i][j] -= a[i][k] * b[k][j];
+  vnl_gemm(false, false, ma, nb, na, -1.0, A.data_block(), na, B.data_block(), nb,
+           1.0, X.data_block(), nx);
 }
 
 //: Compute $X += A^\top B$
@@ -412,17 +342,8 @@ void vnl_fastops::inc_X_by_AtB(vnl_matrix<double>& X, const vnl_matrix<double>&
     std::abort();
   }
 
-  double const* const* a = A.data_array();
-  double const* const* b = B.data_array();
-  double** x = X.data_array();
-
-  for (unsigned int i = 0; i < na; ++i)
-    for (unsigned int j = 0; j < nb; ++j) {
-      double accum = 0;
-      for (unsigned int k = 0; k < ma; ++k)
-        accum += a[k][i] * b[k][j];
-      x[i][j] += accum;
-    }
+  vnl_gemm(true, false, na, nb, ma, 1.0, A.data_block(), na, B.data_block(), nb,
+           1.0, X.data_block(), nx);
 }
 
 //: Compute $X -= A^\top B$
@@ -448,17 +369,8 @@ void vnl_fastops::dec_X_by_AtB(vnl_matrix<double>& X, const vnl_matrix<double>&
     std::abort();
   }
 
-  double const* const* a = A.data_array();
-  double const* const* b = B.data_array();
-  double** x = X.data_array();
-
-  for (unsigned int i = 0; i < na; ++i)
-    for (unsigned int j = 0; j < nb; ++j) {
-      double accum = 0;
-      for (unsigned int k = 0; k < ma; ++k)
-        accum += a[k][i] * b[k][j];
-      x[i][j] -= accum;
-    }
+  vnl_gemm(true, false, na, nb, ma, -1.0, A.data_block(), na, B.data_block(), nb,
+           1.0, X.data_block(), nx);
 }
 
 //: Compute $X += A^\top b$
@@ -554,15 +466,8 @@ void vnl_fastops::dec_X_by_AtA(vnl_matrix<double>& X, const vnl_matrix<double>&
       }
     }
   } else {
-    for (unsigned int i = 0; i < n; ++i)
-      for (unsigned int j = i; j < n; ++j) {
-        double accum = 0;
-        for (unsigned int k = 0; k < l; ++k)
-          accum += a[k][i] * a[k][j];
-        x[i][j] -= accum;
-        if (i != j)
-          x[j][i] -= accum;
-      }
+    vnl_gemm(true, false, n, n, l, -1.0, A.data_block(), n, A.data_block(), n,
+             1.0, X.data_block(), n);
   }
 }
 
@@ -636,9 +541,8 @@ void vnl_fastops::inc_X_by_ABt(vnl_matrix<double>& X, const vnl_matrix<double>&
       for (unsigned int j = 0; j < ma; ++j)
         x[j][i] += a[j][0] * b[i][0];
   } else {
-    for (unsigned int i = 0; i < mb; ++i)
-      for (unsigned int j = 0; j < ma; ++j)
-        x[j][i] += dot(a[j], b[i], na);
+    vnl_gemm(false, true, ma, mb, na, 1.0, A.data_block(), na, B.data_block(), nb,
+             1.0, X.data_block(), nx);
   }
 }
 
@@ -685,9 +589,8 @@ void vnl_fastops::dec_X_by_ABt(vnl_matrix<double>& X, const vnl_matrix<double>&
       for (unsigned int j = 0; j < ma; ++j)
         x[j][i] -= a[j][0] * b[i][0];
   } else {
-    for (unsigned int i = 0; i < mb; ++i)
-      for (unsigned int j = 0; j < ma; ++j)
-        x[j][i] -= dot(a[j], b[i], na);
+    vnl_gemm(false, true, ma, mb, na, -1.0, A.data_block(), na, B.data_block(), nb,
+             1.0, X.data_block(), nx);
   }
 }
 
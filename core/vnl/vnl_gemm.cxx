@@ -0,0 +1,209 @@
+// This is core/vnl/vnl_gemm.cxx
+//:
+// \file
+//
+// The blocking follows the usual layout for packed matrix products: a
+// KC x NC panel of op(B) is packed once and reused for every MC x KC block of
+// op(A), which in turn is packed into MR-row strips.  The kernel keeps an
+// MR x NR tile of C in registers while it runs along KC.
+//
+//-----------------------------------------------------------------------------
+
+#include <vector>
+#include "vnl_gemm.h"
+#include <vcl_compiler.h>
+
+namespace
+{
+  //: Blocking parameters.
+  // The C tile is MR x NR, with NR chosen to fill two 128-bit registers per
+  // row; MC x KC of op(A) fits in L2 and KC x NR of op(B) in L1.
+  template <class T>
+  struct vnl_gemm_blocking
+  {
+    enum { MR = 4, NR = 32/sizeof(T), KC = 256, MC = 128, NC = 4096 };
+  };
+
+  //: Products with fewer multiply-adds than this are not worth packing.
+  const unsigned long vnl_gemm_small_product = 32*32*32;
+
+  //: Straightforward row-oriented product, C += alpha*op(A)*op(B).
+  template <class T>
+  void vnl_gemm_simple(unsigned m, unsigned n, unsigned k, T alpha,
+                       T const* A, unsigned rsA, unsigned csA,
+                       T const* B, unsigned rsB, unsigned csB,
+                       T* C, unsigned ldc)
+  {
+    if (csB == 1) {
+      for (unsigned i = 0; i < m; ++i) {
+        T* ci = C + i*ldc;
+        for (unsigned p = 0; p < k; ++p) {
+          const T a = alpha * A[i*rsA + p*csA];
+          T const* bp = B + p*rsB;
+          for (unsigned j = 0; j < n; ++j)
+            ci[j] += a * bp[j];
+        }
+      }
+    }
+    else {
+      for (unsigned i = 0; i < m; ++i) {
+        T* ci = C + i*ldc;
+        for (unsigned j = 0; j < n; ++j) {
+          T sum(0);
+          for (unsigned p = 0; p < k; ++p)
+            sum += A[i*rsA + p*csA] * B[p*rsB + j*csB];
+          ci[j] += alpha * sum;
+        }
+      }
+    }
+  }
+
+  //: Copy an mc x kc block of op(A) into MR-row strips, zero padded.
+  template <class T>
+  void vnl_gemm_pack_A(unsigned mc, unsigned kc, T const* A, unsigned rsA, unsigned csA, T* dst)
+  {
+    const unsigned MR = vnl_gemm_blocking<T>::MR;
+    for (unsigned ir = 0; ir < mc; ir += MR) {
+      const unsigned mr = mc - ir < MR ? mc - ir : MR;
+      T const* a = A + ir*rsA;
+      for (unsigned p = 0; p < kc; ++p, dst += MR) {
+        unsigned i = 0;
+        for (; i < mr; ++i) dst[i] = a[i*rsA + p*csA];
+        for (; i < MR; ++i) dst[i] = T(0);
+      }
+    }
+  }
+
+  //: Copy a kc x nc panel of op(B) into NR-column strips, zero padded.
+  template <class T>
+  void vnl_gemm_pack_B(unsigned kc, unsigned nc, T const* B, unsigned rsB, unsigned csB, T* dst)
+  {
+    const unsigned NR = vnl_gemm_blocking<T>::NR;
+    for (unsigned jr = 0; jr < nc; jr += NR) {
+      const unsigned nr = nc - jr < NR ? nc - jr : NR;
+      T const* b = B + jr*csB;
+      for (unsigned p = 0; p < kc; ++p, dst += NR) {
+        unsigned j = 0;
+        for (; j < nr; ++j) dst[j] = b[p*rsB + j*csB];
+        for (; j < NR; ++j) dst[j] = T(0);
+      }
+    }
+  }
+
+  //: C(0:mr,0:nr) += alpha * (packed strip a) * (packed strip b).
+  template <class T>
+  inline void vnl_gemm_kernel(unsigned kc, T const* a, T const* b, T alpha,
+                              T* C, unsigned ldc, unsigned mr, unsigned nr)
+  {
+    const unsigned MR = vnl_gemm_blocking<T>::MR;
+    const unsigned NR = vnl_gemm_blocking<T>::NR;
+    T acc[MR][NR];
+    for (unsigned i = 0; i < MR; ++i)
+      for (unsigned j = 0; j < NR; ++j)
+        acc[i][j] = T(0);
+
+    for (unsigned p = 0; p < kc; ++p, a += MR, b += NR)
+      for (unsigned i = 0; i < MR; ++i) {
+        const T ai = a[i];
+        for (unsigned j = 0; j < NR; ++j)
+          acc[i][j] += ai * b[j];
+      }
+
+    for (unsigned i = 0; i < mr; ++i, C += ldc)
+      for (unsigned j = 0; j < nr; ++j)
+        C[j] += alpha * acc[i][j];
+  }
+
+  template <class T>
+  void vnl_gemm_impl(bool transA, bool transB,
+                     unsigned m, unsigned n, unsigned k,
+                     T alpha, T const* A, unsigned lda,
+                     T const* B, unsigned ldb,
+                     T beta, T* C, unsigned ldc)
+  {
+    if (m == 0 || n == 0)
+      return;
+
+    // Apply beta first; a zero beta overwrites C, so its contents need not be valid.
+    if (beta == T(0)) {
+      for (unsigned i = 0; i < m; ++i)
+        for (unsigned j = 0; j < n; ++j)
+          C[i*ldc + j] = T(0);
+    }
+    else if (beta != T(1)) {
+      for (unsigned i = 0; i < m; ++i)
+        for (unsigned j = 0; j < n; ++j)
+          C[i*ldc + j] *= beta;
+    }
+    if (k == 0 || alpha == T(0))
+      return;
+
+    // Element (i,p) of op(A) is A[i*rsA + p*csA]; likewise for op(B).
+    const unsigned rsA = transA ? 1 : lda, csA = transA ? lda : 1;
+    const unsigned rsB = transB ? 1 : ldb, csB = transB ? ldb : 1;
+
+    if ((unsigned long)m * n * k <= vnl_gemm_small_product) {
+      vnl_gemm_simple(m, n, k, alpha, A, rsA, csA, B, rsB, csB, C, ldc);
+      return;
+    }
+
+    const unsigned MR = vnl_gemm_blocking<T>::MR;
+    const unsigned NR = vnl_gemm_blocking<T>::NR;
+    const unsigned KC = vnl_gemm_blocking<T>::KC;
+    const unsigned MC = vnl_gemm_blocking<T>::MC;
+    const unsigned NC = vnl_gemm_blocking<T>::NC;
+
+    const unsigned ncmax = n < NC ? n : NC;
+    std::vector<T> Bp(KC * ((ncmax + NR - 1) / NR) * NR);
+    const int nblocks = int((m + MC - 1) / MC);
+
+    for (unsigned jc = 0; jc < n; jc += NC) {
+      const unsigned nc = n - jc < NC ? n - jc : NC;
+      for (unsigned pc = 0; pc < k; pc += KC) {
+        const unsigned kc = k - pc < KC ? k - pc : KC;
+        vnl_gemm_pack_B(kc, nc, B + pc*rsB + jc*csB, rsB, csB, &Bp[0]);
+
+#if defined(_OPENMP)
+#pragma omp parallel if (nblocks > 1)
+#endif
+        {
+          std::vector<T> Ap(MC * kc);
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic)
+#endif
+          for (int blk = 0; blk < nblocks; ++blk) {
+            const unsigned ic = unsigned(blk) * MC;
+            const unsigned mc = m - ic < MC ? m - ic : MC;
+            vnl_gemm_pack_A(mc, kc, A + ic*rsA + pc*csA, rsA, csA, &Ap[0]);
+            for (unsigned jr = 0; jr < nc; jr += NR) {
+              const unsigned nr = nc - jr < NR ? nc - jr : NR;
+              for (unsigned ir = 0; ir < mc; ir += MR) {
+                const unsigned mr = mc - ir < MR ? mc - ir : MR;
+                vnl_gemm_kernel(kc, &Ap[ir*kc], &Bp[jr*kc], alpha,
+                                C + (ic + ir)*ldc + jc + jr, ldc, mr, nr);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+void vnl_gemm(bool transA, bool transB,
+              unsigned m, unsigned n, unsigned k,
+              double alpha, double const* A, unsigned lda,
+              double const* B, unsigned ldb,
+              double beta, double* C, unsigned ldc)
+{
+  vnl_gemm_impl(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+void vnl_gemm(bool transA, bool transB,
+              unsigned m, unsigned n, unsigned k,
+              float alpha, float const* A, unsigned lda,
+              float const* B, unsigned ldb,
+              float beta, float* C, unsigned ldc)
+{
+  vnl_gemm_impl(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
@@ -0,0 +1,40 @@
+// This is core/vnl/vnl_gemm.h
+#ifndef vnl_gemm_h_
+#define vnl_gemm_h_
+//:
+// \file
+// \brief Cache-blocked general matrix-matrix product for float and double
+//
+// vnl_gemm computes C = alpha*op(A)*op(B) + beta*C on row-major arrays,
+// where op(X) is X or its transpose, in the style of the BLAS routine xGEMM.
+// op(A) is m x k, op(B) is k x n and C is m x n; lda, ldb and ldc are the
+// row strides of the arrays as stored.
+//
+// The operands are copied into contiguous panels sized to stay in cache and
+// multiplied by a small register-tiled kernel which the compiler is able to
+// vectorise.  When built with OpenMP the row panels of C are shared among
+// threads.  Small products are done with a plain loop, where packing would
+// cost more than it saves.
+//
+// This is the kernel behind vnl_matrix<float/double>::operator*, vnl_fastops
+// and mbl_matrix_products.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include "vnl/vnl_export.h"
+
+VNL_EXPORT void vnl_gemm(bool transA, bool transB,
+                         unsigned m, unsigned n, unsigned k,
+                         double alpha, double const* A, unsigned lda,
+                         double const* B, unsigned ldb,
+                         double beta, double* C, unsigned ldc);
+
+VNL_EXPORT void vnl_gemm(bool transA, bool transB,
+                         unsigned m, unsigned n, unsigned k,
+                         float alpha, float const* A, unsigned lda,
+                         float const* B, unsigned ldb,
+                         float beta, float* C, unsigned ldc);
+
+#endif // vnl_gemm_h_
@@ -11,6 +11,8 @@
 #include "vnl_least_squares_function.h"
 #include <vcl_compiler.h>
 #include <vcl_cassert.h>
+#include <vnl/vnl_vector_ref.h>
+#include <vnl/vnl_matrix_ref.h>
 
 void vnl_least_squares_function::dim_warning(unsigned int number_of_unknowns,
                                              unsigned int number_of_residuals)
@@ -75,7 +77,8 @@ void vnl_least_squares_function::ffdgradf(vnl_vector<double> const& x,
   vnl_vector<double> tx = x;
   vnl_vector<double> fplus(n);
   vnl_vector<double> fcentre(n);
-  this->f(x, fcentre);
+  if (!cached_f(x, fcentre))
+    this->f(x, fcentre);
   for (unsigned int i = 0; i < dim; ++i)
   {
     // calculate f just to the right of x[i]
@@ -91,6 +94,78 @@ void vnl_least_squares_function::ffdgradf(vnl_vector<double> const& x,
   }
 }
 
+void vnl_least_squares_function::f_block(vnl_vector<double> const& /*x*/,
+                                         unsigned int /*first*/,
+                                         vnl_vector<double>& /*fx*/)
+{
+  std::cerr << "Warning: f_block() called but not implemented in derived class\n";
+}
+
+void vnl_least_squares_function::gradf_block(vnl_vector<double> const& /*x*/,
+                                             unsigned int /*first*/,
+                                             vnl_matrix<double>& /*jacobian*/)
+{
+  std::cerr << "Warning: gradf_block() called but not implemented in derived class\n";
+}
+
+void vnl_least_squares_function::f_blocks(vnl_vector<double> const& x,
+                                          vnl_vector<double>& fx)
+{
+  assert(fx.size() == n_);
+  const unsigned int bs = block_size_ > 0 ? block_size_ : n_;
+  const int num_blocks = bs > 0 ? int((n_ + bs - 1) / bs) : 0;
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int b = 0; b < num_blocks; ++b)
+  {
+    const unsigned int first = b * bs;
+    const unsigned int count = first + bs < n_ ? bs : n_ - first;
+    vnl_vector_ref<double> fx_block(count, fx.data_block() + first);
+    f_block(x, first, fx_block);
+  }
+}
+
+void vnl_least_squares_function::gradf_blocks(vnl_vector<double> const& x,
+                                              vnl_matrix<double>& jacobian)
+{
+  assert(jacobian.rows() == n_ && jacobian.cols() == p_);
+  const unsigned int bs = block_size_ > 0 ? block_size_ : n_;
+  const int num_blocks = bs > 0 ? int((n_ + bs - 1) / bs) : 0;
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int b = 0; b < num_blocks; ++b)
+  {
+    const unsigned int first = b * bs;
+    const unsigned int count = first + bs < n_ ? bs : n_ - first;
+    vnl_matrix_ref<double> jacobian_block(count, p_, jacobian[first]);
+    gradf_block(x, first, jacobian_block);
+  }
+}
+
+void vnl_least_squares_function::cache_evaluation(vnl_vector<double> const& x,
+                                                  vnl_vector<double> const& fx)
+{
+  cache_x_ = x;
+  cache_fx_ = fx;
+}
+
+bool vnl_least_squares_function::cached_f(vnl_vector<double> const& x,
+                                          vnl_vector<double>& fx) const
+{
+  if (cache_x_.empty() || x != cache_x_)
+    return false;
+  fx = cache_fx_;
+  return true;
+}
+
+void vnl_least_squares_function::clear_cache()
+{
+  cache_x_.clear();
+  cache_fx_.clear();
+}
+
 void vnl_least_squares_function::trace(int /* iteration */,
                                        vnl_vector<double> const& /*x*/,
                                        vnl_vector<double> const& /*fx*/)
@@ -101,6 +176,7 @@ void vnl_least_squares_function::trace(int /* iteration */,
 double vnl_least_squares_function::rms(vnl_vector<double> const& x)
 {
   vnl_vector<double> fx(n_);
-  f(x, fx);
+  if (!cached_f(x, fx))
+    f(x, fx);
   return fx.rms();
 }
@@ -35,6 +35,19 @@
 //    want to cache some information during the call, and if they're compute
 //    objects, will almost certainly be writing to members during the
 //    computation.  For the moment it's non-const, but we'll see...
+//
+//    Residuals that fall into independent groups (one per image point, say)
+//    may instead be computed a block at a time: implement f_block (and
+//    optionally gradf_block), call set_block_size in the constructor, and let
+//    f (and gradf) call f_blocks (and gradf_blocks), which share the blocks
+//    among threads when VNL_CONFIG_ENABLE_OPENMP is set:
+//    \code
+//      void f(vnl_vector<double> const& x, vnl_vector<double>& fx) { f_blocks(x, fx); }
+//    \endcode
+//
+//    Minimizers record the residuals at each point they accept with
+//    cache_evaluation.  ffdgradf and rms reuse them instead of calling f again
+//    at that point, and gradf may use cached_f to do the same.
 class VNL_EXPORT vnl_least_squares_function
 {
  public:
@@ -53,7 +66,7 @@ class VNL_EXPORT vnl_least_squares_function
                              unsigned int number_of_residuals,
                              UseGradient g = use_gradient)
   : failure(false), p_(number_of_unknowns), n_(number_of_residuals),
-    use_gradient_(g == use_gradient)
+    use_gradient_(g == use_gradient), block_size_(0)
   { dim_warning(p_,n_); }
 
   virtual ~vnl_least_squares_function() {}
@@ -79,6 +92,35 @@ class VNL_EXPORT vnl_least_squares_function
   void ffdgradf(vnl_vector<double> const& x, vnl_matrix<double>& jacobian,
                 double stepsize);
 
+  //: Compute the fx.size() residuals starting at residual first.
+  //  Called concurrently for disjoint blocks by f_blocks, so it must not
+  //  write to shared members.
+  virtual void f_block(vnl_vector<double> const& x, unsigned int first,
+                       vnl_vector<double>& fx);
+
+  //: Compute the jacobian.rows() rows of the Jacobian starting at row first.
+  //  Called concurrently for disjoint blocks by gradf_blocks.
+  virtual void gradf_block(vnl_vector<double> const& x, unsigned int first,
+                           vnl_matrix<double>& jacobian);
+
+  //: Compute f(x) by calling f_block on each block of block_size() residuals.
+  void f_blocks(vnl_vector<double> const& x, vnl_vector<double>& fx);
+
+  //: Compute the Jacobian by calling gradf_block on each block of block_size() rows.
+  void gradf_blocks(vnl_vector<double> const& x, vnl_matrix<double>& jacobian);
+
+  //: Number of residuals per block for f_blocks and gradf_blocks; 0 means one block.
+  unsigned int block_size() const { return block_size_; }
+
+  //: Record that f(x) = fx, at a point accepted by a minimizer.
+  void cache_evaluation(vnl_vector<double> const& x, vnl_vector<double> const& fx);
+
+  //: If f(x) has been cached, copy it into fx and return true.
+  bool cached_f(vnl_vector<double> const& x, vnl_vector<double>& fx) const;
+
+  //: Forget the cached evaluation; call this when the data behind f change.
+  void clear_cache();
+
   //: Called after each LM iteration to print debugging etc.
   virtual void trace(int iteration,
                      vnl_vector<double> const& x,
@@ -100,11 +142,19 @@ class VNL_EXPORT vnl_least_squares_function
   unsigned int p_;
   unsigned int n_;
   bool use_gradient_;
+  unsigned int block_size_;
+
+  //: Set the number of residuals per block for f_blocks and gradf_blocks.
+  void set_block_size(unsigned int block_size) { block_size_ = block_size; }
 
   void init(unsigned int number_of_unknowns, unsigned int number_of_residuals)
   { p_ = number_of_unknowns; n_ = number_of_residuals; dim_warning(p_,n_); }
  private:
   void dim_warning(unsigned int n_unknowns, unsigned int n_residuals);
+
+  //: The last evaluation recorded by cache_evaluation
+  vnl_vector<double> cache_x_;
+  vnl_vector<double> cache_fx_;
 };
 
 #endif // vnl_least_squares_function_h_
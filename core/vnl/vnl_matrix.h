@@ -55,6 +55,7 @@
 
 VCL_TEMPLATE_EXPORT template <class T> class vnl_vector;
 VCL_TEMPLATE_EXPORT template <class T> class vnl_matrix;
+template <class E> class vnl_expression;
 
 //--------------------------------------------------------------------------------
 
@@ -103,6 +104,10 @@ enum VNL_EXPORT vnl_matrix_type
 //
 // Note: Indexing of the matrix is zero-based, so the top-left element is M(0,0).
 //
+// Note: Unless VNL_CONFIG_SMALL_BUFFER is 0, matrices of up to 80 bytes
+// (e.g. 3x3 double) keep their elements inline, and matrices of up to 4
+// rows their row pointers, so a vnl_matrix must not be copied bytewise.
+//
 // Note: Inversion of matrix M, and other operations such as solving systems of linear
 // equations are handled by the matrix decomposition classes in vnl/algo, such
 // as matrix_inverse, svd, qr etc.
@@ -117,7 +122,8 @@ class VNL_EXPORT vnl_matrix
   vnl_matrix() :
     num_rows(0),
     num_cols(0),
-    data(VXL_NULLPTR)
+    data(VXL_NULLPTR),
+    vnl_matrix_own_data(1)
   {
   }
 
@@ -149,6 +155,18 @@ class VNL_EXPORT vnl_matrix
   // Complexity $O(r.c)$
   vnl_matrix(vnl_matrix<T> const&);                             // from another matrix.
 
+#ifdef VXL_HAS_CXX11_RVREF
+  //: Move construct a matrix
+  // Complexity $O(1)$, or $O(r.c)$ if the elements are stored inline.
+  // A vnl_matrix_ref is copied instead.
+  vnl_matrix(vnl_matrix<T>&& that) : num_rows(0), num_cols(0), data(VXL_NULLPTR), vnl_matrix_own_data(1) { steal(that); }
+#endif
+
+  //: Construct a matrix holding the value of a lazy expression (see vnl_expression.h)
+  // Complexity $O(r.c)$
+  template <class E>
+  vnl_matrix(vnl_expression<E> const& e) : num_rows(0), num_cols(0), data(VXL_NULLPTR), vnl_matrix_own_data(1) { *this = e; }
+
 #ifndef VXL_DOXYGEN_SHOULD_SKIP_THIS
 // <internal>
   // These constructors are here so that operator* etc can take
@@ -161,8 +179,8 @@ class VNL_EXPORT vnl_matrix
   vnl_matrix(vnl_matrix<T> const &, T,                     vnl_tag_sub); // M - s
   vnl_matrix(vnl_matrix<T> const &, vnl_matrix<T> const &, vnl_tag_mul); // M * M
   vnl_matrix(vnl_matrix<T> &that, vnl_tag_grab)
-    : num_rows(that.num_rows), num_cols(that.num_cols), data(that.data)
-  { that.num_cols=that.num_rows=0; that.data=VXL_NULLPTR; } // "*this" now uses "that"'s data.
+    : num_rows(0), num_cols(0), data(VXL_NULLPTR), vnl_matrix_own_data(1)
+  { steal(that); } // "*this" now uses "that"'s data.
 // </internal>
 #endif
 
@@ -291,6 +309,26 @@ class VNL_EXPORT vnl_matrix
   // Complexity $O(\min(r,c))$
   vnl_matrix<T>& operator=(vnl_matrix<T> const&);
 
+#ifdef VXL_HAS_CXX11_RVREF
+  //: Moves the elements of rhs into lhs matrix.
+  // Complexity $O(1)$, or $O(r.c)$ if the elements are stored inline
+  // or either side is a vnl_matrix_ref, which are copied.
+  vnl_matrix<T>& operator=(vnl_matrix<T>&&);
+#endif
+
+  //: Evaluate a lazy expression (see vnl_expression.h) in one loop.
+  // Only reallocates if the size changes.
+  template <class E>
+  vnl_matrix<T>& operator=(vnl_expression<E> const& e)
+  {
+    E const& x = e.self();
+    this->set_size(x.rows(), x.cols());
+    T* out = this->data_block();
+    for (unsigned int i = 0; i < num_rows * num_cols; ++i)
+      out[i] = x[i];
+    return *this;
+  }
+
   // ----------------------- Arithmetic --------------------------------
   // note that these functions should not pass scalar as a const&.
   // Look what would happen to A /= A(0,0).
@@ -311,6 +349,36 @@ class VNL_EXPORT vnl_matrix
   vnl_matrix<T>& operator+=(vnl_matrix<T> const&);
   //: Subtract rhs from lhs matrix in situ
   vnl_matrix<T>& operator-=(vnl_matrix<T> const&);
+
+  //: Add a lazy expression (see vnl_expression.h) to lhs matrix in situ
+  template <class E>
+  vnl_matrix<T>& operator+=(vnl_expression<E> const& e)
+  {
+    E const& x = e.self();
+#if VNL_CONFIG_CHECK_BOUNDS  && (!defined NDEBUG)
+    if (x.rows() != num_rows || x.cols() != num_cols)
+      vnl_error_matrix_dimension("vnl_matrix<>::operator+=(vnl_expression)", num_rows, num_cols, x.rows(), x.cols());
+#endif
+    T* out = this->data_block();
+    for (unsigned int i = 0; i < num_rows * num_cols; ++i)
+      out[i] += x[i];
+    return *this;
+  }
+
+  //: Subtract a lazy expression (see vnl_expression.h) from lhs matrix in situ
+  template <class E>
+  vnl_matrix<T>& operator-=(vnl_expression<E> const& e)
+  {
+    E const& x = e.self();
+#if VNL_CONFIG_CHECK_BOUNDS  && (!defined NDEBUG)
+    if (x.rows() != num_rows || x.cols() != num_cols)
+      vnl_error_matrix_dimension("vnl_matrix<>::operator-=(vnl_expression)", num_rows, num_cols, x.rows(), x.cols());
+#endif
+    T* out = this->data_block();
+    for (unsigned int i = 0; i < num_rows * num_cols; ++i)
+      out[i] -= x[i];
+    return *this;
+  }
   //: Multiply lhs matrix in situ by rhs
   vnl_matrix<T>& operator*=(vnl_matrix<T> const&rhs) { return *this = (*this) * rhs; }
 
@@ -507,6 +575,7 @@ class VNL_EXPORT vnl_matrix
   vnl_matrix& scale_column(unsigned col, T value);
 
   //: Swap this matrix with that matrix
+  // Elements stored inline are copied, so pointers to them are not swapped.
   void swap(vnl_matrix<T> & that);
 
   //: Type def for norms.
@@ -679,12 +748,62 @@ class VNL_EXPORT vnl_matrix
   unsigned num_cols;   // Number of columns
   T** data;            // Pointer to the vnl_matrix
 
-#if VCL_HAS_SLICED_DESTRUCTOR_BUG
-  // Since this bug exists, we need a flag that can be set during
-  // construction to tell our destructor whether we own data.
+  // Whether the destructor releases data; 0 in a vnl_matrix_ref.
   char vnl_matrix_own_data;
+
+#if VNL_CONFIG_SMALL_BUFFER
+  // Inline storage for the elements and the row pointers, each used
+  // instead of the heap when they fit.
+  union { long double align_; char bytes_[80]; } vnl_matrix_small_;
+  T* vnl_matrix_small_rows_[4];
 #endif
 
+  //: The inline storage for n elements, or null if they do not fit.
+  T* small_block(unsigned n)
+  {
+#if VNL_CONFIG_SMALL_BUFFER
+    if (n * sizeof(T) <= sizeof vnl_matrix_small_)
+      return reinterpret_cast<T*>(vnl_matrix_small_.bytes_);
+#endif
+    (void)n;
+    return VXL_NULLPTR;
+  }
+
+  //: The inline storage for r row pointers, or null if they do not fit.
+  T** small_rows(unsigned r)
+  {
+#if VNL_CONFIG_SMALL_BUFFER
+    if (r <= sizeof vnl_matrix_small_rows_ / sizeof vnl_matrix_small_rows_[0])
+      return vnl_matrix_small_rows_;
+#endif
+    (void)r;
+    return VXL_NULLPTR;
+  }
+
+  //: Whether the elements are stored inline.
+  bool is_small() const
+  {
+#if VNL_CONFIG_SMALL_BUFFER
+    return data && data[0] == reinterpret_cast<T const*>(vnl_matrix_small_.bytes_);
+#else
+    return false;
+#endif
+  }
+
+  //: Whether the row pointers are stored inline.
+  bool has_small_rows() const
+  {
+#if VNL_CONFIG_SMALL_BUFFER
+    return data == vnl_matrix_small_rows_;
+#else
+    return false;
+#endif
+  }
+
+  //: Take the elements of that, leaving it empty; *this must be empty.
+  // The elements are copied if they are inline or that does not own them.
+  void steal(vnl_matrix<T>& that);
+
   void assert_size_internal(unsigned r, unsigned c) const;
   void assert_finite_internal() const;
 
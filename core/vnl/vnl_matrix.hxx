@@ -92,43 +92,52 @@
 #include <vnl/vnl_math.h>
 #include <vnl/vnl_vector.h>
 #include <vnl/vnl_c_vector.h>
+#include <vnl/vnl_gemm.h>
 #include <vnl/vnl_numeric_traits.h>
 //--------------------------------------------------------------------------------
 
-#if VCL_HAS_SLICED_DESTRUCTOR_BUG
 // vnl_matrix owns its data by default.
-# define vnl_matrix_construct_hack() vnl_matrix_own_data = 1
-#else
-# define vnl_matrix_construct_hack()
-#endif
+#define vnl_matrix_construct_hack() vnl_matrix_own_data = 1
 
-// This macro allocates and initializes the dynamic storage used by a vnl_matrix.
+// This macro allocates and initializes the storage used by a vnl_matrix,
+// inline if it fits.
 #define vnl_matrix_alloc_blah() \
 do { \
   if (this->num_rows && this->num_cols) { \
-    /* Allocate memory to hold the row pointers */ \
-    this->data = vnl_c_vector<T>::allocate_Tptr(this->num_rows); \
-    /* Allocate memory to hold the elements of the matrix */ \
-    T* elmns = vnl_c_vector<T>::allocate_T(this->num_rows * this->num_cols); \
+    /* Memory to hold the row pointers */ \
+    if ((this->data = this->small_rows(this->num_rows)) == VXL_NULLPTR) \
+      this->data = vnl_c_vector<T>::allocate_Tptr(this->num_rows); \
+    /* Memory to hold the elements of the matrix */ \
+    T* elmns = this->small_block(this->num_rows * this->num_cols); \
+    if (elmns) \
+      vnl_c_vector<T>::construct(elmns, this->num_rows * this->num_cols); \
+    else \
+      elmns = vnl_c_vector<T>::allocate_T(this->num_rows * this->num_cols); \
     /* Fill in the array of row pointers */ \
     for (unsigned int i = 0; i < this->num_rows; ++ i) \
       this->data[i] = elmns + i*this->num_cols; \
   } \
   else { \
    /* This is to make sure .begin() and .end() work for 0xN matrices: */ \
-   (this->data = vnl_c_vector<T>::allocate_Tptr(1))[0] = 0; \
+   if ((this->data = this->small_rows(1)) == VXL_NULLPTR) \
+     this->data = vnl_c_vector<T>::allocate_Tptr(1); \
+   this->data[0] = 0; \
   } \
 } while (false)
 
-// This macro releases the dynamic storage used by a vnl_matrix.
+// This macro releases the storage used by a vnl_matrix.
 #define vnl_matrix_free_blah \
 do { \
   if (this->data) { \
     if (this->num_cols && this->num_rows) { \
-      vnl_c_vector<T>::deallocate(this->data[0], this->num_cols * this->num_rows); \
-      vnl_c_vector<T>::deallocate(this->data, this->num_rows); \
+      if (this->is_small()) \
+        vnl_c_vector<T>::destruct(this->data[0], this->num_cols * this->num_rows); \
+      else \
+        vnl_c_vector<T>::deallocate(this->data[0], this->num_cols * this->num_rows); \
+      if (!this->has_small_rows()) \
+        vnl_c_vector<T>::deallocate(this->data, this->num_rows); \
     } \
-    else { \
+    else if (!this->has_small_rows()) { \
       vnl_c_vector<T>::deallocate(this->data, 1); \
     } \
   } \
@@ -331,6 +340,34 @@ vnl_matrix<T>::vnl_matrix (vnl_matrix<T> const &M, T s, vnl_tag_sub)
     dst[i] = T(m[i] - s);
 }
 
+//: c = a * b for contiguous row-major l x m and m x n arrays.
+template <class T>
+static inline void vnl_matrix_mul(T const* a, T const* b, T* c,
+                                  unsigned int l, unsigned int m, unsigned int n)
+{
+  for (unsigned int i=0; i<l; ++i) {
+    for (unsigned int k=0; k<n; ++k) {
+      T sum(0);
+      for (unsigned int j=0; j<m; ++j)
+        sum += T(a[i*m+j] * b[j*n+k]);
+      c[i*n+k] = sum;
+    }
+  }
+}
+
+//: float and double products go through the blocked kernel.
+static inline void vnl_matrix_mul(double const* a, double const* b, double* c,
+                                  unsigned int l, unsigned int m, unsigned int n)
+{
+  vnl_gemm(false, false, l, n, m, 1.0, a, m, b, n, 0.0, c, n);
+}
+
+static inline void vnl_matrix_mul(float const* a, float const* b, float* c,
+                                  unsigned int l, unsigned int m, unsigned int n)
+{
+  vnl_gemm(false, false, l, n, m, 1.0f, a, m, b, n, 0.0f, c, n);
+}
+
 template <class T>
 vnl_matrix<T>::vnl_matrix (vnl_matrix<T> const &A, vnl_matrix<T> const &B, vnl_tag_mul)
 : num_rows(A.num_rows), num_cols(B.num_cols)
@@ -347,14 +384,8 @@ vnl_matrix<T>::vnl_matrix (vnl_matrix<T> const &A, vnl_matrix<T> const &B, vnl_t
   vnl_matrix_construct_hack();
   vnl_matrix_alloc_blah();
 
-  for (unsigned int i=0; i<l; ++i) {
-    for (unsigned int k=0; k<n; ++k) {
-      T sum(0);
-      for (unsigned int j=0; j<m; ++j)
-        sum += T(A.data[i][j] * B.data[j][k]);
-      this->data[i][k] = sum;
-    }
-  }
+  if (l > 0 && n > 0)
+    vnl_matrix_mul(A.data[0], B.data[0], this->data[0], l, m, n);
 }
 
 //------------------------------------------------------------
@@ -366,6 +397,7 @@ vnl_matrix<T>::~vnl_matrix()
 #if VCL_HAS_SLICED_DESTRUCTOR_BUG
   if (data && vnl_matrix_own_data) destroy();
 #else
+  // vnl_matrix_ref clears data[0] and leaves its row pointers to be released here.
   if (data) destroy();
 #endif
 }
@@ -416,6 +448,36 @@ bool vnl_matrix<T>::set_size (unsigned rowz, unsigned colz)
   return true;
 }
 
+template <class T>
+void vnl_matrix<T>::steal(vnl_matrix<T>& that)
+{
+  this->num_rows = that.num_rows;
+  this->num_cols = that.num_cols;
+  if (!that.data) {
+    this->data = VXL_NULLPTR;
+    return;
+  }
+  if (that.vnl_matrix_own_data && that.num_rows && that.num_cols && !that.is_small()) {
+    // Take over the elements, and the row pointers unless they are inline.
+    if (that.has_small_rows()) {
+      T* elmns = that.data[0];
+      this->data = this->small_rows(this->num_rows);
+      for (unsigned int i = 0; i < this->num_rows; ++ i)
+        this->data[i] = elmns + i*this->num_cols;
+    }
+    else
+      this->data = that.data;
+    that.num_rows = that.num_cols = 0;
+    that.data = VXL_NULLPTR;
+    return;
+  }
+  vnl_matrix_alloc_blah();
+  if (this->num_rows && this->num_cols)
+    std::copy(that.data[0], that.data[0] + this->num_rows * this->num_cols, this->data[0]);
+  if (that.vnl_matrix_own_data)
+    that.clear();
+}
+
 #undef vnl_matrix_alloc_blah
 #undef vnl_matrix_free_blah
 
@@ -479,6 +541,22 @@ vnl_matrix<T>& vnl_matrix<T>::operator= (vnl_matrix<T> const& rhs)
   return *this;
 }
 
+#ifdef VXL_HAS_CXX11_RVREF
+template <class T>
+vnl_matrix<T>& vnl_matrix<T>::operator= (vnl_matrix<T>&& rhs)
+{
+  if (this != &rhs) {
+    // A vnl_matrix_ref keeps its storage, and inline elements cannot be
+    // taken over, so these are copied.
+    if (!this->vnl_matrix_own_data || !rhs.vnl_matrix_own_data || rhs.is_small())
+      return *this = static_cast<vnl_matrix<T> const&>(rhs);
+    clear();
+    steal(rhs);
+  }
+  return *this;
+}
+#endif
+
 template <class T>
 void vnl_matrix<T>::print(std::ostream& os) const
 {
@@ -1410,9 +1488,19 @@ vnl_matrix<T> vnl_matrix<T>::read(std::istream& s)
 template <class T>
 void vnl_matrix<T>::swap(vnl_matrix<T> &that)
 {
-  std::swap(this->num_rows, that.num_rows);
-  std::swap(this->num_cols, that.num_cols);
-  std::swap(this->data, that.data);
+  if (!this->is_small() && !this->has_small_rows() &&
+      !that.is_small() && !that.has_small_rows()) {
+    std::swap(this->num_rows, that.num_rows);
+    std::swap(this->num_cols, that.num_cols);
+    std::swap(this->data, that.data);
+    return;
+  }
+  // Inline storage has to be copied; neither side is a vnl_matrix_ref.
+  assert(this->vnl_matrix_own_data && that.vnl_matrix_own_data);
+  vnl_matrix<T> tmp;
+  tmp.steal(*this);
+  this->steal(that);
+  that.steal(tmp);
 }
 
 //: Reverse order of rows.  Name is from Matlab, meaning "flip upside down".
@@ -1625,8 +1713,11 @@ vnl_matrix<T>& vnl_matrix<T>::inplace_transpose()
   // vnl_c_vector<T>::deallocate needs to know n_when_allocatod.
   {
     T *tmp = data[0];
-    vnl_c_vector<T>::deallocate(data, m);
-    data = vnl_c_vector<T>::allocate_Tptr(n);
+    if (!has_small_rows())
+      vnl_c_vector<T>::deallocate(data, m);
+    data = small_rows(n);
+    if (!data)
+      data = vnl_c_vector<T>::allocate_Tptr(n);
     for (unsigned i=0; i<n; ++i)
       data[i] = tmp + i * m;
   }
@@ -125,6 +125,14 @@ class VNL_EXPORT vnl_sparse_matrix
   //: Copy another vnl_sparse_matrix<T> into this.
   vnl_sparse_matrix<T>& operator=(vnl_sparse_matrix<T> const& rhs);
 
+#ifdef VXL_HAS_CXX11_RVREF
+  //: Construct from the rows of rhs, leaving it an empty 0*0 matrix.
+  vnl_sparse_matrix(vnl_sparse_matrix<T>&& rhs);
+
+  //: Move the rows of rhs into this, leaving rhs an empty 0*0 matrix.
+  vnl_sparse_matrix<T>& operator=(vnl_sparse_matrix<T>&& rhs);
+#endif
+
   //: Multiply this*rhs, where rhs is a vector.
   void mult(vnl_vector<T> const& rhs, vnl_vector<T>& result) const;
 
@@ -160,6 +168,9 @@ class VNL_EXPORT vnl_sparse_matrix
   //  Added to aid binary I/O
   row& get_row(unsigned int r) {return elements[r];}
 
+  //: Return row as vector of pairs
+  row const& get_row(unsigned int r) const {return elements[r];}
+
   //: Laminate matrix A onto the bottom of this one
   vnl_sparse_matrix<T>& vcat(vnl_sparse_matrix<T> const& A);
 
@@ -59,6 +59,38 @@ vnl_sparse_matrix<T>& vnl_sparse_matrix<T>::operator=(const vnl_sparse_matrix<T>
   return *this;
 }
 
+#ifdef VXL_HAS_CXX11_RVREF
+//------------------------------------------------------------
+//: Construct from the rows of rhs, leaving it an empty 0*0 matrix.
+template <class T>
+vnl_sparse_matrix<T>::vnl_sparse_matrix(vnl_sparse_matrix<T>&& rhs)
+  : rs_(rhs.rs_), cs_(rhs.cs_)
+{
+  elements.swap(rhs.elements);
+  rhs.rs_ = rhs.cs_ = 0;
+  rhs.reset();
+}
+
+//------------------------------------------------------------
+//: Move the rows of rhs into this, leaving rhs an empty 0*0 matrix.
+template <class T>
+vnl_sparse_matrix<T>& vnl_sparse_matrix<T>::operator=(vnl_sparse_matrix<T>&& rhs)
+{
+  if (this == &rhs)
+    return *this;
+
+  elements.swap(rhs.elements);
+  rhs.elements.clear();
+  rs_ = rhs.rs_;
+  cs_ = rhs.cs_;
+  rhs.rs_ = rhs.cs_ = 0;
+  rhs.reset();
+  reset();
+
+  return *this;
+}
+#endif
+
 //------------------------------------------------------------
 //: Multiply this*rhs, another sparse matrix.
 template <class T>
@@ -0,0 +1,80 @@
+// This is core/vnl/vnl_sparse_matrix_crs.h
+#ifndef vnl_sparse_matrix_crs_h_
+#define vnl_sparse_matrix_crs_h_
+//:
+// \file
+// \brief Frozen compressed row storage copy of a vnl_sparse_matrix
+//
+//    vnl_sparse_matrix is convenient to build, but each row is a separately
+//    allocated vector of (column,value) pairs, so products chase a pointer per
+//    row and move twice the data they need.  vnl_sparse_matrix_crs takes a
+//    snapshot of a finished vnl_sparse_matrix in compressed row storage: the
+//    structure is a vnl_crs_index and the values are one contiguous array in
+//    the same order.  A second, column-ordered copy makes the transposed
+//    product a gather as well, so both products can be split among threads
+//    without write conflicts (with OpenMP, when VNL_CONFIG_ENABLE_OPENMP is set).
+//
+//    The snapshot does not follow later changes to the source matrix.
+//
+// \verbatim
+//  Modifications
+// \endverbatim
+
+#include <vector>
+#include <vnl/vnl_sparse_matrix.h>
+#include <vnl/vnl_crs_index.h>
+#include <vnl/vnl_vector.h>
+#include "vnl/vnl_export.h"
+
+//: Compressed row storage snapshot of a vnl_sparse_matrix
+template <class T>
+class VNL_EXPORT vnl_sparse_matrix_crs
+{
+ public:
+  //: Construct an empty 0x0 matrix
+  vnl_sparse_matrix_crs();
+
+  //: Copy the current contents of \p A
+  explicit vnl_sparse_matrix_crs(vnl_sparse_matrix<T> const& A);
+
+  //: Replace the contents with those of \p A
+  void set(vnl_sparse_matrix<T> const& A);
+
+  //: Get the number of rows in the matrix.
+  unsigned int rows() const { return rows_; }
+
+  //: Get the number of columns in the matrix.
+  unsigned int cols() const { return cols_; }
+
+  //: Get the number of columns in the matrix.
+  unsigned int columns() const { return cols_; }
+
+  //: Number of stored entries
+  unsigned int num_non_zero() const { return (unsigned int)(values_.size()); }
+
+  //: The row structure; value k of values() sits at the k-th index it lists
+  vnl_crs_index const& index() const { return index_; }
+
+  //: The stored values in row order
+  std::vector<T> const& values() const { return values_; }
+
+  //: Get the value of an entry in the matrix.
+  T operator()(unsigned int row, unsigned int column) const;
+
+  //: Multiply this*rhs, where rhs is a vector.
+  void mult(vnl_vector<T> const& rhs, vnl_vector<T>& result) const;
+
+  //: Multiplies lhs*this, where lhs is a vector; i.e. this->transpose()*lhs
+  void pre_mult(vnl_vector<T> const& lhs, vnl_vector<T>& result) const;
+
+ private:
+  unsigned int rows_, cols_;
+  //: Structure and values in row order
+  vnl_crs_index index_;
+  std::vector<T> values_;
+  //: Structure and values of the transpose, i.e. in column order
+  vnl_crs_index t_index_;
+  std::vector<T> t_values_;
+};
+
+#endif // vnl_sparse_matrix_crs_h_
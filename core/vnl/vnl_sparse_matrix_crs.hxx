@@ -0,0 +1,123 @@
+// This is core/vnl/vnl_sparse_matrix_crs.hxx
+#ifndef vnl_sparse_matrix_crs_hxx_
+#define vnl_sparse_matrix_crs_hxx_
+//:
+// \file
+
+#include "vnl_sparse_matrix_crs.h"
+#include <vcl_cassert.h>
+#include <vcl_compiler.h>
+
+//: Rows below which a product is not worth sharing among threads
+#define VNL_SPARSE_MATRIX_CRS_PARALLEL_ROWS 1024
+
+template <class T>
+vnl_sparse_matrix_crs<T>::vnl_sparse_matrix_crs()
+  : rows_(0), cols_(0)
+{
+}
+
+template <class T>
+vnl_sparse_matrix_crs<T>::vnl_sparse_matrix_crs(vnl_sparse_matrix<T> const& A)
+  : rows_(0), cols_(0)
+{
+  set(A);
+}
+
+template <class T>
+void vnl_sparse_matrix_crs<T>::set(vnl_sparse_matrix<T> const& A)
+{
+  typedef typename vnl_sparse_matrix<T>::row row;
+  rows_ = A.rows();
+  cols_ = A.cols();
+
+  // Row order: the rows of A are already sorted by column.
+  std::vector<int> row_ptr(rows_+1, 0), col_idx;
+  std::vector<int> col_count(cols_+1, 0);
+  values_.clear();
+  for (unsigned int r = 0; r < rows_; ++r) {
+    row const& rw = A.get_row(r);
+    row_ptr[r] = int(col_idx.size());
+    for (typename row::const_iterator it = rw.begin(); it != rw.end(); ++it) {
+      col_idx.push_back(int(it->first));
+      values_.push_back(it->second);
+      ++col_count[it->first+1];
+    }
+  }
+  row_ptr[rows_] = int(col_idx.size());
+  index_ = vnl_crs_index(cols_, row_ptr, col_idx);
+
+  // Column order, by a counting sort of the entries on their column.
+  std::vector<int> col_ptr(cols_+1, 0);
+  for (unsigned int c = 0; c < cols_; ++c)
+    col_ptr[c+1] = col_ptr[c] + col_count[c+1];
+  std::vector<int> next(col_ptr.begin(), col_ptr.end()-1);
+  std::vector<int> row_idx(col_idx.size());
+  t_values_.resize(values_.size());
+  for (unsigned int r = 0; r < rows_; ++r)
+    for (int k = row_ptr[r]; k < row_ptr[r+1]; ++k) {
+      int dst = next[col_idx[k]]++;
+      row_idx[dst] = int(r);
+      t_values_[dst] = values_[k];
+    }
+  t_index_ = vnl_crs_index(rows_, col_ptr, row_idx);
+}
+
+template <class T>
+T vnl_sparse_matrix_crs<T>::operator()(unsigned int r, unsigned int c) const
+{
+  assert(r < rows_ && c < cols_);
+  int k = index_(int(r), int(c));
+  return k < 0 ? T(0) : values_[k];
+}
+
+//: Result i is the dot product of the stored values of row i with the matching entries of x.
+template <class T>
+static void vnl_sparse_matrix_crs_gather(unsigned int n, int const* ptr, int const* idx,
+                                         T const* val, T const* x, T* y)
+{
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) if (n > VNL_SPARSE_MATRIX_CRS_PARALLEL_ROWS)
+#endif
+  for (int i = 0; i < int(n); ++i) {
+    T sum(0);
+    for (int k = ptr[i]; k < ptr[i+1]; ++k)
+      sum += x[idx[k]] * val[k];
+    y[i] = sum;
+  }
+}
+
+template <class T>
+void vnl_sparse_matrix_crs<T>::mult(vnl_vector<T> const& rhs, vnl_vector<T>& result) const
+{
+  assert(rhs.size() == cols_);
+  result.set_size(rows_);
+  if (rows_ == 0)
+    return;
+  if (values_.empty()) {
+    result.fill(T(0));
+    return;
+  }
+  vnl_sparse_matrix_crs_gather(rows_, &index_.row_ptr()[0], &index_.col_idx()[0],
+                               &values_[0], rhs.data_block(), result.data_block());
+}
+
+template <class T>
+void vnl_sparse_matrix_crs<T>::pre_mult(vnl_vector<T> const& lhs, vnl_vector<T>& result) const
+{
+  assert(lhs.size() == rows_);
+  result.set_size(cols_);
+  if (cols_ == 0)
+    return;
+  if (t_values_.empty()) {
+    result.fill(T(0));
+    return;
+  }
+  vnl_sparse_matrix_crs_gather(cols_, &t_index_.row_ptr()[0], &t_index_.col_idx()[0],
+                               &t_values_[0], lhs.data_block(), result.data_block());
+}
+
+#define VNL_SPARSE_MATRIX_CRS_INSTANTIATE(T) \
+template class vnl_sparse_matrix_crs<T >
+
+#endif // vnl_sparse_matrix_crs_hxx_
@@ -16,7 +16,7 @@ void vnl_sparse_matrix_linear_system<double>::get_rhs(vnl_vector<double>& b) con
 VCL_DEFINE_SPECIALIZATION
 void vnl_sparse_matrix_linear_system<double>::transpose_multiply(vnl_vector<double> const& b, vnl_vector<double> & x) const
 {
-  A_.pre_mult(b,x);
+  Acrs_.pre_mult(b,x);
 }
 
 VCL_DEFINE_SPECIALIZATION
@@ -35,14 +35,14 @@ void vnl_sparse_matrix_linear_system<float>::transpose_multiply(vnl_vector<doubl
   if (b_float.size() != b.size()) b_float = vnl_vector<float> (b.size());
 
   vnl_copy(b, b_float);
-  A_.pre_mult(b_float,x_float);
+  Acrs_.pre_mult(b_float,x_float);
   vnl_copy(x_float, x);
 }
 
 VCL_DEFINE_SPECIALIZATION
 void vnl_sparse_matrix_linear_system<double>::multiply(vnl_vector<double> const& x, vnl_vector<double> & b) const
 {
-  A_.mult(x,b);
+  Acrs_.mult(x,b);
 }
 
 
@@ -56,7 +56,7 @@ void vnl_sparse_matrix_linear_system<float>::multiply(vnl_vector<double> const&
   if (b_float.size() != b.size()) b_float = vnl_vector<float> (b.size());
 
   vnl_copy(x, x_float);
-  A_.mult(x_float,b_float);
+  Acrs_.mult(x_float,b_float);
   vnl_copy(b_float, b);
 }
 
@@ -22,6 +22,7 @@
 
 #include <vnl/vnl_linear_system.h>
 #include <vnl/vnl_sparse_matrix.h>
+#include <vnl/vnl_sparse_matrix_crs.h>
 #include "vnl/vnl_export.h"
 
 //: vnl_sparse_matrix -> vnl_linear_system adaptor
@@ -32,8 +33,10 @@ class VNL_EXPORT vnl_sparse_matrix_linear_system : public vnl_linear_system
  public:
   //::Constructor from vnl_sparse_matrix<double> for system Ax = b
   // Keeps a reference to the original sparse matrix A and vector b so DO NOT DELETE THEM!!
+  // The products use a compressed row copy of A taken here, so A should be
+  // complete before the system is constructed.
   vnl_sparse_matrix_linear_system(vnl_sparse_matrix<T> const& A, vnl_vector<T> const& b) :
-    vnl_linear_system(A.columns(), A.rows()), A_(A), b_(b), jacobi_precond_() {}
+    vnl_linear_system(A.columns(), A.rows()), A_(A), Acrs_(A), b_(b), jacobi_precond_() {}
 
   //:  Implementations of the vnl_linear_system virtuals.
   void multiply(vnl_vector<double> const& x, vnl_vector<double> & b) const;
@@ -46,6 +49,7 @@ class VNL_EXPORT vnl_sparse_matrix_linear_system : public vnl_linear_system
 
  protected:
   vnl_sparse_matrix<T> const& A_;
+  vnl_sparse_matrix_crs<T> Acrs_;
   vnl_vector<T> const& b_;
   vnl_vector<double> jacobi_precond_;
 };
@@ -40,6 +40,7 @@
 
 VCL_TEMPLATE_EXPORT template <class T> class vnl_vector;
 VCL_TEMPLATE_EXPORT template <class T> class vnl_matrix;
+template <class E> class vnl_expression;
 
 //----------------------------------------------------------------------
 
@@ -72,6 +73,9 @@ template <class T> VNL_EXPORT void   swap(v &, v &);
 // operator.
 // For faster, non-mallocing vectors with size known at compile
 // time, use vnl_vector_fixed* or vnl_T_n (e.g. vnl_double_3).
+// Unless VNL_CONFIG_SMALL_BUFFER is 0, vectors of up to 64 bytes keep
+// their elements inline and do not allocate either, so a vnl_vector
+// must not be copied bytewise (e.g. by std::qsort or std::memcpy).
 //
 // NOTE: Vectors are indexed from zero!  Thus valid elements are [0,size()-1].
 template<class T>
@@ -81,7 +85,7 @@ class VNL_EXPORT vnl_vector
   friend class vnl_matrix<T>;
 
   //: Creates an empty vector. O(1).
-  vnl_vector() : num_elmts(0) , data(VXL_NULLPTR) {}
+  vnl_vector() : num_elmts(0) , data(VXL_NULLPTR) , vnl_vector_own_data(1) {}
 
   //: Creates a vector containing n uninitialized elements.
   explicit vnl_vector(unsigned int len);
@@ -100,6 +104,16 @@ class VNL_EXPORT vnl_vector
   //: Copy constructor.
   vnl_vector(vnl_vector<T> const&);
 
+#ifdef VXL_HAS_CXX11_RVREF
+  //: Move constructor. O(1) unless the elements are stored inline.
+  // A vnl_vector_ref is copied instead.
+  vnl_vector(vnl_vector<T>&& that) : num_elmts(0) , data(VXL_NULLPTR) , vnl_vector_own_data(1) { steal(that); }
+#endif
+
+  //: Creates a vector holding the value of a lazy expression (see vnl_expression.h).
+  template <class E>
+  vnl_vector(vnl_expression<E> const& e) : num_elmts(0) , data(VXL_NULLPTR) , vnl_vector_own_data(1) { *this = e; }
+
 #if VNL_CONFIG_LEGACY_METHODS // these constructors are deprecated and should not be used
   //: Creates a vector of length 2 and initializes with the arguments, px,py.
   //  Requires that len==2.
@@ -133,8 +147,8 @@ class VNL_EXPORT vnl_vector
   vnl_vector(vnl_matrix<T> const &, vnl_vector<T> const &, vnl_tag_mul); // M * v
   vnl_vector(vnl_vector<T> const &, vnl_matrix<T> const &, vnl_tag_mul); // v * M
   vnl_vector(vnl_vector<T> &that, vnl_tag_grab)
-    : num_elmts(that.num_elmts), data(that.data)
-  { that.num_elmts=0; that.data=0; } // "*this" now uses "that"'s data.
+    : num_elmts(0), data(VXL_NULLPTR), vnl_vector_own_data(1)
+  { steal(that); } // "*this" now uses "that"'s data.
 // </internal>
 #endif
 
@@ -200,6 +214,24 @@ class VNL_EXPORT vnl_vector
   //: Copy operator
   vnl_vector<T>& operator=(vnl_vector<T> const& rhs);
 
+#ifdef VXL_HAS_CXX11_RVREF
+  //: Move operator. O(1) unless the elements are stored inline.
+  // Copies if either side is a vnl_vector_ref.
+  vnl_vector<T>& operator=(vnl_vector<T>&& rhs);
+#endif
+
+  //: Evaluate a lazy expression (see vnl_expression.h) in one loop.
+  // Only reallocates if the size changes.
+  template <class E>
+  vnl_vector<T>& operator=(vnl_expression<E> const& e)
+  {
+    E const& x = e.self();
+    this->set_size(x.rows() * x.cols());
+    for (unsigned int i = 0; i < num_elmts; ++i)
+      data[i] = x[i];
+    return *this;
+  }
+
   //: Add scalar value to all elements
   vnl_vector<T>& operator+=(T );
 
@@ -218,6 +250,34 @@ class VNL_EXPORT vnl_vector
   //: Subtract rhs from this and return *this
   vnl_vector<T>& operator-=(vnl_vector<T> const& rhs);
 
+  //: Add a lazy expression (see vnl_expression.h) to *this in one loop.
+  template <class E>
+  vnl_vector<T>& operator+=(vnl_expression<E> const& e)
+  {
+    E const& x = e.self();
+#if VNL_CONFIG_CHECK_BOUNDS  && (!defined NDEBUG)
+    if (x.rows() * x.cols() != num_elmts)
+      vnl_error_vector_dimension("vnl_vector<>::operator+=(vnl_expression)", num_elmts, x.rows() * x.cols());
+#endif
+    for (unsigned int i = 0; i < num_elmts; ++i)
+      data[i] += x[i];
+    return *this;
+  }
+
+  //: Subtract a lazy expression (see vnl_expression.h) from *this in one loop.
+  template <class E>
+  vnl_vector<T>& operator-=(vnl_expression<E> const& e)
+  {
+    E const& x = e.self();
+#if VNL_CONFIG_CHECK_BOUNDS  && (!defined NDEBUG)
+    if (x.rows() * x.cols() != num_elmts)
+      vnl_error_vector_dimension("vnl_vector<>::operator-=(vnl_expression)", num_elmts, x.rows() * x.cols());
+#endif
+    for (unsigned int i = 0; i < num_elmts; ++i)
+      data[i] -= x[i];
+    return *this;
+  }
+
   //: *this = M*(*this) where M is a suitable matrix.
   //  this is treated as a column vector
   vnl_vector<T>& pre_multiply(vnl_matrix<T> const& M);
@@ -364,6 +424,7 @@ class VNL_EXPORT vnl_vector
   vnl_vector& roll_inplace(const int &shift);
 
   //: Set this to that and that to this
+  // Elements stored inline are copied, so pointers to them are not swapped.
   void swap(vnl_vector<T> & that);
 
 #if VNL_CONFIG_LEGACY_METHODS // these methods are deprecated and should not be used
@@ -448,12 +509,39 @@ class VNL_EXPORT vnl_vector
   unsigned num_elmts;           // Number of elements (length)
   T* data;                      // Pointer to the actual data
 
-#if VCL_HAS_SLICED_DESTRUCTOR_BUG
-  // Since this bug exists, we need a flag that can be set during
-  // construction to tell our destructor whether we own data.
+  // Whether the destructor releases data; 0 in a vnl_vector_ref.
   char vnl_vector_own_data;
+
+#if VNL_CONFIG_SMALL_BUFFER
+  // Inline storage, used instead of the heap when the elements fit.
+  union { long double align_; char bytes_[64]; } vnl_vector_small_;
 #endif
 
+  //: The inline storage for n elements, or null if they do not fit.
+  T* small_block(unsigned n)
+  {
+#if VNL_CONFIG_SMALL_BUFFER
+    if (n * sizeof(T) <= sizeof vnl_vector_small_)
+      return reinterpret_cast<T*>(vnl_vector_small_.bytes_);
+#endif
+    (void)n;
+    return VXL_NULLPTR;
+  }
+
+  //: Whether the elements are stored inline.
+  bool is_small() const
+  {
+#if VNL_CONFIG_SMALL_BUFFER
+    return data == reinterpret_cast<T const*>(vnl_vector_small_.bytes_);
+#else
+    return false;
+#endif
+  }
+
+  //: Take the elements of that, leaving it empty; *this must be empty.
+  // The elements are copied if they are inline or that does not own them.
+  void steal(vnl_vector<T>& that);
+
   void assert_size_internal(unsigned sz) const;
   void assert_finite_internal() const;
 
@@ -53,26 +53,32 @@
 
 //--------------------------------------------------------------------------------
 
-#if VCL_HAS_SLICED_DESTRUCTOR_BUG
 // vnl_vector owns its data by default.
-# define vnl_vector_construct_hack() vnl_vector_own_data = 1
-#else
-# define vnl_vector_construct_hack()
-#endif
+#define vnl_vector_construct_hack() vnl_vector_own_data = 1
 
-// This macro allocates the dynamic storage used by a vnl_vector.
+// This macro allocates the storage used by a vnl_vector, inline if it fits.
 
 #define vnl_vector_alloc_blah(size) \
 do { \
   this->num_elmts = (size); \
-  this->data = size ? vnl_c_vector<T>::allocate_T(size) : 0; \
+  this->data = VXL_NULLPTR; \
+  if (this->num_elmts) { \
+    if ((this->data = this->small_block(this->num_elmts)) != VXL_NULLPTR) \
+      vnl_c_vector<T>::construct(this->data, this->num_elmts); \
+    else \
+      this->data = vnl_c_vector<T>::allocate_T(this->num_elmts); \
+  } \
 } while (false)
 
-// This macro deallocates the dynamic storage used by a vnl_vector.
+// This macro deallocates the storage used by a vnl_vector.
 #define vnl_vector_free_blah \
 do { \
-  if (this->data) \
-    vnl_c_vector<T>::deallocate(this->data, this->num_elmts); \
+  if (this->data) { \
+    if (this->is_small()) \
+      vnl_c_vector<T>::destruct(this->data, this->num_elmts); \
+    else \
+      vnl_c_vector<T>::deallocate(this->data, this->num_elmts); \
+  } \
 } while (false)
 
 
@@ -267,11 +273,7 @@ vnl_vector<T>::vnl_vector (vnl_vector<T> const &v, vnl_matrix<T> const &M, vnl_t
 template<class T>
 vnl_vector<T>::~vnl_vector()
 {
-#if VCL_HAS_SLICED_DESTRUCTOR_BUG
   if (data && vnl_vector_own_data) destroy();
-#else
-  if (data) destroy();
-#endif
 }
 
 //: Frees up the array inside vector. O(1).
@@ -310,6 +312,23 @@ bool vnl_vector<T>::set_size(unsigned n)
   return true;
 }
 
+template<class T>
+void vnl_vector<T>::steal(vnl_vector<T>& that)
+{
+  if (that.vnl_vector_own_data && that.data && !that.is_small()) {
+    this->num_elmts = that.num_elmts;
+    this->data = that.data;
+    that.num_elmts = 0;
+    that.data = VXL_NULLPTR;
+    return;
+  }
+  vnl_vector_alloc_blah(that.num_elmts);
+  if (that.data)
+    std::copy(that.data, that.data + that.num_elmts, this->data);
+  if (that.vnl_vector_own_data)
+    that.clear();
+}
+
 #undef vnl_vector_alloc_blah
 #undef vnl_vector_free_blah
 
@@ -404,6 +423,22 @@ vnl_vector<T>& vnl_vector<T>::operator= (vnl_vector<T> const& rhs)
   return *this;
 }
 
+#ifdef VXL_HAS_CXX11_RVREF
+template<class T>
+vnl_vector<T>& vnl_vector<T>::operator= (vnl_vector<T>&& rhs)
+{
+  if (this != &rhs) {
+    // A vnl_vector_ref keeps its storage, and inline elements cannot be
+    // taken over, so these are copied.
+    if (!this->vnl_vector_own_data || !rhs.vnl_vector_own_data || rhs.is_small())
+      return *this = static_cast<vnl_vector<T> const&>(rhs);
+    clear();
+    steal(rhs);
+  }
+  return *this;
+}
+#endif
+
 //: Increments all elements of vector with value. O(n).
 
 template<class T>
@@ -474,15 +509,13 @@ vnl_vector<T>& vnl_vector<T>::pre_multiply (vnl_matrix<T> const& m)
   if (m.columns() != this->num_elmts)           // dimensions do not match?
     vnl_error_vector_dimension ("operator*=", this->num_elmts, m.columns());
 #endif
-  T* temp= vnl_c_vector<T>::allocate_T(m.rows()); // Temporary
+  vnl_vector<T> temp(m.rows());                 // Temporary
   for (unsigned i = 0; i < m.rows(); i++) {     // For each index
     temp[i] = (T)0;                             // Initialize element value
     for (unsigned k = 0; k < this->num_elmts; k++)      // Loop over column values
       temp[i] += (m.get(i,k) * this->data[k]);  // Multiply
   }
-  vnl_c_vector<T>::deallocate(this->data, this->num_elmts); // Free up the data space
-  num_elmts = m.rows();                         // Set new num_elmts
-  this->data = temp;                            // Pointer to new storage
+  this->swap(temp);                             // Take the new storage
   return *this;                                 // Return vector reference
 }
 
@@ -496,15 +529,13 @@ vnl_vector<T>& vnl_vector<T>::post_multiply (vnl_matrix<T> const& m)
   if (this->num_elmts != m.rows())              // dimensions do not match?
     vnl_error_vector_dimension ("operator*=", this->num_elmts, m.rows());
 #endif
-  T* temp= vnl_c_vector<T>::allocate_T(m.columns()); // Temporary
+  vnl_vector<T> temp(m.columns());              // Temporary
   for (unsigned i = 0; i < m.columns(); i++) {  // For each index
     temp[i] = (T)0;                             // Initialize element value
     for (unsigned k = 0; k < this->num_elmts; k++) // Loop over column values
       temp[i] += (this->data[k] * m.get(k,i));  // Multiply
   }
-  vnl_c_vector<T>::deallocate(this->data, num_elmts); // Free up the data space
-  num_elmts = m.columns();                      // Set new num_elmts
-  this->data = temp;                            // Pointer to new storage
+  this->swap(temp);                             // Take the new storage
   return *this;                                 // Return vector reference
 }
 
@@ -724,8 +755,17 @@ vnl_vector<T>::roll_inplace(const int &shift)
 template <class T>
 void vnl_vector<T>::swap(vnl_vector<T> &that)
 {
-  std::swap(this->num_elmts, that.num_elmts);
-  std::swap(this->data, that.data);
+  if (!this->is_small() && !that.is_small()) {
+    std::swap(this->num_elmts, that.num_elmts);
+    std::swap(this->data, that.data);
+    return;
+  }
+  // Inline elements have to be copied; neither side is a vnl_vector_ref.
+  assert(this->vnl_vector_own_data && that.vnl_vector_own_data);
+  vnl_vector<T> tmp;
+  tmp.steal(*this);
+  this->steal(that);
+  that.steal(tmp);
 }
 
 //--------------------------------------------------------------------------------
@@ -13,6 +13,9 @@
 #include <vgl/algo/vgl_rotation_3d.h>
 #include <vcl_cassert.h>
 
+//: Number of points whose residuals are computed together by f_block
+static const unsigned int points_per_block = 256;
+
 //: Constructor
 vpgl_orientation_lsqr::
   vpgl_orientation_lsqr(const vpgl_calibration_matrix<double>& K,
@@ -26,6 +29,7 @@ vpgl_orientation_lsqr::
    image_points_(image_points)
 {
   assert(world_points_.size() == image_points_.size());
+  set_block_size(2*points_per_block);
 }
 
 
@@ -36,13 +40,22 @@ vpgl_orientation_lsqr::
 //  where w is the Rodrigues vector of the rotation.
 void
 vpgl_orientation_lsqr::f(vnl_vector<double> const& x, vnl_vector<double>& fx)
+{
+  f_blocks(x, fx);
+}
+
+
+//: Compute the residuals of the points in one block
+void
+vpgl_orientation_lsqr::f_block(vnl_vector<double> const& x, unsigned int first, vnl_vector<double>& fx)
 {
   vpgl_perspective_camera<double> cam(K_,c_,vgl_rotation_3d<double>(x));
-  for (unsigned int i=0; i<world_points_.size(); ++i)
+  const unsigned int p0 = first/2;
+  for (unsigned int i=0; 2*i<fx.size(); ++i)
   {
-    vgl_homg_point_2d<double> proj = cam(world_points_[i]);
-    fx[2*i]   = image_points_[i].x() - proj.x()/proj.w();
-    fx[2*i+1] = image_points_[i].y() - proj.y()/proj.w();
+    vgl_homg_point_2d<double> proj = cam(world_points_[p0+i]);
+    fx[2*i]   = image_points_[p0+i].x() - proj.x()/proj.w();
+    fx[2*i+1] = image_points_[p0+i].y() - proj.y()/proj.w();
   }
 }
 
@@ -59,6 +72,7 @@ vpgl_orientation_position_lsqr::
    image_points_(image_points)
 {
   assert(world_points_.size() == image_points_.size());
+  set_block_size(2*points_per_block);
 }
 
 
@@ -69,16 +83,25 @@ vpgl_orientation_position_lsqr::
 //  where w is the Rodrigues vector of the rotation and t is the translation.
 void
 vpgl_orientation_position_lsqr::f(vnl_vector<double> const& x, vnl_vector<double>& fx)
+{
+  f_blocks(x, fx);
+}
+
+
+//: Compute the residuals of the points in one block
+void
+vpgl_orientation_position_lsqr::f_block(vnl_vector<double> const& x, unsigned int first, vnl_vector<double>& fx)
 {
   assert(x.size() == 6);
   vnl_double_3 w(x[0], x[1], x[2]);
   vgl_homg_point_3d<double> t(x[3], x[4], x[5]);
   vpgl_perspective_camera<double> cam(K_,t,vgl_rotation_3d<double>(w));
-  for (unsigned int i=0; i<world_points_.size(); ++i)
+  const unsigned int p0 = first/2;
+  for (unsigned int i=0; 2*i<fx.size(); ++i)
   {
-    vgl_homg_point_2d<double> proj = cam(world_points_[i]);
-    fx[2*i]   = image_points_[i].x() - proj.x()/proj.w();
-    fx[2*i+1] = image_points_[i].y() - proj.y()/proj.w();
+    vgl_homg_point_2d<double> proj = cam(world_points_[p0+i]);
+    fx[2*i]   = image_points_[p0+i].x() - proj.x()/proj.w();
+    fx[2*i+1] = image_points_[p0+i].y() - proj.y()/proj.w();
   }
 }
 
@@ -111,6 +134,7 @@ vpgl_orientation_position_calibration_lsqr(const std::vector<vgl_homg_point_3d<d
    image_points_(image_points)
 {
   assert(world_points_.size() == image_points_.size());
+  set_block_size(2*points_per_block);
 }
 
 
@@ -121,6 +145,14 @@ vpgl_orientation_position_calibration_lsqr(const std::vector<vgl_homg_point_3d<d
 //  where w is the Rodrigues vector of the rotation and t is the translation.
 void
 vpgl_orientation_position_calibration_lsqr::f(vnl_vector<double> const& x, vnl_vector<double>& fx)
+{
+  f_blocks(x, fx);
+}
+
+
+//: Compute the residuals of the points in one block
+void
+vpgl_orientation_position_calibration_lsqr::f_block(vnl_vector<double> const& x, unsigned int first, vnl_vector<double>& fx)
 {
   assert(x.size() == 10);
   vnl_double_3 w(x[0], x[1], x[2]);
@@ -133,20 +165,18 @@ vpgl_orientation_position_calibration_lsqr::f(vnl_vector<double> const& x, vnl_v
 
   // Check that it is a valid calibration matrix.
   if ( !(kk[0][0]>0) || !(kk[1][1]>0) ) {
-    for (unsigned int i=0; i<world_points_.size(); ++i) {
-      fx[2*i]   = 100000000;
-      fx[2*i+1] = 100000000;
-    }
+    fx.fill(100000000);
     return;
   }
 
   vpgl_calibration_matrix<double> K(kk);
   vpgl_perspective_camera<double> cam(K, t, R);
-  for (unsigned int i=0; i<world_points_.size(); ++i)
+  const unsigned int p0 = first/2;
+  for (unsigned int i=0; 2*i<fx.size(); ++i)
   {
-    vgl_homg_point_2d<double> proj = cam(world_points_[i]);
-    fx[2*i]   = image_points_[i].x() - proj.x()/proj.w();
-    fx[2*i+1] = image_points_[i].y() - proj.y()/proj.w();
+    vgl_homg_point_2d<double> proj = cam(world_points_[p0+i]);
+    fx[2*i]   = image_points_[p0+i].x() - proj.x()/proj.w();
+    fx[2*i+1] = image_points_[p0+i].y() - proj.y()/proj.w();
   }
 }
 
@@ -161,6 +191,7 @@ vpgl_orientation_position_focal_lsqr(const vpgl_calibration_matrix<double>& K_in
    image_points_(image_points)
 {
   assert(world_points_.size() == image_points_.size());
+  set_block_size(2*points_per_block);
 }
 
 
@@ -171,6 +202,14 @@ vpgl_orientation_position_focal_lsqr(const vpgl_calibration_matrix<double>& K_in
 //  where w is the Rodrigues vector of the rotation and t is the translation.
 void
 vpgl_orientation_position_focal_lsqr::f(vnl_vector<double> const& x, vnl_vector<double>& fx)
+{
+  f_blocks(x, fx);
+}
+
+
+//: Compute the residuals of the points in one block
+void
+vpgl_orientation_position_focal_lsqr::f_block(vnl_vector<double> const& x, unsigned int first, vnl_vector<double>& fx)
 {
   assert(x.size() == 7);
   vnl_double_3 w(x[0], x[1], x[2]);
@@ -180,11 +219,12 @@ vpgl_orientation_position_focal_lsqr::f(vnl_vector<double> const& x, vnl_vector<
   vpgl_calibration_matrix<double> K(K_init_);
   K.set_focal_length(x[6]);
   vpgl_perspective_camera<double> cam(K, t, R);
-  for (unsigned int i=0; i<world_points_.size(); ++i)
+  const unsigned int p0 = first/2;
+  for (unsigned int i=0; 2*i<fx.size(); ++i)
   {
-    vgl_homg_point_2d<double> proj = cam(world_points_[i]);
-    fx[2*i]   = image_points_[i].x() - proj.x()/proj.w();
-    fx[2*i+1] = image_points_[i].y() - proj.y()/proj.w();
+    vgl_homg_point_2d<double> proj = cam(world_points_[p0+i]);
+    fx[2*i]   = image_points_[p0+i].x() - proj.x()/proj.w();
+    fx[2*i+1] = image_points_[p0+i].y() - proj.y()/proj.w();
   }
 }
 
@@ -33,6 +33,9 @@ class vpgl_orientation_lsqr : public vnl_least_squares_function
   //  where w is the Rodrigues vector of the rotation.
   virtual void f(vnl_vector<double> const& x, vnl_vector<double>& fx);
 
+  //: Compute the residuals of the points in one block; see vnl_least_squares_function::f_block
+  virtual void f_block(vnl_vector<double> const& x, unsigned int first, vnl_vector<double>& fx);
+
 #if 0
   //: Called after each LM iteration to print debugging etc.
   virtual void trace(int iteration, vnl_vector<double> const& x, vnl_vector<double> const& fx);
@@ -69,6 +72,9 @@ class vpgl_orientation_position_lsqr : public vnl_least_squares_function
   //  where w is the Rodrigues vector of the rotation and t is the translation.
   virtual void f(vnl_vector<double> const& x, vnl_vector<double>& fx);
 
+  //: Compute the residuals of the points in one block; see vnl_least_squares_function::f_block
+  virtual void f_block(vnl_vector<double> const& x, unsigned int first, vnl_vector<double>& fx);
+
 #if 0
   //: Called after each LM iteration to print debugging etc.
   virtual void trace(int iteration, vnl_vector<double> const& x, vnl_vector<double> const& fx);
@@ -101,6 +107,9 @@ class vpgl_orientation_position_calibration_lsqr : public vnl_least_squares_func
   //  where w is the Rodrigues vector of the rotation and t is the translation.
   virtual void f(vnl_vector<double> const& x, vnl_vector<double>& fx);
 
+  //: Compute the residuals of the points in one block; see vnl_least_squares_function::f_block
+  virtual void f_block(vnl_vector<double> const& x, unsigned int first, vnl_vector<double>& fx);
+
 #if 0
   //: Called after each LM iteration to print debugging etc.
   virtual void trace(int iteration, vnl_vector<double> const& x, vnl_vector<double> const& fx);
@@ -132,6 +141,9 @@ class vpgl_orientation_position_focal_lsqr : public vnl_least_squares_function
   //  where w is the Rodrigues vector of the rotation and t is the translation.
   virtual void f(vnl_vector<double> const& x, vnl_vector<double>& fx);
 
+  //: Compute the residuals of the points in one block; see vnl_least_squares_function::f_block
+  virtual void f_block(vnl_vector<double> const& x, unsigned int first, vnl_vector<double>& fx);
+
 #if 0
   //: Called after each LM iteration to print debugging etc.
   virtual void trace(int iteration, vnl_vector<double> const& x, vnl_vector<double> const& fx);
@@ -53,6 +53,7 @@
 #include <vgl/vgl_homg_plane_3d.h>
 #include <vgl/algo/vgl_h_matrix_2d.h>
 #include <vgl/algo/vgl_h_matrix_3d.h>
+#include <vgl/algo/vgl_projective_map.h>
 #include <vcl_compiler.h>
 
 
@@ -101,6 +102,16 @@ class vpgl_proj_camera : public vpgl_camera<T>
   //: Projection from base class
   virtual void project(const T x, const T y, const T z, T& u, T& v) const;
 
+  //: Project the points (x[i], y[i], z[i]) to (u[i], v[i]), 0 <= i < n, all at once.
+  //  Unlike the single point version, a point projected to infinity gives
+  //  non-finite coordinates, without a warning.  See vgl_projective_map.h
+  void project(T const* x, T const* y, T const* z, T* u, T* v, unsigned n) const
+  { vgl_projective_project_3d(P_.data_block(), x, y, z, u, v, n); }
+
+  //: Project the n interleaved points xyz = (x0, y0, z0, x1, ...) to the interleaved image points uv
+  void project(T const* xyz, T* uv, unsigned n) const
+  { vgl_projective_project_3d(P_.data_block(), xyz, uv, n); }
+
   //: Project a point in world coordinates onto the image plane.
   virtual vgl_homg_point_2d<T> project( const vgl_homg_point_3d<T>& world_point ) const;
 
@@ -76,7 +76,8 @@
 #   define VCL_GCC_60
 #  endif
 # else
-#  error "Dunno about this gcc"
+#  define VCL_GCC_6
+#  define VCL_GCC_63
 # endif
 #endif
 